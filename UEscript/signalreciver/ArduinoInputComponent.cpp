@@ -1,6 +1,7 @@
 #include "ArduinoInputComponent.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "SensorClock.h"
 
 UArduinoInputComponent::UArduinoInputComponent()
 {
@@ -18,20 +19,85 @@ void UArduinoInputComponent::BeginPlay()
     LastButton3State = AOSCReceiver::GetButton3();
     LastButton4State = AOSCReceiver::GetButton4();
     
-    LastPressure1Triggered = AOSCReceiver::GetPressure1() > PressureTriggerThreshold;
-    LastPressure2Triggered = AOSCReceiver::GetPressure2() > PressureTriggerThreshold;
+    LastPressure1Triggered = AOSCReceiver::GetPressure1() > GetPressureTriggerThreshold(1);
+    LastPressure2Triggered = AOSCReceiver::GetPressure2() > GetPressureTriggerThreshold(2);
     
     FVector2D JoystickVec = AOSCReceiver::GetJoystickVector();
     LastJoystickInDeadzone = JoystickVec.Size() <= JoystickDeadzone;
     
     LastConnectionState = AOSCReceiver::IsJoystickConnected();
     
+    TrajectoryAnalyzer.Reset();
+    bTrajectoryInDeadzone = LastJoystickInDeadzone;
+    
+    for (int32 Index = 0; Index < 2; Index++)
+    {
+        SqueezeAnalyzers[Index].Reset();
+        SqueezeAnalyzers[Index].SensorNumber = Index + 1;
+    }
+    ApplySqueezeSettings();
+    InputSampleHandle = AOSCReceiver::OnInputSample.AddUObject(this, &UArduinoInputComponent::HandleInputSample);
+    
+    ScrDetector.Reset();
+    GsrSampleHandle = AOSCReceiver::OnGsrSampleReceived.AddUObject(this, &UArduinoInputComponent::HandleGsrSample);
+    
+    EventWindows.Reset();
+    TrialMarkerHandle = AOSCReceiver::OnTrialMarker.AddUObject(this, &UArduinoInputComponent::HandleTrialMarker);
+    
     if (bEnableDebugLog)
     {
         UE_LOG(LogTemp, Warning, TEXT("Arduino Input Component 已初始化"));
     }
 }
 
+void UArduinoInputComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    AOSCReceiver::OnInputSample.Remove(InputSampleHandle);
+    InputSampleHandle.Reset();
+    AOSCReceiver::OnGsrSampleReceived.Remove(GsrSampleHandle);
+    GsrSampleHandle.Reset();
+    AOSCReceiver::OnTrialMarker.Remove(TrialMarkerHandle);
+    TrialMarkerHandle.Reset();
+    
+    Super::EndPlay(EndPlayReason);
+}
+
+void UArduinoInputComponent::HandleGsrSample(const FGsrSample& Sample)
+{
+    OnGsrSample.Broadcast(Sample);
+    
+    if (bEnableEventWindows)
+    {
+        EventWindows.AddSample(EEraChannel::Conductance, Sample.Time, Sample.Conductance);
+    }
+    
+    if (!bEnableScrDetection)
+    {
+        return;
+    }
+    
+    // 参数可能在运行时被蓝图修改
+    ScrDetector.AmplitudeThreshold = ScrAmplitudeThreshold;
+    ScrDetector.SmoothingTime = ScrSmoothingTime;
+    
+    const FScrSampleResult Result = ScrDetector.AddSample(Sample.Time, Sample.Conductance);
+    if (Result.bOnset)
+    {
+        OnScrOnset.Broadcast(Result.Event);
+    }
+    if (Result.bPeak)
+    {
+        EventWindows.AddScr(Result.Event);
+        OnScrDetected.Broadcast(Result.Event);
+        
+        if (bEnableDebugLog)
+        {
+            UE_LOG(LogTemp, Log, TEXT("Arduino: SCR 起始=%.2fs 峰值=%.2fs 幅度=%.3fμS 张力=%.2fμS"),
+                   Result.Event.OnsetTime, Result.Event.PeakTime, Result.Event.Amplitude, Result.Event.TonicLevel);
+        }
+    }
+}
+
 void UArduinoInputComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
     Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
@@ -47,6 +113,57 @@ void UArduinoInputComponent::TickComponent(float DeltaTime, ELevelTick TickType,
     CheckButtonEvents();
     CheckPressureEvents();
     CheckJoystickEvents();
+    CheckEventWindows();
+}
+
+void UArduinoInputComponent::HandleTrialMarker(const FTrialMarker& Marker)
+{
+    if (!bEnableEventWindows || Marker.Type != ETrialMarkerType::Stimulus)
+    {
+        return;
+    }
+    
+    // 窗口参数只在没有打开的窗口时生效，避免同一批试次用不同的窗口
+    if (EventWindows.GetOpenWindowCount() == 0)
+    {
+        EventWindows.WindowStart = EraWindowStart;
+        EventWindows.WindowEnd = FMath::Max(EraWindowEnd, EraWindowStart);
+    }
+    EventWindows.OpenWindow(Marker.Time, Marker.Condition, Marker.TrialIndex);
+}
+
+void UArduinoInputComponent::CheckEventWindows()
+{
+    if (!bEnableEventWindows)
+    {
+        return;
+    }
+    
+    // 压力样本在接收路径上送入（HandleInputSample），这里只结算到期的窗口
+    TArray<FEraWindowResult> Results;
+    EventWindows.CloseReadyWindows(FSensorClock::Now(), Results);
+    for (const FEraWindowResult& Result : Results)
+    {
+        OnEraWindowCompleted.Broadcast(Result);
+        
+        if (bEnableDebugLog)
+        {
+            UE_LOG(LogTemp, Log, TEXT("Arduino: 试次%d [%s] 电导最大偏移=%.3fμS 潜伏期=%.2fs SCR=%d 压力峰值=%.2f/%.2f%s"),
+                   Result.TrialIndex, *Result.Condition, Result.Conductance.MaxDeflection, Result.Conductance.Latency,
+                   Result.ScrCount, Result.Pressure1.MaxDeflection, Result.Pressure2.MaxDeflection,
+                   Result.bTruncated ? TEXT("（截断）") : TEXT(""));
+        }
+    }
+}
+
+TArray<FEraConditionSummary> UArduinoInputComponent::GetEraConditionSummaries() const
+{
+    return EventWindows.GetSummaries();
+}
+
+void UArduinoInputComponent::ResetEraSummaries()
+{
+    EventWindows.ResetSummaries();
 }
 
 void UArduinoInputComponent::CheckButtonEvents()
@@ -152,7 +269,7 @@ void UArduinoInputComponent::CheckPressureEvents()
 {
     // 压力传感器1
     float CurrentPressure1 = AOSCReceiver::GetPressure1();
-    bool CurrentPressure1Triggered = CurrentPressure1 > PressureTriggerThreshold;
+    bool CurrentPressure1Triggered = CurrentPressure1 > GetPressureTriggerThreshold(1);
     
     if (CurrentPressure1Triggered && !LastPressure1Triggered)
     {
@@ -177,7 +294,7 @@ void UArduinoInputComponent::CheckPressureEvents()
     
     // 压力传感器2
     float CurrentPressure2 = AOSCReceiver::GetPressure2();
-    bool CurrentPressure2Triggered = CurrentPressure2 > PressureTriggerThreshold;
+    bool CurrentPressure2Triggered = CurrentPressure2 > GetPressureTriggerThreshold(2);
     
     if (CurrentPressure2Triggered && !LastPressure2Triggered)
     {
@@ -201,6 +318,152 @@ void UArduinoInputComponent::CheckPressureEvents()
     LastPressure2Triggered = CurrentPressure2Triggered;
 }
 
+float UArduinoInputComponent::GetPressureTriggerThreshold(int32 SensorNumber) const
+{
+    if (bUsePercentileThresholds && AOSCReceiver::IsPressureCalibrated(SensorNumber))
+    {
+        return AOSCReceiver::GetPressureAtPercentile(SensorNumber, PressureTriggerPercentile);
+    }
+    return PressureTriggerThreshold;
+}
+
+void UArduinoInputComponent::ApplySqueezeSettings()
+{
+    for (FSqueezeAnalyzer& Analyzer : SqueezeAnalyzers)
+    {
+        // 正在握压时不改阈值，避免分段被打断
+        if (Analyzer.IsSqueezing())
+        {
+            continue;
+        }
+        
+        if (bUsePercentileThresholds && AOSCReceiver::IsPressureCalibrated(Analyzer.SensorNumber))
+        {
+            Analyzer.OnsetThreshold = AOSCReceiver::GetPressureAtPercentile(Analyzer.SensorNumber, SqueezeOnsetPercentile);
+            Analyzer.ReleaseThreshold = Analyzer.OnsetThreshold * 0.5f;
+        }
+        else
+        {
+            Analyzer.OnsetThreshold = SqueezeOnsetThreshold;
+            Analyzer.ReleaseThreshold = FMath::Min(SqueezeReleaseThreshold, SqueezeOnsetThreshold);
+        }
+        Analyzer.DoubleSqueezeInterval = DoubleSqueezeInterval;
+        Analyzer.SustainedDuration = SustainedSqueezeDuration;
+    }
+}
+
+void UArduinoInputComponent::HandleInputSample(const FHandleInputSample& Sample)
+{
+    if (bEnableSqueezeAnalysis)
+    {
+        // 参数可能在运行时被蓝图修改
+        ApplySqueezeSettings();
+        
+        // 每个样本分析一次，时间取样本在共享时钟上的采样时刻，发力速率和震颤频段与帧率无关
+        if (Sample.bHasPressure1)
+        {
+            AnalyzeSqueeze(SqueezeAnalyzers[0], Sample.Time, Sample.Pressure1);
+        }
+        if (Sample.bHasPressure2)
+        {
+            AnalyzeSqueeze(SqueezeAnalyzers[1], Sample.Time, Sample.Pressure2);
+        }
+    }
+    
+    if (Sample.bHasJoystick)
+    {
+        AnalyzeTrajectory(Sample.Time, Sample.Joystick);
+    }
+    
+    // 响应窗口内的压力曲线按样本累积，批量样本也进入窗口
+    if (bEnableEventWindows)
+    {
+        if (Sample.bHasPressure1)
+        {
+            EventWindows.AddSample(EEraChannel::Pressure1, Sample.Time, Sample.Pressure1);
+        }
+        if (Sample.bHasPressure2)
+        {
+            EventWindows.AddSample(EEraChannel::Pressure2, Sample.Time, Sample.Pressure2);
+        }
+    }
+}
+
+void UArduinoInputComponent::AnalyzeTrajectory(double Time, const FVector2D& Joystick)
+{
+    // 动作按样本分段：离开死区开始，回到死区结束，速度和子动作由采样时刻计算，与帧率无关
+    const float Now = static_cast<float>(Time);
+    const bool bInDeadzone = Joystick.Size() <= JoystickDeadzone;
+    TrajectoryAnalyzer.MinPeakVelocity = SubmovementMinPeakVelocity;
+    
+    if (!bInDeadzone && bTrajectoryInDeadzone)
+    {
+        if (bEnableTrajectoryAnalysis)
+        {
+            TrajectoryAnalyzer.Begin(Now, Joystick);
+        }
+    }
+    else if (!bInDeadzone)
+    {
+        if (TrajectoryAnalyzer.IsActive())
+        {
+            TrajectoryAnalyzer.AddSample(Now, Joystick);
+        }
+    }
+    else if (!bTrajectoryInDeadzone && TrajectoryAnalyzer.IsActive())
+    {
+        const FJoystickMovementMetrics Metrics = TrajectoryAnalyzer.End(Now, Joystick);
+        OnJoystickMovementCompleted.Broadcast(Metrics);
+        
+        if (bEnableDebugLog)
+        {
+            UE_LOG(LogTemp, Log, TEXT("Arduino: 摇杆动作 时间=%.3fs 峰值速度=%.2f 路径=%.2f 效率=%.2f 子动作=%d"),
+                   Metrics.MovementTime, Metrics.PeakVelocity, Metrics.PathLength,
+                   Metrics.PathEfficiency, Metrics.SubmovementCount);
+        }
+    }
+    
+    bTrajectoryInDeadzone = bInDeadzone;
+}
+
+void UArduinoInputComponent::AnalyzeSqueeze(FSqueezeAnalyzer& Analyzer, double Time, float Pressure)
+{
+    const float Now = static_cast<float>(Time);
+    const FSqueezeSampleResult Result = Analyzer.AddSample(Now, Pressure);
+    
+    if (Result.bOnset)
+    {
+        OnSqueezeStarted.Broadcast(Analyzer.SensorNumber, Now);
+    }
+    
+    for (uint8 PatternIndex = 0; PatternIndex <= static_cast<uint8>(ESqueezePattern::Tremor); PatternIndex++)
+    {
+        const ESqueezePattern Pattern = static_cast<ESqueezePattern>(PatternIndex);
+        if (Result.HasPattern(Pattern))
+        {
+            OnSqueezePattern.Broadcast(Analyzer.SensorNumber, Pattern, Now);
+            
+            if (bEnableDebugLog)
+            {
+                UE_LOG(LogTemp, Log, TEXT("Arduino: 压力传感器%d 握压模式 %s"),
+                       Analyzer.SensorNumber, *UEnum::GetValueAsString(Pattern));
+            }
+        }
+    }
+    
+    if (Result.bReleased)
+    {
+        OnSqueezeCompleted.Broadcast(Result.Metrics);
+        
+        if (bEnableDebugLog)
+        {
+            UE_LOG(LogTemp, Log, TEXT("Arduino: 压力传感器%d 握压完成 峰值=%.2f 达峰=%.3fs 发力速率=%.2f/s 冲量=%.3f 保持=%.3fs"),
+                   Analyzer.SensorNumber, Result.Metrics.PeakForce, Result.Metrics.TimeToPeak,
+                   Result.Metrics.RateOfForceDevelopment, Result.Metrics.Impulse, Result.Metrics.HoldDuration);
+        }
+    }
+}
+
 void UArduinoInputComponent::CheckJoystickEvents()
 {
     FVector2D JoystickVec = AOSCReceiver::GetJoystickVector();
@@ -3,6 +3,10 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "OSCReceiver.h"
+#include "SqueezeAnalyzer.h"
+#include "JoystickTrajectoryAnalyzer.h"
+#include "ScrDetector.h"
+#include "EventWindowAnalyzer.h"
 #include "ArduinoInputComponent.generated.h"
 
 // === 事件委托声明（类似键盘事件）===
@@ -19,6 +23,15 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnArduinoPressureTriggered, int32,
 /** 压力传感器释放事件 */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnArduinoPressureReleased, int32, SensorNumber, float, PressureValue);
 
+/** 握压开始事件（Timestamp 为共享传感器时钟，见 FSensorClock）*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnArduinoSqueezeStarted, int32, SensorNumber, float, Timestamp);
+
+/** 握压完成事件（释放时携带整次握压的力曲线指标）*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArduinoSqueezeCompleted, const FSqueezeMetrics&, Metrics);
+
+/** 握压模式事件（双握压、持续握压、震颤；Timestamp 为共享传感器时钟）*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnArduinoSqueezePattern, int32, SensorNumber, ESqueezePattern, Pattern, float, Timestamp);
+
 /** 摇杆移动事件 */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnArduinoJoystickMoved, float, X, float, Y);
 
@@ -28,6 +41,21 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnArduinoJoystickPressed, float, X
 /** 摇杆释放事件（进入死区）*/
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnArduinoJoystickReleased);
 
+/** 摇杆动作完成事件（回到死区时携带整次动作的轨迹指标）*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArduinoJoystickMovementCompleted, const FJoystickMovementMetrics&, Metrics);
+
+/** GSR 样本事件（每个样本一次，时间为共享传感器时钟）*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArduinoGsrSample, const FGsrSample&, Sample);
+
+/** SCR 起始事件（上升幅度超过阈值时，只有起始相关字段有效）*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArduinoScrOnset, const FScrEvent&, Event);
+
+/** SCR 完成事件（确认峰值时携带起始、峰值、幅度、上升时间）*/
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArduinoScrDetected, const FScrEvent&, Event);
+
+/** 事件相关分析窗口结算事件 */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArduinoEraWindowCompleted, const FEraWindowResult&, Result);
+
 /** 连接状态变化事件 */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnArduinoConnectionChanged, bool, bIsConnected);
 
@@ -46,6 +74,7 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 public:
@@ -113,6 +142,20 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Arduino Events|Pressure")
     FOnArduinoPressureTriggered OnAnyPressureTriggered;
     
+    // === 握压分析事件 ===
+    
+    /** 当任意压力通道开始一次握压时 */
+    UPROPERTY(BlueprintAssignable, Category = "Arduino Events|Squeeze")
+    FOnArduinoSqueezeStarted OnSqueezeStarted;
+    
+    /** 当一次握压释放时（附带峰值力、达峰时间、发力速率、冲量、保持时间）*/
+    UPROPERTY(BlueprintAssignable, Category = "Arduino Events|Squeeze")
+    FOnArduinoSqueezeCompleted OnSqueezeCompleted;
+    
+    /** 当识别到握压模式时 */
+    UPROPERTY(BlueprintAssignable, Category = "Arduino Events|Squeeze")
+    FOnArduinoSqueezePattern OnSqueezePattern;
+    
     // === 摇杆事件 ===
     
     /** 当摇杆移动时持续触发 */
@@ -127,22 +170,118 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Arduino Events|Joystick")
     FOnArduinoJoystickReleased OnJoystickReleased;
     
+    /** 当一次摇杆动作结束时触发（摇杆样本回到死区时，附带动作时间、峰值速度、路径效率、子动作数）*/
+    UPROPERTY(BlueprintAssignable, Category = "Arduino Events|Joystick")
+    FOnArduinoJoystickMovementCompleted OnJoystickMovementCompleted;
+    
     // === 连接事件 ===
     
     /** 当 Arduino 连接状态改变时触发 */
     UPROPERTY(BlueprintAssignable, Category = "Arduino Events|Connection")
     FOnArduinoConnectionChanged OnConnectionChanged;
     
+    // === GSR 事件 ===
+    
+    /** 每个 GSR 样本到达时触发 */
+    UPROPERTY(BlueprintAssignable, Category = "Arduino Events|GSR")
+    FOnArduinoGsrSample OnGsrSample;
+    
+    /** 检测到皮肤电反应起始时触发（起始后约 0.2~0.3 秒）*/
+    UPROPERTY(BlueprintAssignable, Category = "Arduino Events|GSR")
+    FOnArduinoScrOnset OnScrOnset;
+    
+    /** 皮肤电反应越过峰值时触发 */
+    UPROPERTY(BlueprintAssignable, Category = "Arduino Events|GSR")
+    FOnArduinoScrDetected OnScrDetected;
+    
+    // === 事件相关分析 ===
+    
+    /** 刺激标记的响应窗口结算时触发（附带电导、压力指标和窗口内的 SCR）*/
+    UPROPERTY(BlueprintAssignable, Category = "Arduino Events|ERA")
+    FOnArduinoEraWindowCompleted OnEraWindowCompleted;
+    
+    /** 获取每个条件的运行平均 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino ERA")
+    TArray<FEraConditionSummary> GetEraConditionSummaries() const;
+    
+    /** 清空条件平均（更换被试时调用），已打开的窗口继续累积 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino ERA")
+    void ResetEraSummaries();
+    
     // === 可配置参数 ===
     
-    /** 压力传感器触发阈值（默认 100）*/
+    /** 压力传感器触发阈值（压力值范围 0~1，默认 0.5）*/
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings")
-    float PressureTriggerThreshold = 100.0f;
+    float PressureTriggerThreshold = 0.5f;
+    
+    /** 热身完成后是否改用被试握压范围的百分位作为阈值 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Percentile")
+    bool bUsePercentileThresholds = false;
+    
+    /** 压力触发阈值对应的百分位（0~100）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Percentile", meta = (ClampMin = "0", ClampMax = "100"))
+    float PressureTriggerPercentile = 50.0f;
+    
+    /** 握压开始阈值对应的百分位（0~100），释放阈值取其一半 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Percentile", meta = (ClampMin = "0", ClampMax = "100"))
+    float SqueezeOnsetPercentile = 20.0f;
     
     /** 摇杆死区半径（默认 0.1）*/
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings")
     float JoystickDeadzone = 0.1f;
     
+    /** 是否启用握压分析 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Squeeze")
+    bool bEnableSqueezeAnalysis = true;
+    
+    /** 握压开始阈值（压力值 0~1）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Squeeze")
+    float SqueezeOnsetThreshold = 0.1f;
+    
+    /** 握压释放阈值（压力值 0~1，应小于开始阈值）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Squeeze")
+    float SqueezeReleaseThreshold = 0.05f;
+    
+    /** 双握压的最大间隔（秒）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Squeeze")
+    float DoubleSqueezeInterval = 0.4f;
+    
+    /** 持续握压的时长阈值（秒）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Squeeze")
+    float SustainedSqueezeDuration = 2.0f;
+    
+    /** 是否启用摇杆轨迹分析 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Trajectory")
+    bool bEnableTrajectoryAnalysis = true;
+    
+    /** 子动作速度峰的最小高度（摇杆坐标/秒）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|Trajectory")
+    float SubmovementMinPeakVelocity = 0.5f;
+    
+    /** 是否启用 SCR 检测 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|SCR")
+    bool bEnableScrDetection = true;
+    
+    /** 最小 SCR 幅度（μS）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|SCR")
+    float ScrAmplitudeThreshold = 0.01f;
+    
+    /** 电导平滑时间常数（秒），越大越抗噪但延迟越大 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|SCR")
+    float ScrSmoothingTime = 0.2f;
+    
+    /** 是否在刺激标记后计算事件相关指标 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|ERA")
+    bool bEnableEventWindows = true;
+    
+    /** 响应窗口起点（相对刺激标记，秒，可为负）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|ERA")
+    float EraWindowStart = 1.0f;
+    
+    /** 响应窗口终点（相对刺激标记，秒）*/
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings|ERA")
+    float EraWindowEnd = 4.0f;
+    
     /** 是否启用调试日志 */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Arduino Settings")
     bool bEnableDebugLog = false;
@@ -161,15 +300,55 @@ private:
     
     bool LastConnectionState = false;
     
+    // 每个压力通道一个握压分析器
+    FSqueezeAnalyzer SqueezeAnalyzers[2];
+    
+    // 摇杆轨迹分析器（按样本分段，死区状态与逐帧的摇杆事件分开跟踪）
+    FJoystickTrajectoryAnalyzer TrajectoryAnalyzer;
+    bool bTrajectoryInDeadzone = true;
+    
     // 检测并分发按钮事件
     void CheckButtonEvents();
     
     // 检测并分发压力传感器事件
     void CheckPressureEvents();
     
+    // 当前生效的压力触发阈值（固定值或被试百分位）
+    float GetPressureTriggerThreshold(int32 SensorNumber) const;
+    
+    // 按样本分析握压、摇杆轨迹和响应窗口内的压力（接收路径上每个输入样本调用一次）
+    void HandleInputSample(const FHandleInputSample& Sample);
+    FDelegateHandle InputSampleHandle;
+    
+    // 送入一个压力样本并分发握压事件
+    void AnalyzeSqueeze(FSqueezeAnalyzer& Analyzer, double Time, float Pressure);
+    
+    // 将组件上的握压参数同步到分析器
+    void ApplySqueezeSettings();
+    
     // 检测并分发摇杆事件
     void CheckJoystickEvents();
     
+    // 送入一个摇杆样本，动作结束时分发轨迹指标
+    void AnalyzeTrajectory(double Time, const FVector2D& Joystick);
+    
+    // 皮肤电反应检测器
+    FScrDetector ScrDetector;
+    
+    // 转发 GSR 样本并检测 SCR
+    void HandleGsrSample(const FGsrSample& Sample);
+    FDelegateHandle GsrSampleHandle;
+    
+    // 事件相关分析（压力样本在 HandleInputSample 中送入）
+    FEventWindowAnalyzer EventWindows;
+    
+    // 刺激标记打开分析窗口
+    void HandleTrialMarker(const FTrialMarker& Marker);
+    FDelegateHandle TrialMarkerHandle;
+    
+    // 结算到期的窗口
+    void CheckEventWindows();
+    
     // 检测连接状态
     void CheckConnectionStatus();
 };
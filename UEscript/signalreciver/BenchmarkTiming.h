@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+
+/** 基准测试 commandlet 共用的计时 */
+struct FBenchmarkTiming
+{
+    /** 重复 Repeat 次取最快的一次（秒）；最快的一次受缓存预热和调度干扰最小 */
+    template <typename FunctionType>
+    static double TimeBest(int32 Repeat, FunctionType&& Function)
+    {
+        double Best = TNumericLimits<double>::Max();
+        for (int32 Pass = 0; Pass < FMath::Max(Repeat, 1); Pass++)
+        {
+            const uint64 Start = FPlatformTime::Cycles64();
+            Function();
+            Best = FMath::Min(Best, FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start));
+        }
+        return Best;
+    }
+};
@@ -0,0 +1,273 @@
+#include "EventWindowAnalyzer.h"
+
+namespace
+{
+    /** 标记从游戏逻辑到这里的最大延迟，以及样本按共享时钟对齐后的抖动 */
+    constexpr double MarkerLatencyMargin = 0.5;
+
+    void UpdateMean(float& Mean, float Value, int32 Count)
+    {
+        Mean += (Value - Mean) / Count;
+    }
+
+    void UpdateMean(FEraChannelMetrics& Mean, const FEraChannelMetrics& Value, int32 Count)
+    {
+        UpdateMean(Mean.Baseline, Value.Baseline, Count);
+        UpdateMean(Mean.MaxDeflection, Value.MaxDeflection, Count);
+        UpdateMean(Mean.Latency, Value.Latency, Count);
+        UpdateMean(Mean.Area, Value.Area, Count);
+        UpdateMean(Mean.Mean, Value.Mean, Count);
+        Mean.SampleCount += Value.SampleCount;
+    }
+}
+
+void FEventWindowAnalyzer::FAccumulator::Add(double Time, float Value)
+{
+    if (!bHasSample)
+    {
+        bHasSample = true;
+        Baseline = Value;
+        Max = Value;
+        MaxTime = Time;
+    }
+    else
+    {
+        // 梯形积分，相对窗口起点的值
+        Area += 0.5 * ((LastValue - Baseline) + (Value - Baseline)) * (Time - LastTime);
+    }
+
+    if (Value > Max)
+    {
+        Max = Value;
+        MaxTime = Time;
+    }
+    Sum += Value;
+    Count++;
+    LastTime = Time;
+    LastValue = Value;
+}
+
+FEraChannelMetrics FEventWindowAnalyzer::FAccumulator::Finish(double MarkerTime) const
+{
+    FEraChannelMetrics Metrics;
+    if (!bHasSample)
+    {
+        return Metrics;
+    }
+
+    Metrics.Baseline = Baseline;
+    Metrics.MaxDeflection = Max - Baseline;
+    Metrics.Latency = static_cast<float>(MaxTime - MarkerTime);
+    Metrics.Area = static_cast<float>(Area);
+    Metrics.Mean = static_cast<float>(Sum / Count);
+    Metrics.SampleCount = Count;
+    return Metrics;
+}
+
+void FEventWindowAnalyzer::AddSample(EEraChannel Channel, double Time, float Value)
+{
+    const int32 ChannelIndex = static_cast<int32>(Channel);
+    if (ChannelIndex < 0 || ChannelIndex >= NumChannels)
+    {
+        return;
+    }
+
+    TRing<FPoint>& Points = History[ChannelIndex];
+    if (Points.Num() > 0 && Time <= Points.Last().Time)
+    {
+        // 重复或乱序的样本
+        return;
+    }
+    Points.Add({ Time, Value });
+
+    for (FOpenWindow& Window : OpenWindows)
+    {
+        const double Start = Window.Result.MarkerTime + WindowStart;
+        const double End = Window.Result.MarkerTime + WindowEnd;
+        if (Time >= Start && Time <= End)
+        {
+            Window.Channels[ChannelIndex].Add(Time, Value);
+        }
+    }
+
+    Prune(Time);
+}
+
+void FEventWindowAnalyzer::AddScr(const FScrEvent& Event)
+{
+    ScrHistory.Add(Event);
+
+    for (FOpenWindow& Window : OpenWindows)
+    {
+        AddScrToWindow(Window, Event);
+    }
+}
+
+void FEventWindowAnalyzer::AddScrToWindow(FOpenWindow& Window, const FScrEvent& Event) const
+{
+    // SCR 按起始时间顺序到达，同一个 SCR 不会重复计入
+    if (Event.OnsetTime <= Window.LastScrOnset)
+    {
+        return;
+    }
+
+    const double Latency = Event.OnsetTime - Window.Result.MarkerTime;
+    if (Latency < WindowStart || Latency > WindowEnd)
+    {
+        return;
+    }
+
+    FEraWindowResult& Result = Window.Result;
+    if (Result.ScrCount == 0)
+    {
+        Result.ScrLatency = static_cast<float>(Latency);
+    }
+    Result.ScrCount++;
+    Result.ScrAmplitudeSum += Event.Amplitude;
+    Window.LastScrOnset = Event.OnsetTime;
+}
+
+void FEventWindowAnalyzer::OpenWindow(double MarkerTime, const FString& Condition, int32 TrialIndex)
+{
+    if (MaxOpenWindows > 0 && OpenWindows.Num() >= MaxOpenWindows)
+    {
+        // 最早的窗口提前结算，带着截断标记在下一次 CloseReadyWindows 输出
+        FOpenWindow& Oldest = OpenWindows[0];
+        FinishWindow(Oldest);
+        Oldest.Result.bTruncated = true;
+        UE_LOG(LogTemp, Warning, TEXT("ERA: 同时打开的窗口超过 %d 个，试次%d [%s] 的窗口被提前结算"),
+               MaxOpenWindows, Oldest.Result.TrialIndex, *Oldest.Result.Condition);
+        TruncatedResults.Add(Oldest.Result);
+        OpenWindows.RemoveAt(0);
+    }
+
+    FOpenWindow& Window = OpenWindows.AddDefaulted_GetRef();
+    Window.Result.Condition = Condition;
+    Window.Result.TrialIndex = TrialIndex;
+    Window.Result.MarkerTime = MarkerTime;
+
+    // 补上已经到达的样本与 SCR（窗口起点为负，或标记晚于样本到达）
+    const double Start = MarkerTime + WindowStart;
+    const double End = MarkerTime + WindowEnd;
+    for (int32 ChannelIndex = 0; ChannelIndex < NumChannels; ChannelIndex++)
+    {
+        const TRing<FPoint>& Points = History[ChannelIndex];
+        for (int32 Index = 0; Index < Points.Num(); Index++)
+        {
+            const FPoint& Point = Points[Index];
+            if (Point.Time >= Start && Point.Time <= End)
+            {
+                Window.Channels[ChannelIndex].Add(Point.Time, Point.Value);
+            }
+        }
+    }
+
+    for (int32 Index = 0; Index < ScrHistory.Num(); Index++)
+    {
+        AddScrToWindow(Window, ScrHistory[Index]);
+    }
+}
+
+void FEventWindowAnalyzer::FinishWindow(FOpenWindow& Window)
+{
+    FEraWindowResult& Result = Window.Result;
+    Result.Conductance = Window.Channels[static_cast<int32>(EEraChannel::Conductance)].Finish(Result.MarkerTime);
+    Result.Pressure1 = Window.Channels[static_cast<int32>(EEraChannel::Pressure1)].Finish(Result.MarkerTime);
+    Result.Pressure2 = Window.Channels[static_cast<int32>(EEraChannel::Pressure2)].Finish(Result.MarkerTime);
+}
+
+int32 FEventWindowAnalyzer::CloseReadyWindows(double Now, TArray<FEraWindowResult>& OutResults)
+{
+    // 截断的窗口不计入条件平均
+    int32 Closed = TruncatedResults.Num();
+    OutResults.Append(TruncatedResults);
+    TruncatedResults.Reset();
+
+    for (int32 Index = 0; Index < OpenWindows.Num();)
+    {
+        FOpenWindow& Window = OpenWindows[Index];
+        if (Now < Window.Result.MarkerTime + WindowEnd + CloseDelay)
+        {
+            Index++;
+            continue;
+        }
+
+        FinishWindow(Window);
+        const FEraWindowResult& Result = Window.Result;
+
+        FEraConditionSummary* Summary = Summaries.FindByPredicate([&Result](const FEraConditionSummary& Existing)
+        {
+            return Existing.Condition == Result.Condition;
+        });
+        if (!Summary)
+        {
+            Summary = &Summaries.AddDefaulted_GetRef();
+            Summary->Condition = Result.Condition;
+        }
+        Accumulate(*Summary, Result);
+
+        OutResults.Add(Result);
+        OpenWindows.RemoveAt(Index);
+        Closed++;
+    }
+    return Closed;
+}
+
+void FEventWindowAnalyzer::Accumulate(FEraConditionSummary& Summary, const FEraWindowResult& Result)
+{
+    Summary.Trials++;
+    UpdateMean(Summary.Conductance, Result.Conductance, Summary.Trials);
+    UpdateMean(Summary.Pressure1, Result.Pressure1, Summary.Trials);
+    UpdateMean(Summary.Pressure2, Result.Pressure2, Summary.Trials);
+    UpdateMean(Summary.ScrCount, static_cast<float>(Result.ScrCount), Summary.Trials);
+    UpdateMean(Summary.ScrAmplitudeSum, Result.ScrAmplitudeSum, Summary.Trials);
+
+    if (Result.ScrCount > 0)
+    {
+        Summary.ResponsiveTrials++;
+        UpdateMean(Summary.ScrLatency, Result.ScrLatency, Summary.ResponsiveTrials);
+    }
+}
+
+double FEventWindowAnalyzer::GetRetention() const
+{
+    return FMath::Max(0.0, -static_cast<double>(WindowStart)) + MarkerLatencyMargin;
+}
+
+void FEventWindowAnalyzer::Prune(double LatestTime)
+{
+    const double Oldest = LatestTime - GetRetention();
+
+    for (TRing<FPoint>& Points : History)
+    {
+        int32 Expired = 0;
+        while (Expired < Points.Num() && Points[Expired].Time < Oldest)
+        {
+            Expired++;
+        }
+        Points.RemoveFirst(Expired);
+    }
+
+    int32 ExpiredScr = 0;
+    while (ExpiredScr < ScrHistory.Num() && ScrHistory[ExpiredScr].OnsetTime < Oldest)
+    {
+        ExpiredScr++;
+    }
+    ScrHistory.RemoveFirst(ExpiredScr);
+}
+
+void FEventWindowAnalyzer::Reset(bool bResetSummaries)
+{
+    for (TRing<FPoint>& Points : History)
+    {
+        Points.Reset();
+    }
+    ScrHistory.Reset();
+    OpenWindows.Reset();
+    TruncatedResults.Reset();
+
+    if (bResetSummaries)
+    {
+        Summaries.Reset();
+    }
+}
@@ -0,0 +1,269 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScrDetector.h"
+#include "EventWindowAnalyzer.generated.h"
+
+/** 参与事件相关分析的通道 */
+UENUM(BlueprintType)
+enum class EEraChannel : uint8
+{
+    Conductance UMETA(DisplayName = "Conductance"),
+    Pressure1   UMETA(DisplayName = "Pressure 1"),
+    Pressure2   UMETA(DisplayName = "Pressure 2")
+};
+
+/** 一个通道在响应窗口内的指标（与 Ledalab export_era 的 Global 指标对应）*/
+USTRUCT(BlueprintType)
+struct FEraChannelMetrics
+{
+    GENERATED_BODY()
+
+    /** 窗口起点的值 */
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float Baseline = 0.0f;
+
+    /** 最大偏移：窗口内最大值 - 起点值 */
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float MaxDeflection = 0.0f;
+
+    /** 最大值相对刺激标记的潜伏期（秒）*/
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float Latency = 0.0f;
+
+    /** 相对起点值的面积（单位 x 秒，梯形积分）*/
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float Area = 0.0f;
+
+    /** 窗口内均值 */
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float Mean = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    int32 SampleCount = 0;
+};
+
+/** 一个刺激标记对应的响应窗口 */
+USTRUCT(BlueprintType)
+struct FEraWindowResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    FString Condition;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    int32 TrialIndex = 0;
+
+    /** 刺激标记时间（秒，共享传感器时钟）*/
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    double MarkerTime = 0.0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    FEraChannelMetrics Conductance;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    FEraChannelMetrics Pressure1;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    FEraChannelMetrics Pressure2;
+
+    /** 起始落在窗口内的 SCR 个数与幅度和（TTP.nSCR / TTP.AmpSum）*/
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    int32 ScrCount = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float ScrAmplitudeSum = 0.0f;
+
+    /** 第一个 SCR 的起始潜伏期（秒，没有 SCR 时为 -1）*/
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float ScrLatency = -1.0f;
+
+    /** 同时打开的窗口超过上限，窗口在结束前被提前结算；指标只覆盖已到达的部分，不计入条件平均 */
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    bool bTruncated = false;
+};
+
+/** 某个条件下所有已结束窗口的运行平均 */
+USTRUCT(BlueprintType)
+struct FEraConditionSummary
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    FString Condition;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    int32 Trials = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    FEraChannelMetrics Conductance;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    FEraChannelMetrics Pressure1;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    FEraChannelMetrics Pressure2;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float ScrCount = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float ScrAmplitudeSum = 0.0f;
+
+    /** 有 SCR 的窗口中的平均起始潜伏期 */
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    float ScrLatency = 0.0f;
+
+    /** 有 SCR 的窗口数 */
+    UPROPERTY(BlueprintReadOnly, Category = "ERA")
+    int32 ResponsiveTrials = 0;
+};
+
+/**
+ * 刺激锁定的事件相关分析（对应 leda_batchanalysis.m 的 export_era，但在采集过程中增量计算）
+ * 刺激标记打开 [标记 + WindowStart, 标记 + WindowEnd] 的窗口，样本到达时累积指标，
+ * 窗口结束 CloseDelay 秒后（等待峰值尚未确认的 SCR）结算并计入条件平均
+ * 只保留覆盖 WindowStart 之前部分所需的历史，内存与会话长度无关
+ */
+struct WORKVOILENCEGAME_API FEventWindowAnalyzer
+{
+public:
+    static constexpr int32 NumChannels = 3;
+
+    // === 窗口参数（秒，相对刺激标记）===
+
+    /** 窗口起点，可以为负（包含刺激前的数据）*/
+    float WindowStart = 1.0f;
+
+    /** 窗口终点 */
+    float WindowEnd = 4.0f;
+
+    /** 窗口结束后等待 SCR 确认的时间 */
+    float CloseDelay = 2.0f;
+
+    /** 同时打开的窗口上限，超出时最早的窗口提前结算（bTruncated）*/
+    int32 MaxOpenWindows = 16;
+
+    // === 接口 ===
+
+    void AddSample(EEraChannel Channel, double Time, float Value);
+
+    /** 检测到的 SCR（按起始时间归入窗口）*/
+    void AddScr(const FScrEvent& Event);
+
+    /** 刺激标记：打开一个窗口，并用历史数据补上标记之前已经到达的部分 */
+    void OpenWindow(double MarkerTime, const FString& Condition, int32 TrialIndex);
+
+    /** 结算 Now 之前可以关闭的窗口（以及因超过上限被提前结算的窗口），返回结算的个数 */
+    int32 CloseReadyWindows(double Now, TArray<FEraWindowResult>& OutResults);
+
+    const TArray<FEraConditionSummary>& GetSummaries() const { return Summaries; }
+
+    int32 GetOpenWindowCount() const { return OpenWindows.Num(); }
+
+    /** 清空窗口和历史，ResetSummaries 同时清空条件平均 */
+    void Reset(bool bResetSummaries = true);
+
+    /** 只清空条件平均，打开的窗口和历史保留 */
+    void ResetSummaries() { Summaries.Reset(); }
+
+private:
+    struct FPoint
+    {
+        double Time;
+        float Value;
+    };
+
+    /**
+     * 按时间顺序追加、从头部过期的环形缓冲
+     * 容量按 2 的幂增长到覆盖保留时长为止，之后过期不再移动元素，也不再分配
+     */
+    template <typename ItemType>
+    struct TRing
+    {
+        int32 Num() const { return static_cast<int32>(Head - Tail); }
+
+        const ItemType& operator[](int32 Index) const { return Items[(Tail + Index) & Mask]; }
+
+        const ItemType& Last() const { return (*this)[Num() - 1]; }
+
+        void Add(const ItemType& Item)
+        {
+            if (Num() == Items.Num())
+            {
+                Grow();
+            }
+            Items[Head++ & Mask] = Item;
+        }
+
+        void RemoveFirst(int32 Count) { Tail += Count; }
+
+        void Reset() { Head = Tail = 0; }
+
+    private:
+        void Grow()
+        {
+            TArray<ItemType> Grown;
+            Grown.SetNum(FMath::Max(64, Items.Num() * 2));
+            const int32 Count = Num();
+            for (int32 Index = 0; Index < Count; Index++)
+            {
+                Grown[Index] = (*this)[Index];
+            }
+            Items = MoveTemp(Grown);
+            Mask = static_cast<uint64>(Items.Num() - 1);
+            Tail = 0;
+            Head = Count;
+        }
+
+        TArray<ItemType> Items;
+        uint64 Mask = 0;
+        uint64 Head = 0;
+        uint64 Tail = 0;
+    };
+
+    /** 单个通道在窗口内的累积量 */
+    struct FAccumulator
+    {
+        bool bHasSample = false;
+        float Baseline = 0.0f;
+        float Max = 0.0f;
+        double MaxTime = 0.0;
+        double Area = 0.0;
+        double Sum = 0.0;
+        int32 Count = 0;
+        double LastTime = 0.0;
+        float LastValue = 0.0f;
+
+        void Add(double Time, float Value);
+        FEraChannelMetrics Finish(double MarkerTime) const;
+    };
+
+    struct FOpenWindow
+    {
+        FEraWindowResult Result;
+        FAccumulator Channels[NumChannels];
+        double LastScrOnset = -1.0;
+    };
+
+    /** 历史保留时长：覆盖窗口起点之前的部分以及标记的传输延迟 */
+    double GetRetention() const;
+
+    void Prune(double LatestTime);
+
+    void AddScrToWindow(FOpenWindow& Window, const FScrEvent& Event) const;
+
+    /** 由累积量计算窗口指标 */
+    static void FinishWindow(FOpenWindow& Window);
+
+    void Accumulate(FEraConditionSummary& Summary, const FEraWindowResult& Result);
+
+    TRing<FPoint> History[NumChannels];
+    TRing<FScrEvent> ScrHistory;
+    TArray<FOpenWindow> OpenWindows;
+    TArray<FEraConditionSummary> Summaries;
+
+    /** 因超过上限被提前结算、等待下一次 CloseReadyWindows 输出的窗口 */
+    TArray<FEraWindowResult> TruncatedResults;
+};
@@ -0,0 +1,58 @@
+#include "FrameSequenceTracker.h"
+
+FFrameSequenceResult FFrameSequenceTracker::EndFrame(int32 Sequence, bool bKeyframe, float Time)
+{
+    FFrameSequenceResult Result;
+
+    if (bHasSequence)
+    {
+        const int32 Expected = LastSequence + 1;
+        if (Sequence < Expected)
+        {
+            // 序号回退：手柄重启（重启后第一帧总是关键帧），不计为丢帧
+            bSynchronized = false;
+        }
+        else if (Sequence > Expected)
+        {
+            Result.bGap = true;
+            Result.LostFrames = Sequence - Expected;
+            LostFrames += Result.LostFrames;
+            bSynchronized = false;
+        }
+    }
+
+    bHasSequence = true;
+    LastSequence = Sequence;
+    ReceivedFrames++;
+
+    if (bKeyframe)
+    {
+        ReceivedKeyframes++;
+        bSynchronized = true;
+    }
+
+    if (!bSynchronized && (LastKeyframeRequestTime < 0.0f || Time - LastKeyframeRequestTime >= KeyframeRequestInterval))
+    {
+        Result.bNeedKeyframe = true;
+        LastKeyframeRequestTime = Time;
+    }
+
+    return Result;
+}
+
+float FFrameSequenceTracker::GetLossRatio() const
+{
+    const int64 Expected = ReceivedFrames + LostFrames;
+    return Expected > 0 ? static_cast<float>(static_cast<double>(LostFrames) / static_cast<double>(Expected)) : 0.0f;
+}
+
+void FFrameSequenceTracker::Reset()
+{
+    bHasSequence = false;
+    bSynchronized = false;
+    LastSequence = 0;
+    LastKeyframeRequestTime = -1.0f;
+    ReceivedFrames = 0;
+    ReceivedKeyframes = 0;
+    LostFrames = 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** 一帧结束时的判定结果 */
+struct FFrameSequenceResult
+{
+    /** 与上一帧之间有帧丢失 */
+    bool bGap = false;
+
+    /** 本次丢失的帧数 */
+    int32 LostFrames = 0;
+
+    /** 当前状态不完整（丢帧后尚未收到关键帧），应请求关键帧 */
+    bool bNeedKeyframe = false;
+};
+
+/**
+ * 增量帧序号跟踪
+ * 手柄空闲时只发送变化的通道并定期发送关键帧，接收端的通道值在帧之间保持，
+ * 因此完整状态 = 最近一次关键帧 + 之后的所有增量；这里负责检测丢帧并判断状态是否仍然完整
+ */
+struct WORKVOILENCEGAME_API FFrameSequenceTracker
+{
+public:
+    /** 丢帧后请求关键帧的最小间隔（秒），避免每个增量帧都重复请求 */
+    float KeyframeRequestInterval = 0.2f;
+
+    /** 帧结束（收到 /avatar/frame）时调用，Time 为接收时间（秒） */
+    FFrameSequenceResult EndFrame(int32 Sequence, bool bKeyframe, float Time);
+
+    /** 收到过关键帧且此后没有丢帧 */
+    bool IsSynchronized() const { return bSynchronized; }
+
+    int32 GetLastSequence() const { return LastSequence; }
+    int64 GetReceivedFrames() const { return ReceivedFrames; }
+    int64 GetReceivedKeyframes() const { return ReceivedKeyframes; }
+    int64 GetLostFrames() const { return LostFrames; }
+
+    /** 丢帧率（丢失帧 / 应收帧） */
+    float GetLossRatio() const;
+
+    void Reset();
+
+private:
+    bool bHasSequence = false;
+    bool bSynchronized = false;
+    int32 LastSequence = 0;
+    float LastKeyframeRequestTime = -1.0f;
+
+    int64 ReceivedFrames = 0;
+    int64 ReceivedKeyframes = 0;
+    int64 LostFrames = 0;
+};
@@ -0,0 +1,253 @@
+#include "GorillaCodec.h"
+
+namespace
+{
+    /** 二阶差分的分档：前缀为 N 个 1 加一个 0（最后一档没有 0），后面跟 ValueBits 位 zigzag 值 */
+    constexpr int32 TimestampBuckets = 5;
+    const int32 TimestampValueBits[TimestampBuckets + 1] = { 0, 7, 12, 20, 32, 64 };
+
+    uint64 ToBits(double Value)
+    {
+        uint64 Bits;
+        FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+        return Bits;
+    }
+
+    double FromBits(uint64 Bits)
+    {
+        double Value;
+        FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+        return Value;
+    }
+
+    /**
+     * 异或编码，Width 为位宽（32/64），LengthBits 为有效位长度字段的位数
+     * 前导零个数用 5 位表示（超过 31 按 31 处理，多出的零算在有效位里）
+     */
+    template <int32 Width, int32 LengthBits>
+    void EncodeXor(const uint64* Bits, int32 Count, FGorillaBitWriter& Writer)
+    {
+        if (Count <= 0)
+        {
+            return;
+        }
+
+        uint64 Previous = Bits[0];
+        Writer.Write(Previous, Width);
+        int32 WindowLeading = -1;
+        int32 WindowTrailing = 0;
+        for (int32 Index = 1; Index < Count; Index++)
+        {
+            const uint64 Xor = Bits[Index] ^ Previous;
+            Previous = Bits[Index];
+            if (Xor == 0)
+            {
+                Writer.Write(0, 1);
+                continue;
+            }
+
+            const int32 Leading = FMath::Min(static_cast<int32>(FMath::CountLeadingZeros64(Xor)) - (64 - Width), 31);
+            const int32 Trailing = static_cast<int32>(FMath::CountTrailingZeros64(Xor));
+            if (WindowLeading >= 0 && Leading >= WindowLeading && Trailing >= WindowTrailing)
+            {
+                Writer.Write(0b10, 2);
+                Writer.Write(Xor >> WindowTrailing, Width - WindowLeading - WindowTrailing);
+            }
+            else
+            {
+                const int32 Length = Width - Leading - Trailing;
+                Writer.Write(0b11, 2);
+                Writer.Write(static_cast<uint64>(Leading), 5);
+                Writer.Write(static_cast<uint64>(Length - 1), LengthBits);
+                Writer.Write(Xor >> Trailing, Length);
+                WindowLeading = Leading;
+                WindowTrailing = Trailing;
+            }
+        }
+    }
+
+    template <int32 Width, int32 LengthBits>
+    bool DecodeXor(FGorillaBitReader& Reader, int32 Count, uint64* OutBits)
+    {
+        if (Count <= 0)
+        {
+            return true;
+        }
+
+        uint64 Previous = Reader.Read(Width);
+        OutBits[0] = Previous;
+        int32 WindowLeading = -1;
+        int32 WindowTrailing = 0;
+        for (int32 Index = 1; Index < Count; Index++)
+        {
+            if (Reader.Read(1) != 0)
+            {
+                if (Reader.Read(1) == 0)
+                {
+                    if (WindowLeading < 0)
+                    {
+                        return false;
+                    }
+                    Previous ^= Reader.Read(Width - WindowLeading - WindowTrailing) << WindowTrailing;
+                }
+                else
+                {
+                    WindowLeading = static_cast<int32>(Reader.Read(5));
+                    const int32 Length = static_cast<int32>(Reader.Read(LengthBits)) + 1;
+                    WindowTrailing = Width - WindowLeading - Length;
+                    if (WindowTrailing < 0)
+                    {
+                        return false;
+                    }
+                    Previous ^= Reader.Read(Length) << WindowTrailing;
+                }
+            }
+            OutBits[Index] = Previous;
+        }
+        return !Reader.HasOverflowed();
+    }
+}
+
+void FGorillaCodec::EncodeTimestamps(const double* Values, int32 Count, FGorillaBitWriter& Writer)
+{
+    if (Count <= 0)
+    {
+        return;
+    }
+
+    uint64 Previous = ToBits(Values[0]);
+    uint64 PreviousDelta = 0;
+    Writer.Write(Previous, 64);
+    for (int32 Index = 1; Index < Count; Index++)
+    {
+        // 无符号运算避免溢出，差值按补码解释
+        const uint64 Current = ToBits(Values[Index]);
+        const uint64 Delta = Current - Previous;
+        const int64 DeltaOfDelta = static_cast<int64>(Delta - PreviousDelta);
+        const uint64 ZigZag = (static_cast<uint64>(DeltaOfDelta) << 1) ^ static_cast<uint64>(DeltaOfDelta >> 63);
+        Previous = Current;
+        PreviousDelta = Delta;
+
+        int32 Bucket = 0;
+        while (Bucket < TimestampBuckets && ZigZag >> TimestampValueBits[Bucket] != 0)
+        {
+            Bucket++;
+        }
+        if (Bucket < TimestampBuckets)
+        {
+            // Bucket 个 1 加一个 0
+            Writer.Write((uint64(1) << (Bucket + 1)) - 2, Bucket + 1);
+        }
+        else
+        {
+            Writer.Write((uint64(1) << TimestampBuckets) - 1, TimestampBuckets);
+        }
+        Writer.Write(ZigZag, TimestampValueBits[Bucket]);
+    }
+}
+
+bool FGorillaCodec::DecodeTimestamps(FGorillaBitReader& Reader, int32 Count, double* OutValues)
+{
+    if (Count <= 0)
+    {
+        return true;
+    }
+
+    uint64 Previous = Reader.Read(64);
+    uint64 PreviousDelta = 0;
+    OutValues[0] = FromBits(Previous);
+    for (int32 Index = 1; Index < Count; Index++)
+    {
+        int32 Bucket = 0;
+        while (Bucket < TimestampBuckets && Reader.Read(1) != 0)
+        {
+            Bucket++;
+        }
+        const uint64 ZigZag = Reader.Read(TimestampValueBits[Bucket]);
+        const uint64 DeltaOfDelta = (ZigZag >> 1) ^ (0 - (ZigZag & 1));
+        PreviousDelta += DeltaOfDelta;
+        Previous += PreviousDelta;
+        OutValues[Index] = FromBits(Previous);
+    }
+    return !Reader.HasOverflowed();
+}
+
+void FGorillaCodec::EncodeFloats(const float* Values, int32 Count, FGorillaBitWriter& Writer)
+{
+    TArray<uint64> Bits;
+    Bits.SetNumUninitialized(Count);
+    for (int32 Index = 0; Index < Count; Index++)
+    {
+        uint32 Value;
+        FMemory::Memcpy(&Value, &Values[Index], sizeof(Value));
+        Bits[Index] = Value;
+    }
+    EncodeXor<32, 5>(Bits.GetData(), Count, Writer);
+}
+
+bool FGorillaCodec::DecodeFloats(FGorillaBitReader& Reader, int32 Count, float* OutValues)
+{
+    TArray<uint64> Bits;
+    Bits.SetNumUninitialized(Count);
+    if (!DecodeXor<32, 5>(Reader, Count, Bits.GetData()))
+    {
+        return false;
+    }
+    for (int32 Index = 0; Index < Count; Index++)
+    {
+        const uint32 Value = static_cast<uint32>(Bits[Index]);
+        FMemory::Memcpy(&OutValues[Index], &Value, sizeof(Value));
+    }
+    return true;
+}
+
+void FGorillaCodec::EncodeDoubles(const double* Values, int32 Count, FGorillaBitWriter& Writer)
+{
+    TArray<uint64> Bits;
+    Bits.SetNumUninitialized(Count);
+    FMemory::Memcpy(Bits.GetData(), Values, Count * sizeof(double));
+    EncodeXor<64, 6>(Bits.GetData(), Count, Writer);
+}
+
+bool FGorillaCodec::DecodeDoubles(FGorillaBitReader& Reader, int32 Count, double* OutValues)
+{
+    TArray<uint64> Bits;
+    Bits.SetNumUninitialized(Count);
+    if (!DecodeXor<64, 6>(Reader, Count, Bits.GetData()))
+    {
+        return false;
+    }
+    FMemory::Memcpy(OutValues, Bits.GetData(), Count * sizeof(double));
+    return true;
+}
+
+void FGorillaCodec::EncodeBytes(const uint8* Values, int32 Count, FGorillaBitWriter& Writer)
+{
+    uint8 Previous = 0;
+    for (int32 Index = 0; Index < Count; Index++)
+    {
+        if (Values[Index] == Previous)
+        {
+            Writer.Write(0, 1);
+        }
+        else
+        {
+            Writer.Write(0x100 | Values[Index], 9);
+            Previous = Values[Index];
+        }
+    }
+}
+
+bool FGorillaCodec::DecodeBytes(FGorillaBitReader& Reader, int32 Count, uint8* OutValues)
+{
+    uint8 Previous = 0;
+    for (int32 Index = 0; Index < Count; Index++)
+    {
+        if (Reader.Read(1) != 0)
+        {
+            Previous = static_cast<uint8>(Reader.Read(8));
+        }
+        OutValues[Index] = Previous;
+    }
+    return !Reader.HasOverflowed();
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** 按位写入（高位在前），Flush 后末尾不足一个字节的部分补 0 */
+class WORKVOILENCEGAME_API FGorillaBitWriter
+{
+public:
+    explicit FGorillaBitWriter(TArray<uint8>& InOutput) : Output(InOutput) {}
+
+    /** 写入 Value 的低 NumBits 位（0~64）*/
+    void Write(uint64 Value, int32 NumBits)
+    {
+        if (NumBits > 32)
+        {
+            Write(Value >> 32, NumBits - 32);
+            NumBits = 32;
+        }
+        if (NumBits <= 0)
+        {
+            return;
+        }
+
+        // 缓冲中最多剩 7 位，加上 32 位不会溢出
+        Buffer = (Buffer << NumBits) | (Value & ((uint64(1) << NumBits) - 1));
+        Count += NumBits;
+        while (Count >= 8)
+        {
+            Count -= 8;
+            Output.Add(static_cast<uint8>(Buffer >> Count));
+        }
+    }
+
+    void Flush()
+    {
+        if (Count > 0)
+        {
+            Output.Add(static_cast<uint8>(Buffer << (8 - Count)));
+            Count = 0;
+        }
+        Buffer = 0;
+    }
+
+private:
+    TArray<uint8>& Output;
+    uint64 Buffer = 0;
+    int32 Count = 0;
+};
+
+/** 按位读取（与 FGorillaBitWriter 对应），越界时返回 0 并设置 HasOverflowed */
+class WORKVOILENCEGAME_API FGorillaBitReader
+{
+public:
+    FGorillaBitReader(const uint8* InData, int32 InNumBytes) : Data(InData), NumBytes(InNumBytes) {}
+
+    uint64 Read(int32 NumBits)
+    {
+        if (NumBits > 32)
+        {
+            const uint64 High = Read(NumBits - 32);
+            return (High << 32) | Read(32);
+        }
+        if (NumBits <= 0)
+        {
+            return 0;
+        }
+
+        while (Count < NumBits)
+        {
+            if (Position >= NumBytes)
+            {
+                bOverflowed = true;
+                return 0;
+            }
+            Buffer = (Buffer << 8) | Data[Position++];
+            Count += 8;
+        }
+        Count -= NumBits;
+        return (Buffer >> Count) & ((uint64(1) << NumBits) - 1);
+    }
+
+    bool HasOverflowed() const { return bOverflowed; }
+
+    /** 已经读到的字节位置（最后一个字节中未用的位是填充）*/
+    int32 GetBytePosition() const { return Position; }
+
+private:
+    const uint8* Data;
+    int32 NumBytes;
+    int32 Position = 0;
+    uint64 Buffer = 0;
+    int32 Count = 0;
+    bool bOverflowed = false;
+};
+
+/**
+ * Gorilla 风格的时间序列编码（Facebook Gorilla / Pelkonen et al. 2015），无损
+ * - 时间戳：按 double 的位模式做二阶差分（同一数量级内等间隔的时间戳位模式也等间隔），
+ *   zigzag 后按 0 / 7 / 12 / 20 / 32 / 64 位分档
+ * - 浮点数：与上一个值异或，相同时 1 位；否则沿用上一个有效位窗口，或写出新的前导零个数与长度
+ * - 字节（按钮位图）：不变时 1 位，变化时 1 + 8 位
+ * 所有函数都写入同一个位流，各列依次排列，解码时按相同顺序读取
+ */
+struct WORKVOILENCEGAME_API FGorillaCodec
+{
+    static void EncodeTimestamps(const double* Values, int32 Count, FGorillaBitWriter& Writer);
+
+    static bool DecodeTimestamps(FGorillaBitReader& Reader, int32 Count, double* OutValues);
+
+    static void EncodeFloats(const float* Values, int32 Count, FGorillaBitWriter& Writer);
+
+    static bool DecodeFloats(FGorillaBitReader& Reader, int32 Count, float* OutValues);
+
+    static void EncodeDoubles(const double* Values, int32 Count, FGorillaBitWriter& Writer);
+
+    static bool DecodeDoubles(FGorillaBitReader& Reader, int32 Count, double* OutValues);
+
+    static void EncodeBytes(const uint8* Values, int32 Count, FGorillaBitWriter& Writer);
+
+    static bool DecodeBytes(FGorillaBitReader& Reader, int32 Count, uint8* OutValues);
+};
@@ -0,0 +1,267 @@
+#include "GroupComparison.h"
+#include "SessionImporter.h"
+#include "ParallelWorkers.h"
+#include "HAL/PlatformMisc.h"
+#include "Math/RandomStream.h"
+#include "Misc/Crc.h"
+
+namespace
+{
+    /** 随机流的用途，参与种子计算，置换检验和 bootstrap 互不相关 */
+    enum class EResamplingTest : uint32
+    {
+        Permutation = 0,
+        Bootstrap = 1
+    };
+
+    /** 一块的随机流，种子取 (种子, 指标名, 检验, 块号) 的 CRC，与哪个线程执行这一块无关 */
+    FRandomStream MakeStream(int32 Seed, uint32 MetricKey, EResamplingTest Test, int32 Block)
+    {
+        const uint32 Key[] = { static_cast<uint32>(Seed), MetricKey, static_cast<uint32>(Test), static_cast<uint32>(Block) };
+        return FRandomStream(static_cast<int32>(FCrc::MemCrc32(Key, sizeof(Key))));
+    }
+
+    /** [0, Count) 中的随机下标 */
+    int32 RandomIndex(FRandomStream& Stream, int32 Count)
+    {
+        return FMath::Min(FMath::TruncToInt(Stream.GetFraction() * static_cast<double>(Count)), Count - 1);
+    }
+
+    /** 已排序数组的分位数，相邻两个值之间线性插值（同 numpy.quantile 的默认方法）*/
+    double Quantile(const TArray<double>& Sorted, double Probability)
+    {
+        if (Sorted.Num() == 0)
+        {
+            return 0.0;
+        }
+        const double Position = FMath::Clamp(Probability, 0.0, 1.0) * (Sorted.Num() - 1);
+        const int32 Lower = FMath::FloorToInt(Position);
+        const int32 Upper = FMath::Min(Lower + 1, Sorted.Num() - 1);
+        return Sorted[Lower] + (Sorted[Upper] - Sorted[Lower]) * (Position - Lower);
+    }
+
+    void Describe(const TArray<double>& Values, int32& OutCount, double& OutMean, double& OutStdDev, double& OutMedian)
+    {
+        OutCount = Values.Num();
+        OutMean = FGroupComparison::Mean(Values);
+        OutMedian = FGroupComparison::Median(Values);
+
+        double Variance = 0.0;
+        for (const double Value : Values)
+        {
+            Variance += FMath::Square(Value - OutMean);
+        }
+        OutStdDev = Values.Num() > 1 ? FMath::Sqrt(Variance / (Values.Num() - 1)) : 0.0;
+    }
+}
+
+bool FGroupComparison::LoadParticipant(const FString& Path, const FParticipantSettings& Settings, FParticipantMetrics& OutMetrics)
+{
+    OutMetrics = FParticipantMetrics();
+    OutMetrics.Path = Path;
+
+    FImportedTable Table;
+    if (!FSessionImporter::Load(Path, Table, OutMetrics.Error))
+    {
+        return false;
+    }
+    return AnalyzeParticipant(Table, Settings, OutMetrics);
+}
+
+bool FGroupComparison::AnalyzeParticipant(const FImportedTable& Table, const FParticipantSettings& Settings, FParticipantMetrics& OutMetrics)
+{
+    const FString Path = OutMetrics.Path;
+    OutMetrics = FParticipantMetrics();
+    OutMetrics.Path = Path;
+
+    const TArray<double>* Times = Table.FindColumn(TEXT("time"));
+    const TArray<double>* Conductance = Table.FindColumn(TEXT("conductance"));
+    if (!Times || !Conductance || Conductance->Num() < 2)
+    {
+        OutMetrics.Error = TEXT("没有电导数据");
+        return false;
+    }
+    OutMetrics.DurationMinutes = (Times->Last() - (*Times)[0]) / 60.0;
+
+    TArray<double> Time = *Times;
+    TArray<double> Values = *Conductance;
+    FGsrDecompositionResult Decomposition;
+    if (!FGsrDecomposition::Preprocess(Settings.Preprocess, Time, Values, OutMetrics.Error)
+        || !FGsrDecomposition::Decompose(Time, Values, Settings.Decomposition, Decomposition, OutMetrics.Error))
+    {
+        return false;
+    }
+
+    for (const FGsrDecomposedScr& Scr : Decomposition.Scrs)
+    {
+        if (Scr.Amplitude >= Settings.Threshold)
+        {
+            OutMetrics.ScrAmplitudes.Add(Scr.Amplitude);
+        }
+    }
+    OutMetrics.ScrPerMinute = OutMetrics.DurationMinutes > 0.0 ? OutMetrics.ScrAmplitudes.Num() / OutMetrics.DurationMinutes : 0.0;
+    OutMetrics.ScrAmplitudeMean = Mean(OutMetrics.ScrAmplitudes);
+    OutMetrics.TonicMean = Mean(Decomposition.TonicData);
+
+    ReactionTimes(Table.Events, OutMetrics.ReactionTimes);
+    OutMetrics.ReactionTimeMean = Mean(OutMetrics.ReactionTimes);
+    OutMetrics.ReactionTimeMedian = Median(OutMetrics.ReactionTimes);
+
+    OutMetrics.bSucceeded = true;
+    return true;
+}
+
+void FGroupComparison::ReactionTimes(const TArray<FLedalabEvent>& Events, TArray<double>& OutTimes)
+{
+    OutTimes.Reset();
+
+    // 试次序号 -> 还没有反应的刺激时间
+    TMap<int32, double> PendingStimuli;
+    for (const FLedalabEvent& Event : Events)
+    {
+        if (Event.Name.StartsWith(TEXT("Stimulus")))
+        {
+            PendingStimuli.Add(Event.TrialIndex, Event.Time);
+        }
+        else if (Event.Name.StartsWith(TEXT("Response")))
+        {
+            if (const double* StimulusTime = PendingStimuli.Find(Event.TrialIndex))
+            {
+                const double ReactionTime = Event.Time - *StimulusTime;
+                if (ReactionTime > 0.0)
+                {
+                    OutTimes.Add(ReactionTime);
+                }
+                PendingStimuli.Remove(Event.TrialIndex);
+            }
+        }
+    }
+}
+
+FMetricComparison FGroupComparison::Compare(const FString& Metric, const TArray<double>& A, const TArray<double>& B, const FResamplingSettings& Settings)
+{
+    FMetricComparison Result;
+    Result.Metric = Metric;
+    Describe(A, Result.CountA, Result.MeanA, Result.StdDevA, Result.MedianA);
+    Describe(B, Result.CountB, Result.MeanB, Result.StdDevB, Result.MedianB);
+    Result.Difference = Result.MeanA - Result.MeanB;
+    Result.CiLow = Result.Difference;
+    Result.CiHigh = Result.Difference;
+
+    const int32 CountA = A.Num();
+    const int32 CountB = B.Num();
+    if (CountA < 2 || CountB < 2)
+    {
+        return Result;
+    }
+    Result.bValid = true;
+
+    const double PooledStdDev = FMath::Sqrt(((CountA - 1) * FMath::Square(Result.StdDevA) + (CountB - 1) * FMath::Square(Result.StdDevB)) / (CountA + CountB - 2));
+    const double Correction = 1.0 - 3.0 / (4.0 * (CountA + CountB) - 9.0);
+    Result.EffectSize = PooledStdDev > 0.0 ? Result.Difference / PooledStdDev * Correction : 0.0;
+
+    const int32 NumThreads = Settings.NumThreads > 0 ? Settings.NumThreads : FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    const uint32 MetricKey = FCrc::StrCrc32(*Metric);
+
+    // === 置换检验 ===
+
+    if (Settings.Permutations > 0)
+    {
+        TArray<double> Pooled = A;
+        Pooled.Append(B);
+        double Total = 0.0;
+        for (const double Value : Pooled)
+        {
+            Total += Value;
+        }
+
+        // 只需要随机抽出较小的一组，另一组的和由总和减去；与观测值相等的置换（含原分组）按舍入误差放宽后计入
+        const bool bPickA = CountA <= CountB;
+        const int32 Picked = bPickA ? CountA : CountB;
+        const double Threshold = FMath::Abs(Result.Difference) * (1.0 - 1e-9);
+
+        const int32 NumBlocks = FMath::DivideAndRoundUp(Settings.Permutations, BlockSize);
+        TArray<int32> Extreme;
+        Extreme.SetNumZeroed(NumBlocks);
+        FParallelWorkers::ForEach(NumBlocks, NumThreads, TEXT("GroupComparison"), [&](int32 Block)
+        {
+            FRandomStream Stream = MakeStream(Settings.Seed, MetricKey, EResamplingTest::Permutation, Block);
+            TArray<double> Shuffled = Pooled;
+            const int32 Last = FMath::Min((Block + 1) * BlockSize, Settings.Permutations);
+            int32 Count = 0;
+            for (int32 Sample = Block * BlockSize; Sample < Last; Sample++)
+            {
+                // 部分 Fisher-Yates：交换到前 Picked 个位置的值即这次分到所抽组的值
+                double PickedSum = 0.0;
+                for (int32 Index = 0; Index < Picked; Index++)
+                {
+                    Swap(Shuffled[Index], Shuffled[Index + RandomIndex(Stream, Shuffled.Num() - Index)]);
+                    PickedSum += Shuffled[Index];
+                }
+                const double SumA = bPickA ? PickedSum : Total - PickedSum;
+                if (FMath::Abs(SumA / CountA - (Total - SumA) / CountB) >= Threshold)
+                {
+                    Count++;
+                }
+            }
+            Extreme[Block] = Count;
+        });
+
+        int64 TotalExtreme = 0;
+        for (const int32 Count : Extreme)
+        {
+            TotalExtreme += Count;
+        }
+        Result.PValue = (1.0 + TotalExtreme) / (1.0 + Settings.Permutations);
+    }
+
+    // === bootstrap ===
+
+    if (Settings.BootstrapSamples > 0)
+    {
+        TArray<double> Differences;
+        Differences.SetNumUninitialized(Settings.BootstrapSamples);
+        const int32 NumBlocks = FMath::DivideAndRoundUp(Settings.BootstrapSamples, BlockSize);
+        FParallelWorkers::ForEach(NumBlocks, NumThreads, TEXT("GroupComparison"), [&](int32 Block)
+        {
+            FRandomStream Stream = MakeStream(Settings.Seed, MetricKey, EResamplingTest::Bootstrap, Block);
+            const int32 Last = FMath::Min((Block + 1) * BlockSize, Settings.BootstrapSamples);
+            for (int32 Sample = Block * BlockSize; Sample < Last; Sample++)
+            {
+                double SumA = 0.0;
+                for (int32 Index = 0; Index < CountA; Index++)
+                {
+                    SumA += A[RandomIndex(Stream, CountA)];
+                }
+                double SumB = 0.0;
+                for (int32 Index = 0; Index < CountB; Index++)
+                {
+                    SumB += B[RandomIndex(Stream, CountB)];
+                }
+                Differences[Sample] = SumA / CountA - SumB / CountB;
+            }
+        });
+
+        Differences.Sort();
+        const double Alpha = (1.0 - FMath::Clamp(Settings.ConfidenceLevel, 0.0, 1.0)) / 2.0;
+        Result.CiLow = Quantile(Differences, Alpha);
+        Result.CiHigh = Quantile(Differences, 1.0 - Alpha);
+    }
+    return Result;
+}
+
+double FGroupComparison::Mean(const TArray<double>& Values)
+{
+    double Sum = 0.0;
+    for (const double Value : Values)
+    {
+        Sum += Value;
+    }
+    return Values.Num() > 0 ? Sum / Values.Num() : 0.0;
+}
+
+double FGroupComparison::Median(TArray<double> Values)
+{
+    Values.Sort();
+    return Quantile(Values, 0.5);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GsrDecomposition.h"
+#include "LedalabSessionRecorder.h"
+
+struct FImportedTable;
+
+/** 重采样设置 */
+struct FResamplingSettings
+{
+    /** 置换检验和 bootstrap 的重采样次数（0 为不做）*/
+    int32 Permutations = 20000;
+    int32 BootstrapSamples = 20000;
+
+    /** 均值差置信区间的水平（双侧百分位区间）*/
+    double ConfidenceLevel = 0.95;
+
+    /** 随机种子：结果只由种子决定，与线程数无关 */
+    int32 Seed = 1;
+
+    /** 线程数，0 为逻辑核数 */
+    int32 NumThreads = 0;
+};
+
+/** 一个指标的两组比较，差值为 A − B */
+struct FMetricComparison
+{
+    FString Metric;
+
+    /** 每组的样本数、均值、标准差（n − 1）和中位数 */
+    int32 CountA = 0;
+    int32 CountB = 0;
+    double MeanA = 0.0;
+    double MeanB = 0.0;
+    double StdDevA = 0.0;
+    double StdDevB = 0.0;
+    double MedianA = 0.0;
+    double MedianB = 0.0;
+
+    /** 均值差和它的 bootstrap 百分位置信区间（两组分别有放回抽样）*/
+    double Difference = 0.0;
+    double CiLow = 0.0;
+    double CiHigh = 0.0;
+
+    /** Hedges g：均值差除以合并标准差，乘小样本校正 1 − 3 / (4 (nA + nB) − 9) */
+    double EffectSize = 0.0;
+
+    /** 双侧置换检验：(1 + |置换均值差| ≥ |观测均值差| 的次数) / (1 + 置换次数) */
+    double PValue = 1.0;
+
+    /** 两组都至少有 2 个值时才做检验，否则只有描述统计 */
+    bool bValid = false;
+};
+
+/** 分析一个被试（会话文件）的设置 */
+struct FParticipantSettings
+{
+    FGsrPreprocessSettings Preprocess;
+    FGsrDecompositionSettings Decomposition;
+
+    /** 计入的 SCR 最小幅度（µS）*/
+    double Threshold = 0.01;
+};
+
+/** 一个被试（会话文件）的 SCR 和反应时指标 */
+struct FParticipantMetrics
+{
+    FString Path;
+
+    bool bSucceeded = false;
+    FString Error;
+
+    double DurationMinutes = 0.0;
+
+    /** 幅度不低于阈值的 SCR */
+    TArray<double> ScrAmplitudes;
+    double ScrPerMinute = 0.0;
+    double ScrAmplitudeMean = 0.0;
+
+    /** 基线电导（分解的 tonic 成分）的均值，µS */
+    double TonicMean = 0.0;
+
+    /** 反应时（秒），没有试次标记时为空 */
+    TArray<double> ReactionTimes;
+    double ReactionTimeMean = 0.0;
+    double ReactionTimeMedian = 0.0;
+};
+
+/**
+ * 键盘组与手柄组的比较：逐个被试分解 GSR、配对试次标记得到 SCR 和反应时指标，
+ * 再对每个指标做置换检验和 bootstrap 置信区间
+ * 重采样按 BlockSize 分块，由线程池中的线程领取；每块的随机流由 (种子, 指标名, 检验, 块号) 决定，
+ * 置换检验每块只输出计数，bootstrap 每个样本写到固定的位置再排序，所以任意线程数下结果逐位相同
+ */
+class WORKVOILENCEGAME_API FGroupComparison
+{
+public:
+    /** 每块的重采样次数 */
+    static constexpr int32 BlockSize = 1024;
+
+    /** 读取（FSessionImporter）、预处理、分解并计算指标 */
+    static bool LoadParticipant(const FString& Path, const FParticipantSettings& Settings, FParticipantMetrics& OutMetrics);
+
+    /** 对已读取的数据（time / conductance 列和事件）预处理、分解并计算指标，OutMetrics.Path 不变 */
+    static bool AnalyzeParticipant(const FImportedTable& Table, const FParticipantSettings& Settings, FParticipantMetrics& OutMetrics);
+
+    /**
+     * 反应时：名称以 Response 开头的事件减去同一试次（TrialIndex）中名称以 Stimulus 开头的事件，
+     * 每个刺激只取第一个反应，没有对应刺激或时间不为正的反应忽略
+     */
+    static void ReactionTimes(const TArray<FLedalabEvent>& Events, TArray<double>& OutTimes);
+
+    /** 比较两组值 */
+    static FMetricComparison Compare(const FString& Metric, const TArray<double>& A, const TArray<double>& B, const FResamplingSettings& Settings);
+
+    static double Mean(const TArray<double>& Values);
+
+    static double Median(TArray<double> Values);
+};
@@ -0,0 +1,367 @@
+#include "GroupComparisonCommandlet.h"
+#include "GroupComparison.h"
+#include "ParallelWorkers.h"
+#include "SessionIndex.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    struct FParticipant
+    {
+        /** 0 为第一组，1 为第二组 */
+        int32 Group = 0;
+
+        FParticipantMetrics Metrics;
+    };
+
+    /** 一个比较的指标：两组的值，以及每个值来自哪个被试（Participants 的下标）*/
+    struct FMetricValues
+    {
+        FString Name;
+        TArray<double> Values[2];
+        TArray<int32> Sources[2];
+    };
+
+    /** 解析 "1,5" 这样的数值列表 */
+    TArray<double> ParseList(const FString& Text)
+    {
+        TArray<FString> Fields;
+        Text.ParseIntoArray(Fields, TEXT(","));
+        TArray<double> Values;
+        for (const FString& Field : Fields)
+        {
+            Values.Add(FCString::Atod(*Field));
+        }
+        return Values;
+    }
+
+    /** 标准化（均值 0、标准差 1），少于 2 个时不变 */
+    void ZScale(TArray<double>& InOut)
+    {
+        if (InOut.Num() < 2)
+        {
+            return;
+        }
+        const double Mean = FGroupComparison::Mean(InOut);
+        double Variance = 0.0;
+        for (const double Value : InOut)
+        {
+            Variance += FMath::Square(Value - Mean);
+        }
+        const double Deviation = FMath::Sqrt(Variance / (InOut.Num() - 1));
+        for (double& Value : InOut)
+        {
+            Value = Deviation > 0.0 ? (Value - Mean) / Deviation : 0.0;
+        }
+    }
+
+    /** 每个指标比较一次，返回耗时（秒）*/
+    double CompareAll(const TArray<FMetricValues>& Metrics, const FResamplingSettings& Settings, TArray<FMetricComparison>& OutResults)
+    {
+        const uint64 Start = FPlatformTime::Cycles64();
+        OutResults.Reset();
+        for (const FMetricValues& Metric : Metrics)
+        {
+            OutResults.Add(FGroupComparison::Compare(Metric.Name, Metric.Values[0], Metric.Values[1], Settings));
+        }
+        return FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start);
+    }
+
+    /** 重采样得到的各项是否逐位相同 */
+    bool IdenticalResults(const TArray<FMetricComparison>& A, const TArray<FMetricComparison>& B)
+    {
+        if (A.Num() != B.Num())
+        {
+            return false;
+        }
+        for (int32 Index = 0; Index < A.Num(); Index++)
+        {
+            if (A[Index].CiLow != B[Index].CiLow || A[Index].CiHigh != B[Index].CiHigh || A[Index].PValue != B[Index].PValue)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+UGroupComparisonCommandlet::UGroupComparisonCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UGroupComparisonCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Arguments;
+    TArray<FString> Switches;
+    ParseCommandLine(*Params, Arguments, Switches);
+
+    FParticipantSettings Settings;
+    FResamplingSettings Resampling;
+    FString OutputDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("GroupComparison"));
+    FString ListText;
+    Resampling.NumThreads = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+    FParse::Value(*Params, TEXT("Permutations="), Resampling.Permutations);
+    FParse::Value(*Params, TEXT("Bootstrap="), Resampling.BootstrapSamples);
+    FParse::Value(*Params, TEXT("Confidence="), Resampling.ConfidenceLevel);
+    FParse::Value(*Params, TEXT("Seed="), Resampling.Seed);
+    FParse::Value(*Params, TEXT("Threads="), Resampling.NumThreads);
+    FParse::Value(*Params, TEXT("Threshold="), Settings.Threshold);
+    FParse::Value(*Params, TEXT("Downsample="), Settings.Preprocess.DownsampleFactor);
+    FParse::Value(*Params, TEXT("Optimize="), Settings.Decomposition.OptimizeRounds);
+    const bool bZScale = FParse::Param(*Params, TEXT("ZScale"));
+    const bool bVerify = FParse::Param(*Params, TEXT("Verify"));
+    Resampling.NumThreads = FMath::Max(Resampling.NumThreads, 1);
+    Resampling.Permutations = FMath::Max(Resampling.Permutations, 0);
+    Resampling.BootstrapSamples = FMath::Max(Resampling.BootstrapSamples, 0);
+
+    if (FParse::Value(*Params, TEXT("Filter="), ListText, false))
+    {
+        const TArray<double> Values = ParseList(ListText);
+        Settings.Preprocess.FilterOrder = Values.Num() > 0 ? FMath::RoundToInt(Values[0]) : 0;
+        Settings.Preprocess.FilterCutoffHz = Values.Num() > 1 ? Values[1] : Settings.Preprocess.FilterCutoffHz;
+    }
+    if (FParse::Value(*Params, TEXT("Smooth="), ListText, false))
+    {
+        TArray<FString> Fields;
+        ListText.ParseIntoArray(Fields, TEXT(","));
+        Settings.Preprocess.SmoothType = Fields.Num() > 0 ? Fields[0].ToLower() : Settings.Preprocess.SmoothType;
+        Settings.Preprocess.SmoothWidth = Fields.Num() > 1 ? FCString::Atoi(*Fields[1]) : 0;
+    }
+    if (FParse::Value(*Params, TEXT("Tau="), ListText, false))
+    {
+        const TArray<double> Values = ParseList(ListText);
+        Settings.Decomposition.Tau1 = Values.Num() > 0 ? Values[0] : Settings.Decomposition.Tau1;
+        Settings.Decomposition.Tau2 = Values.Num() > 1 ? Values[1] : Settings.Decomposition.Tau2;
+    }
+
+    if (Arguments.Num() != 2)
+    {
+        UE_LOG(LogTemp, Error, TEXT("用法: -run=GroupComparison <目录、文件或 @条件> <目录、文件或 @条件> [-Index=<索引.tsv>] [-Names=keyboard,joystick] [-Output=<目录>] [-Permutations=20000] [-Bootstrap=20000] [-Confidence=0.95] [-Seed=1] [-Threads=<线程数>] [-Verify] [-Filter=1,5] [-Downsample=2] [-Smooth=gauss,8] [-Optimize=0] [-Tau=1,3.75] [-Threshold=0.01] [-ZScale]"));
+        return 1;
+    }
+
+    // 以 @ 开头的组从会话索引选取
+    FSessionIndex Index;
+    FString IndexPath = FSessionIndex::GetDefaultPath();
+    FString Error;
+    FParse::Value(*Params, TEXT("Index="), IndexPath);
+    if (Arguments.ContainsByPredicate([](const FString& Argument) { return Argument.StartsWith(TEXT("@")); })
+        && !Index.Load(IndexPath, Error))
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+        return 1;
+    }
+
+    // 组名默认取目录或文件名，索引查询取条件
+    FString GroupNames[2];
+    for (int32 Group = 0; Group < 2; Group++)
+    {
+        GroupNames[Group] = Arguments[Group].StartsWith(TEXT("@")) ? Arguments[Group].Mid(1) : FPaths::GetCleanFilename(Arguments[Group]);
+    }
+    if (FParse::Value(*Params, TEXT("Names="), ListText, false))
+    {
+        TArray<FString> Fields;
+        ListText.ParseIntoArray(Fields, TEXT(","));
+        for (int32 Group = 0; Group < FMath::Min(Fields.Num(), 2); Group++)
+        {
+            GroupNames[Group] = Fields[Group];
+        }
+    }
+
+    TArray<FParticipant> Participants;
+    for (int32 Group = 0; Group < 2; Group++)
+    {
+        TArray<FString> Paths;
+        if (!Index.SelectInputs(Arguments[Group], Paths, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+            return 1;
+        }
+        for (const FString& Path : Paths)
+        {
+            FParticipant& Participant = Participants.AddDefaulted_GetRef();
+            Participant.Group = Group;
+            Participant.Metrics.Path = Path;
+        }
+    }
+
+    // === 被试指标 ===
+
+    const uint64 LoadStart = FPlatformTime::Cycles64();
+    FParallelWorkers::ForEach(Participants.Num(), Resampling.NumThreads, TEXT("GroupComparison"), [&Participants, &Settings](int32 Index)
+    {
+        FParticipantMetrics& Metrics = Participants[Index].Metrics;
+        const FString Path = Metrics.Path;
+        FGroupComparison::LoadParticipant(Path, Settings, Metrics);
+    });
+    UE_LOG(LogTemp, Display, TEXT("%d 个被试，分解用时 %.3f s"), Participants.Num(), FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - LoadStart));
+
+    int32 Failures = 0;
+    int32 Succeeded[2] = { 0, 0 };
+    for (const FParticipant& Participant : Participants)
+    {
+        const FParticipantMetrics& Metrics = Participant.Metrics;
+        if (!Metrics.bSucceeded)
+        {
+            UE_LOG(LogTemp, Error, TEXT("  %s: %s"), *Metrics.Path, *Metrics.Error);
+            Failures++;
+            continue;
+        }
+        Succeeded[Participant.Group]++;
+        UE_LOG(LogTemp, Display, TEXT("  [%s] %s：%.1f min，SCR %d 个（%.2f/min，平均 %.3f µS），SCL %.3f µS，反应 %d 次（平均 %.3f s）"),
+            *GroupNames[Participant.Group], *FPaths::GetCleanFilename(Metrics.Path), Metrics.DurationMinutes,
+            Metrics.ScrAmplitudes.Num(), Metrics.ScrPerMinute, Metrics.ScrAmplitudeMean, Metrics.TonicMean,
+            Metrics.ReactionTimes.Num(), Metrics.ReactionTimeMean);
+    }
+    if (Succeeded[0] == 0 || Succeeded[1] == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("每组至少需要一个可以分析的被试"));
+        return 1;
+    }
+
+    TArray<FMetricValues> Metrics;
+    const auto AddParticipantMetric = [&Metrics, &Participants](const TCHAR* Name, bool bNeedsTrials, double FParticipantMetrics::* Field)
+    {
+        FMetricValues& Metric = Metrics.AddDefaulted_GetRef();
+        Metric.Name = Name;
+        for (int32 Index = 0; Index < Participants.Num(); Index++)
+        {
+            const FParticipant& Participant = Participants[Index];
+            if (Participant.Metrics.bSucceeded && (!bNeedsTrials || Participant.Metrics.ReactionTimes.Num() > 0))
+            {
+                Metric.Values[Participant.Group].Add(Participant.Metrics.*Field);
+                Metric.Sources[Participant.Group].Add(Index);
+            }
+        }
+    };
+    const auto AddPooledMetric = [&Metrics, &Participants](const TCHAR* Name, bool bScale, TArray<double> FParticipantMetrics::* Field)
+    {
+        FMetricValues& Metric = Metrics.AddDefaulted_GetRef();
+        Metric.Name = Name;
+        for (int32 Index = 0; Index < Participants.Num(); Index++)
+        {
+            const FParticipant& Participant = Participants[Index];
+            if (!Participant.Metrics.bSucceeded)
+            {
+                continue;
+            }
+            TArray<double> Values = Participant.Metrics.*Field;
+            if (bScale)
+            {
+                ZScale(Values);
+            }
+            Metric.Values[Participant.Group].Append(Values);
+            for (int32 Value = 0; Value < Values.Num(); Value++)
+            {
+                Metric.Sources[Participant.Group].Add(Index);
+            }
+        }
+    };
+    AddParticipantMetric(TEXT("scr_per_min"), false, &FParticipantMetrics::ScrPerMinute);
+    AddParticipantMetric(TEXT("scr_amp_mean"), false, &FParticipantMetrics::ScrAmplitudeMean);
+    AddParticipantMetric(TEXT("scl_mean"), false, &FParticipantMetrics::TonicMean);
+    AddParticipantMetric(TEXT("rt_mean"), true, &FParticipantMetrics::ReactionTimeMean);
+    AddParticipantMetric(TEXT("rt_median"), true, &FParticipantMetrics::ReactionTimeMedian);
+    AddPooledMetric(bZScale ? TEXT("scr_amp_z") : TEXT("scr_amp"), bZScale, &FParticipantMetrics::ScrAmplitudes);
+    AddPooledMetric(TEXT("rt"), false, &FParticipantMetrics::ReactionTimes);
+
+    // === 重采样 ===
+
+    TArray<FMetricComparison> Results;
+    const double Seconds = CompareAll(Metrics, Resampling, Results);
+    UE_LOG(LogTemp, Display, TEXT("%s − %s：置换 %d 次，bootstrap %d 次，种子 %d，%d 线程，用时 %.3f s"),
+        *GroupNames[0], *GroupNames[1], Resampling.Permutations, Resampling.BootstrapSamples, Resampling.Seed, Resampling.NumThreads, Seconds);
+    for (const FMetricComparison& Result : Results)
+    {
+        if (!Result.bValid)
+        {
+            UE_LOG(LogTemp, Display, TEXT("  %-14s n = %d / %d，样本不足，不做检验"), *Result.Metric, Result.CountA, Result.CountB);
+            continue;
+        }
+        UE_LOG(LogTemp, Display, TEXT("  %-14s n = %d / %d，均值 %.4g / %.4g，差 %.4g [%.4g, %.4g]，g = %.3f，p = %.4f"),
+            *Result.Metric, Result.CountA, Result.CountB, Result.MeanA, Result.MeanB, Result.Difference,
+            Result.CiLow, Result.CiHigh, Result.EffectSize, Result.PValue);
+    }
+
+    if (bVerify)
+    {
+        FResamplingSettings SingleThreaded = Resampling;
+        SingleThreaded.NumThreads = 1;
+        TArray<FMetricComparison> Reference;
+        const double SingleThreadSeconds = CompareAll(Metrics, SingleThreaded, Reference);
+        const bool bIdentical = IdenticalResults(Results, Reference);
+        UE_LOG(LogTemp, Display, TEXT("单线程重算：%.3f s（%d 线程加速 %.2f 倍），结果%s"),
+            SingleThreadSeconds, Resampling.NumThreads, Seconds > 0.0 ? SingleThreadSeconds / Seconds : 0.0,
+            bIdentical ? TEXT("逐位相同") : TEXT("不同"));
+        if (!bIdentical)
+        {
+            Failures++;
+        }
+    }
+
+    // === 结果 ===
+
+    FString ParticipantsText = TEXT("group\tfile\tduration_min\tscr_count\tscr_per_min\tscr_amp_mean\tscl_mean\ttrials\trt_mean\trt_median\n");
+    for (const FParticipant& Participant : Participants)
+    {
+        const FParticipantMetrics& Metric = Participant.Metrics;
+        if (Metric.bSucceeded)
+        {
+            ParticipantsText += FString::Printf(TEXT("%s\t%s\t%.6g\t%d\t%.6g\t%.6g\t%.6g\t%d\t%.6g\t%.6g\n"),
+                *GroupNames[Participant.Group], *FPaths::GetCleanFilename(Metric.Path), Metric.DurationMinutes,
+                Metric.ScrAmplitudes.Num(), Metric.ScrPerMinute, Metric.ScrAmplitudeMean, Metric.TonicMean,
+                Metric.ReactionTimes.Num(), Metric.ReactionTimeMean, Metric.ReactionTimeMedian);
+        }
+    }
+
+    FString ValuesText = TEXT("metric\tgroup\tfile\tvalue\n");
+    for (const FMetricValues& Metric : Metrics)
+    {
+        for (int32 Group = 0; Group < 2; Group++)
+        {
+            for (int32 Index = 0; Index < Metric.Values[Group].Num(); Index++)
+            {
+                ValuesText += FString::Printf(TEXT("%s\t%s\t%s\t%.6g\n"), *Metric.Name, *GroupNames[Group],
+                    *FPaths::GetCleanFilename(Participants[Metric.Sources[Group][Index]].Metrics.Path), Metric.Values[Group][Index]);
+            }
+        }
+    }
+
+    FString ComparisonText = TEXT("metric\tgroup_a\tgroup_b\tn_a\tn_b\tmean_a\tmean_b\tsd_a\tsd_b\tmedian_a\tmedian_b\tdiff\tci_low\tci_high\thedges_g\tp_perm\n");
+    for (const FMetricComparison& Result : Results)
+    {
+        ComparisonText += FString::Printf(TEXT("%s\t%s\t%s\t%d\t%d\t%.6g\t%.6g\t%.6g\t%.6g\t%.6g\t%.6g\t%.6g\t%.6g\t%.6g\t%.6g\t%.6g\n"),
+            *Result.Metric, *GroupNames[0], *GroupNames[1], Result.CountA, Result.CountB, Result.MeanA, Result.MeanB,
+            Result.StdDevA, Result.StdDevB, Result.MedianA, Result.MedianB, Result.Difference,
+            Result.CiLow, Result.CiHigh, Result.EffectSize, Result.PValue);
+    }
+
+    IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+    const auto SaveTable = [&OutputDirectory](const TCHAR* Name, const FString& Text)
+    {
+        const FString Path = FPaths::Combine(OutputDirectory, Name);
+        if (!FFileHelper::SaveStringToFile(Text, *Path))
+        {
+            UE_LOG(LogTemp, Error, TEXT("无法写入 %s"), *Path);
+            return false;
+        }
+        return true;
+    };
+    if (!SaveTable(TEXT("participants.tsv"), ParticipantsText) || !SaveTable(TEXT("values.tsv"), ValuesText)
+        || !SaveTable(TEXT("comparison.tsv"), ComparisonText))
+    {
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("已写出 %s"), *OutputDirectory);
+    return Failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GroupComparisonCommandlet.generated.h"
+
+/**
+ * 键盘组与手柄组的比较：两个位置参数各是一组（目录中的 .wvsession / .mat / .txt、单个文件，
+ * 或 @<条件> 从 -Index 会话索引中选取，见 FSessionIndex），
+ * 每个文件作为一个被试，分解 GSR 并由试次标记计算反应时（FGroupComparison），再比较两组：
+ * - 被试水平：scr_per_min、scr_amp_mean、scl_mean、rt_mean、rt_median（每个被试一个值）
+ * - 合并水平：scr_amp（所有 SCR 幅度，-ZScale 时每个被试分别标准化）、rt（所有试次的反应时）
+ * 每个指标报告均值差（第一组 − 第二组）、bootstrap 置信区间、Hedges g 和置换检验 p 值
+ * 结果写到 -Output 目录（默认 Saved/GroupComparison），都是带表头的制表符分隔文本，可以直接作图：
+ * participants.tsv（每个被试一行）、values.tsv（长格式：指标、组、被试、值）、comparison.tsv（每个指标一行）
+ * 重采样的结果只由 -Seed 决定；-Verify 再用单线程重算一遍，检查结果逐位相同并报告两次的耗时
+ * 预处理和分解选项与 GsrBatchAnalysis 相同
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=GroupComparison <目录、文件或 @条件> <目录、文件或 @条件>
+ *       [-Index=<索引.tsv>] [-Names=keyboard,joystick]
+ *       [-Output=<目录>] [-Permutations=20000] [-Bootstrap=20000] [-Confidence=0.95] [-Seed=1] [-Threads=<线程数>] [-Verify]
+ *       [-Filter=1,5] [-Downsample=2] [-Smooth=gauss,8] [-Optimize=0] [-Tau=1,3.75] [-Threshold=0.01] [-ZScale]
+ * 例如 Experiment/keyboardGroup Experiment/joystickgroup -Names=keyboard,joystick，或 @condition=keyboard @condition=joystick
+ */
+UCLASS()
+class WORKVOILENCEGAME_API UGroupComparisonCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGroupComparisonCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,539 @@
+#include "GsrBatchAnalysisCommandlet.h"
+#include "GsrDecomposition.h"
+#include "SessionImporter.h"
+#include "SessionIndex.h"
+#include "MatFileReader.h"
+#include "MatFileWriter.h"
+#include "ParallelWorkers.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    /** 一个文件的处理结果 */
+    struct FFileResult
+    {
+        FString Path;
+        int32 Group = 0;
+        int64 Bytes = 0;
+
+        bool bSucceeded = false;
+        FString Error;
+
+        /** 预处理后的采样数和采样率 */
+        int32 Samples = 0;
+        double SampleRateHz = 0.0;
+
+        double Tau1 = 0.0;
+        double Tau2 = 0.0;
+
+        /** 分解的优化准则（FGsrDecompositionResult::Error）*/
+        double Criterion = 0.0;
+        double Discreteness = 0.0;
+        double Negativity = 0.0;
+
+        /** 幅度不低于阈值的 SCR */
+        TArray<FGsrDecomposedScr> Scrs;
+
+        /** 读取 + 预处理 + 分解的耗时 */
+        double Seconds = 0.0;
+    };
+
+    struct FBatchSettings
+    {
+        FGsrPreprocessSettings Preprocess;
+        FGsrDecompositionSettings Decomposition;
+        double Threshold = 0.01;
+    };
+
+    /**
+     * 工作窃取调度：任务按给定顺序（文件从大到小）轮流分到各线程的队列，线程从自己队列的头部取，
+     * 取完后从其他线程队列的尾部（剩下最小的任务）窃取；每个任务是一个完整的文件，队列用锁保护即可
+     * 线程由 FParallelWorkers 创建，当前线程也是其中之一
+     */
+    class FWorkStealingPool
+    {
+    public:
+        FWorkStealingPool(int32 InNumThreads, TFunction<void(int32)> InTask)
+            : NumThreads(FMath::Max(InNumThreads, 1))
+            , Task(MoveTemp(InTask))
+        {
+        }
+
+        /** 执行全部任务并等待结束，返回被窃取的任务数 */
+        int32 Run(const TArray<int32>& Jobs)
+        {
+            Queues.Reset();
+            for (int32 Index = 0; Index < NumThreads; Index++)
+            {
+                Queues.Add(MakeUnique<FQueue>());
+            }
+            for (int32 Index = 0; Index < Jobs.Num(); Index++)
+            {
+                Queues[Index % NumThreads]->Jobs.Add(Jobs[Index]);
+            }
+            Stolen = 0;
+
+            FParallelWorkers::Run(NumThreads, TEXT("GsrBatchAnalysis"), [this](int32 Worker)
+            {
+                int32 Job = INDEX_NONE;
+                while (Take(Worker, Job))
+                {
+                    Task(Job);
+                }
+            });
+            return Stolen;
+        }
+
+    private:
+        struct FQueue
+        {
+            FCriticalSection Lock;
+            TArray<int32> Jobs;
+            int32 Head = 0;
+        };
+
+        bool Take(int32 Worker, int32& OutJob)
+        {
+            {
+                FQueue& Own = *Queues[Worker];
+                FScopeLock Lock(&Own.Lock);
+                if (Own.Head < Own.Jobs.Num())
+                {
+                    OutJob = Own.Jobs[Own.Head++];
+                    return true;
+                }
+            }
+            for (int32 Offset = 1; Offset < NumThreads; Offset++)
+            {
+                FQueue& Victim = *Queues[(Worker + Offset) % NumThreads];
+                FScopeLock Lock(&Victim.Lock);
+                if (Victim.Head < Victim.Jobs.Num())
+                {
+                    OutJob = Victim.Jobs.Pop();
+                    Stolen++;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        const int32 NumThreads;
+        TFunction<void(int32)> Task;
+        TArray<TUniquePtr<FQueue>> Queues;
+        TAtomic<int32> Stolen { 0 };
+    };
+
+    /** 由 FSessionImporter 读取 time / conductance 列（会话记录取 Gsr 通道的共享时钟时间）*/
+    bool LoadConductance(const FString& Path, TArray<double>& OutTime, TArray<double>& OutConductance, FString& OutError)
+    {
+        FImportedTable Table;
+        if (!FSessionImporter::Load(Path, Table, OutError))
+        {
+            return false;
+        }
+        const TArray<double>* Times = Table.FindColumn(TEXT("time"));
+        const TArray<double>* Conductance = Table.FindColumn(TEXT("conductance"));
+        OutTime = Times ? *Times : TArray<double>();
+        OutConductance = Conductance ? *Conductance : TArray<double>();
+
+        if (OutConductance.Num() == 0)
+        {
+            OutError = TEXT("没有电导数据");
+            return false;
+        }
+        return true;
+    }
+
+    void ProcessFile(const FBatchSettings& Settings, FFileResult& Result)
+    {
+        const uint64 Start = FPlatformTime::Cycles64();
+        Result.bSucceeded = false;
+        Result.Scrs.Reset();
+
+        TArray<double> Time;
+        TArray<double> Conductance;
+        FGsrDecompositionResult Decomposition;
+        if (LoadConductance(Result.Path, Time, Conductance, Result.Error)
+            && FGsrDecomposition::Preprocess(Settings.Preprocess, Time, Conductance, Result.Error)
+            && FGsrDecomposition::Decompose(Time, Conductance, Settings.Decomposition, Decomposition, Result.Error))
+        {
+            Result.bSucceeded = true;
+            Result.Samples = Conductance.Num();
+            Result.SampleRateHz = Decomposition.SampleRateHz;
+            Result.Tau1 = Decomposition.Tau1;
+            Result.Tau2 = Decomposition.Tau2;
+            Result.Criterion = Decomposition.Error;
+            Result.Discreteness = Decomposition.Discreteness;
+            Result.Negativity = Decomposition.Negativity;
+            for (const FGsrDecomposedScr& Scr : Decomposition.Scrs)
+            {
+                if (Scr.Amplitude >= Settings.Threshold)
+                {
+                    Result.Scrs.Add(Scr);
+                }
+            }
+        }
+        Result.Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start);
+    }
+
+    /** 解析 "1,5" 这样的数值列表 */
+    TArray<double> ParseList(const FString& Text)
+    {
+        TArray<FString> Fields;
+        Text.ParseIntoArray(Fields, TEXT(","));
+        TArray<double> Values;
+        for (const FString& Field : Fields)
+        {
+            Values.Add(FCString::Atod(*Field));
+        }
+        return Values;
+    }
+
+    double Correlation(const TArray<double>& A, const TArray<double>& B)
+    {
+        const int32 Count = A.Num();
+        if (Count < 2)
+        {
+            return 0.0;
+        }
+
+        double MeanA = 0.0, MeanB = 0.0;
+        for (int32 Index = 0; Index < Count; Index++)
+        {
+            MeanA += A[Index];
+            MeanB += B[Index];
+        }
+        MeanA /= Count;
+        MeanB /= Count;
+
+        double Covariance = 0.0, VarianceA = 0.0, VarianceB = 0.0;
+        for (int32 Index = 0; Index < Count; Index++)
+        {
+            Covariance += (A[Index] - MeanA) * (B[Index] - MeanB);
+            VarianceA += FMath::Square(A[Index] - MeanA);
+            VarianceB += FMath::Square(B[Index] - MeanB);
+        }
+        return VarianceA > 0.0 && VarianceB > 0.0 ? Covariance / FMath::Sqrt(VarianceA * VarianceB) : 0.0;
+    }
+
+    /** 幅度标准化（均值 0、标准差 1），少于 2 个时不变 */
+    void ZScale(TArray<double>& InOut)
+    {
+        if (InOut.Num() < 2)
+        {
+            return;
+        }
+        double Mean = 0.0;
+        for (const double Value : InOut)
+        {
+            Mean += Value;
+        }
+        Mean /= InOut.Num();
+        double Variance = 0.0;
+        for (const double Value : InOut)
+        {
+            Variance += FMath::Square(Value - Mean);
+        }
+        const double Deviation = FMath::Sqrt(Variance / (InOut.Num() - 1));
+        for (double& Value : InOut)
+        {
+            Value = Deviation > 0.0 ? (Value - Mean) / Deviation : 0.0;
+        }
+    }
+
+    /**
+     * 与参考的一组 SCR 比较：两边按起始时间排序后贪心匹配，每个参考 SCR 取容差内最近的、尚未使用的结果，
+     * 报告精确率、召回率、平均起始误差和命中对的幅度相关（相关系数不受标准化影响）
+     */
+    void CompareGroup(int32 Group, const TArray<double>& ReferenceOnsets, const TArray<double>& ReferenceAmplitudes,
+        const TArray<double>& Onsets, const TArray<double>& Amplitudes, double Tolerance)
+    {
+        const auto SortedOrder = [](const TArray<double>& Times)
+        {
+            TArray<int32> Order;
+            for (int32 Index = 0; Index < Times.Num(); Index++)
+            {
+                Order.Add(Index);
+            }
+            Order.Sort([&Times](int32 A, int32 B) { return Times[A] < Times[B]; });
+            return Order;
+        };
+        const TArray<int32> ReferenceOrder = SortedOrder(ReferenceOnsets);
+        const TArray<int32> Order = SortedOrder(Onsets);
+
+        TArray<bool> Used;
+        Used.SetNumZeroed(Order.Num());
+        TArray<double> MatchedReference;
+        TArray<double> Matched;
+        double ErrorSum = 0.0;
+        int32 First = 0;
+        for (const int32 Reference : ReferenceOrder)
+        {
+            const double Onset = ReferenceOnsets[Reference];
+            while (First < Order.Num() && Onsets[Order[First]] < Onset - Tolerance)
+            {
+                First++;
+            }
+
+            int32 Best = INDEX_NONE;
+            double BestError = Tolerance;
+            for (int32 Index = First; Index < Order.Num() && Onsets[Order[Index]] <= Onset + Tolerance; Index++)
+            {
+                const double Error = FMath::Abs(Onsets[Order[Index]] - Onset);
+                if (!Used[Index] && Error <= BestError)
+                {
+                    Best = Index;
+                    BestError = Error;
+                }
+            }
+            if (Best != INDEX_NONE)
+            {
+                Used[Best] = true;
+                ErrorSum += BestError;
+                MatchedReference.Add(ReferenceAmplitudes.IsValidIndex(Reference) ? ReferenceAmplitudes[Reference] : 0.0);
+                Matched.Add(Amplitudes[Order[Best]]);
+            }
+        }
+
+        const int32 Hits = Matched.Num();
+        UE_LOG(LogTemp, Display, TEXT("  组 %d：参考=%d 结果=%d 命中=%d 精确率=%.2f 召回率=%.2f 起始误差=%.3fs 幅度相关=%.2f"),
+            Group, ReferenceOnsets.Num(), Onsets.Num(), Hits,
+            Onsets.Num() > 0 ? static_cast<double>(Hits) / Onsets.Num() : 0.0,
+            ReferenceOnsets.Num() > 0 ? static_cast<double>(Hits) / ReferenceOnsets.Num() : 0.0,
+            Hits > 0 ? ErrorSum / Hits : 0.0, Correlation(MatchedReference, Matched));
+    }
+}
+
+UGsrBatchAnalysisCommandlet::UGsrBatchAnalysisCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UGsrBatchAnalysisCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Arguments;
+    TArray<FString> Switches;
+    ParseCommandLine(*Params, Arguments, Switches);
+
+    FBatchSettings Settings;
+    FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("GsrBatchAnalysis.mat"));
+    FString ComparePath;
+    FString ListText;
+    double Tolerance = 0.5;
+    int32 MaxThreads = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+    FParse::Value(*Params, TEXT("Compare="), ComparePath);
+    FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+    FParse::Value(*Params, TEXT("Threshold="), Settings.Threshold);
+    FParse::Value(*Params, TEXT("Threads="), MaxThreads);
+    FParse::Value(*Params, TEXT("Downsample="), Settings.Preprocess.DownsampleFactor);
+    FParse::Value(*Params, TEXT("Optimize="), Settings.Decomposition.OptimizeRounds);
+    const bool bZScale = FParse::Param(*Params, TEXT("ZScale"));
+    const bool bScaling = FParse::Param(*Params, TEXT("Scaling"));
+    MaxThreads = FMath::Max(MaxThreads, 1);
+
+    if (FParse::Value(*Params, TEXT("Filter="), ListText, false))
+    {
+        const TArray<double> Values = ParseList(ListText);
+        Settings.Preprocess.FilterOrder = Values.Num() > 0 ? FMath::RoundToInt(Values[0]) : 0;
+        Settings.Preprocess.FilterCutoffHz = Values.Num() > 1 ? Values[1] : Settings.Preprocess.FilterCutoffHz;
+    }
+    if (FParse::Value(*Params, TEXT("Smooth="), ListText, false))
+    {
+        TArray<FString> Fields;
+        ListText.ParseIntoArray(Fields, TEXT(","));
+        Settings.Preprocess.SmoothType = Fields.Num() > 0 ? Fields[0].ToLower() : Settings.Preprocess.SmoothType;
+        Settings.Preprocess.SmoothWidth = Fields.Num() > 1 ? FCString::Atoi(*Fields[1]) : 0;
+    }
+    if (FParse::Value(*Params, TEXT("Tau="), ListText, false))
+    {
+        const TArray<double> Values = ParseList(ListText);
+        Settings.Decomposition.Tau1 = Values.Num() > 0 ? Values[0] : Settings.Decomposition.Tau1;
+        Settings.Decomposition.Tau2 = Values.Num() > 1 ? Values[1] : Settings.Decomposition.Tau2;
+    }
+
+    if (Arguments.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("用法: -run=GsrBatchAnalysis <目录、文件或 @条件> [...] [-Index=<索引.tsv>] [-Output=<文件.mat>] [-Filter=1,5] [-Downsample=2] [-Smooth=gauss,8] [-Optimize=0] [-Tau=1,3.75] [-Threshold=0.01] [-ZScale] [-Threads=<线程数>] [-Scaling] [-Compare=<参考.mat>] [-Tolerance=0.5]"));
+        return 1;
+    }
+
+    // 以 @ 开头的组从会话索引选取
+    FSessionIndex Index;
+    FString IndexPath = FSessionIndex::GetDefaultPath();
+    FString Error;
+    FParse::Value(*Params, TEXT("Index="), IndexPath);
+    if (Arguments.ContainsByPredicate([](const FString& Argument) { return Argument.StartsWith(TEXT("@")); })
+        && !Index.Load(IndexPath, Error))
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+        return 1;
+    }
+
+    int32 Failures = 0;
+    TArray<FFileResult> Results;
+    for (int32 Group = 0; Group < Arguments.Num(); Group++)
+    {
+        TArray<FString> Paths;
+        if (!Index.SelectInputs(Arguments[Group], Paths, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+            Failures++;
+            continue;
+        }
+        for (const FString& Path : Paths)
+        {
+            FFileResult& Result = Results.AddDefaulted_GetRef();
+            Result.Path = Path;
+            Result.Group = Group + 1;
+            Result.Bytes = IFileManager::Get().FileSize(*Path);
+        }
+    }
+    if (Results.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("没有可处理的文件"));
+        return 1;
+    }
+
+    // 大文件先处理，轮流分配后各线程的负载接近，剩下的小文件留给窃取
+    TArray<int32> Jobs;
+    for (int32 Index = 0; Index < Results.Num(); Index++)
+    {
+        Jobs.Add(Index);
+    }
+    Jobs.Sort([&Results](int32 A, int32 B) { return Results[A].Bytes > Results[B].Bytes; });
+
+    TArray<int32> ThreadCounts;
+    for (int32 Threads = 1; bScaling && Threads < MaxThreads; Threads *= 2)
+    {
+        ThreadCounts.Add(Threads);
+    }
+    ThreadCounts.Add(MaxThreads);
+
+    UE_LOG(LogTemp, Display, TEXT("%d 组，%d 个文件，%d 个逻辑核"), Arguments.Num(), Results.Num(), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+    double SingleThreadSeconds = 0.0;
+    for (const int32 Threads : ThreadCounts)
+    {
+        FWorkStealingPool Pool(Threads, [&Settings, &Results](int32 Job)
+        {
+            ProcessFile(Settings, Results[Job]);
+        });
+        const uint64 Start = FPlatformTime::Cycles64();
+        const int32 Stolen = Pool.Run(Jobs);
+        const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start);
+
+        double WorkSeconds = 0.0;
+        for (const FFileResult& Result : Results)
+        {
+            WorkSeconds += Result.Seconds;
+        }
+        SingleThreadSeconds = Threads == 1 ? Seconds : SingleThreadSeconds;
+        const double Speedup = SingleThreadSeconds > 0.0 && Seconds > 0.0 ? SingleThreadSeconds / Seconds : 0.0;
+        UE_LOG(LogTemp, Display, TEXT("  %2d 线程：%.3f s（各文件合计 %.3f s），窃取 %d 个文件%s"),
+            Threads, Seconds, WorkSeconds, Stolen,
+            Speedup > 0.0 ? *FString::Printf(TEXT("，加速 %.2f 倍，效率 %.0f%%"), Speedup, 100.0 * Speedup / Threads) : TEXT(""));
+    }
+
+    // === 结果 ===
+
+    TArray<FMatVariable> Variables;
+    TArray<FMatVariable> FileElements;
+    const TArray<FString> FileFields = { TEXT("name"), TEXT("group"), TEXT("samplingrate"), TEXT("tau"), TEXT("error"),
+        TEXT("discreteness"), TEXT("negativity"), TEXT("onset"), TEXT("amp"), TEXT("peaktime") };
+    TArray<TArray<double>> GroupOnsets;
+    TArray<TArray<double>> GroupAmplitudes;
+    GroupOnsets.SetNum(Arguments.Num());
+    GroupAmplitudes.SetNum(Arguments.Num());
+    TArray<TArray<FMatVariable>> GroupFiles;
+    GroupFiles.SetNum(Arguments.Num());
+    for (const FFileResult& Result : Results)
+    {
+        if (!Result.bSucceeded)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: %s"), *Result.Path, *Result.Error);
+            Failures++;
+            continue;
+        }
+
+        TArray<double> Onsets;
+        TArray<double> Amplitudes;
+        TArray<double> PeakTimes;
+        for (const FGsrDecomposedScr& Scr : Result.Scrs)
+        {
+            Onsets.Add(Scr.Onset);
+            Amplitudes.Add(Scr.Amplitude);
+            PeakTimes.Add(Scr.PeakTime);
+        }
+        if (bZScale)
+        {
+            ZScale(Amplitudes);
+        }
+        UE_LOG(LogTemp, Display, TEXT("组 %d %s：%d 个采样（%.2f Hz），tau=(%.3f, %.3f)，误差 %.4f（离散度 %.4f，负值 %.4f），%d 个 SCR，%.1f ms"),
+            Result.Group, *FPaths::GetCleanFilename(Result.Path), Result.Samples, Result.SampleRateHz, Result.Tau1, Result.Tau2,
+            Result.Criterion, Result.Discreteness, Result.Negativity, Onsets.Num(), Result.Seconds * 1000.0);
+
+        GroupOnsets[Result.Group - 1].Append(Onsets);
+        GroupAmplitudes[Result.Group - 1].Append(Amplitudes);
+        GroupFiles[Result.Group - 1].Add(FMatFileWriter::MakeText(FString(), FPaths::GetCleanFilename(Result.Path)));
+
+        FileElements.Add(FMatFileWriter::MakeText(FString(), FPaths::GetCleanFilename(Result.Path)));
+        FileElements.Add(FMatFileWriter::MakeScalar(FString(), Result.Group));
+        FileElements.Add(FMatFileWriter::MakeScalar(FString(), Result.SampleRateHz));
+        FileElements.Add(FMatFileWriter::MakeNumbers(FString(), { Result.Tau1, Result.Tau2 }));
+        FileElements.Add(FMatFileWriter::MakeScalar(FString(), Result.Criterion));
+        FileElements.Add(FMatFileWriter::MakeScalar(FString(), Result.Discreteness));
+        FileElements.Add(FMatFileWriter::MakeScalar(FString(), Result.Negativity));
+        FileElements.Add(FMatFileWriter::MakeNumbers(FString(), Onsets));
+        FileElements.Add(FMatFileWriter::MakeNumbers(FString(), Amplitudes));
+        FileElements.Add(FMatFileWriter::MakeNumbers(FString(), PeakTimes));
+    }
+
+    for (int32 Group = 0; Group < Arguments.Num(); Group++)
+    {
+        Variables.Add(FMatFileWriter::MakeNumbers(FString::Printf(TEXT("group%d_onset_all"), Group + 1), GroupOnsets[Group]));
+        Variables.Add(FMatFileWriter::MakeNumbers(FString::Printf(TEXT("group%d_amp_all"), Group + 1), GroupAmplitudes[Group]));
+        Variables.Add(FMatFileWriter::MakeCell(FString::Printf(TEXT("group%d_files"), Group + 1), GroupFiles[Group]));
+    }
+    Variables.Add(FMatFileWriter::MakeStruct(TEXT("files"), FileFields, FileElements));
+    Variables.Add(FMatFileWriter::MakeText(TEXT("command"), Params));
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(OutputPath), true);
+    if (!FMatFileWriter::Save(OutputPath, Variables, Error))
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s: %s"), *OutputPath, *Error);
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("已写出 %s"), *OutputPath);
+
+    if (!ComparePath.IsEmpty())
+    {
+        TArray<FMatVariable> Reference;
+        if (!FMatFileReader::Load(ComparePath, Reference, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: %s"), *ComparePath, *Error);
+            return 1;
+        }
+        UE_LOG(LogTemp, Display, TEXT("与 %s 比较（容差 %.2f s）："), *ComparePath, Tolerance);
+        for (int32 Group = 0; Group < Arguments.Num(); Group++)
+        {
+            const TArray<double>* Onsets = FMatFileReader::FindNumbers(Reference, FString::Printf(TEXT("group%d_onset_all"), Group + 1));
+            const TArray<double>* Amplitudes = FMatFileReader::FindNumbers(Reference, FString::Printf(TEXT("group%d_amp_all"), Group + 1));
+            if (!Onsets || !Amplitudes)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("  参考中没有组 %d"), Group + 1);
+                continue;
+            }
+            CompareGroup(Group + 1, *Onsets, *Amplitudes, GroupOnsets[Group], GroupAmplitudes[Group], Tolerance);
+        }
+    }
+    return Failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GsrBatchAnalysisCommandlet.generated.h"
+
+/**
+ * 批量 GSR 分解，替代 result/leda_batchanalysis.m：对一批会话做预处理（-Filter、-Downsample、-Smooth，写法与
+ * leda_batchanalysis 相同，按这个顺序执行）和 CDA 分解（FGsrDecomposition），导出 SCR 列表
+ * 每个位置参数是一组：目录（其中的 .wvsession / .mat / .txt，跳过 Ledalab 导出的 *_scrlist.mat）、单个文件，
+ * 或 @<条件>（从 -Index 会话索引中选取，默认 Saved/Sessions/SessionIndex.tsv，见 FSessionIndex），组号按参数顺序从 1 开始
+ * 文件由工作窃取线程池并行处理：按文件大小从大到小轮流分给各线程，线程做完自己的文件后从其他线程的队列尾部窃取
+ * 结果写到 -Output（默认 Saved/GsrBatchAnalysis.mat）：group<k>_onset_all / group<k>_amp_all（与
+ * result/SCR_Txt_Comparison_Result.mat 相同，幅度不低于 -Threshold，-ZScale 时每个文件的幅度分别标准化）、
+ * group<k>_files，以及每个文件的 tau、误差和完整 SCR 列表（files 结构体数组）
+ * -Compare=<参考.mat>：按组与参考中的 group<k>_onset_all / group<k>_amp_all 比较（起始时间容差 -Tolerance 秒）
+ * -Scaling：依次用 1、2、4…… 个线程（直到 -Threads，默认为逻辑核数）处理整批文件，报告耗时和加速比
+ * 只支持 CDA，leda_batchanalysis 的 DDA（nndeco）、adapt 平滑和 ERA 导出不在这里做
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=GsrBatchAnalysis <目录、文件或 @条件> [...] [-Index=<索引.tsv>] [-Output=<文件.mat>]
+ *       [-Filter=1,5] [-Downsample=2] [-Smooth=gauss,8] [-Optimize=0] [-Tau=1,3.75] [-Threshold=0.01] [-ZScale]
+ *       [-Threads=<线程数>] [-Scaling] [-Compare=<参考.mat>] [-Tolerance=0.5]
+ * 例如 Experiment/keyboardGroup Experiment/joystickgroup -Compare=result/SCR_Txt_Comparison_Result.mat
+ */
+UCLASS()
+class WORKVOILENCEGAME_API UGsrBatchAnalysisCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGsrBatchAnalysisCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,132 @@
+#include "GsrBinaryDecoder.h"
+
+bool FGsrBinaryDecoder::Feed(uint8 Byte, FGsrBinarySample& OutSample)
+{
+    // 同步字节
+    if (Buffered == 0 && Byte != Sync0)
+    {
+        return false;
+    }
+    if (Buffered == 1 && Byte != Sync1)
+    {
+        Buffered = Byte == Sync0 ? 1 : 0;
+        return false;
+    }
+
+    Buffer[Buffered++] = Byte;
+    if (Buffered < FrameSize)
+    {
+        return false;
+    }
+
+    if (Crc8(Buffer + 2, FrameSize - 3) != Buffer[FrameSize - 1])
+    {
+        CrcErrors++;
+        Resync();
+        return false;
+    }
+
+    Buffered = 0;
+    return DecodeFrame(OutSample);
+}
+
+bool FGsrBinaryDecoder::DecodeFrame(FGsrBinarySample& OutSample)
+{
+    const uint8 Sequence = Buffer[2];
+    const uint8 Count = Buffer[3];
+    const uint16 Sum = static_cast<uint16>(Buffer[4] | (Buffer[5] << 8));
+    const uint32 TimestampUs = static_cast<uint32>(Buffer[6]) | (static_cast<uint32>(Buffer[7]) << 8)
+        | (static_cast<uint32>(Buffer[8]) << 16) | (static_cast<uint32>(Buffer[9]) << 24);
+
+    if (Count == 0)
+    {
+        return false;
+    }
+
+    if (bHasFrame)
+    {
+        LostFrames += static_cast<uint8>(Sequence - LastSequence - 1);
+
+        // 无符号差值处理 micros 回绕；大幅回退说明设备重新开始，时间轴从当前值重新起算
+        const uint32 Elapsed = TimestampUs - LastTimestampUs;
+        DeviceTime = Elapsed < 0x80000000u ? DeviceTime + Elapsed * 1.0e-6 : TimestampUs * 1.0e-6;
+    }
+    else
+    {
+        DeviceTime = TimestampUs * 1.0e-6;
+        bHasFrame = true;
+    }
+    LastSequence = Sequence;
+    LastTimestampUs = TimestampUs;
+    FrameCount++;
+
+    OutSample.DeviceTime = DeviceTime;
+    OutSample.Raw = static_cast<float>(Sum) / Count;
+    Convert(OutSample.Raw, OutSample.Resistance, OutSample.Conductance);
+    return true;
+}
+
+void FGsrBinaryDecoder::Convert(float Raw, float& OutResistance, float& OutConductance) const
+{
+    // 分压公式：Vout = Vin * R_skin / (R_known + R_skin)，与固件文本模式的换算相同
+    const float Voltage = Raw / AdcMax * SupplyVoltage;
+    OutResistance = Voltage > 0.0f ? (SupplyVoltage - Voltage) * KnownResistance / Voltage / 1000.0f : 0.0f;
+    OutConductance = OutResistance > 0.0f ? 1000.0f / OutResistance : 0.0f;
+}
+
+void FGsrBinaryDecoder::Resync()
+{
+    uint8 Pending[FrameSize];
+    const int32 PendingCount = Buffered - 1;
+    FMemory::Memcpy(Pending, Buffer + 1, PendingCount);
+    Buffered = 0;
+
+    // 剩余字节不足一帧，不会在这里解出新帧
+    FGsrBinarySample Unused;
+    for (int32 Index = 0; Index < PendingCount; Index++)
+    {
+        Feed(Pending[Index], Unused);
+    }
+}
+
+uint8 FGsrBinaryDecoder::Crc8(const uint8* Data, int32 Length)
+{
+    // CRC-8，多项式 0x07，初值 0
+    uint8 Crc = 0;
+    for (int32 Index = 0; Index < Length; Index++)
+    {
+        Crc ^= Data[Index];
+        for (int32 Bit = 0; Bit < 8; Bit++)
+        {
+            Crc = (Crc & 0x80) ? static_cast<uint8>((Crc << 1) ^ 0x07) : static_cast<uint8>(Crc << 1);
+        }
+    }
+    return Crc;
+}
+
+void FGsrBinaryDecoder::EncodeFrame(uint8 Sequence, uint8 Count, uint16 Sum, uint32 TimestampUs, uint8 (&OutFrame)[FrameSize])
+{
+    OutFrame[0] = Sync0;
+    OutFrame[1] = Sync1;
+    OutFrame[2] = Sequence;
+    OutFrame[3] = Count;
+    OutFrame[4] = static_cast<uint8>(Sum);
+    OutFrame[5] = static_cast<uint8>(Sum >> 8);
+    OutFrame[6] = static_cast<uint8>(TimestampUs);
+    OutFrame[7] = static_cast<uint8>(TimestampUs >> 8);
+    OutFrame[8] = static_cast<uint8>(TimestampUs >> 16);
+    OutFrame[9] = static_cast<uint8>(TimestampUs >> 24);
+    OutFrame[10] = Crc8(OutFrame + 2, FrameSize - 3);
+}
+
+void FGsrBinaryDecoder::Reset()
+{
+    Buffered = 0;
+    bHasFrame = false;
+    LastSequence = 0;
+    LastTimestampUs = 0;
+    DeviceTime = 0.0;
+    FrameCount = 0;
+    LostFrames = 0;
+    CrcErrors = 0;
+}
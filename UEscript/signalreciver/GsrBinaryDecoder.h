@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** 一个解码后的二进制 GSR 帧 */
+struct FGsrBinarySample
+{
+    /** 设备时间（秒，micros 展开回绕后的值）*/
+    double DeviceTime = 0.0;
+
+    /** 过采样平均后的 ADC 值（0~1023，带小数）*/
+    float Raw = 0.0f;
+
+    /** 皮肤电阻（kΩ）与电导（μS），在上位机计算 */
+    float Resistance = 0.0f;
+    float Conductance = 0.0f;
+};
+
+/**
+ * gsrpifudian.ino 二进制模式的流式解码器
+ * 帧格式（11 字节，小端）：0xA5 0x5A | 序号 u8 | 累加次数 u8 | ADC 累加值 u16 | 时间戳 u32 (micros) | CRC8
+ * 按字节输入，CRC 失败时从下一个同步字节重新对齐；序号缺口计为丢帧
+ */
+class WORKVOILENCEGAME_API FGsrBinaryDecoder
+{
+public:
+    static constexpr int32 FrameSize = 11;
+    static constexpr uint8 Sync0 = 0xA5;
+    static constexpr uint8 Sync1 = 0x5A;
+
+    // === 换算参数（与 Grove GSR 模块和固件一致）===
+
+    /** 供电电压（V）*/
+    float SupplyVoltage = 5.0f;
+
+    /** 模块上的已知电阻（Ω）*/
+    float KnownResistance = 10000.0f;
+
+    /** ADC 满量程 */
+    float AdcMax = 1023.0f;
+
+    /** 输入一个字节，解出完整帧时返回 true 并写入 OutSample */
+    bool Feed(uint8 Byte, FGsrBinarySample& OutSample);
+
+    /** ADC 值换算为电阻/电导 */
+    void Convert(float Raw, float& OutResistance, float& OutConductance) const;
+
+    int64 GetFrameCount() const { return FrameCount; }
+    int64 GetLostFrames() const { return LostFrames; }
+    int64 GetCrcErrors() const { return CrcErrors; }
+
+    static uint8 Crc8(const uint8* Data, int32 Length);
+
+    /** 按固件的格式编码一帧（模拟器和测试使用）*/
+    static void EncodeFrame(uint8 Sequence, uint8 Count, uint16 Sum, uint32 TimestampUs, uint8 (&OutFrame)[FrameSize]);
+
+    void Reset();
+
+private:
+    bool DecodeFrame(FGsrBinarySample& OutSample);
+
+    /** 丢弃第一个字节，把剩余字节重新送入同步状态机 */
+    void Resync();
+
+    uint8 Buffer[FrameSize] = {};
+    int32 Buffered = 0;
+
+    bool bHasFrame = false;
+    uint8 LastSequence = 0;
+    uint32 LastTimestampUs = 0;
+    double DeviceTime = 0.0;
+
+    int64 FrameCount = 0;
+    int64 LostFrames = 0;
+    int64 CrcErrors = 0;
+};
@@ -0,0 +1,898 @@
+#include "GsrDecomposition.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#elif PLATFORM_CPU_ARM_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    /** 驱动平滑窗最长 3 秒（sdeco 的 winwidth_max）*/
+    constexpr double MaxDriverSmoothSeconds = 3.0;
+
+    /** 准则中负值部分的权重（sdeco 的 alpha）*/
+    constexpr double NegativityWeight = 5.0;
+
+    /** tau 的取值范围（Ledalab 的 tauMin、tauMinDiff，tau1 不超过 10 秒，tau2 不超过 20 秒）*/
+    constexpr double TauMin = 0.001;
+    constexpr double TauMinDiff = 0.01;
+    constexpr double Tau1Max = 10.0;
+    constexpr double Tau2Max = 20.0;
+
+    /** 冲激响应峰值之后截断的阈值（归一化之前）*/
+    constexpr double KernelTailThreshold = 1.0e-5;
+
+    constexpr int32 MaxFilterOrder = 8;
+
+    /** 一个显著的驱动脉冲：前后两个极小值之间的极大值 */
+    struct FImpulse
+    {
+        /** 截取段的起点（极大值之前最多半个段长，不早于前一个极小值）*/
+        int32 Start = 0;
+        int32 Peak = 0;
+        int32 MinBefore = 0;
+        int32 MinAfter = 0;
+    };
+
+    /** Butterworth 的一个二阶节（奇数阶的最后一节为一阶，B2 = A2 = 0），直流增益为 1 */
+    struct FBiquad
+    {
+        double B0 = 1.0;
+        double B1 = 0.0;
+        double B2 = 0.0;
+        double A1 = 0.0;
+        double A2 = 0.0;
+    };
+
+    /** 双线性变换设计低通：模拟原型的二阶节为 s^2 + 2 sin(θk) s + 1，θk = π (2k + 1) / (2 Order) */
+    void DesignButterworth(int32 Order, double CutoffHz, double SampleRateHz, TArray<FBiquad>& OutSections)
+    {
+        OutSections.Reset();
+        const double K = FMath::Tan(PI * CutoffHz / SampleRateHz);
+        for (int32 Pair = 0; Pair < Order / 2; Pair++)
+        {
+            const double Damping = 2.0 * FMath::Sin(PI * (2 * Pair + 1) / (2.0 * Order));
+            const double Norm = 1.0 / (1.0 + Damping * K + K * K);
+            FBiquad& Section = OutSections.AddDefaulted_GetRef();
+            Section.B0 = K * K * Norm;
+            Section.B1 = 2.0 * Section.B0;
+            Section.B2 = Section.B0;
+            Section.A1 = 2.0 * (K * K - 1.0) * Norm;
+            Section.A2 = (1.0 - Damping * K + K * K) * Norm;
+        }
+        if (Order % 2 == 1)
+        {
+            const double Norm = 1.0 / (1.0 + K);
+            FBiquad& Section = OutSections.AddDefaulted_GetRef();
+            Section.B0 = K * Norm;
+            Section.B1 = Section.B0;
+            Section.A1 = (K - 1.0) * Norm;
+        }
+    }
+
+    /** 直接 II 型转置，初始状态取第一个输入的稳态（直流增益为 1，输出等于输入）*/
+    void FilterSection(const FBiquad& Section, TArray<double>& InOut)
+    {
+        if (InOut.Num() == 0)
+        {
+            return;
+        }
+        double Z1 = InOut[0] * (1.0 - Section.B0);
+        double Z2 = InOut[0] * (Section.B2 - Section.A2);
+        for (double& Value : InOut)
+        {
+            const double Input = Value;
+            Value = Section.B0 * Input + Z1;
+            Z1 = Section.B1 * Input - Section.A1 * Value + Z2;
+            Z2 = Section.B2 * Input - Section.A2 * Value;
+        }
+    }
+
+    void Reverse(TArray<double>& InOut)
+    {
+        for (int32 Left = 0, Right = InOut.Num() - 1; Left < Right; Left++, Right--)
+        {
+            Swap(InOut[Left], InOut[Right]);
+        }
+    }
+
+    /**
+     * sdeco 的前缀：onset 5 秒、tau 2/40 的 Bateman 函数经 0.4 秒高斯平滑后，开头到峰值的部分按峰值后一个采样
+     * 缩放到第一个采样的电导，去掉其中的零，使反卷积从接近稳态的位置开始
+     */
+    void BuildPrefix(double FirstValue, double SampleRateHz, int32 Count, TArray<double>& OutPrefix)
+    {
+        OutPrefix.Reset();
+        const int32 Length = FMath::Min(Count, FMath::CeilToInt(30.0 * SampleRateHz));
+        if (Length < 2)
+        {
+            return;
+        }
+
+        TArray<double> Bateman;
+        Bateman.SetNumZeroed(Length);
+        for (int32 Index = 0; Index < Length; Index++)
+        {
+            const double Time = (Index + 1) / SampleRateHz - 5.0;
+            if (Time > 0.0)
+            {
+                Bateman[Index] = FMath::Exp(-Time / 40.0) - FMath::Exp(-Time / 2.0);
+            }
+        }
+
+        const double Sigma = 0.4 * SampleRateHz;
+        const int32 HalfWidth = FMath::CeilToInt(4.0 * Sigma);
+        TArray<double> Smoothed;
+        Smoothed.SetNumZeroed(Length);
+        int32 Peak = 0;
+        for (int32 Index = 0; Index < Length; Index++)
+        {
+            double Sum = 0.0;
+            for (int32 Offset = -HalfWidth; Offset <= HalfWidth; Offset++)
+            {
+                Sum += Bateman[FMath::Clamp(Index + Offset, 0, Length - 1)] * FMath::Exp(-0.5 * FMath::Square(Offset / Sigma));
+            }
+            Smoothed[Index] = Sum;
+            Peak = Sum > Smoothed[Peak] ? Index : Peak;
+        }
+        if (Peak + 1 >= Length || Smoothed[Peak + 1] <= 0.0)
+        {
+            return;
+        }
+
+        for (int32 Index = 0; Index <= Peak; Index++)
+        {
+            const double Value = Smoothed[Index] / Smoothed[Peak + 1] * FirstValue;
+            if (Value != 0.0)
+            {
+                OutPrefix.Add(Value);
+            }
+        }
+    }
+
+    /** 驱动信号的显著脉冲（Ledalab get_peaks + signpeak + segment_driver）*/
+    void FindImpulses(const TArray<double>& Driver, double Significance, int32 SegmentLength, TArray<FImpulse>& OutImpulses)
+    {
+        OutImpulses.Reset();
+        const int32 Count = Driver.Num();
+
+        // 一阶差分变号处为极值，平台（差分为 0）跳过，极值记在平台末端
+        int32 First = 0;
+        while (First + 1 < Count && Driver[First + 1] == Driver[First])
+        {
+            First++;
+        }
+        if (First + 1 >= Count)
+        {
+            return;
+        }
+
+        TArray<int32> Minima;
+        TArray<int32> Maxima;
+        bool bRising = Driver[First + 1] > Driver[First];
+        for (int32 Index = First + 1; Index + 1 < Count; Index++)
+        {
+            const double Delta = Driver[Index + 1] - Driver[Index];
+            if (Delta == 0.0 || (Delta > 0.0) == bRising)
+            {
+                continue;
+            }
+            (bRising ? Maxima : Minima).Add(Index);
+            bRising = !bRising;
+        }
+        if (Maxima.Num() == 0)
+        {
+            return;
+        }
+
+        // 补齐首尾，使极小值和极大值交替排列：min, max, min, ..., max, min
+        if (Minima.Num() == 0 || Maxima[0] < Minima[0])
+        {
+            Minima.Insert(0, 0);
+        }
+        if (Maxima.Last() > Minima.Last())
+        {
+            Minima.Add(Count - 1);
+        }
+
+        // 相对前后任一极小值的高度超过阈值的极大值为显著脉冲
+        for (int32 Index = 0; Index < Maxima.Num(); Index++)
+        {
+            FImpulse Impulse;
+            Impulse.Peak = Maxima[Index];
+            Impulse.MinBefore = Minima[Index];
+            Impulse.MinAfter = Minima[Index + 1];
+            const double Height = FMath::Max(Driver[Impulse.Peak] - Driver[Impulse.MinBefore], Driver[Impulse.Peak] - Driver[Impulse.MinAfter]);
+            if (Height > Significance)
+            {
+                Impulse.Start = FMath::Max(Impulse.MinBefore, Impulse.Peak - (SegmentLength + 1) / 2);
+                OutImpulses.Add(Impulse);
+            }
+        }
+    }
+
+    /** 截取一个脉冲：从 Start 起最多 SegmentLength 个采样，后一个极小值及之后置 0 */
+    void ExtractImpulse(const TArray<double>& Driver, const FImpulse& Impulse, int32 SegmentLength, TArray<double>& OutSamples)
+    {
+        const int32 End = FMath::Min(Impulse.Start + SegmentLength, Driver.Num());
+        OutSamples.Reset();
+        for (int32 Index = Impulse.Start; Index < End; Index++)
+        {
+            OutSamples.Add(Index < Impulse.MinAfter ? Driver[Index] : 0.0);
+        }
+    }
+
+    /** 分段三次 Hermite 插值，斜率与 MATLAB pchip 相同（保形）；X 严格递增，At 递增 */
+    void Pchip(const TArray<double>& X, const TArray<double>& Y, const TArray<double>& At, TArray<double>& Out)
+    {
+        const int32 Count = X.Num();
+        Out.SetNumUninitialized(At.Num());
+        if (Count == 1)
+        {
+            for (double& Value : Out)
+            {
+                Value = Y[0];
+            }
+            return;
+        }
+
+        TArray<double> Step;
+        TArray<double> Secant;
+        for (int32 Index = 0; Index + 1 < Count; Index++)
+        {
+            Step.Add(X[Index + 1] - X[Index]);
+            Secant.Add((Y[Index + 1] - Y[Index]) / Step.Last());
+        }
+
+        TArray<double> Slope;
+        Slope.SetNumZeroed(Count);
+        if (Count == 2)
+        {
+            Slope[0] = Slope[1] = Secant[0];
+        }
+        else
+        {
+            for (int32 Index = 1; Index + 1 < Count; Index++)
+            {
+                if (Secant[Index - 1] * Secant[Index] > 0.0)
+                {
+                    const double Weight1 = 2.0 * Step[Index] + Step[Index - 1];
+                    const double Weight2 = Step[Index] + 2.0 * Step[Index - 1];
+                    Slope[Index] = (Weight1 + Weight2) / (Weight1 / Secant[Index - 1] + Weight2 / Secant[Index]);
+                }
+            }
+
+            // 端点：三点公式，方向与相邻割线相反时取 0，割线变号时不超过割线的 3 倍
+            const auto EndSlope = [](double Step0, double Step1, double Secant0, double Secant1)
+            {
+                double Value = ((2.0 * Step0 + Step1) * Secant0 - Step0 * Secant1) / (Step0 + Step1);
+                if (FMath::Sign(Value) != FMath::Sign(Secant0))
+                {
+                    Value = 0.0;
+                }
+                else if (FMath::Sign(Secant0) != FMath::Sign(Secant1) && FMath::Abs(Value) > FMath::Abs(3.0 * Secant0))
+                {
+                    Value = 3.0 * Secant0;
+                }
+                return Value;
+            };
+            Slope[0] = EndSlope(Step[0], Step[1], Secant[0], Secant[1]);
+            Slope[Count - 1] = EndSlope(Step[Count - 2], Step[Count - 3], Secant[Count - 2], Secant[Count - 3]);
+        }
+
+        int32 Segment = 0;
+        for (int32 Index = 0; Index < At.Num(); Index++)
+        {
+            while (Segment + 2 < Count && At[Index] >= X[Segment + 1])
+            {
+                Segment++;
+            }
+            const double H = Step[Segment];
+            const double S = At[Index] - X[Segment];
+            const double C = (3.0 * Secant[Segment] - 2.0 * Slope[Segment] - Slope[Segment + 1]) / H;
+            const double B = (Slope[Segment] - 2.0 * Secant[Segment] + Slope[Segment + 1]) / (H * H);
+            Out[Index] = Y[Segment] + S * (Slope[Segment] + S * (C + S * B));
+        }
+    }
+
+    /** 第一个大于 Value 的位置 */
+    int32 UpperBound(const TArray<double>& Sorted, double Value)
+    {
+        int32 Low = 0;
+        int32 High = Sorted.Num();
+        while (Low < High)
+        {
+            const int32 Middle = (Low + High) / 2;
+            if (Sorted[Middle] <= Value)
+            {
+                Low = Middle + 1;
+            }
+            else
+            {
+                High = Middle;
+            }
+        }
+        return Low;
+    }
+
+    /** 第一个不小于 Value 的位置 */
+    int32 LowerBound(const TArray<double>& Sorted, double Value)
+    {
+        int32 Low = 0;
+        int32 High = Sorted.Num();
+        while (Low < High)
+        {
+            const int32 Middle = (Low + High) / 2;
+            if (Sorted[Middle] < Value)
+            {
+                Low = Middle + 1;
+            }
+            else
+            {
+                High = Middle;
+            }
+        }
+        return Low;
+    }
+
+    /** 基线电导：基线驱动前面补 Kernel.Num() 个首值后与冲激响应卷积（与 sdeco 相同，相对驱动延后一个采样）*/
+    void ConvolveTonic(const TArray<double>& TonicDriver, const TArray<double>& Kernel, TArray<double>& OutTonicData)
+    {
+        const int32 Count = TonicDriver.Num();
+        const int32 KernelLength = Kernel.Num();
+        TArray<double> Extended;
+        Extended.Reserve(Count + KernelLength);
+        Extended.Init(TonicDriver[0], KernelLength);
+        Extended.Append(TonicDriver);
+
+        TArray<double> Full;
+        FGsrDecomposition::Convolve(Extended.GetData(), Extended.Num(), Kernel, Full);
+        OutTonicData.Reset(Count);
+        OutTonicData.Append(Full.GetData() + KernelLength - 1, Count);
+    }
+
+    /**
+     * 基线估计（sdeco_interimpulsefit）：取显著脉冲之间的驱动采样，在每个网格点附近（两倍网格间距的窗口）取均值，
+     * 不超过该点的电导；窗口内脉冲间采样不足 3 个时改用全部驱动采样的中位数；网格点之间用 pchip 插值
+     */
+    void FitTonic(const TArray<double>& Time, const TArray<double>& Data, const TArray<double>& Driver, const TArray<FImpulse>& Impulses,
+        const TArray<double>& Kernel, double SampleRateHz, double GridSeconds, TArray<double>& OutTonicDriver, TArray<double>& OutTonicData)
+    {
+        const int32 Count = Driver.Num();
+        TArray<int32> Gaps;
+        if (Impulses.Num() > 2)
+        {
+            Gaps.Add(Impulses[1].MinBefore);
+            for (int32 Index = 0; Index + 1 < Impulses.Num(); Index++)
+            {
+                const int32 From = Impulses[Index].MinAfter;
+                const int32 To = FMath::Max(From, Impulses[Index + 1].MinBefore);
+                for (int32 Sample = From; Sample <= To; Sample++)
+                {
+                    Gaps.Add(Sample);
+                }
+            }
+            for (int32 Sample = Impulses.Last().MinAfter; Sample < Count - FMath::RoundToInt(SampleRateHz); Sample++)
+            {
+                Gaps.Add(Sample);
+            }
+            Gaps.Sort();
+        }
+        else
+        {
+            // 几乎没有脉冲时整段都是基线
+            for (int32 Sample = 1; Sample < Count; Sample++)
+            {
+                Gaps.Add(Sample);
+            }
+        }
+
+        // 脉冲间采样按时间排序后用前缀和求窗口均值
+        TArray<double> GapTime;
+        TArray<double> GapSum;
+        GapTime.Reserve(Gaps.Num());
+        GapSum.Reserve(Gaps.Num() + 1);
+        GapSum.Add(0.0);
+        for (const int32 Sample : Gaps)
+        {
+            GapTime.Add(Time[Sample]);
+            GapSum.Add(GapSum.Last() + Driver[Sample]);
+        }
+
+        TArray<double> GroundTime;
+        for (int32 Step = 0; Step * GridSeconds <= Time[Count - 2]; Step++)
+        {
+            GroundTime.Add(Step * GridSeconds);
+        }
+        GroundTime.Add(Time.Last());
+
+        const double Window = GridSeconds < 30.0 ? 2.0 * GridSeconds : GridSeconds;
+        TArray<double> GroundLevel;
+        TArray<double> Median;
+        for (int32 Index = 0; Index < GroundTime.Num(); Index++)
+        {
+            // 窗口为 (Low, High]，最后一个网格点为 (Low, High)
+            const double Ground = GroundTime[Index];
+            const bool bLast = Index == GroundTime.Num() - 1;
+            const double Low = Index == 0 ? 1.0 : Ground - (bLast ? Window : Window / 2.0);
+            const double High = Index == 0 ? Ground + Window : (bLast ? Time.Last() - 1.0 : Ground + Window / 2.0);
+            const auto End = [&](const TArray<double>& Sorted) { return bLast ? LowerBound(Sorted, High) : UpperBound(Sorted, High); };
+
+            const double DataLevel = Data[FMath::Min(LowerBound(Time, Ground), Count - 1)];
+            const int32 GapFirst = UpperBound(GapTime, Low);
+            const int32 GapEnd = End(GapTime);
+            if (GapEnd - GapFirst > 2)
+            {
+                GroundLevel.Add(FMath::Min((GapSum[GapEnd] - GapSum[GapFirst]) / (GapEnd - GapFirst), DataLevel));
+                continue;
+            }
+
+            const int32 First = UpperBound(Time, Low);
+            const int32 Last = End(Time);
+            if (Last <= First)
+            {
+                GroundLevel.Add(DataLevel);
+                continue;
+            }
+            Median.Reset();
+            Median.Append(Driver.GetData() + First, Last - First);
+            Median.Sort();
+            const int32 Half = Median.Num() / 2;
+            const double Middle = Median.Num() % 2 == 1 ? Median[Half] : 0.5 * (Median[Half - 1] + Median[Half]);
+            GroundLevel.Add(FMath::Min(Middle, DataLevel));
+        }
+
+        Pchip(GroundTime, GroundLevel, Time, OutTonicDriver);
+        ConvolveTonic(OutTonicDriver, Kernel, OutTonicData);
+    }
+
+    /** 驱动中超过阈值的连续段（秒）的平方和除以总时长（Ledalab succnz）*/
+    double Discreteness(const TArray<double>& Driver, double Threshold, double SampleRateHz)
+    {
+        double Sum = 0.0;
+        int32 Run = 0;
+        for (int32 Index = 0; Index <= Driver.Num(); Index++)
+        {
+            if (Index < Driver.Num() && FMath::Abs(Driver[Index]) > Threshold)
+            {
+                Run++;
+                continue;
+            }
+            Sum += FMath::Square(Run / SampleRateHz);
+            Run = 0;
+        }
+        return Driver.Num() > 0 ? Sum / (Driver.Num() / SampleRateHz) : 0.0;
+    }
+
+    /** 按一组 tau 分解，返回优化准则；bFull 为 false 时（优化过程中）不计算相位电导和 SCR 列表 */
+    double Analyze(const TArray<double>& Time, const TArray<double>& Data, const TArray<double>& Prefix, double SampleRateHz,
+        const FGsrDecompositionSettings& Settings, double Tau1, double Tau2, bool bFull, FGsrDecompositionResult& Out)
+    {
+        const int32 Count = Data.Num();
+        TArray<double> Extended;
+        Extended.Reserve(Prefix.Num() + Count);
+        Extended.Append(Prefix);
+        Extended.Append(Data);
+
+        FGsrDecomposition::BuildKernel(Tau1, Tau2, SampleRateHz, Extended.Num(), Out.Kernel);
+        const TArray<double>& Kernel = Out.Kernel;
+        double KernelPeak = 0.0;
+        for (const double Value : Kernel)
+        {
+            KernelPeak = FMath::Max(KernelPeak, Value);
+        }
+        const double Significance = FMath::Max(0.1, Settings.SigPeak / KernelPeak * 10.0);
+        const int32 SegmentLength = FMath::Max(FMath::RoundToInt(Settings.SegmentSeconds * SampleRateHz), 1);
+        const int32 SmoothWidth = FMath::RoundToInt(FMath::Min(Settings.SmoothWindowSeconds * 8.0, MaxDriverSmoothSeconds) * SampleRateHz);
+
+        // 末尾用最后一个值补齐一个核长，商的长度与扩展后的数据相同
+        const double LastValue = Extended.Last();
+        for (int32 Index = 1; Index < Kernel.Num(); Index++)
+        {
+            Extended.Add(LastValue);
+        }
+        TArray<double> Driver;
+        FGsrDecomposition::Deconvolve(Extended, Kernel, Driver);
+        TArray<double> DriverSmooth = Driver;
+        FGsrDecomposition::Smooth(DriverSmooth, SmoothWidth, TEXT("gauss"));
+        Driver.RemoveAt(0, Prefix.Num());
+        DriverSmooth.RemoveAt(0, Prefix.Num());
+
+        TArray<FImpulse> Impulses;
+        FindImpulses(DriverSmooth, Significance, SegmentLength, Impulses);
+        FitTonic(Time, Data, DriverSmooth, Impulses, Kernel, SampleRateHz, Settings.TonicGridSeconds, Out.TonicDriver, Out.TonicData);
+
+        Out.Driver.SetNumUninitialized(Count);
+        for (int32 Index = 0; Index < Count; Index++)
+        {
+            Out.Driver[Index] = Driver[Index] - Out.TonicDriver[Index];
+        }
+        FGsrDecomposition::Smooth(Out.Driver, SmoothWidth, TEXT("gauss"));
+
+        double DriverPeak = 0.0;
+        double NegativeSquares = 0.0;
+        for (const double Value : Out.Driver)
+        {
+            DriverPeak = FMath::Max(DriverPeak, Value);
+            NegativeSquares += Value < 0.0 ? Value * Value : 0.0;
+        }
+        Out.Tau1 = Tau1;
+        Out.Tau2 = Tau2;
+        Out.Negativity = FMath::Sqrt(NegativeSquares / Count);
+        Out.Discreteness = Discreteness(Out.Driver, FMath::Max(0.01, DriverPeak / 20.0), SampleRateHz);
+        Out.Error = Out.Discreteness + NegativityWeight * Out.Negativity;
+        if (!bFull)
+        {
+            return Out.Error;
+        }
+
+        Out.PhasicData.SetNumUninitialized(Count);
+        for (int32 Index = 0; Index < Count; Index++)
+        {
+            Out.PhasicData[Index] = Data[Index] - Out.TonicData[Index];
+        }
+
+        // 相位驱动的每个显著脉冲与冲激响应卷积，峰值为 SCR 幅度
+        FindImpulses(Out.Driver, Significance, SegmentLength, Impulses);
+        Out.Scrs.Reset(Impulses.Num());
+        TArray<double> Samples;
+        TArray<double> Response;
+        for (const FImpulse& Impulse : Impulses)
+        {
+            ExtractImpulse(Out.Driver, Impulse, SegmentLength, Samples);
+            FGsrDecomposition::Convolve(Samples.GetData(), Samples.Num(), Kernel, Response);
+
+            int32 SamplePeak = 0;
+            for (int32 Index = 1; Index < Samples.Num(); Index++)
+            {
+                SamplePeak = Samples[Index] > Samples[SamplePeak] ? Index : SamplePeak;
+            }
+            int32 ResponsePeak = 0;
+            for (int32 Index = 1; Index < Response.Num(); Index++)
+            {
+                ResponsePeak = Response[Index] > Response[ResponsePeak] ? Index : ResponsePeak;
+            }
+
+            FGsrDecomposedScr& Scr = Out.Scrs.AddDefaulted_GetRef();
+            Scr.ImpulseOnset = Time[Impulse.Start];
+            Scr.Onset = Scr.ImpulseOnset + SamplePeak / SampleRateHz;
+            Scr.ImpulseAmplitude = Samples[SamplePeak];
+            Scr.Amplitude = Response[ResponsePeak];
+            Scr.PeakTime = Scr.ImpulseOnset + ResponsePeak / SampleRateHz;
+        }
+        return Out.Error;
+    }
+}
+
+bool FGsrDecomposition::Preprocess(const FGsrPreprocessSettings& Settings, TArray<double>& InOutTime, TArray<double>& InOutConductance, FString& OutError)
+{
+    const int32 Count = InOutConductance.Num();
+    if (InOutTime.Num() != Count || Count < 2)
+    {
+        OutError = FString::Printf(TEXT("时间和电导的长度不一致或采样太少（%d / %d）"), InOutTime.Num(), Count);
+        return false;
+    }
+    const double SampleRateHz = (Count - 1) / (InOutTime.Last() - InOutTime[0]);
+    if (!(SampleRateHz > 0.0))
+    {
+        OutError = TEXT("时间不递增");
+        return false;
+    }
+
+    if (Settings.FilterOrder > 0)
+    {
+        if (Settings.FilterOrder > MaxFilterOrder || !(Settings.FilterCutoffHz > 0.0) || Settings.FilterCutoffHz >= SampleRateHz / 2.0)
+        {
+            OutError = FString::Printf(TEXT("滤波参数无效：阶数 %d（最高 %d），截止频率 %.3f Hz（采样率 %.2f Hz）"),
+                Settings.FilterOrder, MaxFilterOrder, Settings.FilterCutoffHz, SampleRateHz);
+            return false;
+        }
+        LowpassFiltFilt(InOutConductance, Settings.FilterOrder, Settings.FilterCutoffHz, SampleRateHz);
+    }
+
+    if (Settings.DownsampleFactor > 1)
+    {
+        const int32 Factor = Settings.DownsampleFactor;
+        const int32 Blocks = Count / Factor;
+        if (Blocks < 2)
+        {
+            OutError = FString::Printf(TEXT("降采样因子 %d 太大（%d 个采样）"), Factor, Count);
+            return false;
+        }
+        for (int32 Block = 0; Block < Blocks; Block++)
+        {
+            double Sum = 0.0;
+            for (int32 Index = 0; Index < Factor; Index++)
+            {
+                Sum += InOutConductance[Block * Factor + Index];
+            }
+            InOutConductance[Block] = Sum / Factor;
+            InOutTime[Block] = InOutTime[Block * Factor];
+        }
+        InOutConductance.SetNum(Blocks);
+        InOutTime.SetNum(Blocks);
+    }
+
+    if (Settings.SmoothWidth > 0)
+    {
+        if (Settings.SmoothType != TEXT("hann") && Settings.SmoothType != TEXT("mean") && Settings.SmoothType != TEXT("gauss"))
+        {
+            OutError = FString::Printf(TEXT("不支持的平滑类型 %s（hann / mean / gauss）"), *Settings.SmoothType);
+            return false;
+        }
+        Smooth(InOutConductance, Settings.SmoothWidth, Settings.SmoothType);
+    }
+    return true;
+}
+
+bool FGsrDecomposition::Decompose(const TArray<double>& Time, const TArray<double>& Conductance, const FGsrDecompositionSettings& Settings,
+    FGsrDecompositionResult& OutResult, FString& OutError)
+{
+    OutResult = FGsrDecompositionResult();
+    const int32 Count = Conductance.Num();
+    if (Time.Num() != Count || Count < 3)
+    {
+        OutError = FString::Printf(TEXT("时间和电导的长度不一致或采样太少（%d / %d）"), Time.Num(), Count);
+        return false;
+    }
+    OutResult.SampleRateHz = (Count - 1) / (Time.Last() - Time[0]);
+    if (!(OutResult.SampleRateHz > 0.0))
+    {
+        OutError = TEXT("时间不递增");
+        return false;
+    }
+    if (!(Settings.Tau1 > 0.0) || Settings.Tau2 <= Settings.Tau1)
+    {
+        OutError = FString::Printf(TEXT("tau 无效（%.3f, %.3f），需要 0 < tau1 < tau2"), Settings.Tau1, Settings.Tau2);
+        return false;
+    }
+
+    // 网格和窗口按从 0 开始的时间计算，SCR 时间最后加回起点
+    TArray<double> Relative;
+    Relative.SetNumUninitialized(Count);
+    for (int32 Index = 0; Index < Count; Index++)
+    {
+        Relative[Index] = Time[Index] - Time[0];
+    }
+    TArray<double> Prefix;
+    BuildPrefix(Conductance[0], OutResult.SampleRateHz, Count, Prefix);
+
+    // 坐标搜索：每轮依次把 tau1、tau2 放大或缩小 (1 + Step) 倍，准则下降则接受，每轮步长减半
+    double Tau1 = Settings.Tau1;
+    double Tau2 = Settings.Tau2;
+    if (Settings.OptimizeRounds > 0)
+    {
+        FGsrDecompositionResult Trial;
+        double BestError = Analyze(Relative, Conductance, Prefix, OutResult.SampleRateHz, Settings, Tau1, Tau2, false, Trial);
+        double Step = 0.5;
+        for (int32 Round = 0; Round < Settings.OptimizeRounds; Round++, Step *= 0.5)
+        {
+            for (int32 Parameter = 0; Parameter < 2; Parameter++)
+            {
+                for (const double Factor : { 1.0 + Step, 1.0 / (1.0 + Step) })
+                {
+                    const double Candidate1 = Parameter == 0 ? FMath::Clamp(Tau1 * Factor, TauMin, Tau1Max) : Tau1;
+                    const double Candidate2 = Parameter == 1 ? FMath::Clamp(Tau2 * Factor, TauMin, Tau2Max) : Tau2;
+                    if (Candidate2 - Candidate1 < TauMinDiff)
+                    {
+                        continue;
+                    }
+                    const double Error = Analyze(Relative, Conductance, Prefix, OutResult.SampleRateHz, Settings, Candidate1, Candidate2, false, Trial);
+                    if (Error < BestError)
+                    {
+                        BestError = Error;
+                        Tau1 = Candidate1;
+                        Tau2 = Candidate2;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    Analyze(Relative, Conductance, Prefix, OutResult.SampleRateHz, Settings, Tau1, Tau2, true, OutResult);
+    for (FGsrDecomposedScr& Scr : OutResult.Scrs)
+    {
+        Scr.Onset += Time[0];
+        Scr.PeakTime += Time[0];
+        Scr.ImpulseOnset += Time[0];
+    }
+    return true;
+}
+
+void FGsrDecomposition::LowpassFiltFilt(TArray<double>& InOut, int32 Order, double CutoffHz, double SampleRateHz)
+{
+    const int32 Count = InOut.Num();
+    const int32 Pad = FMath::Min(3 * Order, Count - 1);
+    if (Order <= 0 || Pad <= 0)
+    {
+        return;
+    }
+
+    TArray<FBiquad> Sections;
+    DesignButterworth(Order, CutoffHz, SampleRateHz, Sections);
+
+    // 两端奇对称延拓，减小起止处的瞬态
+    TArray<double> Extended;
+    Extended.Reserve(Count + 2 * Pad);
+    for (int32 Index = Pad; Index > 0; Index--)
+    {
+        Extended.Add(2.0 * InOut[0] - InOut[Index]);
+    }
+    Extended.Append(InOut);
+    for (int32 Index = Count - 2; Index >= Count - 1 - Pad; Index--)
+    {
+        Extended.Add(2.0 * InOut.Last() - InOut[Index]);
+    }
+
+    for (int32 Pass = 0; Pass < 2; Pass++)
+    {
+        for (const FBiquad& Section : Sections)
+        {
+            FilterSection(Section, Extended);
+        }
+        Reverse(Extended);
+    }
+    FMemory::Memcpy(InOut.GetData(), Extended.GetData() + Pad, Count * sizeof(double));
+}
+
+void FGsrDecomposition::Smooth(TArray<double>& InOut, int32 Width, const FString& Type)
+{
+    const int32 Even = Width / 2 * 2;
+    const int32 Count = InOut.Num();
+    if (Even < 2 || Count == 0)
+    {
+        return;
+    }
+
+    // 窗口对称，卷积等于与窗口本身的点积
+    TArray<double> Window;
+    Window.SetNumUninitialized(Even + 1);
+    double Sum = 0.0;
+    for (int32 Index = 0; Index <= Even; Index++)
+    {
+        if (Type == TEXT("hann"))
+        {
+            Window[Index] = 0.5 * (1.0 - FMath::Cos(2.0 * PI * Index / Even));
+        }
+        else if (Type == TEXT("mean"))
+        {
+            Window[Index] = 1.0;
+        }
+        else
+        {
+            Window[Index] = FMath::Exp(-0.5 * FMath::Square((Index - Even / 2) / (Even / 8.0)));
+        }
+        Sum += Window[Index];
+    }
+    for (double& Value : Window)
+    {
+        Value /= Sum;
+    }
+
+    const int32 Half = Even / 2;
+    TArray<double> Extended;
+    Extended.Reserve(Count + Even);
+    Extended.Init(InOut[0], Half);
+    Extended.Append(InOut);
+    for (int32 Index = 0; Index < Half; Index++)
+    {
+        Extended.Add(InOut.Last());
+    }
+    for (int32 Index = 0; Index < Count; Index++)
+    {
+        InOut[Index] = Dot(Extended.GetData() + Index, Window.GetData(), Even + 1);
+    }
+}
+
+void FGsrDecomposition::BuildKernel(double Tau1, double Tau2, double SampleRateHz, int32 MaxLength, TArray<double>& OutKernel)
+{
+    // Bateman 函数按 1 / ((tau2 - tau1) * 采样率) 缩放，截断阈值针对这个尺度
+    const double Scale = 1.0 / ((Tau2 - Tau1) * SampleRateHz);
+    OutKernel.Reset();
+    double Sum = 0.0;
+    bool bDecaying = false;
+    for (int32 Index = 0; Index < MaxLength; Index++)
+    {
+        const double Time = (Index + 1) / SampleRateHz;
+        const double Value = Scale * (FMath::Exp(-Time / Tau2) - FMath::Exp(-Time / Tau1));
+        bDecaying |= Index > 0 && Value < OutKernel.Last();
+        if (bDecaying && Value <= KernelTailThreshold)
+        {
+            break;
+        }
+        OutKernel.Add(Value);
+        Sum += Value;
+    }
+    for (double& Value : OutKernel)
+    {
+        Value /= Sum;
+    }
+}
+
+void FGsrDecomposition::Convolve(const double* Signal, int32 Count, const TArray<double>& Kernel, TArray<double>& Out)
+{
+    const int32 KernelLength = Kernel.Num();
+    Out.Reset();
+    if (Count == 0 || KernelLength == 0)
+    {
+        return;
+    }
+
+    // 输入两端补零后，每个输出都是一段连续输入与反转核的点积
+    TArray<double> Reversed;
+    Reversed.SetNumUninitialized(KernelLength);
+    for (int32 Index = 0; Index < KernelLength; Index++)
+    {
+        Reversed[Index] = Kernel[KernelLength - 1 - Index];
+    }
+    TArray<double> Padded;
+    Padded.SetNumZeroed(Count + 2 * (KernelLength - 1));
+    FMemory::Memcpy(Padded.GetData() + KernelLength - 1, Signal, Count * sizeof(double));
+
+    Out.SetNumUninitialized(Count + KernelLength - 1);
+    for (int32 Index = 0; Index < Out.Num(); Index++)
+    {
+        Out[Index] = Dot(Padded.GetData() + Index, Reversed.GetData(), KernelLength);
+    }
+}
+
+void FGsrDecomposition::Deconvolve(const TArray<double>& Signal, const TArray<double>& Kernel, TArray<double>& OutQuotient)
+{
+    const int32 KernelLength = Kernel.Num();
+    const int32 Count = Signal.Num() - KernelLength + 1;
+    OutQuotient.Reset();
+    if (KernelLength == 0 || Count <= 0)
+    {
+        return;
+    }
+
+    // q[i] = (s[i] - Σ k[j] q[i - j]) / k[0]，求和是已求出的最近 KernelLength - 1 个商与反转核的点积
+    TArray<double> Reversed;
+    Reversed.SetNumUninitialized(KernelLength);
+    for (int32 Index = 0; Index < KernelLength; Index++)
+    {
+        Reversed[Index] = Kernel[KernelLength - 1 - Index];
+    }
+
+    OutQuotient.SetNumUninitialized(Count);
+    double* Quotient = OutQuotient.GetData();
+    for (int32 Index = 0; Index < Count; Index++)
+    {
+        const int32 Taps = FMath::Min(Index, KernelLength - 1);
+        Quotient[Index] = (Signal[Index] - Dot(Reversed.GetData() + KernelLength - 1 - Taps, Quotient + Index - Taps, Taps)) / Kernel[0];
+    }
+}
+
+double FGsrDecomposition::Dot(const double* A, const double* B, int32 Count)
+{
+    int32 Index = 0;
+    double Sum = 0.0;
+#if PLATFORM_CPU_X86_FAMILY
+    // 两个累加器交替，隐藏加法延迟
+    __m128d Sum0 = _mm_setzero_pd();
+    __m128d Sum1 = _mm_setzero_pd();
+    for (; Index + 4 <= Count; Index += 4)
+    {
+        Sum0 = _mm_add_pd(Sum0, _mm_mul_pd(_mm_loadu_pd(A + Index), _mm_loadu_pd(B + Index)));
+        Sum1 = _mm_add_pd(Sum1, _mm_mul_pd(_mm_loadu_pd(A + Index + 2), _mm_loadu_pd(B + Index + 2)));
+    }
+    Sum0 = _mm_add_pd(Sum0, Sum1);
+    Sum = _mm_cvtsd_f64(_mm_add_sd(Sum0, _mm_unpackhi_pd(Sum0, Sum0)));
+#elif PLATFORM_CPU_ARM_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    float64x2_t Sum0 = vdupq_n_f64(0.0);
+    float64x2_t Sum1 = vdupq_n_f64(0.0);
+    for (; Index + 4 <= Count; Index += 4)
+    {
+        Sum0 = vfmaq_f64(Sum0, vld1q_f64(A + Index), vld1q_f64(B + Index));
+        Sum1 = vfmaq_f64(Sum1, vld1q_f64(A + Index + 2), vld1q_f64(B + Index + 2));
+    }
+    Sum = vaddvq_f64(vaddq_f64(Sum0, Sum1));
+#endif
+    for (; Index < Count; Index++)
+    {
+        Sum += A[Index] * B[Index];
+    }
+    return Sum;
+}
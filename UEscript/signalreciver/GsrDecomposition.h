@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** 预处理设置，对应 leda_batchanalysis.m 的 filter / downsample / smooth 选项，按这个顺序执行 */
+struct FGsrPreprocessSettings
+{
+    /** 低通 Butterworth 阶数（0 为不滤波，最高 8）和截止频率（Hz），正反向各滤一次（同 filtfilt，零相位）*/
+    int32 FilterOrder = 0;
+    double FilterCutoffHz = 5.0;
+
+    /** 降采样因子：每 Factor 个采样取平均，时间取每块的第一个；1 为不降采样 */
+    int32 DownsampleFactor = 1;
+
+    /** 平滑窗类型（hann / mean / gauss）和窗宽（采样数，按偶数处理），窗宽为 0 时不平滑 */
+    FString SmoothType = TEXT("gauss");
+    int32 SmoothWidth = 0;
+};
+
+/** CDA 参数，默认值与 Ledalab sdeco 相同（tau0_sdeco、smoothwin_sdeco、tonicGridSize_sdeco、segmWidth、sigPeak）*/
+struct FGsrDecompositionSettings
+{
+    /** 冲激响应（Bateman 函数）的上升和衰减时间常数（秒）*/
+    double Tau1 = 1.0;
+    double Tau2 = 3.75;
+
+    /** 驱动信号的高斯平滑窗（秒），实际窗宽为它的 8 倍，最长 3 秒 */
+    double SmoothWindowSeconds = 0.2;
+
+    /** 估计基线（tonic）的网格间距（秒）*/
+    double TonicGridSeconds = 10.0;
+
+    /** 每个驱动脉冲截取的长度（秒）*/
+    double SegmentSeconds = 12.0;
+
+    /** 显著峰阈值（换算到驱动信号时除以核的最大值）*/
+    double SigPeak = 0.001;
+
+    /** tau 坐标搜索的轮数，0 为直接使用 Tau1/Tau2 */
+    int32 OptimizeRounds = 0;
+};
+
+/** 分解得到的一个 SCR（字段与 Ledalab analysis 中的同名向量对应）*/
+struct FGsrDecomposedScr
+{
+    /** 驱动脉冲峰值的时间（analysis.onset / impulsePeakTime）*/
+    double Onset = 0.0;
+
+    /** 脉冲与冲激响应卷积后的峰值（analysis.amp，µS）*/
+    double Amplitude = 0.0;
+
+    /** 卷积后峰值的时间（analysis.peakTime）*/
+    double PeakTime = 0.0;
+
+    /** 脉冲截取段的起点（analysis.impulseOnset）*/
+    double ImpulseOnset = 0.0;
+
+    /** 驱动脉冲的峰值（analysis.impulseAmp）*/
+    double ImpulseAmplitude = 0.0;
+};
+
+struct FGsrDecompositionResult
+{
+    double SampleRateHz = 0.0;
+
+    /** 实际使用的 tau（优化后）*/
+    double Tau1 = 0.0;
+    double Tau2 = 0.0;
+
+    /** 冲激响应，和为 1 */
+    TArray<double> Kernel;
+
+    /** 平滑后的相位驱动（analysis.driver）*/
+    TArray<double> Driver;
+
+    TArray<double> TonicDriver;
+    TArray<double> TonicData;
+    TArray<double> PhasicData;
+
+    TArray<FGsrDecomposedScr> Scrs;
+
+    /** 驱动的离散度（succnz）和负值部分的均方根 */
+    double Discreteness = 0.0;
+    double Negativity = 0.0;
+
+    /** 优化准则：Discreteness + 5 * Negativity */
+    double Error = 0.0;
+};
+
+/**
+ * GSR 连续分解（Ledalab CDA / sdeco）：
+ * 1. 电导信号前面补一段平滑上升的前缀，用归一化的 Bateman 冲激响应反卷积得到驱动信号
+ * 2. 驱动信号高斯平滑后按局部极值切成脉冲，脉冲之间的部分按网格（TonicGridSeconds）取均值，
+ *    用 pchip 插值得到基线驱动，再与冲激响应卷积得到基线电导
+ * 3. 驱动减去基线驱动得到相位驱动，每个显著脉冲与冲激响应卷积的峰值即 SCR 幅度
+ * 卷积、反卷积和平滑都归结为与反转核的点积（Dot），用 SSE2 / NEON 每次处理 2 个 double
+ * 所有函数都无状态，可以在多个线程上同时处理不同的文件
+ */
+class WORKVOILENCEGAME_API FGsrDecomposition
+{
+public:
+    /** 依次滤波、降采样、平滑；Time 与 Conductance 长度必须相同 */
+    static bool Preprocess(const FGsrPreprocessSettings& Settings, TArray<double>& InOutTime, TArray<double>& InOutConductance, FString& OutError);
+
+    /** 分解，Time 需要等间隔（采样率按平均间隔计算）*/
+    static bool Decompose(const TArray<double>& Time, const TArray<double>& Conductance, const FGsrDecompositionSettings& Settings,
+        FGsrDecompositionResult& OutResult, FString& OutError);
+
+    // === 基本运算 ===
+
+    /** Butterworth 低通（二阶节级联），正反向各一次，两端按奇对称延拓 3 * Order 个采样，节的初始状态取稳态 */
+    static void LowpassFiltFilt(TArray<double>& InOut, int32 Order, double CutoffHz, double SampleRateHz);
+
+    /** 与 Ledalab smooth.m 相同：窗宽取偶数，两端用端点值延拓后卷积 */
+    static void Smooth(TArray<double>& InOut, int32 Width, const FString& Type);
+
+    /** 归一化的 Bateman 冲激响应：峰值之前全部保留，峰值之后保留大于 1e-5 的部分，最长 MaxLength */
+    static void BuildKernel(double Tau1, double Tau2, double SampleRateHz, int32 MaxLength, TArray<double>& OutKernel);
+
+    /** 完整卷积，Out 长度为 Count + Kernel.Num() - 1（同 MATLAB conv）*/
+    static void Convolve(const double* Signal, int32 Count, const TArray<double>& Kernel, TArray<double>& Out);
+
+    /** 多项式除法的商（同 MATLAB deconv），Out 长度为 Signal.Num() - Kernel.Num() + 1 */
+    static void Deconvolve(const TArray<double>& Signal, const TArray<double>& Kernel, TArray<double>& OutQuotient);
+
+    static double Dot(const double* A, const double* B, int32 Count);
+};
@@ -0,0 +1,392 @@
+#include "GsrScrValidationCommandlet.h"
+#include "MatFileReader.h"
+#include "ScrDetector.h"
+#include "GsrDecomposition.h"
+#include "GsrSignalSynthesizer.h"
+#include "GsrSource.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+    /**
+     * 冲激响应与 analysis.kernel 的最大允许误差（相对核的峰值）
+     * test_keyboard.mat 逐位一致，joystick ver2.mat 的核由另一次 Ledalab 分析保存，相差约 3e-5
+     */
+    constexpr double KernelTolerance = 1.0e-4;
+
+    /** 参考 SCR（Ledalab 输出）*/
+    struct FReferenceScr
+    {
+        double Onset = 0.0;
+        double Amplitude = 0.0;
+    };
+
+    struct FMatchStats
+    {
+        int32 Reference = 0;
+        int32 Detected = 0;
+        int32 Hits = 0;
+        double OnsetErrorSum = 0.0;
+
+        // 命中对的幅度，用于相关系数
+        TArray<double> ReferenceAmplitudes;
+        TArray<double> DetectedAmplitudes;
+    };
+
+    bool LoadReference(const TArray<FMatVariable>& Variables, const FString& Prefix, TArray<FReferenceScr>& Out)
+    {
+        const TArray<double>* Onsets = FMatFileReader::FindNumbers(Variables, Prefix + TEXT(".onset"));
+        const TArray<double>* Amplitudes = FMatFileReader::FindNumbers(Variables, Prefix + TEXT(".amp"));
+        if (!Onsets || !Amplitudes || Onsets->Num() != Amplitudes->Num())
+        {
+            return false;
+        }
+
+        for (int32 Index = 0; Index < Onsets->Num(); Index++)
+        {
+            Out.Add({ (*Onsets)[Index], (*Amplitudes)[Index] });
+        }
+        return true;
+    }
+
+    /**
+     * 检查 FGsrDecomposition 的冲激响应与 Ledalab 保存的 analysis.kernel 一致
+     * （按 analysis.tau 和 data.time 的采样率构建）；文件中没有 analysis.kernel 时跳过
+     */
+    bool CheckKernel(const TArray<FMatVariable>& Variables, const TArray<double>& Time, const FString& Name)
+    {
+        const TArray<double>* Reference = FMatFileReader::FindNumbers(Variables, TEXT("analysis.kernel"));
+        const TArray<double>* Tau = FMatFileReader::FindNumbers(Variables, TEXT("analysis.tau"));
+        if (!Reference || !Tau || Tau->Num() != 2 || Time.Num() < 2)
+        {
+            return true;
+        }
+
+        const double SampleRateHz = (Time.Num() - 1) / (Time.Last() - Time[0]);
+        TArray<double> Kernel;
+        FGsrDecomposition::BuildKernel((*Tau)[0], (*Tau)[1], SampleRateHz, Reference->Num() + 1, Kernel);
+
+        double MaxError = 0.0;
+        double Peak = 0.0;
+        for (int32 Index = 0; Index < FMath::Min(Kernel.Num(), Reference->Num()); Index++)
+        {
+            MaxError = FMath::Max(MaxError, FMath::Abs(Kernel[Index] - (*Reference)[Index]));
+            Peak = FMath::Max(Peak, (*Reference)[Index]);
+        }
+        const bool bMatches = Kernel.Num() == Reference->Num() && MaxError <= KernelTolerance * Peak;
+        UE_LOG(LogTemp, Display, TEXT("  冲激响应 tau=%.2f/%.2f %.1fHz：%d 点（analysis.kernel %d 点），最大误差 %.3g，%s"),
+            (*Tau)[0], (*Tau)[1], SampleRateHz, Kernel.Num(), Reference->Num(), MaxError, bMatches ? TEXT("一致") : TEXT("不一致！"));
+        if (!bMatches)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: 冲激响应与 analysis.kernel 不一致"), *Name);
+        }
+        return bMatches;
+    }
+
+    /** 按时间顺序贪心匹配：每个参考 SCR 取容差内最近的、尚未使用的检测结果 */
+    FMatchStats Match(const TArray<FReferenceScr>& Reference, const TArray<FScrEvent>& Detected, double Threshold, double Tolerance)
+    {
+        FMatchStats Stats;
+        Stats.Detected = Detected.Num();
+
+        TArray<bool> Used;
+        Used.SetNumZeroed(Detected.Num());
+
+        int32 First = 0;
+        for (const FReferenceScr& Scr : Reference)
+        {
+            if (Scr.Amplitude < Threshold)
+            {
+                continue;
+            }
+            Stats.Reference++;
+
+            // 两个列表都按时间排序，窗口起点单调前移
+            while (First < Detected.Num() && Detected[First].OnsetTime < Scr.Onset - Tolerance)
+            {
+                First++;
+            }
+
+            int32 Best = INDEX_NONE;
+            double BestError = Tolerance;
+            for (int32 Index = First; Index < Detected.Num() && Detected[Index].OnsetTime <= Scr.Onset + Tolerance; Index++)
+            {
+                const double Error = FMath::Abs(Detected[Index].OnsetTime - Scr.Onset);
+                if (!Used[Index] && Error <= BestError)
+                {
+                    Best = Index;
+                    BestError = Error;
+                }
+            }
+
+            if (Best != INDEX_NONE)
+            {
+                Used[Best] = true;
+                Stats.Hits++;
+                Stats.OnsetErrorSum += BestError;
+                Stats.ReferenceAmplitudes.Add(Scr.Amplitude);
+                Stats.DetectedAmplitudes.Add(Detected[Best].Amplitude);
+            }
+        }
+        return Stats;
+    }
+
+    double Correlation(const TArray<double>& A, const TArray<double>& B)
+    {
+        const int32 Count = A.Num();
+        if (Count < 2)
+        {
+            return 0.0;
+        }
+
+        double MeanA = 0.0, MeanB = 0.0;
+        for (int32 Index = 0; Index < Count; Index++)
+        {
+            MeanA += A[Index];
+            MeanB += B[Index];
+        }
+        MeanA /= Count;
+        MeanB /= Count;
+
+        double Covariance = 0.0, VarianceA = 0.0, VarianceB = 0.0;
+        for (int32 Index = 0; Index < Count; Index++)
+        {
+            Covariance += (A[Index] - MeanA) * (B[Index] - MeanB);
+            VarianceA += FMath::Square(A[Index] - MeanA);
+            VarianceB += FMath::Square(B[Index] - MeanB);
+        }
+        return VarianceA > 0.0 && VarianceB > 0.0 ? Covariance / FMath::Sqrt(VarianceA * VarianceB) : 0.0;
+    }
+
+    void Report(const FString& Label, const FMatchStats& Stats)
+    {
+        const double Precision = Stats.Detected > 0 ? static_cast<double>(Stats.Hits) / Stats.Detected : 0.0;
+        const double Recall = Stats.Reference > 0 ? static_cast<double>(Stats.Hits) / Stats.Reference : 0.0;
+        const double F1 = Precision + Recall > 0.0 ? 2.0 * Precision * Recall / (Precision + Recall) : 0.0;
+
+        UE_LOG(LogTemp, Display, TEXT("  对照 %-8s 参考=%d 检测=%d 命中=%d 精确率=%.2f 召回率=%.2f F1=%.2f 起始误差=%.3fs 幅度相关=%.2f"),
+               *Label, Stats.Reference, Stats.Detected, Stats.Hits, Precision, Recall, F1,
+               Stats.Hits > 0 ? Stats.OnsetErrorSum / Stats.Hits : 0.0,
+               Correlation(Stats.ReferenceAmplitudes, Stats.DetectedAmplitudes));
+    }
+
+    /** 逐样本回放，与游戏内的调用方式相同 */
+    TArray<FScrEvent> RunDetector(const FScrDetector& Settings, const FString& Label, const TArray<double>& Time, const TArray<double>& Conductance)
+    {
+        FScrDetector Detector = Settings;
+        Detector.Reset();
+
+        TArray<FScrEvent> Detected;
+        double OnsetLatencySum = 0.0;
+        double OnsetLatencyMax = 0.0;
+        double PeakLatencySum = 0.0;
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 Index = 0; Index < Time.Num(); Index++)
+        {
+            const FScrSampleResult Result = Detector.AddSample(Time[Index], static_cast<float>(Conductance[Index]));
+            if (Result.bPeak)
+            {
+                Detected.Add(Result.Event);
+
+                const double OnsetLatency = Result.Event.OnsetDetectionTime - Result.Event.OnsetTime;
+                OnsetLatencySum += OnsetLatency;
+                OnsetLatencyMax = FMath::Max(OnsetLatencyMax, OnsetLatency);
+                PeakLatencySum += Result.Event.DetectionTime - Result.Event.PeakTime;
+            }
+        }
+        const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+        const int32 Events = FMath::Max(Detected.Num(), 1);
+        UE_LOG(LogTemp, Display, TEXT("%s: %d 个样本 (%.1fs)，检测到 %d 个 SCR，起始确认延迟 平均 %.3fs / 最大 %.3fs，峰值确认延迟 平均 %.3fs，每样本 %.1fns"),
+               *Label, Time.Num(), Time.Num() > 0 ? Time.Last() - Time[0] : 0.0, Detected.Num(),
+               OnsetLatencySum / Events, OnsetLatencyMax, PeakLatencySum / Events, ElapsedTime * 1.0e9 / FMath::Max(Time.Num(), 1));
+        return Detected;
+    }
+
+    /**
+     * 合成信号基准：生成 -Synthetic 秒的信号，按固件协议编码成字节流，再经过与采集线程相同的解析，
+     * 最后送入检测器并与合成时的真值比较
+     */
+    int32 RunSynthetic(const FString& Params, const FScrDetector& Settings, double Duration, double Tolerance)
+    {
+        FGsrSignalSynthesizer Synthesizer;
+        Synthesizer.ParseCommandLine(*Params);
+        const bool bBinary = FParse::Param(*Params, TEXT("Binary"));
+        int32 RateHz = 100;
+        FParse::Value(*Params, TEXT("Rate="), RateHz);
+        Synthesizer.ConfigureForProtocol(bBinary, RateHz);
+        Synthesizer.Reset();
+
+        // 生成并编码
+        double StartTime = FPlatformTime::Seconds();
+        TArray<uint8> Stream;
+        while (Synthesizer.GetTime() < Duration)
+        {
+            FGsrBinarySample Sample;
+            if (!Synthesizer.Next(Sample))
+            {
+                continue;
+            }
+            if (bBinary)
+            {
+                uint8 Frame[FGsrBinaryDecoder::FrameSize];
+                Synthesizer.EncodeFrame(Sample, Frame);
+                Stream.Append(Frame, FGsrBinaryDecoder::FrameSize);
+            }
+            else
+            {
+                const FTCHARToUTF8 Line(*FGsrSignalSynthesizer::FormatLine(Sample));
+                Stream.Append(reinterpret_cast<const uint8*>(Line.Get()), Line.Length());
+            }
+        }
+        const double GenerateTime = FPlatformTime::Seconds() - StartTime;
+
+        // 解析（与 FGsrSource 后台线程相同的路径）
+        StartTime = FPlatformTime::Seconds();
+        TArray<double> Time;
+        TArray<double> Conductance;
+        if (bBinary)
+        {
+            FGsrBinaryDecoder Decoder;
+            FGsrBinarySample Binary;
+            for (const uint8 Byte : Stream)
+            {
+                if (Decoder.Feed(Byte, Binary))
+                {
+                    Time.Add(Binary.DeviceTime);
+                    Conductance.Add(Binary.Conductance);
+                }
+            }
+        }
+        else
+        {
+            TArray<ANSICHAR> LineBuffer;
+            FGsrSample Sample;
+            for (const uint8 Byte : Stream)
+            {
+                if (Byte != '\n')
+                {
+                    LineBuffer.Add(static_cast<ANSICHAR>(Byte));
+                    continue;
+                }
+                LineBuffer.Add('\0');
+                if (FGsrSource::ParseLine(FString(ANSI_TO_TCHAR(LineBuffer.GetData())), Sample))
+                {
+                    Time.Add(Sample.DeviceTimeMs / 1000.0);
+                    Conductance.Add(Sample.Conductance);
+                }
+                LineBuffer.Reset();
+            }
+        }
+        const double DecodeTime = FPlatformTime::Seconds() - StartTime;
+
+        UE_LOG(LogTemp, Display, TEXT("合成信号 %.0fs（%s %.0fHz，种子 %d）：%d 字节，生成+编码 %.1fns/样本，解析 %.1fns/样本"),
+               Duration, bBinary ? TEXT("二进制") : TEXT("文本"), Synthesizer.SampleRateHz, Synthesizer.Seed, Stream.Num(),
+               GenerateTime * 1.0e9 / FMath::Max(Time.Num(), 1), DecodeTime * 1.0e9 / FMath::Max(Time.Num(), 1));
+
+        const TArray<FScrEvent> Detected = RunDetector(Settings, TEXT("合成信号"), Time, Conductance);
+
+        TArray<FReferenceScr> Reference;
+        for (const FGsrSyntheticScr& Scr : Synthesizer.GetGroundTruth())
+        {
+            Reference.Add({ Scr.OnsetTime, Scr.Amplitude });
+        }
+        Report(TEXT("真值"), Match(Reference, Detected, Settings.AmplitudeThreshold, Tolerance));
+
+        FString TruthPath;
+        if (FParse::Value(*Params, TEXT("Truth="), TruthPath) && !FGsrSignalSynthesizer::SaveGroundTruth(TruthPath, Synthesizer.GetGroundTruth()))
+        {
+            UE_LOG(LogTemp, Error, TEXT("真值写入失败: %s"), *TruthPath);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+UGsrScrValidationCommandlet::UGsrScrValidationCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UGsrScrValidationCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Files;
+    TArray<FString> Switches;
+    ParseCommandLine(*Params, Files, Switches);
+
+    FScrDetector Settings;
+    double Tolerance = 1.0;
+    FParse::Value(*Params, TEXT("Threshold="), Settings.AmplitudeThreshold);
+    FParse::Value(*Params, TEXT("Smoothing="), Settings.SmoothingTime);
+    FParse::Value(*Params, TEXT("Hysteresis="), Settings.Hysteresis);
+    FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+
+    double SyntheticDuration = 0.0;
+    if (FParse::Value(*Params, TEXT("Synthetic="), SyntheticDuration) && SyntheticDuration > 0.0)
+    {
+        return RunSynthetic(Params, Settings, SyntheticDuration, Tolerance);
+    }
+
+    if (Files.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("用法: -run=GsrScrValidation (<会话.mat> [...] | -Synthetic=<秒> [-Binary] [-Rate=100] [-Seed=1] [-Truth=<文件>]) [-Threshold=0.01] [-Tolerance=1.0] [-Smoothing=0.2] [-Hysteresis=0.005]"));
+        return 1;
+    }
+
+    int32 Failures = 0;
+    for (const FString& File : Files)
+    {
+        TArray<FMatVariable> Variables;
+        FString Error;
+        if (!FMatFileReader::Load(File, Variables, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: %s"), *File, *Error);
+            Failures++;
+            continue;
+        }
+
+        const TArray<double>* Conductance = FMatFileReader::FindNumbers(Variables, TEXT("data.conductance"));
+        const TArray<double>* Time = FMatFileReader::FindNumbers(Variables, TEXT("data.time"));
+        if (!Conductance || !Time || Conductance->Num() != Time->Num() || Time->Num() == 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: 缺少 data.conductance / data.time"), *File);
+            Failures++;
+            continue;
+        }
+
+        const TArray<FScrEvent> Detected = RunDetector(Settings, FPaths::GetCleanFilename(File), *Time, *Conductance);
+        if (!CheckKernel(Variables, *Time, FPaths::GetCleanFilename(File)))
+        {
+            Failures++;
+        }
+
+        TArray<FReferenceScr> Reference;
+        if (LoadReference(Variables, TEXT("analysis"), Reference))
+        {
+            Report(TEXT("CDA"), Match(Reference, Detected, Settings.AmplitudeThreshold, Tolerance));
+        }
+
+        // Ledalab 导出的 SCR 列表（<名称>_scrlist.mat）
+        const FString ScrListFile = FPaths::Combine(FPaths::GetPath(File), FPaths::GetBaseFilename(File) + TEXT("_scrlist.mat"));
+        TArray<FMatVariable> ScrList;
+        if (FPaths::FileExists(ScrListFile) && FMatFileReader::Load(ScrListFile, ScrList, Error))
+        {
+            for (const TCHAR* Method : { TEXT("TTP"), TEXT("CDA") })
+            {
+                Reference.Reset();
+                if (LoadReference(ScrList, FString(TEXT("scrList.")) + Method, Reference))
+                {
+                    Report(FString(TEXT("列表 ")) + Method, Match(Reference, Detected, Settings.AmplitudeThreshold, Tolerance));
+                }
+            }
+        }
+    }
+
+    return Failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GsrScrValidationCommandlet.generated.h"
+
+/**
+ * 用 Ledalab 的离线分析结果验证流式 SCR 检测器
+ * 读取会话 MAT 文件的 data.conductance/data.time，逐样本送入 FScrDetector，
+ * 与同一文件中的 analysis.onset/amp（CDA）以及同目录 <名称>_scrlist.mat 中的 scrList.TTP/CDA 比较
+ * 文件中有 analysis.kernel 时，同时检查 FGsrDecomposition 构建的冲激响应与它一致，不一致时返回 1
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=GsrScrValidation <会话.mat> [<会话.mat> ...]
+ *       [-Threshold=0.01] [-Tolerance=1.0] [-Smoothing=0.2] [-Hysteresis=0.005]
+ * 例如 Experiment/keyboardGroup/test_keyboard.mat "Experiment/joystickgroup/joystick ver2.mat"
+ *
+ * 合成信号基准：-Synthetic=<秒> [-Binary] [-Rate=100] [-Seed=1] [-Truth=<文件>]（其余参数见 FGsrSignalSynthesizer::ParseCommandLine）
+ * 用 FGsrSignalSynthesizer 生成信号，经过固件协议编码和解析后送入检测器，与真值比较并报告各阶段每样本耗时
+ */
+UCLASS()
+class WORKVOILENCEGAME_API UGsrScrValidationCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGsrScrValidationCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
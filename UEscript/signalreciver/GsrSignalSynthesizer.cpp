@@ -0,0 +1,167 @@
+#include "GsrSignalSynthesizer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+void FGsrSignalSynthesizer::ConfigureForProtocol(bool bBinary, int32 RateHz)
+{
+    SampleRateHz = bBinary ? static_cast<float>(FMath::Clamp(RateHz, 50, 200)) : 10.0f;
+    AdcOversample = bBinary ? 4 : 1;
+}
+
+void FGsrSignalSynthesizer::ParseCommandLine(const TCHAR* Params)
+{
+    FParse::Value(Params, TEXT("Seed="), Seed);
+    FParse::Value(Params, TEXT("Tonic="), TonicLevel);
+    FParse::Value(Params, TEXT("Drift="), TonicDrift);
+    FParse::Value(Params, TEXT("ScrPerMinute="), ScrPerMinute);
+    FParse::Value(Params, TEXT("MinAmplitude="), MinAmplitude);
+    FParse::Value(Params, TEXT("MaxAmplitude="), MaxAmplitude);
+    FParse::Value(Params, TEXT("Noise="), NoiseStd);
+    FParse::Value(Params, TEXT("Dropouts="), DropoutsPerMinute);
+
+    FString OnsetList;
+    if (FParse::Value(Params, TEXT("Onsets="), OnsetList, false))
+    {
+        TArray<FString> Onsets;
+        OnsetList.ParseIntoArray(Onsets, TEXT(","));
+        ScheduledOnsets.Reset();
+        for (const FString& Onset : Onsets)
+        {
+            ScheduledOnsets.Add(FCString::Atod(*Onset));
+        }
+        ScheduledOnsets.Sort();
+    }
+    bStarted = false;
+}
+
+void FGsrSignalSynthesizer::Reset()
+{
+    Random.Initialize(Seed);
+    bStarted = true;
+    SampleIndex = 0;
+    Tonic = TonicLevel;
+    SlowState = 0.0;
+    FastState = 0.0;
+    NextScheduled = 0;
+    DropoutEnd = -1.0;
+    FrameSequence = 0;
+    GroundTruth.Reset();
+
+    // Bateman 核 exp(-t/Decay) - exp(-t/Rise) 的峰值位置，用于把幅度归一到峰值
+    KernelRise = FMath::Max(FMath::Min(RiseTau, DecayTau), 0.01f);
+    KernelDecay = FMath::Max(static_cast<double>(FMath::Max(RiseTau, DecayTau)), KernelRise + 0.01);
+    PeakDelay = FMath::Loge(KernelDecay / KernelRise) * KernelRise * KernelDecay / (KernelDecay - KernelRise);
+    KernelScale = 1.0 / (FMath::Exp(-PeakDelay / KernelDecay) - FMath::Exp(-PeakDelay / KernelRise));
+
+    ScheduleNextOnset(-MinScrInterval);
+}
+
+bool FGsrSignalSynthesizer::Next(FGsrBinarySample& OutSample)
+{
+    if (!bStarted)
+    {
+        Reset();
+    }
+
+    const double Dt = 1.0 / SampleRateHz;
+    const double Time = GetTime();
+
+    // 本样本之前开始的 SCR；起始落在两个样本之间时按已经过的时间衰减
+    while (NextOnset <= Time)
+    {
+        const float Amplitude = MinAmplitude * FMath::Pow(MaxAmplitude / MinAmplitude, Random.GetFraction());
+        const double Elapsed = Time - NextOnset;
+        SlowState += Amplitude * KernelScale * FMath::Exp(-Elapsed / KernelDecay);
+        FastState += Amplitude * KernelScale * FMath::Exp(-Elapsed / KernelRise);
+        GroundTruth.Add({ NextOnset, NextOnset + PeakDelay, Amplitude });
+        ScheduleNextOnset(NextOnset);
+    }
+
+    // 张力分量：均值回归的随机游走，不低于 0.1μS
+    Tonic += (TonicLevel - Tonic) * Dt / FMath::Max(TonicRecoveryTime, 1.0f) + TonicDrift * FMath::Sqrt(Dt) * Gaussian();
+    Tonic = FMath::Max(Tonic, 0.1);
+
+    const double Conductance = FMath::Max(Tonic + SlowState - FastState + NoiseStd * Gaussian(), 0.0);
+
+    SlowState *= FMath::Exp(-Dt / KernelDecay);
+    FastState *= FMath::Exp(-Dt / KernelRise);
+    SampleIndex++;
+
+    // 掉线：信号照常演变，只是没有样本
+    if (Time < DropoutEnd)
+    {
+        return false;
+    }
+    if (DropoutsPerMinute > 0.0f && Random.GetFraction() < DropoutsPerMinute / 60.0 * Dt)
+    {
+        DropoutEnd = Time + Random.GetFraction() * MaxDropoutTime;
+        return false;
+    }
+
+    // 分压：Vout/Vin = R_known / (R_known + R_skin)，R_skin = 1/电导
+    const double SkinResistance = Conductance > 0.0 ? 1.0e6 / Conductance : 1.0e12;
+    const double Analog = Adc.AdcMax * Adc.KnownResistance / (Adc.KnownResistance + SkinResistance);
+    const int32 Count = FMath::Max(AdcOversample, 1);
+    int32 Sum = 0;
+    for (int32 Index = 0; Index < Count; Index++)
+    {
+        Sum += FMath::Clamp(FMath::RoundToInt(static_cast<float>(Analog + AdcNoise * Gaussian())), 0, static_cast<int32>(Adc.AdcMax));
+    }
+
+    OutSample.DeviceTime = Time;
+    OutSample.Raw = static_cast<float>(Sum) / Count;
+    Adc.Convert(OutSample.Raw, OutSample.Resistance, OutSample.Conductance);
+    return true;
+}
+
+FString FGsrSignalSynthesizer::FormatLine(const FGsrBinarySample& Sample)
+{
+    // 与固件文本模式相同："DATA:时间(ms),原始值,电阻(kΩ),电导(μS)"
+    return FString::Printf(TEXT("DATA:%d,%d,%.4f,%.4f\n"), static_cast<int32>(Sample.DeviceTime * 1000.0),
+        FMath::RoundToInt(Sample.Raw), Sample.Resistance, Sample.Conductance);
+}
+
+void FGsrSignalSynthesizer::EncodeFrame(const FGsrBinarySample& Sample, uint8 (&OutFrame)[FGsrBinaryDecoder::FrameSize])
+{
+    const int32 Count = FMath::Max(AdcOversample, 1);
+    const uint32 TimestampUs = static_cast<uint32>(static_cast<uint64>(Sample.DeviceTime * 1.0e6));
+    FGsrBinaryDecoder::EncodeFrame(FrameSequence++, static_cast<uint8>(Count),
+        static_cast<uint16>(FMath::RoundToInt(Sample.Raw * Count)), TimestampUs, OutFrame);
+}
+
+bool FGsrSignalSynthesizer::SaveGroundTruth(const FString& Path, const TArray<FGsrSyntheticScr>& Scrs)
+{
+    FString Text = TEXT("Onset(s)\tPeak(s)\tAmplitude(uS)\n");
+    for (const FGsrSyntheticScr& Scr : Scrs)
+    {
+        Text += FString::Printf(TEXT("%.3f\t%.3f\t%.4f\n"), Scr.OnsetTime, Scr.PeakTime, Scr.Amplitude);
+    }
+    return FFileHelper::SaveStringToFile(Text, *Path);
+}
+
+float FGsrSignalSynthesizer::Gaussian()
+{
+    // Box-Muller
+    const float U1 = FMath::Max(1.0f - Random.GetFraction(), 1.0e-7f);
+    const float U2 = Random.GetFraction();
+    return FMath::Sqrt(-2.0f * FMath::Loge(U1)) * FMath::Cos(2.0f * PI * U2);
+}
+
+void FGsrSignalSynthesizer::ScheduleNextOnset(double After)
+{
+    if (ScheduledOnsets.Num() > 0)
+    {
+        NextOnset = NextScheduled < ScheduledOnsets.Num() ? ScheduledOnsets[NextScheduled++] : TNumericLimits<double>::Max();
+        return;
+    }
+
+    if (ScrPerMinute <= 0.0f)
+    {
+        NextOnset = TNumericLimits<double>::Max();
+        return;
+    }
+
+    // 不应期之后的指数间隔，使平均频率等于 ScrPerMinute
+    const double MeanGap = FMath::Max(60.0 / ScrPerMinute - MinScrInterval, 0.1);
+    NextOnset = After + MinScrInterval - MeanGap * FMath::Loge(FMath::Max(1.0f - Random.GetFraction(), 1.0e-7f));
+}
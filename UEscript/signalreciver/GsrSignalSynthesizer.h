@@ -0,0 +1,139 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "GsrBinaryDecoder.h"
+
+/** 合成信号中的一次 SCR（真值）*/
+struct FGsrSyntheticScr
+{
+    /** 起始时间（秒，设备时间）*/
+    double OnsetTime = 0.0;
+
+    /** 单个反应的峰值时间（秒）*/
+    double PeakTime = 0.0;
+
+    /** 单个反应的峰值幅度（μS，重叠时实际谷峰幅度会不同）*/
+    float Amplitude = 0.0f;
+};
+
+/**
+ * 合成皮肤电信号，用于在没有被试和传感器的情况下测试采集与 SCR 检测
+ * 张力分量：围绕 TonicLevel 的均值回归随机游走；
+ * 位相分量：Bateman 函数核 exp(-t/DecayTau) - exp(-t/RiseTau)（与 Ledalab 的 CDA 模型相同），
+ * 起始时间按泊松过程随机生成或由 ScheduledOnsets 指定，重叠的反应线性叠加；
+ * 再叠加电极噪声，经过与 Grove GSR 模块相同的分压和 10 位 ADC 量化，并随机掉线（期间没有样本输出）
+ * 输出的 FGsrBinarySample 可以编码为 gsrpifudian.ino 的文本行或二进制帧
+ */
+struct WORKVOILENCEGAME_API FGsrSignalSynthesizer
+{
+public:
+    // === 采样 ===
+
+    float SampleRateHz = 10.0f;
+
+    /** 每个样本的 ADC 累加次数（文本模式 1，二进制模式与固件 OVERSAMPLE 一致为 4）*/
+    int32 AdcOversample = 1;
+
+    /** ADC 噪声（LSB）*/
+    float AdcNoise = 0.5f;
+
+    // === 张力分量（μS）===
+
+    float TonicLevel = 5.0f;
+
+    /** 随机游走强度（μS/√秒）*/
+    float TonicDrift = 0.02f;
+
+    /** 回到 TonicLevel 的时间常数（秒）*/
+    float TonicRecoveryTime = 60.0f;
+
+    // === 位相分量 ===
+
+    /** 平均每分钟的 SCR 个数（ScheduledOnsets 为空时使用）*/
+    float ScrPerMinute = 6.0f;
+
+    /** 相邻 SCR 起始的最小间隔（秒）*/
+    float MinScrInterval = 1.5f;
+
+    /** 幅度范围（μS，对数均匀分布）*/
+    float MinAmplitude = 0.05f;
+    float MaxAmplitude = 1.0f;
+
+    /** Bateman 核的时间常数（秒，Benedek & Kaernbach 2010 的典型值）*/
+    float RiseTau = 0.75f;
+    float DecayTau = 2.0f;
+
+    /** 指定的 SCR 起始时间（秒，升序），非空时不再随机生成 */
+    TArray<double> ScheduledOnsets;
+
+    // === 干扰 ===
+
+    /** 电极噪声（μS，高斯）*/
+    float NoiseStd = 0.003f;
+
+    /** 平均每分钟掉线次数，每次持续 0~MaxDropoutTime 秒 */
+    float DropoutsPerMinute = 0.2f;
+    float MaxDropoutTime = 1.0f;
+
+    int32 Seed = 1;
+
+    /** ADC 模型（与解码端的换算参数一致）*/
+    FGsrBinaryDecoder Adc;
+
+    // === 接口 ===
+
+    /** 按固件的协议设置采样：文本模式 10Hz 单次采样，二进制模式 50~200Hz 4 倍过采样 */
+    void ConfigureForProtocol(bool bBinary, int32 RateHz = 100);
+
+    /** 读取命令行参数（-Seed= -Tonic= -Drift= -ScrPerMinute= -MinAmplitude= -MaxAmplitude= -Noise= -Dropouts= -Onsets=a,b,c）*/
+    void ParseCommandLine(const TCHAR* Params);
+
+    /** 按当前参数重新开始（时间从 0 起算），修改参数后调用 */
+    void Reset();
+
+    /** 前进一个采样周期；掉线期间返回 false（没有样本）*/
+    bool Next(FGsrBinarySample& OutSample);
+
+    /** 当前设备时间（秒）*/
+    double GetTime() const { return SampleIndex / static_cast<double>(SampleRateHz); }
+
+    /** 已经开始的 SCR（按起始时间排序）*/
+    const TArray<FGsrSyntheticScr>& GetGroundTruth() const { return GroundTruth; }
+
+    /** 编码为固件文本模式的一行（含换行）*/
+    static FString FormatLine(const FGsrBinarySample& Sample);
+
+    /** 编码为固件二进制帧 */
+    void EncodeFrame(const FGsrBinarySample& Sample, uint8 (&OutFrame)[FGsrBinaryDecoder::FrameSize]);
+
+    /** 写出真值（制表符分隔：起始、峰值时间、幅度），失败返回 false */
+    static bool SaveGroundTruth(const FString& Path, const TArray<FGsrSyntheticScr>& Scrs);
+
+private:
+    float Gaussian();
+
+    /** 按泊松过程安排下一个 SCR 起始 */
+    void ScheduleNextOnset(double After);
+
+    FRandomStream Random;
+    bool bStarted = false;
+    int64 SampleIndex = 0;
+    double Tonic = 0.0;
+
+    // Bateman 核分解为两个一阶衰减，每个 SCR 起始时同时加上相同的量
+    double SlowState = 0.0;
+    double FastState = 0.0;
+    double KernelRise = 0.0;
+    double KernelDecay = 0.0;
+    double KernelScale = 1.0;
+    double PeakDelay = 0.0;
+
+    double NextOnset = 0.0;
+    int32 NextScheduled = 0;
+    double DropoutEnd = -1.0;
+
+    uint8 FrameSequence = 0;
+
+    TArray<FGsrSyntheticScr> GroundTruth;
+};
@@ -0,0 +1,265 @@
+#include "GsrSimulatorCommandlet.h"
+#include "GsrSignalSynthesizer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformTime.h"
+
+#if !PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // 固件开始记录时输出的提示行
+    const TCHAR* TextStartedReply = TEXT("RECORDING_STARTED\nHEADER:Time(ms),GSR_Raw,GSR_Resistance(kohm),GSR_Conductance(uS)\n");
+    const TCHAR* BinaryStartedReply = TEXT("BINARY_STARTED\n");
+    const TCHAR* StoppedReply = TEXT("RECORDING_STOPPED\n");
+
+    void AppendText(TArray<uint8>& Bytes, const FString& Text)
+    {
+        const FTCHARToUTF8 Utf8(*Text);
+        Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+    }
+
+    /** 生成一个样本并按协议编码，掉线期间不输出 */
+    void AppendNextSample(FGsrSignalSynthesizer& Synthesizer, bool bBinary, TArray<uint8>& Bytes)
+    {
+        FGsrBinarySample Sample;
+        if (!Synthesizer.Next(Sample))
+        {
+            return;
+        }
+
+        if (bBinary)
+        {
+            uint8 Frame[FGsrBinaryDecoder::FrameSize];
+            Synthesizer.EncodeFrame(Sample, Frame);
+            Bytes.Append(Frame, FGsrBinaryDecoder::FrameSize);
+        }
+        else
+        {
+            AppendText(Bytes, FGsrSignalSynthesizer::FormatLine(Sample));
+        }
+    }
+
+    void SaveTruth(const FString& Path, const FGsrSignalSynthesizer& Synthesizer)
+    {
+        if (!FGsrSignalSynthesizer::SaveGroundTruth(Path, Synthesizer.GetGroundTruth()))
+        {
+            UE_LOG(LogTemp, Error, TEXT("真值写入失败: %s"), *Path);
+        }
+    }
+
+    int32 WriteCapture(FGsrSignalSynthesizer& Synthesizer, bool bBinary, double Duration, const FString& OutputPath, const FString& TruthPath)
+    {
+        TArray<uint8> Bytes;
+        AppendText(Bytes, bBinary ? BinaryStartedReply : TextStartedReply);
+
+        Synthesizer.Reset();
+        while (Synthesizer.GetTime() < Duration)
+        {
+            AppendNextSample(Synthesizer, bBinary, Bytes);
+        }
+
+        if (!FFileHelper::SaveArrayToFile(Bytes, *OutputPath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("输出写入失败: %s"), *OutputPath);
+            return 1;
+        }
+        SaveTruth(TruthPath, Synthesizer);
+
+        UE_LOG(LogTemp, Display, TEXT("已生成 %.0fs（%s %.0fHz，%d 字节），%d 个 SCR，真值: %s"),
+               Duration, bBinary ? TEXT("二进制") : TEXT("文本"), Synthesizer.SampleRateHz, Bytes.Num(),
+               Synthesizer.GetGroundTruth().Num(), *TruthPath);
+        return 0;
+    }
+
+#if !PLATFORM_WINDOWS
+    int32 ServePty(FGsrSignalSynthesizer& Synthesizer, double Duration, const FString& TruthPath)
+    {
+        const int Master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (Master < 0 || grantpt(Master) != 0 || unlockpt(Master) != 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("无法创建伪终端"));
+            if (Master >= 0)
+            {
+                close(Master);
+            }
+            return 1;
+        }
+        const FString SlavePath = UTF8_TO_TCHAR(ptsname(Master));
+
+        // 自己保持从端打开，客户端断开重连时主端不会读到 EIO；
+        // 从端设为原始模式，否则输出会被回显成命令
+        const int Slave = open(TCHAR_TO_UTF8(*SlavePath), O_RDWR | O_NOCTTY);
+        termios Options = {};
+        if (Slave >= 0 && tcgetattr(Slave, &Options) == 0)
+        {
+            cfmakeraw(&Options);
+            tcsetattr(Slave, TCSANOW, &Options);
+        }
+
+        // 没有客户端读取时与真实串口一样直接丢数据，而不是阻塞
+        fcntl(Master, F_SETFL, fcntl(Master, F_GETFL) | O_NONBLOCK);
+
+        UE_LOG(LogTemp, Display, TEXT("GSR 模拟器已就绪: %s（填到 OSCReceiver 的 GsrSerialPort），等待 START / BINARY 命令"), *SlavePath);
+
+        bool bStreaming = false;
+        bool bBinary = false;
+        double StreamStart = 0.0;
+        int32 SavedTruth = 0;
+        TArray<ANSICHAR> Command;
+        TArray<uint8> Output;
+
+        auto HandleCommand = [&](FString Line)
+        {
+            Line.TrimStartAndEndInline();
+            Line.ToUpperInline();
+
+            if (Line == TEXT("START") || Line.StartsWith(TEXT("BINARY")))
+            {
+                bBinary = Line.StartsWith(TEXT("BINARY"));
+                const FString RateText = Line.RightChop(6).TrimStart();
+                Synthesizer.ConfigureForProtocol(bBinary, bBinary && !RateText.IsEmpty() ? FCString::Atoi(*RateText) : 100);
+                Synthesizer.Reset();
+                SavedTruth = 0;
+                bStreaming = true;
+                StreamStart = FPlatformTime::Seconds();
+                AppendText(Output, bBinary ? BinaryStartedReply : TextStartedReply);
+                UE_LOG(LogTemp, Display, TEXT("开始输出（%s %.0fHz）"), bBinary ? TEXT("二进制") : TEXT("文本"), Synthesizer.SampleRateHz);
+            }
+            else if (Line == TEXT("STOP"))
+            {
+                bStreaming = false;
+                AppendText(Output, StoppedReply);
+                SaveTruth(TruthPath, Synthesizer);
+                UE_LOG(LogTemp, Display, TEXT("停止输出，%d 个 SCR"), Synthesizer.GetGroundTruth().Num());
+            }
+        };
+
+        while (!IsEngineExitRequested())
+        {
+            // 等待命令，输出期间最多等到下一个样本
+            int TimeoutMs = 100;
+            if (bStreaming)
+            {
+                const double Wait = StreamStart + Synthesizer.GetTime() - FPlatformTime::Seconds();
+                TimeoutMs = FMath::Clamp(FMath::CeilToInt(Wait * 1000.0), 0, 100);
+            }
+
+            pollfd Poll = { Master, POLLIN, 0 };
+            if (poll(&Poll, 1, TimeoutMs) > 0 && (Poll.revents & POLLIN))
+            {
+                uint8 Buffer[256];
+                const ssize_t BytesRead = read(Master, Buffer, sizeof(Buffer));
+                for (ssize_t Index = 0; Index < BytesRead; Index++)
+                {
+                    const ANSICHAR Char = static_cast<ANSICHAR>(Buffer[Index]);
+                    if (Char == '\n')
+                    {
+                        Command.Add('\0');
+                        HandleCommand(FString(ANSI_TO_TCHAR(Command.GetData())));
+                        Command.Reset();
+                    }
+                    else if (Char != '\r' && Command.Num() < 64)
+                    {
+                        Command.Add(Char);
+                    }
+                }
+            }
+
+            if (bStreaming)
+            {
+                const double Now = FPlatformTime::Seconds();
+                while (StreamStart + Synthesizer.GetTime() <= Now)
+                {
+                    AppendNextSample(Synthesizer, bBinary, Output);
+                }
+
+                if (Duration > 0.0 && Synthesizer.GetTime() >= Duration)
+                {
+                    bStreaming = false;
+                    UE_LOG(LogTemp, Display, TEXT("已输出 %.0fs，模拟会话结束"), Duration);
+                }
+
+                // 真值随新的 SCR 更新，模拟器被中途关掉也不会丢
+                if (Synthesizer.GetGroundTruth().Num() != SavedTruth)
+                {
+                    SavedTruth = Synthesizer.GetGroundTruth().Num();
+                    SaveTruth(TruthPath, Synthesizer);
+                }
+            }
+
+            if (Output.Num() > 0)
+            {
+                const ssize_t Written = write(Master, Output.GetData(), static_cast<size_t>(Output.Num()));
+                (void)Written;
+                Output.Reset();
+            }
+        }
+
+        if (Slave >= 0)
+        {
+            close(Slave);
+        }
+        close(Master);
+        return 0;
+    }
+#endif
+}
+
+UGsrSimulatorCommandlet::UGsrSimulatorCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UGsrSimulatorCommandlet::Main(const FString& Params)
+{
+    FGsrSignalSynthesizer Synthesizer;
+    Synthesizer.ParseCommandLine(*Params);
+
+    const bool bBinary = FParse::Param(*Params, TEXT("Binary"));
+    int32 RateHz = 100;
+    double Duration = 0.0;
+    FString OutputPath;
+    FString TruthPath;
+    FParse::Value(*Params, TEXT("Rate="), RateHz);
+    FParse::Value(*Params, TEXT("Duration="), Duration);
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+    FParse::Value(*Params, TEXT("Truth="), TruthPath);
+
+    if (!OutputPath.IsEmpty())
+    {
+        if (TruthPath.IsEmpty())
+        {
+            TruthPath = FPaths::Combine(FPaths::GetPath(OutputPath), FPaths::GetBaseFilename(OutputPath) + TEXT("_truth.txt"));
+        }
+        Synthesizer.ConfigureForProtocol(bBinary, RateHz);
+        return WriteCapture(Synthesizer, bBinary, Duration > 0.0 ? Duration : 600.0, OutputPath, TruthPath);
+    }
+
+    if (FParse::Param(*Params, TEXT("Pty")))
+    {
+#if PLATFORM_WINDOWS
+        UE_LOG(LogTemp, Error, TEXT("-Pty 只支持 Linux/Mac；Windows 请用 -Output 生成数据文件"));
+        return 1;
+#else
+        if (TruthPath.IsEmpty())
+        {
+            TruthPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("GsrSimulatorTruth.txt"));
+        }
+        return ServePty(Synthesizer, Duration, TruthPath);
+#endif
+    }
+
+    UE_LOG(LogTemp, Error, TEXT("用法: -run=GsrSimulator (-Pty | -Output=<文件>) [-Duration=600] [-Binary] [-Rate=100] [-Seed=1] [-Onsets=10,20] [-Truth=<文件>]"));
+    return 1;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GsrSimulatorCommandlet.generated.h"
+
+/**
+ * 模拟 gsrpifudian.ino：用 FGsrSignalSynthesizer 生成皮肤电信号，按固件的串口协议输出
+ * -Pty（Linux/Mac）：创建伪终端并打印设备路径，把它填到 OSCReceiver 的 GsrSerialPort 即可，
+ *   响应 START / BINARY <Hz> / STOP 命令，实时输出
+ * -Output=<文件>：不等待命令，按 -Binary/-Rate 把 -Duration 秒的数据一次写入文件（比实时快）
+ * 两种方式都把 SCR 真值（设备时间，制表符分隔）写到 -Truth=<文件>（默认 <输出>_truth.txt 或 GsrSimulatorTruth.txt）
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=GsrSimulator (-Pty | -Output=<文件>) [-Duration=600]
+ *       [-Binary] [-Rate=100] [-Seed=1] [-Tonic=5] [-ScrPerMinute=6] [-Noise=0.003] [-Dropouts=0.2]
+ *       [-Onsets=10,20,35.5] [-Truth=<文件>]
+ */
+UCLASS()
+class WORKVOILENCEGAME_API UGsrSimulatorCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGsrSimulatorCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,542 @@
+#include "GsrSource.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "IPAddress.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if !PLATFORM_WINDOWS
+    /** termios 只能设置标准档位的波特率，其他值返回 false */
+    bool GetPosixSpeed(int32 BaudRate, speed_t& OutSpeed)
+    {
+        switch (BaudRate)
+        {
+        case 1200: OutSpeed = B1200; return true;
+        case 2400: OutSpeed = B2400; return true;
+        case 4800: OutSpeed = B4800; return true;
+        case 9600: OutSpeed = B9600; return true;
+        case 19200: OutSpeed = B19200; return true;
+        case 38400: OutSpeed = B38400; return true;
+        case 57600: OutSpeed = B57600; return true;
+        case 115200: OutSpeed = B115200; return true;
+        case 230400: OutSpeed = B230400; return true;
+#ifdef B460800
+        case 460800: OutSpeed = B460800; return true;
+#endif
+#ifdef B921600
+        case 921600: OutSpeed = B921600; return true;
+#endif
+        default: return false;
+        }
+    }
+#endif
+}
+
+// === 串口 ===
+
+class FGsrSerialSource : public FGsrSource
+{
+public:
+    FGsrSerialSource(const FString& InDevicePath, int32 InBaudRate, bool bInBinary, int32 InRateHz)
+        : FGsrSource(FString::Printf(TEXT("串口 %s @ %d%s"), *InDevicePath, InBaudRate,
+            bInBinary ? *FString::Printf(TEXT("（二进制 %dHz）"), InRateHz) : TEXT("")), bInBinary)
+        , DevicePath(InDevicePath)
+        , BaudRate(InBaudRate)
+        , StartCommand(bInBinary ? FString::Printf(TEXT("BINARY %d\n"), InRateHz) : FString(TEXT("START\n")))
+    {
+    }
+
+    virtual ~FGsrSerialSource() override
+    {
+        Shutdown();
+    }
+
+protected:
+#if PLATFORM_WINDOWS
+    virtual bool Open() override
+    {
+        // COM10 以上必须使用 \\.\ 前缀
+        const FString Path = DevicePath.StartsWith(TEXT("\\\\.\\")) ? DevicePath : TEXT("\\\\.\\") + DevicePath;
+        Handle = CreateFileW(*Path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (Handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        DCB Dcb = {};
+        Dcb.DCBlength = sizeof(Dcb);
+        GetCommState(Handle, &Dcb);
+        Dcb.BaudRate = static_cast<DWORD>(BaudRate);
+        Dcb.ByteSize = 8;
+        Dcb.Parity = NOPARITY;
+        Dcb.StopBits = ONESTOPBIT;
+        Dcb.fBinary = TRUE;
+        Dcb.fDtrControl = DTR_CONTROL_ENABLE;
+        Dcb.fRtsControl = RTS_CONTROL_ENABLE;
+        if (!SetCommState(Handle, &Dcb))
+        {
+            Close();
+            return false;
+        }
+
+        // 有数据立即返回，没有数据最多等 100ms
+        COMMTIMEOUTS Timeouts = {};
+        Timeouts.ReadIntervalTimeout = MAXDWORD;
+        Timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+        Timeouts.ReadTotalTimeoutConstant = 100;
+        Timeouts.WriteTotalTimeoutConstant = 100;
+        SetCommTimeouts(Handle, &Timeouts);
+        PurgeComm(Handle, PURGE_RXCLEAR | PURGE_TXCLEAR);
+        return true;
+    }
+
+    virtual void Close() override
+    {
+        if (Handle != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(Handle);
+            Handle = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    virtual int32 Read(uint8* Buffer, int32 BufferSize) override
+    {
+        DWORD BytesRead = 0;
+        if (!ReadFile(Handle, Buffer, static_cast<DWORD>(BufferSize), &BytesRead, nullptr))
+        {
+            return -1;
+        }
+        return static_cast<int32>(BytesRead);
+    }
+
+    virtual void SendStart() override
+    {
+        const FTCHARToUTF8 Command(*StartCommand);
+        DWORD BytesWritten = 0;
+        WriteFile(Handle, Command.Get(), static_cast<DWORD>(Command.Length()), &BytesWritten, nullptr);
+    }
+
+private:
+    HANDLE Handle = INVALID_HANDLE_VALUE;
+#else
+    virtual bool Open() override
+    {
+        Descriptor = open(TCHAR_TO_UTF8(*DevicePath), O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (Descriptor < 0)
+        {
+            return false;
+        }
+
+        termios Options = {};
+        if (tcgetattr(Descriptor, &Options) != 0)
+        {
+            Close();
+            return false;
+        }
+        cfmakeraw(&Options);
+        speed_t Speed = B115200;
+        if (!GetPosixSpeed(BaudRate, Speed))
+        {
+            Close();
+            return false;
+        }
+        cfsetispeed(&Options, Speed);
+        cfsetospeed(&Options, Speed);
+        Options.c_cflag |= CLOCAL | CREAD;
+        if (tcsetattr(Descriptor, TCSANOW, &Options) != 0)
+        {
+            Close();
+            return false;
+        }
+        tcflush(Descriptor, TCIOFLUSH);
+        return true;
+    }
+
+    virtual void Close() override
+    {
+        if (Descriptor >= 0)
+        {
+            close(Descriptor);
+            Descriptor = -1;
+        }
+    }
+
+    virtual int32 Read(uint8* Buffer, int32 BufferSize) override
+    {
+        pollfd Poll = { Descriptor, POLLIN, 0 };
+        const int Ready = poll(&Poll, 1, 100);
+        if (Ready <= 0)
+        {
+            return Ready == 0 ? 0 : -1;
+        }
+        if (Poll.revents & (POLLERR | POLLHUP | POLLNVAL))
+        {
+            // 设备被拔出，或 pty 的另一端已关闭
+            return -1;
+        }
+        const ssize_t BytesRead = read(Descriptor, Buffer, static_cast<size_t>(BufferSize));
+        return BytesRead > 0 ? static_cast<int32>(BytesRead) : -1;
+    }
+
+    virtual void SendStart() override
+    {
+        const FTCHARToUTF8 Command(*StartCommand);
+        const ssize_t Written = write(Descriptor, Command.Get(), static_cast<size_t>(Command.Length()));
+        (void)Written;
+    }
+
+private:
+    int Descriptor = -1;
+#endif
+
+    FString DevicePath;
+    int32 BaudRate;
+    FString StartCommand;
+};
+
+// === UDP 桥 ===
+
+class FGsrUdpSource : public FGsrSource
+{
+public:
+    explicit FGsrUdpSource(int32 InPort)
+        : FGsrSource(FString::Printf(TEXT("UDP 端口 %d"), InPort))
+        , Port(InPort)
+    {
+    }
+
+    virtual ~FGsrUdpSource() override
+    {
+        Shutdown();
+    }
+
+protected:
+    virtual bool Open() override
+    {
+        ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+        if (!SocketSubsystem)
+        {
+            return false;
+        }
+
+        Socket = SocketSubsystem->CreateSocket(NAME_DGram, TEXT("GsrUdpBridge"), false);
+        if (!Socket)
+        {
+            return false;
+        }
+
+        TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+        Address->SetAnyAddress();
+        Address->SetPort(Port);
+        Socket->SetReuseAddr(true);
+        if (!Socket->Bind(*Address))
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    virtual void Close() override
+    {
+        if (Socket)
+        {
+            Socket->Close();
+            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+            Socket = nullptr;
+        }
+    }
+
+    virtual int32 Read(uint8* Buffer, int32 BufferSize) override
+    {
+        if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(100)))
+        {
+            return 0;
+        }
+        int32 BytesRead = 0;
+        if (!Socket->Recv(Buffer, BufferSize - 1, BytesRead))
+        {
+            return -1;
+        }
+        // 每个数据报至少是完整的一行，补上换行以防桥接端省略
+        if (BytesRead > 0 && Buffer[BytesRead - 1] != '\n')
+        {
+            Buffer[BytesRead++] = '\n';
+        }
+        return BytesRead;
+    }
+
+private:
+    int32 Port;
+    FSocket* Socket = nullptr;
+};
+
+// === 合成信号 ===
+
+class FGsrSyntheticSource : public FGsrSource
+{
+public:
+    FGsrSyntheticSource(const FGsrSignalSynthesizer& InSynthesizer, bool bInBinary, const FString& InGroundTruthPath)
+        : FGsrSource(FString::Printf(TEXT("合成信号 %.0fHz%s"), InSynthesizer.SampleRateHz,
+            bInBinary ? TEXT("（二进制）") : TEXT("")), bInBinary)
+        , Synthesizer(InSynthesizer)
+        , GroundTruthPath(InGroundTruthPath)
+        , bSyntheticBinary(bInBinary)
+    {
+    }
+
+    virtual ~FGsrSyntheticSource() override
+    {
+        Shutdown();
+    }
+
+protected:
+    virtual bool Open() override
+    {
+        Synthesizer.Reset();
+        StartTime = FPlatformTime::Seconds();
+        return true;
+    }
+
+    virtual void Close() override
+    {
+        if (!GroundTruthPath.IsEmpty() && !FGsrSignalSynthesizer::SaveGroundTruth(GroundTruthPath, Synthesizer.GetGroundTruth()))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("GSR 合成信号真值写入失败: %s"), *GroundTruthPath);
+        }
+    }
+
+    virtual int32 Read(uint8* Buffer, int32 BufferSize) override
+    {
+        // 实时节奏：下一个样本还没到时间就等待（最多 100ms，与串口读取一致）
+        const double Wait = StartTime + Synthesizer.GetTime() - FPlatformTime::Seconds();
+        if (Wait > 0.0)
+        {
+            FPlatformProcess::Sleep(static_cast<float>(FMath::Min(Wait, 0.1)));
+            return 0;
+        }
+
+        // 一行文本最长约 40 字节，留出余量
+        constexpr int32 MaxRecordSize = 64;
+        const double Now = FPlatformTime::Seconds();
+        int32 Written = 0;
+        while (Written + MaxRecordSize <= BufferSize && StartTime + Synthesizer.GetTime() <= Now)
+        {
+            FGsrBinarySample Sample;
+            if (!Synthesizer.Next(Sample))
+            {
+                continue;
+            }
+
+            if (bSyntheticBinary)
+            {
+                uint8 Frame[FGsrBinaryDecoder::FrameSize];
+                Synthesizer.EncodeFrame(Sample, Frame);
+                FMemory::Memcpy(Buffer + Written, Frame, sizeof(Frame));
+                Written += sizeof(Frame);
+            }
+            else
+            {
+                const FTCHARToUTF8 Line(*FGsrSignalSynthesizer::FormatLine(Sample));
+                FMemory::Memcpy(Buffer + Written, Line.Get(), Line.Length());
+                Written += Line.Length();
+            }
+        }
+        return Written;
+    }
+
+private:
+    FGsrSignalSynthesizer Synthesizer;
+    FString GroundTruthPath;
+    bool bSyntheticBinary;
+    double StartTime = 0.0;
+};
+
+// === 通用部分 ===
+
+TUniquePtr<FGsrSource> FGsrSource::CreateSerial(const FString& DevicePath, int32 BaudRate, bool bBinary, int32 RateHz)
+{
+#if !PLATFORM_WINDOWS
+    // 不能静默改用相近的档位：与固件的波特率不一致时只会读到乱码
+    speed_t Speed;
+    if (!GetPosixSpeed(BaudRate, Speed))
+    {
+        UE_LOG(LogTemp, Error, TEXT("GSR 串口不支持波特率 %d，请使用标准档位（9600、19200、38400、57600、115200、230400 等）"), BaudRate);
+        return nullptr;
+    }
+#endif
+    return MakeUnique<FGsrSerialSource>(DevicePath, BaudRate, bBinary, FMath::Clamp(RateHz, 50, 200));
+}
+
+TUniquePtr<FGsrSource> FGsrSource::CreateUdp(int32 Port)
+{
+    return MakeUnique<FGsrUdpSource>(Port);
+}
+
+TUniquePtr<FGsrSource> FGsrSource::CreateSynthetic(const FGsrSignalSynthesizer& Synthesizer, bool bBinary, const FString& GroundTruthPath)
+{
+    return MakeUnique<FGsrSyntheticSource>(Synthesizer, bBinary, GroundTruthPath);
+}
+
+FGsrSource::~FGsrSource()
+{
+    // 派生类的析构函数已经调用 Shutdown（线程退出前不能销毁派生部分）
+    check(Thread == nullptr);
+}
+
+void FGsrSource::Start()
+{
+    if (Thread)
+    {
+        return;
+    }
+    bStopRequested = false;
+    Thread = FRunnableThread::Create(this, TEXT("GsrSource"), 0, TPri_AboveNormal);
+}
+
+void FGsrSource::Shutdown()
+{
+    if (Thread)
+    {
+        Stop();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+    }
+}
+
+uint32 FGsrSource::Run()
+{
+    uint8 Buffer[512];
+
+    while (!bStopRequested)
+    {
+        if (!Open())
+        {
+            // 设备未就绪，稍后重试
+            FPlatformProcess::Sleep(1.0f);
+            continue;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("GSR 已连接: %s"), *Description);
+        bConnected = true;
+        LineBuffer.Reset();
+        Decoder.Reset();
+        ClockAligner.Reset();
+        SendStart();
+
+        while (!bStopRequested)
+        {
+            const int32 BytesRead = Read(Buffer, sizeof(Buffer));
+            if (BytesRead < 0)
+            {
+                break;
+            }
+
+            if (bBinary)
+            {
+                FGsrBinarySample Binary;
+                for (int32 Index = 0; Index < BytesRead; Index++)
+                {
+                    if (Decoder.Feed(Buffer[Index], Binary))
+                    {
+                        HandleBinarySample(Binary);
+                    }
+                }
+                LostFrames = Decoder.GetLostFrames();
+                CrcErrors = Decoder.GetCrcErrors();
+                continue;
+            }
+
+            for (int32 Index = 0; Index < BytesRead; Index++)
+            {
+                const ANSICHAR Char = static_cast<ANSICHAR>(Buffer[Index]);
+                if (Char == '\n')
+                {
+                    LineBuffer.Add('\0');
+                    HandleLine(FString(ANSI_TO_TCHAR(LineBuffer.GetData())));
+                    LineBuffer.Reset();
+                }
+                else if (Char != '\r' && LineBuffer.Num() < 256)
+                {
+                    LineBuffer.Add(Char);
+                }
+            }
+        }
+
+        Close();
+        bConnected = false;
+        if (!bStopRequested)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("GSR 连接断开，准备重连: %s"), *Description);
+        }
+    }
+    return 0;
+}
+
+void FGsrSource::HandleLine(const FString& Line)
+{
+    const double ArrivalTime = FSensorClock::Now();
+
+    FGsrSample Sample;
+    if (!ParseLine(Line, Sample))
+    {
+        if (Line == TEXT("RECORDING_STARTED"))
+        {
+            // 设备时间从 START 重新起算
+            ClockAligner.Reset();
+        }
+        return;
+    }
+
+    Sample.Time = ClockAligner.Align(Sample.DeviceTimeMs / 1000.0, ArrivalTime);
+    Samples.Enqueue(Sample);
+}
+
+void FGsrSource::HandleBinarySample(const FGsrBinarySample& Binary)
+{
+    const double ArrivalTime = FSensorClock::Now();
+
+    FGsrSample Sample;
+    Sample.DeviceTimeMs = static_cast<int32>(Binary.DeviceTime * 1000.0);
+    Sample.Raw = FMath::RoundToInt(Binary.Raw);
+    Sample.Resistance = Binary.Resistance;
+    Sample.Conductance = Binary.Conductance;
+    Sample.Time = ClockAligner.Align(Binary.DeviceTime, ArrivalTime);
+    Samples.Enqueue(Sample);
+}
+
+bool FGsrSource::ParseLine(const FString& Line, FGsrSample& OutSample)
+{
+    if (!Line.StartsWith(TEXT("DATA:")))
+    {
+        return false;
+    }
+
+    TArray<FString> Fields;
+    Line.RightChop(5).ParseIntoArray(Fields, TEXT(","));
+    if (Fields.Num() != 4 || !Fields[0].IsNumeric() || !Fields[1].IsNumeric())
+    {
+        return false;
+    }
+
+    OutSample.DeviceTimeMs = FCString::Atoi(*Fields[0]);
+    OutSample.Raw = FCString::Atoi(*Fields[1]);
+    OutSample.Resistance = FCString::Atof(*Fields[2]);
+    OutSample.Conductance = FCString::Atof(*Fields[3]);
+    return true;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include "GsrBinaryDecoder.h"
+#include "GsrSignalSynthesizer.h"
+#include "SensorClock.h"
+#include "GsrSource.generated.h"
+
+class FRunnableThread;
+
+/** 一个 GSR 样本（gsrpifudian.ino 的一行 DATA 输出）*/
+USTRUCT(BlueprintType)
+struct FGsrSample
+{
+    GENERATED_BODY()
+
+    /** 共享传感器时钟上的时间（秒，见 FSensorClock）*/
+    UPROPERTY(BlueprintReadOnly, Category = "GSR")
+    double Time = 0.0;
+
+    /** 设备时间（毫秒，从 START 起算）*/
+    UPROPERTY(BlueprintReadOnly, Category = "GSR")
+    int32 DeviceTimeMs = 0;
+
+    /** ADC 原始值（0~1023）*/
+    UPROPERTY(BlueprintReadOnly, Category = "GSR")
+    int32 Raw = 0;
+
+    /** 皮肤电阻（kΩ）*/
+    UPROPERTY(BlueprintReadOnly, Category = "GSR")
+    float Resistance = 0.0f;
+
+    /** 皮肤电导（μS）*/
+    UPROPERTY(BlueprintReadOnly, Category = "GSR")
+    float Conductance = 0.0f;
+};
+
+/**
+ * GSR 数据源：在后台线程读取 gsrpifudian.ino 的文本输出（串口或 UDP 桥），
+ * 解析后按共享传感器时钟打时间戳，放入无锁队列由游戏线程取出
+ *
+ * 时间戳对齐：设备时间 + 偏移，偏移取"到达时间 - 设备时间"的下包络（传输延迟最小的样本最接近真实偏移），
+ * 并允许缓慢上漂以跟踪两边晶振的频率差，从而去掉串口/USB 带来的到达抖动
+ */
+class WORKVOILENCEGAME_API FGsrSource : public FRunnable
+{
+public:
+    /**
+     * 串口设备（Windows 为 COM3 之类，Linux/Mac 为 /dev/ttyUSB0 之类）
+     * 文本模式连接后发送 START；二进制模式发送 "BINARY <RateHz>"，按 FGsrBinaryDecoder 的帧格式解码
+     * Linux/Mac 只支持 termios 的标准波特率，其他值记录错误并返回 nullptr
+     */
+    static TUniquePtr<FGsrSource> CreateSerial(const FString& DevicePath, int32 BaudRate = 115200,
+        bool bBinary = false, int32 RateHz = 100);
+
+    /** UDP 桥：监听端口，每个数据报包含一行或多行与串口相同的文本 */
+    static TUniquePtr<FGsrSource> CreateUdp(int32 Port);
+
+    /**
+     * 合成信号（没有传感器时测试用）：按实时节奏生成与固件相同的文本行或二进制帧，走同一条解析路径
+     * GroundTruthPath 非空时，断开时把 SCR 真值（设备时间）写到该文件
+     */
+    static TUniquePtr<FGsrSource> CreateSynthetic(const FGsrSignalSynthesizer& Synthesizer, bool bBinary = false,
+        const FString& GroundTruthPath = FString());
+
+    virtual ~FGsrSource() override;
+
+    /** 启动后台线程（断开后自动重连）*/
+    void Start();
+
+    /** 停止并等待后台线程退出 */
+    void Shutdown();
+
+    /** 游戏线程取出一个样本 */
+    bool DequeueSample(FGsrSample& OutSample) { return Samples.Dequeue(OutSample); }
+
+    bool IsConnected() const { return bConnected; }
+
+    const FString& GetDescription() const { return Description; }
+
+    /** 二进制模式下的丢帧数与 CRC 错误数（后台线程写入，仅用于统计显示）*/
+    int64 GetLostFrames() const { return LostFrames; }
+    int64 GetCrcErrors() const { return CrcErrors; }
+
+    /** 解析一行 "DATA:时间(ms),原始值,电阻(kΩ),电导(μS)"，其他行返回 false */
+    static bool ParseLine(const FString& Line, FGsrSample& OutSample);
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override { bStopRequested = true; }
+
+protected:
+    explicit FGsrSource(const FString& InDescription, bool bInBinary = false)
+        : Description(InDescription)
+        , bBinary(bInBinary)
+    {
+    }
+
+    // === 传输层（只在后台线程调用）===
+
+    virtual bool Open() = 0;
+    virtual void Close() = 0;
+
+    /** 读取数据，最多阻塞约 100ms；返回读到的字节数，出错返回 -1 */
+    virtual int32 Read(uint8* Buffer, int32 BufferSize) = 0;
+
+    /** 连接后发送的启动命令（UDP 桥不需要）*/
+    virtual void SendStart() {}
+
+private:
+    void HandleLine(const FString& Line);
+
+    void HandleBinarySample(const FGsrBinarySample& Binary);
+
+    FString Description;
+    bool bBinary;
+    FRunnableThread* Thread = nullptr;
+    TAtomic<bool> bStopRequested { false };
+    TAtomic<bool> bConnected { false };
+
+    TQueue<FGsrSample, EQueueMode::Spsc> Samples;
+
+    // 行缓冲与时间对齐状态（后台线程独占）
+    TArray<ANSICHAR> LineBuffer;
+    FGsrBinaryDecoder Decoder;
+    FDeviceClockAligner ClockAligner;
+
+    TAtomic<int64> LostFrames { 0 };
+    TAtomic<int64> CrcErrors { 0 };
+};
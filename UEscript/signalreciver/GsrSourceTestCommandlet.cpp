@@ -0,0 +1,402 @@
+#include "GsrSourceTestCommandlet.h"
+#include "GsrSource.h"
+#include "GsrBinaryDecoder.h"
+#include "SensorClock.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#if !PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    int32 Failures = 0;
+
+    void Check(bool bCondition, const TCHAR* What)
+    {
+        if (!bCondition)
+        {
+            Failures++;
+            UE_LOG(LogTemp, Error, TEXT("失败: %s"), What);
+        }
+    }
+
+    /**
+     * 解码器的字节流测试（不需要串口）：在帧之间插入文本行、孤立的同步字节、CRC 错误帧和被截断的半帧，
+     * 跳过几个序号，并让序号和 micros 都跨过回绕；字节流按随机长度分块送入，帧会被拆在两次读取之间
+     */
+    void TestDecoderStream()
+    {
+        constexpr int32 FrameCount = 300;
+        constexpr uint32 PeriodUs = 5000;
+        const uint32 StartUs = 0xFFFFFFFFu - 100 * PeriodUs;
+
+        auto AppendFrame = [](TArray<uint8>& Stream, int32 Index, uint32 TimestampUs)
+        {
+            uint8 Frame[FGsrBinaryDecoder::FrameSize];
+            FGsrBinaryDecoder::EncodeFrame(static_cast<uint8>(Index), 8, static_cast<uint16>((Index % 1000) * 8 + 4), TimestampUs, Frame);
+            Stream.Append(Frame, sizeof(Frame));
+        };
+
+        TArray<uint8> Stream;
+        TArray<int32> Expected;
+        int32 ExpectedCrcErrors = 0;
+        for (int32 Index = 0; Index < FrameCount; Index++)
+        {
+            const uint32 TimestampUs = StartUs + static_cast<uint32>(Index) * PeriodUs;
+            if (Index == 10)
+            {
+                const ANSICHAR* Reply = "BINARY_STARTED\n";
+                Stream.Append(reinterpret_cast<const uint8*>(Reply), FCStringAnsi::Strlen(Reply));
+            }
+            else if (Index == 20)
+            {
+                // 孤立的同步字节和错误的第二个同步字节
+                const uint8 Junk[] = { FGsrBinaryDecoder::Sync0, 0x00, FGsrBinaryDecoder::Sync0, FGsrBinaryDecoder::Sync0 };
+                Stream.Append(Junk, UE_ARRAY_COUNT(Junk));
+            }
+            else if (Index == 30)
+            {
+                // 同一帧的损坏副本：CRC 错误后从下一个同步字节重新对齐
+                AppendFrame(Stream, Index, TimestampUs);
+                Stream[Stream.Num() - 5] ^= 0x10;
+                ExpectedCrcErrors++;
+            }
+            else if (Index == 40)
+            {
+                // 半帧（例如上电时从中间开始读）：真正的帧头落在已缓冲的字节里
+                AppendFrame(Stream, Index, TimestampUs);
+                Stream.SetNum(Stream.Num() - 5);
+                ExpectedCrcErrors++;
+            }
+            else if (Index >= 50 && Index < 53)
+            {
+                // 丢失的帧
+                continue;
+            }
+
+            AppendFrame(Stream, Index, TimestampUs);
+            Expected.Add(Index);
+        }
+
+        FGsrBinaryDecoder Decoder;
+        FRandomStream Random(7);
+        TArray<FGsrBinarySample> Decoded;
+        for (int32 Offset = 0; Offset < Stream.Num();)
+        {
+            const int32 ChunkSize = FMath::Min(Random.RandRange(1, 32), Stream.Num() - Offset);
+            FGsrBinarySample Sample;
+            for (int32 Index = Offset; Index < Offset + ChunkSize; Index++)
+            {
+                if (Decoder.Feed(Stream[Index], Sample))
+                {
+                    Decoded.Add(Sample);
+                }
+            }
+            Offset += ChunkSize;
+        }
+
+        Check(Decoded.Num() == Expected.Num(), *FString::Printf(TEXT("解码器解出 %d 帧（期望 %d）"), Decoded.Num(), Expected.Num()));
+        Check(Decoder.GetFrameCount() == Expected.Num(), TEXT("解码器的帧计数"));
+        Check(Decoder.GetCrcErrors() == ExpectedCrcErrors, *FString::Printf(TEXT("解码器统计 %lld 个 CRC 错误（期望 %d）"), Decoder.GetCrcErrors(), ExpectedCrcErrors));
+        Check(Decoder.GetLostFrames() == 3, *FString::Printf(TEXT("解码器统计 %lld 个丢帧（期望 3）"), Decoder.GetLostFrames()));
+
+        const int32 Compared = FMath::Min(Decoded.Num(), Expected.Num());
+        for (int32 Index = 0; Index < Compared; Index++)
+        {
+            const int32 Frame = Expected[Index];
+            Check(FMath::IsNearlyEqual(Decoded[Index].Raw, Frame % 1000 + 0.5f, 1e-3f), TEXT("解码器的原始值（累加值 / 次数）"));
+            const double ExpectedTime = Decoded[0].DeviceTime + (Frame - Expected[0]) * PeriodUs * 1.0e-6;
+            Check(FMath::Abs(Decoded[Index].DeviceTime - ExpectedTime) < 1.0e-6, TEXT("解码器的设备时间跨过 micros 回绕后连续"));
+        }
+    }
+
+#if !PLATFORM_WINDOWS
+    /** 伪终端主端扮演设备，FGsrSource 打开从端 */
+    struct FTestPty
+    {
+        int Master = -1;
+        int Slave = -1;
+        FString SlavePath;
+
+        bool Open()
+        {
+            Master = posix_openpt(O_RDWR | O_NOCTTY);
+            if (Master < 0 || grantpt(Master) != 0 || unlockpt(Master) != 0)
+            {
+                return false;
+            }
+            SlavePath = UTF8_TO_TCHAR(ptsname(Master));
+
+            // 与 GsrSimulator 相同：自己保持从端打开并设为原始模式，避免回显和 EIO
+            Slave = open(TCHAR_TO_UTF8(*SlavePath), O_RDWR | O_NOCTTY);
+            termios Options = {};
+            if (Slave < 0 || tcgetattr(Slave, &Options) != 0)
+            {
+                return false;
+            }
+            cfmakeraw(&Options);
+            return tcsetattr(Slave, TCSANOW, &Options) == 0;
+        }
+
+        /** 模拟拔出设备：关闭两端后从端的读取收到 POLLHUP */
+        void Close()
+        {
+            if (Slave >= 0)
+            {
+                close(Slave);
+                Slave = -1;
+            }
+            if (Master >= 0)
+            {
+                close(Master);
+                Master = -1;
+            }
+        }
+
+        ~FTestPty()
+        {
+            Close();
+        }
+
+        void Write(const uint8* Data, int32 Length)
+        {
+            while (Length > 0)
+            {
+                const ssize_t Written = write(Master, Data, static_cast<size_t>(Length));
+                if (Written <= 0)
+                {
+                    return;
+                }
+                Data += Written;
+                Length -= static_cast<int32>(Written);
+            }
+        }
+
+        void Write(const ANSICHAR* Text)
+        {
+            Write(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text));
+        }
+
+        /** 读取 FGsrSource 发来的一行命令，超时返回空字符串 */
+        FString ReadCommand(double TimeoutSeconds)
+        {
+            TArray<ANSICHAR> Line;
+            const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+            while (FPlatformTime::Seconds() < Deadline)
+            {
+                pollfd Poll = { Master, POLLIN, 0 };
+                if (poll(&Poll, 1, 50) <= 0 || !(Poll.revents & POLLIN))
+                {
+                    continue;
+                }
+                ANSICHAR Char = 0;
+                if (read(Master, &Char, 1) != 1)
+                {
+                    continue;
+                }
+                if (Char == '\n')
+                {
+                    Line.Add('\0');
+                    return FString(ANSI_TO_TCHAR(Line.GetData()));
+                }
+                Line.Add(Char);
+            }
+            return FString();
+        }
+    };
+
+    /** 等待直到收到 Count 个样本或超时 */
+    void WaitForSamples(FGsrSource& Source, int32 Count, TArray<FGsrSample>& OutSamples, double TimeoutSeconds = 3.0)
+    {
+        const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+        FGsrSample Sample;
+        while (OutSamples.Num() < Count && FPlatformTime::Seconds() < Deadline)
+        {
+            if (Source.DequeueSample(Sample))
+            {
+                OutSamples.Add(Sample);
+            }
+            else
+            {
+                FPlatformProcess::Sleep(0.005f);
+            }
+        }
+        // 多出的样本也要取出，用于检查没有把杂行解析成样本
+        FPlatformProcess::Sleep(0.2f);
+        while (Source.DequeueSample(Sample))
+        {
+            OutSamples.Add(Sample);
+        }
+    }
+
+    /** 时间戳在共享时钟上单调，且落在写入前后的时钟范围内 */
+    void CheckTimestamps(const TArray<FGsrSample>& Samples, double ClockBefore, double ClockAfter)
+    {
+        for (int32 Index = 0; Index < Samples.Num(); Index++)
+        {
+            Check(Samples[Index].Time >= ClockBefore && Samples[Index].Time <= ClockAfter, TEXT("样本时间落在写入期间的传感器时钟范围内"));
+            if (Index > 0)
+            {
+                Check(Samples[Index].Time > Samples[Index - 1].Time, TEXT("样本时间单调递增"));
+            }
+        }
+    }
+
+    void WaitForDisconnect(FGsrSource& Source, FTestPty& Pty)
+    {
+        Pty.Close();
+        const double Deadline = FPlatformTime::Seconds() + 2.0;
+        while (Source.IsConnected() && FPlatformTime::Seconds() < Deadline)
+        {
+            FPlatformProcess::Sleep(0.01f);
+        }
+        Check(!Source.IsConnected(), TEXT("设备断开后 IsConnected 变为 false"));
+    }
+
+    void TestTextStream()
+    {
+        FTestPty Pty;
+        if (!Pty.Open())
+        {
+            Check(false, TEXT("创建伪终端（文本模式）"));
+            return;
+        }
+
+        TUniquePtr<FGsrSource> Source = FGsrSource::CreateSerial(Pty.SlavePath, 115200, false);
+        Source->Start();
+        Check(Pty.ReadCommand(3.0) == TEXT("START"), TEXT("文本模式连接后发送 START"));
+        Check(Source->IsConnected(), TEXT("文本模式已连接"));
+
+        // 串口 USB 转换会把一行拆成多次读取；固件的提示行、空行和损坏的行都不产生样本
+        const double ClockBefore = FSensorClock::Now();
+        Pty.Write("RECORDING_STARTED\r\nHEADER:Time(ms),GSR_Raw,GSR_Resistance(kohm),GSR_Conductance(uS)\r\n\r\n");
+        const int32 SampleCount = 20;
+        for (int32 Index = 0; Index < SampleCount; Index++)
+        {
+            const FTCHARToUTF8 Line(*FString::Printf(TEXT("DATA:%d,%d,%.2f,%.3f\r\n"), Index * 10, 500 + Index, 100.0f + Index, 10.0f - Index * 0.1f));
+            const int32 Split = Index % 3 == 0 ? Line.Length() / 2 : Line.Length();
+            Pty.Write(reinterpret_cast<const uint8*>(Line.Get()), Split);
+            if (Split < Line.Length())
+            {
+                FPlatformProcess::Sleep(0.005f);
+                Pty.Write(reinterpret_cast<const uint8*>(Line.Get()) + Split, Line.Length() - Split);
+            }
+            if (Index == SampleCount / 2)
+            {
+                Pty.Write("DATA:x,1,2,3\nDATA:1,2\nnoise\n");
+            }
+            FPlatformProcess::Sleep(0.01f);
+        }
+
+        TArray<FGsrSample> Samples;
+        WaitForSamples(*Source, SampleCount, Samples);
+        const double ClockAfter = FSensorClock::Now();
+
+        Check(Samples.Num() == SampleCount, *FString::Printf(TEXT("文本模式收到 %d 个样本（期望 %d）"), Samples.Num(), SampleCount));
+        for (int32 Index = 0; Index < FMath::Min(Samples.Num(), SampleCount); Index++)
+        {
+            Check(Samples[Index].DeviceTimeMs == Index * 10 && Samples[Index].Raw == 500 + Index, TEXT("文本样本的设备时间和原始值"));
+            Check(FMath::IsNearlyEqual(Samples[Index].Resistance, 100.0f + Index, 0.01f), TEXT("文本样本的电阻"));
+        }
+        CheckTimestamps(Samples, ClockBefore, ClockAfter);
+
+        WaitForDisconnect(*Source, Pty);
+        Source->Shutdown();
+    }
+
+    void TestBinaryStream()
+    {
+        FTestPty Pty;
+        if (!Pty.Open())
+        {
+            Check(false, TEXT("创建伪终端（二进制模式）"));
+            return;
+        }
+
+        TUniquePtr<FGsrSource> Source = FGsrSource::CreateSerial(Pty.SlavePath, 115200, true, 100);
+        Source->Start();
+        Check(Pty.ReadCommand(3.0) == TEXT("BINARY 100"), TEXT("二进制模式连接后发送 BINARY 100"));
+
+        // 固件回复的文本行出现在第一帧之前，解码器靠同步字节跳过
+        const double ClockBefore = FSensorClock::Now();
+        Pty.Write("BINARY_STARTED\n");
+        const int32 FrameCount = 20;
+        for (int32 Index = 0; Index < FrameCount; Index++)
+        {
+            uint8 Frame[FGsrBinaryDecoder::FrameSize];
+            FGsrBinaryDecoder::EncodeFrame(static_cast<uint8>(Index), 4, static_cast<uint16>((400 + Index) * 4), 1000000u + Index * 10000u, Frame);
+            if (Index == 5)
+            {
+                // 损坏的一帧：CRC 错误，不产生样本
+                uint8 Corrupted[FGsrBinaryDecoder::FrameSize];
+                FMemory::Memcpy(Corrupted, Frame, sizeof(Frame));
+                Corrupted[4] ^= 0x01;
+                Pty.Write(Corrupted, sizeof(Corrupted));
+            }
+            if (Index % 4 == 1)
+            {
+                Pty.Write(Frame, 3);
+                FPlatformProcess::Sleep(0.005f);
+                Pty.Write(Frame + 3, sizeof(Frame) - 3);
+            }
+            else
+            {
+                Pty.Write(Frame, sizeof(Frame));
+            }
+            FPlatformProcess::Sleep(0.01f);
+        }
+
+        TArray<FGsrSample> Samples;
+        WaitForSamples(*Source, FrameCount, Samples);
+        const double ClockAfter = FSensorClock::Now();
+
+        Check(Samples.Num() == FrameCount, *FString::Printf(TEXT("二进制模式收到 %d 个样本（期望 %d）"), Samples.Num(), FrameCount));
+        for (int32 Index = 0; Index < FMath::Min(Samples.Num(), FrameCount); Index++)
+        {
+            Check(Samples[Index].Raw == 400 + Index, TEXT("二进制样本的原始值（累加值 / 次数）"));
+            Check(Samples[Index].DeviceTimeMs == 1000 + Index * 10, TEXT("二进制样本的设备时间"));
+            Check(Samples[Index].Conductance > 0.0f, TEXT("二进制样本在上位机换算电导"));
+        }
+        CheckTimestamps(Samples, ClockBefore, ClockAfter);
+        Check(Source->GetCrcErrors() == 1, TEXT("二进制模式统计 1 个 CRC 错误"));
+        Check(Source->GetLostFrames() == 0, TEXT("二进制模式没有丢帧"));
+
+        WaitForDisconnect(*Source, Pty);
+        Source->Shutdown();
+    }
+#endif
+}
+
+UGsrSourceTestCommandlet::UGsrSourceTestCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UGsrSourceTestCommandlet::Main(const FString& Params)
+{
+    Failures = 0;
+    TestDecoderStream();
+
+#if PLATFORM_WINDOWS
+    UE_LOG(LogTemp, Warning, TEXT("串口测试需要伪终端，只支持 Linux/Mac，已跳过"));
+#else
+    Check(!FGsrSource::CreateSerial(TEXT("/dev/null"), 12345).IsValid(), TEXT("不支持的波特率返回 nullptr"));
+    Check(FGsrSource::CreateSerial(TEXT("/dev/null"), 57600).IsValid(), TEXT("标准波特率可以创建"));
+
+    TestTextStream();
+    TestBinaryStream();
+#endif
+
+    UE_LOG(LogTemp, Display, TEXT("GsrSourceTest: %s（%d 个失败）"), Failures == 0 ? TEXT("通过") : TEXT("失败"), Failures);
+    return Failures > 0 ? 1 : 0;
+}
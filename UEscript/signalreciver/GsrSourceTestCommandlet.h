@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GsrSourceTestCommandlet.generated.h"
+
+/**
+ * GSR 采集的测试
+ * - FGsrBinaryDecoder：模拟的串口字节流，包含重新同步、CRC 错误帧、拆开的帧、丢帧以及序号和 micros 回绕
+ * - FGsrSource（只在 Linux/Mac）：用伪终端代替 gsrpifudian.ino，走真实的串口读取线程，
+ *   检查启动命令、文本行的拆分/杂行/\r\n、二进制帧的解码、传感器时钟时间戳，以及设备断开后的状态
+ * 任一检查失败时返回 1
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=GsrSourceTest
+ */
+UCLASS()
+class WORKVOILENCEGAME_API UGsrSourceTestCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGsrSourceTestCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,391 @@
+#include "HandleStreamTestCommandlet.h"
+#include "FrameSequenceTracker.h"
+#include "TransmitModeScheduler.h"
+
+namespace
+{
+    int32 Failures = 0;
+
+    void Check(bool bCondition, const FString& What)
+    {
+        if (!bCondition)
+        {
+            Failures++;
+            UE_LOG(LogTemp, Error, TEXT("失败: %s"), *What);
+        }
+    }
+
+    // 摇杆 X、摇杆 Y、压力2（量化步长与固件 channelEpsilon 相同）
+    constexpr int32 NumChannels = 3;
+    const float ChannelEpsilon[NumChannels] = { 0.01f, 0.01f, 0.005f };
+
+    // 时间都用微秒整数，和固件的 micros() 一样按固定节拍推进
+    constexpr int64 StepUs = 2000;
+    constexpr int64 GameFrameUs = 16000;
+    constexpr int64 StatusIntervalUs = 1000000;
+
+    int64 Quantize(float Value, int32 Channel)
+    {
+        return FMath::RoundToInt(Value / ChannelEpsilon[Channel]);
+    }
+
+    struct FSimFrame
+    {
+        int32 Sequence = 0;
+        bool bKeyframe = false;
+        int32 ChannelMask = 0;
+        float Values[NumChannels] = {};
+        int32 BatchSamples = 0;
+    };
+
+    /** 固件的发送规则：TransmitControl（节拍、模式、关键帧）+ sendFrame（增量通道、批量样本） */
+    struct FSimulatedHandle
+    {
+        bool bTrial = false;
+        int64 IdleIntervalUs = 100000;
+        int64 TrialIntervalUs = 2000;
+        int64 KeyframeIntervalUs = 1000000;
+        bool bKeyframeRequested = true;
+
+        int64 LastTickUs = 0;
+        int64 LastKeyframeUs = 0;
+        int32 Sequence = 0;
+        int32 PendingSamples = 0;
+        int64 LastSentQuantized[NumChannels] = {};
+
+        void SetMode(bool bNewTrial)
+        {
+            bTrial = bNewTrial;
+            bKeyframeRequested = true;
+        }
+
+        /** 每个 500Hz 采样节拍调用一次；到了发送周期且有内容时返回 true */
+        bool Tick(int64 NowUs, const float Values[NumChannels], FSimFrame& OutFrame)
+        {
+            // 定时采样不受发送频率影响，试次模式的帧附带自上一帧以来的样本
+            if (bTrial)
+            {
+                PendingSamples++;
+            }
+
+            const int64 IntervalUs = bTrial ? TrialIntervalUs : IdleIntervalUs;
+            if (NowUs - LastTickUs < IntervalUs)
+            {
+                return false;
+            }
+            LastTickUs += IntervalUs;
+            if (NowUs - LastTickUs >= IntervalUs)
+            {
+                LastTickUs = NowUs;
+            }
+
+            const bool bKeyframe = bTrial || bKeyframeRequested || NowUs - LastKeyframeUs >= KeyframeIntervalUs;
+            OutFrame = FSimFrame();
+            for (int32 Channel = 0; Channel < NumChannels; Channel++)
+            {
+                const int64 Quantized = Quantize(Values[Channel], Channel);
+                if (bKeyframe || Quantized != LastSentQuantized[Channel])
+                {
+                    OutFrame.ChannelMask |= 1 << Channel;
+                    OutFrame.Values[Channel] = Values[Channel];
+                    LastSentQuantized[Channel] = Quantized;
+                }
+            }
+            OutFrame.BatchSamples = bTrial ? PendingSamples : 0;
+            PendingSamples = 0;
+            if (OutFrame.ChannelMask == 0 && OutFrame.BatchSamples == 0)
+            {
+                return false;
+            }
+
+            if (bKeyframe)
+            {
+                LastKeyframeUs = NowUs;
+                bKeyframeRequested = false;
+            }
+            OutFrame.Sequence = ++Sequence;
+            OutFrame.bKeyframe = bKeyframe;
+            return true;
+        }
+    };
+
+    /** 接收端：与 AOSCReceiver 相同，通道值在帧之间保持，帧结束时交给序号跟踪 */
+    struct FReceiver
+    {
+        FFrameSequenceTracker Tracker;
+        FTransmitModeScheduler Scheduler;
+        float Values[NumChannels] = {};
+
+        /** 返回是否需要请求关键帧 */
+        bool ReceiveFrame(const FSimFrame& Frame, int64 NowUs)
+        {
+            for (int32 Channel = 0; Channel < NumChannels; Channel++)
+            {
+                if (Frame.ChannelMask & (1 << Channel))
+                {
+                    Values[Channel] = Frame.Values[Channel];
+                }
+            }
+            return Tracker.EndFrame(Frame.Sequence, Frame.bKeyframe, NowUs * 1.0e-6f).bNeedKeyframe;
+        }
+
+        /** 接收端重建的状态与手柄最近发出的值一致 */
+        bool MatchesHandle(const FSimulatedHandle& Handle) const
+        {
+            for (int32 Channel = 0; Channel < NumChannels; Channel++)
+            {
+                if (Quantize(Values[Channel], Channel) != Handle.LastSentQuantized[Channel])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    enum class ECommand : uint8 { Mode, Keyframe };
+
+    struct FPendingCommand
+    {
+        int64 DeliverUs = 0;
+        ECommand Type = ECommand::Mode;
+        bool bTrial = false;
+    };
+
+    /** 测试用的输入信号：摇杆 X 在 1.0~1.3 秒推到 0.8，在丢包期间（1.4~1.6 秒）回到 0.2；摇杆 Y 在 1.4~2.0 秒缓慢移动 */
+    void SignalAt(int64 NowUs, float OutValues[NumChannels])
+    {
+        const double Time = NowUs * 1.0e-6;
+        auto Ramp = [Time](double Start, double End, float From, float To)
+        {
+            const double Alpha = FMath::Clamp((Time - Start) / (End - Start), 0.0, 1.0);
+            return static_cast<float>(From + (To - From) * Alpha);
+        };
+        OutValues[0] = Time < 1.4 ? Ramp(1.0, 1.3, 0.0f, 0.8f) : Ramp(1.4, 1.6, 0.8f, 0.2f);
+        OutValues[1] = Ramp(1.4, 2.0, 0.0f, 0.3f);
+        OutValues[2] = 0.0f;
+    }
+
+    // 场景的时间点（秒）
+    constexpr int64 LossStartUs = 1450000;
+    constexpr int64 LossEndUs = 1650000;
+    constexpr int64 StimulusUs = 3000000;
+    constexpr int64 PhaseBeginUs = 12000000;
+    constexpr int64 PhaseEndUs = 15000000;
+    constexpr int64 EndUs = 16000000;
+
+    void TestStream()
+    {
+        FSimulatedHandle Handle;
+        FReceiver Receiver;
+        TArray<FPendingCommand> Commands;
+        bool bDropNextModeCommand = false;
+
+        // 统计
+        int32 IdleStaticFrames = 0;
+        int32 IdleMovingDeltaFrames = 0;
+        int32 TrialFrames = 0;
+        int32 TrialKeyframes = 0;
+        int32 TrialBatchSamples = 0;
+        int32 LateIdleFrames = 0;
+        int32 KeyframeRequests = 0;
+        int64 GapDetectedUs = -1;
+        int64 ResyncUs = -1;
+        bool bStaleAtGap = false;
+        bool bMatchedAfterResync = false;
+        int64 TrialEnteredUs = -1;
+        int64 IdleReturnedUs = -1;
+        int64 PhaseTrialUs = -1;
+        int64 PhaseIdleUs = -1;
+        int32 ModeCommandsSent = 0;
+
+        auto SendCommand = [&](int64 NowUs, ECommand Type, bool bTrial)
+        {
+            if (Type == ECommand::Mode)
+            {
+                ModeCommandsSent++;
+                if (bDropNextModeCommand)
+                {
+                    bDropNextModeCommand = false;
+                    return;
+                }
+            }
+            Commands.Add({ NowUs + StepUs, Type, bTrial });
+        };
+
+        int64 LastStatusUs = 0;
+        bool bPendingStatus = false;
+        float Values[NumChannels];
+        for (int64 NowUs = 0; NowUs <= EndUs; NowUs += StepUs)
+        {
+            // 手柄：处理到达的指令，模式变化后立即报告状态
+            for (int32 Index = 0; Index < Commands.Num();)
+            {
+                if (Commands[Index].DeliverUs > NowUs)
+                {
+                    Index++;
+                    continue;
+                }
+                if (Commands[Index].Type == ECommand::Mode)
+                {
+                    Handle.SetMode(Commands[Index].bTrial);
+                    bPendingStatus = true;
+                }
+                else
+                {
+                    Handle.bKeyframeRequested = true;
+                }
+                Commands.RemoveAt(Index);
+            }
+            if (bPendingStatus || NowUs - LastStatusUs >= StatusIntervalUs)
+            {
+                Receiver.Scheduler.NoteReportedMode(Handle.bTrial);
+                LastStatusUs = NowUs;
+                bPendingStatus = false;
+            }
+
+            // 手柄发送一帧，链路在丢包区间内丢掉所有帧
+            SignalAt(NowUs, Values);
+            FSimFrame Frame;
+            if (Handle.Tick(NowUs, Values, Frame))
+            {
+                if (Handle.bTrial)
+                {
+                    if (NowUs >= StimulusUs + 200000 && NowUs < StimulusUs + 1200000)
+                    {
+                        TrialFrames++;
+                        TrialKeyframes += Frame.bKeyframe ? 1 : 0;
+                        TrialBatchSamples += Frame.BatchSamples;
+                    }
+                }
+                else if (NowUs >= 500000 && NowUs < 950000)
+                {
+                    IdleStaticFrames++;
+                }
+                else if (NowUs >= 1050000 && NowUs < 1350000 && !Frame.bKeyframe)
+                {
+                    IdleMovingDeltaFrames++;
+                }
+                else if (NowUs >= 9600000 && NowUs < 9950000)
+                {
+                    LateIdleFrames++;
+                }
+
+                const bool bLost = NowUs >= LossStartUs && NowUs < LossEndUs;
+                if (!bLost)
+                {
+                    const bool bHadGap = Receiver.Tracker.GetLostFrames() > 0;
+                    const bool bNeedKeyframe = Receiver.ReceiveFrame(Frame, NowUs);
+                    if (!bHadGap && Receiver.Tracker.GetLostFrames() > 0)
+                    {
+                        GapDetectedUs = NowUs;
+                        bStaleAtGap = !Receiver.MatchesHandle(Handle);
+                    }
+                    if (bNeedKeyframe)
+                    {
+                        KeyframeRequests++;
+                        SendCommand(NowUs, ECommand::Keyframe, false);
+                    }
+                    if (GapDetectedUs >= 0 && ResyncUs < 0 && Receiver.Tracker.IsSynchronized())
+                    {
+                        ResyncUs = NowUs;
+                        bMatchedAfterResync = Receiver.MatchesHandle(Handle);
+                    }
+                }
+            }
+
+            // 游戏线程：刺激标记、试次阶段，每帧更新一次传输模式
+            if (NowUs == StimulusUs)
+            {
+                Receiver.Scheduler.NoteTrialMarker(NowUs * 1.0e-6);
+            }
+            if (NowUs == PhaseBeginUs)
+            {
+                // 这一次的模式指令在链路上丢失，需要靠状态报告发现并重发
+                Receiver.Scheduler.SetTrialPhase(true);
+                bDropNextModeCommand = true;
+            }
+            if (NowUs == PhaseEndUs)
+            {
+                Receiver.Scheduler.SetTrialPhase(false);
+            }
+            if (NowUs % GameFrameUs == 0)
+            {
+                bool bTrial = false;
+                if (Receiver.Scheduler.Update(NowUs * 1.0e-6, bTrial))
+                {
+                    SendCommand(NowUs, ECommand::Mode, bTrial);
+                }
+            }
+
+            // 模式切换的时刻
+            if (Handle.bTrial && NowUs >= StimulusUs && NowUs < PhaseBeginUs && TrialEnteredUs < 0)
+            {
+                TrialEnteredUs = NowUs;
+            }
+            if (!Handle.bTrial && TrialEnteredUs >= 0 && NowUs < PhaseBeginUs && IdleReturnedUs < 0)
+            {
+                IdleReturnedUs = NowUs;
+            }
+            if (Handle.bTrial && NowUs >= PhaseBeginUs && PhaseTrialUs < 0)
+            {
+                PhaseTrialUs = NowUs;
+            }
+            if (!Handle.bTrial && NowUs >= PhaseEndUs && PhaseIdleUs < 0)
+            {
+                PhaseIdleUs = NowUs;
+            }
+        }
+
+        // 上电空闲：静止时只有定期关键帧，移动时发送增量帧
+        Check(IdleStaticFrames <= 1, FString::Printf(TEXT("空闲静止 0.45 秒内发送 %d 帧（期望不超过 1 个关键帧）"), IdleStaticFrames));
+        Check(IdleMovingDeltaFrames >= 2, FString::Printf(TEXT("空闲移动时发送 %d 个增量帧（期望至少 2 个）"), IdleMovingDeltaFrames));
+
+        // 丢帧 → 请求关键帧 → 重新同步
+        Check(GapDetectedUs >= LossEndUs, TEXT("丢包后的第一帧检测到缺口"));
+        Check(bStaleAtGap, TEXT("缺口处接收端的状态与手柄不一致（丢失的增量没有补上）"));
+        Check(KeyframeRequests >= 1, TEXT("检测到缺口后请求关键帧"));
+        Check(ResyncUs >= 0 && ResyncUs - GapDetectedUs <= 250000,
+              FString::Printf(TEXT("请求关键帧后 %.0f ms 重新同步（期望不超过 250 ms，远早于定期关键帧）"), (ResyncUs - GapDetectedUs) / 1000.0));
+        Check(bMatchedAfterResync, TEXT("重新同步后接收端的状态与手柄一致"));
+
+        // 刺激标记 → 试次模式 → 保持时间结束后回到空闲
+        Check(TrialEnteredUs >= 0 && TrialEnteredUs - StimulusUs <= 50000,
+              FString::Printf(TEXT("刺激标记后 %.0f ms 进入试次模式（期望不超过 50 ms）"), (TrialEnteredUs - StimulusUs) / 1000.0));
+        Check(TrialFrames >= 499 && TrialFrames <= 501, FString::Printf(TEXT("试次模式 1 秒发送 %d 帧（期望 500）"), TrialFrames));
+        Check(TrialKeyframes == TrialFrames, TEXT("试次模式每帧都是完整帧"));
+        Check(TrialBatchSamples >= 499 && TrialBatchSamples <= 501, FString::Printf(TEXT("试次模式 1 秒附带 %d 个定时样本（期望 500）"), TrialBatchSamples));
+        const int64 HoldUs = static_cast<int64>(Receiver.Scheduler.TrialHoldDuration * 1.0e6);
+        Check(IdleReturnedUs >= StimulusUs + HoldUs && IdleReturnedUs - (StimulusUs + HoldUs) <= 50000,
+              FString::Printf(TEXT("标记后 %.2f 秒回到空闲（期望 %.2f 秒）"), (IdleReturnedUs - StimulusUs) * 1.0e-6, HoldUs * 1.0e-6));
+        Check(LateIdleFrames <= 1, FString::Printf(TEXT("回到空闲后静止 0.35 秒内发送 %d 帧（期望不超过 1 个关键帧）"), LateIdleFrames));
+
+        // 试次阶段的指令丢失后按状态报告重发
+        const double ResendLimit = Receiver.Scheduler.ResendInterval + StatusIntervalUs * 1.0e-6 + 0.1;
+        Check(PhaseTrialUs >= 0 && (PhaseTrialUs - PhaseBeginUs) * 1.0e-6 <= ResendLimit,
+              FString::Printf(TEXT("模式指令丢失后 %.2f 秒进入试次模式（期望不超过 %.2f 秒）"), (PhaseTrialUs - PhaseBeginUs) * 1.0e-6, ResendLimit));
+        Check(PhaseIdleUs >= 0 && PhaseIdleUs - PhaseEndUs <= 50000, TEXT("试次阶段结束后回到空闲"));
+        Check(Receiver.Scheduler.IsConfirmed(), TEXT("结束时手柄报告的模式与目标一致"));
+        Check(ModeCommandsSent <= 8, FString::Printf(TEXT("共发送 %d 条模式指令（模式一致时不重复发送）"), ModeCommandsSent));
+
+        UE_LOG(LogTemp, Display, TEXT("HandleStreamTest: 丢失 %lld 帧，请求关键帧 %d 次，%.0f ms 后重新同步；模式指令 %d 条"),
+               Receiver.Tracker.GetLostFrames(), KeyframeRequests, (ResyncUs - GapDetectedUs) / 1000.0, ModeCommandsSent);
+    }
+}
+
+UHandleStreamTestCommandlet::UHandleStreamTestCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UHandleStreamTestCommandlet::Main(const FString& Params)
+{
+    Failures = 0;
+    TestStream();
+
+    UE_LOG(LogTemp, Display, TEXT("HandleStreamTest: %s（%d 个失败）"), Failures == 0 ? TEXT("通过") : TEXT("失败"), Failures);
+    return Failures > 0 ? 1 : 0;
+}
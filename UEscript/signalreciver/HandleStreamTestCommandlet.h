@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HandleStreamTestCommandlet.generated.h"
+
+/**
+ * 手柄数据流的端到端测试（不需要硬件和网络）
+ * 模拟固件的发送规则（与 hardware/shoubingright/TransmitControl.h 相同：空闲模式 10Hz 增量帧 + 1 秒关键帧，
+ * 试次模式 500Hz 完整帧）和一条会丢包的链路，接收端用 AOSCReceiver 同样的 FTransmitModeScheduler 和
+ * FFrameSequenceTracker，依次检查：
+ * - 上电空闲 → UE 发送空闲指令，增量帧只在数据变化时发送
+ * - 丢帧 → 检测到缺口并请求关键帧 → 手柄下一帧发送关键帧，接收端状态与手柄一致
+ * - 刺激标记 → 试次模式（全速完整帧）→ 保持时间结束后回到空闲
+ * - 模式指令丢失 → 状态报告与目标不一致时重发
+ * 任一检查失败时返回 1
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=HandleStreamTest
+ */
+UCLASS()
+class WORKVOILENCEGAME_API UHandleStreamTestCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UHandleStreamTestCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,223 @@
+#include "ImuBiasEstimator.h"
+
+void FImuBiasEstimator::AddSample(const FVector& RawAccel, const FVector& RawGyro)
+{
+    // 更新加速度和陀螺仪的指数滑动均值和方差
+    if (!bStatsInitialized)
+    {
+        AccelMean = RawAccel;
+        AccelVariance = 0.0f;
+        GyroMean = RawGyro;
+        GyroVariance = 0.0f;
+        bStatsInitialized = true;
+        return;
+    }
+
+    const FVector AccelDelta = RawAccel - AccelMean;
+    AccelMean += AccelDelta * VarianceSmoothing;
+    AccelVariance = (1.0f - VarianceSmoothing) * (AccelVariance + VarianceSmoothing * static_cast<float>(AccelDelta.SizeSquared()));
+
+    const FVector GyroDelta = RawGyro - GyroMean;
+    GyroMean += GyroDelta * VarianceSmoothing;
+    GyroVariance = (1.0f - VarianceSmoothing) * (GyroVariance + VarianceSmoothing * static_cast<float>(GyroDelta.SizeSquared()));
+
+    // 静止判定：加速度方差足够小，且扣除当前零偏后的角速度足够小；
+    // 第一次估计前零偏未知，改为要求读数本身足够小且稳定（零偏是常量）
+    const bool bCandidateStill = HasEstimate()
+        ? AccelVariance < AccelVarianceThreshold && CorrectGyro(RawGyro).Size() < GyroStillThreshold
+        : AccelVariance < AccelVarianceThreshold && RawGyro.Size() < GyroInitialStillThreshold && GyroVariance < GyroInitialVarianceThreshold;
+
+    if (!bCandidateStill)
+    {
+        EndStillWindow();
+        StillSampleCount = 0;
+        return;
+    }
+
+    // 静止期间重力方向不应变化；缓慢转动时加速度方差很小，但方向会逐渐偏离
+    const FVector Direction = AccelMean.GetSafeNormal();
+    if (StillSampleCount == 0)
+    {
+        StillStartDirection = Direction;
+    }
+    else if (FVector::DotProduct(Direction, StillStartDirection) < FMath::Cos(FMath::DegreesToRadians(MaxStillDriftDegrees)))
+    {
+        EndStillWindow();
+        StillSampleCount = 0;
+        StillStartDirection = Direction;
+    }
+
+    StillSampleCount++;
+    if (!IsStill())
+    {
+        return;
+    }
+
+    // 增量均值更新陀螺仪零偏：静止时陀螺仪读数即为零偏
+    GyroBiasSamples = FMath::Min(GyroBiasSamples + 1, MaxBiasSamples);
+    GyroBias += (RawGyro - GyroBias) / static_cast<float>(GyroBiasSamples);
+
+    WindowAccelSum += RawAccel;
+    WindowSamples++;
+}
+
+void FImuBiasEstimator::EndStillWindow()
+{
+    if (WindowSamples >= MinStillSamples)
+    {
+        AddOrientation(WindowAccelSum / static_cast<float>(WindowSamples));
+    }
+    WindowAccelSum = FVector::ZeroVector;
+    WindowSamples = 0;
+}
+
+void FImuBiasEstimator::AddOrientation(const FVector& MeanAccel)
+{
+    const FVector Direction = MeanAccel.GetSafeNormal();
+    if (Direction.IsZero())
+    {
+        return;
+    }
+
+    // 与已有姿态相近时用新的平均值替换，以跟踪温漂
+    const float MinCos = FMath::Cos(FMath::DegreesToRadians(MinOrientationSeparationDegrees));
+    FVector* Existing = Orientations.FindByPredicate([&Direction, MinCos](const FVector& Orientation)
+    {
+        return FVector::DotProduct(Orientation.GetSafeNormal(), Direction) > MinCos;
+    });
+    if (Existing)
+    {
+        *Existing = MeanAccel;
+    }
+    else
+    {
+        if (Orientations.Num() >= MaxOrientations)
+        {
+            Orientations.RemoveAt(0);
+        }
+        Orientations.Add(MeanAccel);
+    }
+
+    FitAccelOffset();
+}
+
+void FImuBiasEstimator::FitAccelOffset()
+{
+    const int32 Count = Orientations.Num();
+    if (Count < MinFitOrientations)
+    {
+        return;
+    }
+
+    // 姿态都在同一个平面附近（只绕一个轴转过）时球心沿平面法向不可观测
+    FVector MeanDirection = FVector::ZeroVector;
+    for (const FVector& Orientation : Orientations)
+    {
+        MeanDirection += Orientation.GetSafeNormal();
+    }
+    MeanDirection /= static_cast<float>(Count);
+
+    double Covariance[3][3] = {};
+    for (const FVector& Orientation : Orientations)
+    {
+        const FVector Delta = Orientation.GetSafeNormal() - MeanDirection;
+        for (int32 Row = 0; Row < 3; Row++)
+        {
+            for (int32 Column = 0; Column < 3; Column++)
+            {
+                Covariance[Row][Column] += Delta[Row] * Delta[Column] / Count;
+            }
+        }
+    }
+    const double Trace = Covariance[0][0] + Covariance[1][1] + Covariance[2][2];
+    const double Determinant = Covariance[0][0] * (Covariance[1][1] * Covariance[2][2] - Covariance[1][2] * Covariance[2][1])
+                             - Covariance[0][1] * (Covariance[1][0] * Covariance[2][2] - Covariance[1][2] * Covariance[2][0])
+                             + Covariance[0][2] * (Covariance[1][0] * Covariance[2][1] - Covariance[1][1] * Covariance[2][0]);
+    if (Trace <= 0.0 || Determinant / (Trace * Trace * Trace) < MinOrientationSpread)
+    {
+        return;
+    }
+
+    // 正规方程 N x = b，x = (cx, cy, cz, r^2 - |c|^2)
+    double Normal[4][5] = {};
+    for (const FVector& Orientation : Orientations)
+    {
+        const double Row[4] = { 2.0 * Orientation.X, 2.0 * Orientation.Y, 2.0 * Orientation.Z, 1.0 };
+        const double Target = Orientation.SizeSquared();
+        for (int32 I = 0; I < 4; I++)
+        {
+            for (int32 J = 0; J < 4; J++)
+            {
+                Normal[I][J] += Row[I] * Row[J];
+            }
+            Normal[I][4] += Row[I] * Target;
+        }
+    }
+
+    // 部分主元高斯消元
+    for (int32 Pivot = 0; Pivot < 4; Pivot++)
+    {
+        int32 Best = Pivot;
+        for (int32 Row = Pivot + 1; Row < 4; Row++)
+        {
+            if (FMath::Abs(Normal[Row][Pivot]) > FMath::Abs(Normal[Best][Pivot]))
+            {
+                Best = Row;
+            }
+        }
+        if (FMath::Abs(Normal[Best][Pivot]) < 1e-12)
+        {
+            return;
+        }
+        for (int32 Column = 0; Column < 5; Column++)
+        {
+            Swap(Normal[Pivot][Column], Normal[Best][Column]);
+        }
+        for (int32 Row = 0; Row < 4; Row++)
+        {
+            if (Row != Pivot)
+            {
+                const double Factor = Normal[Row][Pivot] / Normal[Pivot][Pivot];
+                for (int32 Column = Pivot; Column < 5; Column++)
+                {
+                    Normal[Row][Column] -= Factor * Normal[Pivot][Column];
+                }
+            }
+        }
+    }
+
+    const FVector Center(Normal[0][4] / Normal[0][0], Normal[1][4] / Normal[1][1], Normal[2][4] / Normal[2][2]);
+    const double RadiusSquared = Normal[3][4] / Normal[3][3] + Center.SizeSquared();
+    if (RadiusSquared <= 0.0)
+    {
+        return;
+    }
+
+    // 噪声或姿态分布不佳导致结果不合理时保留上一次的偏移
+    const double Radius = FMath::Sqrt(RadiusSquared);
+    if (Center.Size() > MaxAccelOffset || FMath::Abs(Radius - 1.0) > MaxScaleError)
+    {
+        return;
+    }
+
+    AccelOffset = Center;
+    bHasAccelOffset = true;
+}
+
+void FImuBiasEstimator::Reset()
+{
+    GyroBias = FVector::ZeroVector;
+    AccelOffset = FVector::ZeroVector;
+    GyroBiasSamples = 0;
+    bHasAccelOffset = false;
+    AccelMean = FVector::ZeroVector;
+    AccelVariance = 0.0f;
+    GyroMean = FVector::ZeroVector;
+    GyroVariance = 0.0f;
+    bStatsInitialized = false;
+    StillSampleCount = 0;
+    StillStartDirection = FVector::ZeroVector;
+    WindowAccelSum = FVector::ZeroVector;
+    WindowSamples = 0;
+    Orientations.Reset();
+}
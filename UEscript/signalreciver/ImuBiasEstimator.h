@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * IMU 零偏在线估计器
+ * 通过加速度方差和陀螺仪幅值检测静止窗口，在静止期间以增量均值更新陀螺仪零偏，
+ * 因此不需要在会话开始时放置阻塞式的校准界面
+ * 加速度计偏移不能由单个姿态得到（沿重力方向的误差会随姿态改变符号），
+ * 这里保存若干个不同静止姿态下的平均加速度，用最小二乘球面拟合求球心作为三轴偏移
+ */
+struct WORKVOILENCEGAME_API FImuBiasEstimator
+{
+public:
+    // === 静止检测参数 ===
+
+    /** 加速度方差阈值（g^2，三轴方差之和），低于此值视为静止 */
+    float AccelVarianceThreshold = 0.0004f;
+
+    /** 已有零偏估计后的陀螺仪幅值阈值（度/秒，扣除零偏后） */
+    float GyroStillThreshold = 3.0f;
+
+    /**
+     * 尚无零偏估计时的陀螺仪幅值阈值（度/秒，未扣除零偏）
+     * 不能太宽：缓慢匀速转动会被当作零偏学进去，之后扣除零偏的读数永远达不到 GyroStillThreshold
+     */
+    float GyroInitialStillThreshold = 6.0f;
+
+    /** 尚无零偏估计时陀螺仪的方差阈值（(度/秒)^2，三轴方差之和），零偏是常量，手持的微小转动方差较大 */
+    float GyroInitialVarianceThreshold = 0.5f;
+
+    /** 静止窗口内加速度方向相对窗口开始时的最大变化（度），用于排除不绕重力轴的缓慢转动 */
+    float MaxStillDriftDegrees = 3.0f;
+
+    /** 加速度、陀螺仪均值/方差的指数平滑系数（每个样本） */
+    float VarianceSmoothing = 0.1f;
+
+    /** 连续满足条件多少个样本后才认为进入静止窗口（约 0.5 秒 @ 50Hz） */
+    int32 MinStillSamples = 25;
+
+    /** 第一次估计前要求的静止样本数（约 2 秒 @ 50Hz） */
+    int32 MinInitialStillSamples = 100;
+
+    // === 加速度计偏移（球面拟合）参数 ===
+
+    /** 两个静止姿态的加速度方向至少相差多少度才算不同的姿态，否则更新已有姿态 */
+    float MinOrientationSeparationDegrees = 30.0f;
+
+    /** 保存的姿态数上限，超过后丢弃最早的姿态 */
+    int32 MaxOrientations = 12;
+
+    /** 至少多少个姿态才进行拟合（球心和半径共 4 个未知数） */
+    int32 MinFitOrientations = 6;
+
+    /** 姿态分布的最小展开度：方向协方差的行列式 / 迹^3（各向均匀分布约为 1/27，共面时为 0） */
+    float MinOrientationSpread = 0.002f;
+
+    /** 拟合结果的合理范围：偏移幅值上限（g）和半径与 1g 的最大偏差，超出时保留上一次结果 */
+    float MaxAccelOffset = 0.2f;
+    float MaxScaleError = 0.1f;
+
+    /** 增量均值的样本数上限，达到后退化为指数滑动平均，以跟踪温漂 */
+    int32 MaxBiasSamples = 500;
+
+    // === 接口 ===
+
+    /** 输入一帧原始数据（加速度 g，角速度 度/秒） */
+    void AddSample(const FVector& RawAccel, const FVector& RawGyro);
+
+    /** 扣除陀螺仪零偏 */
+    FVector CorrectGyro(const FVector& RawGyro) const { return RawGyro - GyroBias; }
+
+    /** 扣除加速度计偏移 */
+    FVector CorrectAccel(const FVector& RawAccel) const { return RawAccel - AccelOffset; }
+
+    const FVector& GetGyroBias() const { return GyroBias; }
+    const FVector& GetAccelOffset() const { return AccelOffset; }
+
+    /** 当前是否处于静止窗口 */
+    bool IsStill() const { return StillSampleCount >= (HasEstimate() ? MinStillSamples : MinInitialStillSamples); }
+
+    /** 是否已经得到至少一次零偏估计 */
+    bool HasEstimate() const { return GyroBiasSamples > 0; }
+
+    /** 是否已经由球面拟合得到加速度计偏移 */
+    bool HasAccelOffset() const { return bHasAccelOffset; }
+
+    /** 已保存的不同静止姿态数 */
+    int32 GetOrientationCount() const { return Orientations.Num(); }
+
+    void Reset();
+
+private:
+    /** 静止窗口结束：窗口足够长时把平均加速度作为一个姿态 */
+    void EndStillWindow();
+
+    /** 加入或更新一个静止姿态，并重新拟合 */
+    void AddOrientation(const FVector& MeanAccel);
+
+    /** 最小二乘球面拟合：|a - c|^2 = r^2 线性化为 2a·c + (r^2 - |c|^2) = |a|^2 */
+    void FitAccelOffset();
+
+    FVector GyroBias = FVector::ZeroVector;
+    FVector AccelOffset = FVector::ZeroVector;
+    int32 GyroBiasSamples = 0;
+    bool bHasAccelOffset = false;
+
+    // 加速度和陀螺仪的指数滑动均值/方差
+    FVector AccelMean = FVector::ZeroVector;
+    float AccelVariance = 0.0f;
+    FVector GyroMean = FVector::ZeroVector;
+    float GyroVariance = 0.0f;
+    bool bStatsInitialized = false;
+
+    int32 StillSampleCount = 0;
+
+    /** 当前静止窗口开始时的加速度方向 */
+    FVector StillStartDirection = FVector::ZeroVector;
+
+    /** 当前静止窗口内（进入静止后）的加速度之和和样本数 */
+    FVector WindowAccelSum = FVector::ZeroVector;
+    int32 WindowSamples = 0;
+
+    /** 各个静止姿态的平均加速度（g） */
+    TArray<FVector> Orientations;
+};
@@ -204,6 +204,33 @@ bool UJoystickBlueprintLibrary::IsArduinoRotating(float Threshold)
     return GetArduinoGyroMagnitude() > Threshold;
 }
 
+// === IMU 零偏校正 ===
+
+FVector UJoystickBlueprintLibrary::GetArduinoGyroBias()
+{
+    return AOSCReceiver::GetGyroBias();
+}
+
+FVector UJoystickBlueprintLibrary::GetArduinoAccelOffset()
+{
+    return AOSCReceiver::GetAccelOffset();
+}
+
+FVector UJoystickBlueprintLibrary::GetArduinoRawGyroVector()
+{
+    return AOSCReceiver::GetRawGyroVector();
+}
+
+bool UJoystickBlueprintLibrary::IsArduinoImuStill()
+{
+    return AOSCReceiver::IsImuStill();
+}
+
+bool UJoystickBlueprintLibrary::IsArduinoImuCalibrated()
+{
+    return AOSCReceiver::HasImuBiasEstimate();
+}
+
 // === 按钮数据获取函数 ===
 
 bool UJoystickBlueprintLibrary::GetArduinoButton1()
@@ -292,6 +319,96 @@ float UJoystickBlueprintLibrary::GetArduinoNetworkLatency()
     return 0.0f;
 }
 
+// === 反向通道（触觉/LED/采样率） ===
+
+void UJoystickBlueprintLibrary::SendArduinoVibration(int32 HandleNumber, int32 DurationMs, float Strength)
+{
+    AOSCReceiver::QueueHandleVibration(HandleNumber, DurationMs, Strength);
+}
+
+void UJoystickBlueprintLibrary::SetArduinoLedColor(int32 HandleNumber, FLinearColor Color)
+{
+    AOSCReceiver::QueueHandleLedColor(HandleNumber, Color);
+}
+
+void UJoystickBlueprintLibrary::SetArduinoSampleRate(int32 HandleNumber, int32 RateHz)
+{
+    AOSCReceiver::QueueHandleSampleRate(HandleNumber, RateHz);
+}
+
+void UJoystickBlueprintLibrary::SetArduinoTransmitMode(int32 HandleNumber, EHandleTransmitMode Mode, int32 RateHz)
+{
+    AOSCReceiver::QueueHandleTransmitMode(HandleNumber, Mode, RateHz);
+}
+
+void UJoystickBlueprintLibrary::SetArduinoTrialPhase(bool bInTrial)
+{
+    EHandleTransmitMode Mode = bInTrial ? EHandleTransmitMode::Trial : EHandleTransmitMode::Idle;
+    AOSCReceiver::QueueHandleTransmitMode(1, Mode);
+    AOSCReceiver::QueueHandleTransmitMode(2, Mode);
+}
+
+int32 UJoystickBlueprintLibrary::GetArduinoNegotiatedRate(int32 HandleNumber)
+{
+    return AOSCReceiver::GetNegotiatedRate(HandleNumber);
+}
+
+double UJoystickBlueprintLibrary::GetSensorClockTime()
+{
+    return AOSCReceiver::GetSensorClockTime();
+}
+
+FGsrSample UJoystickBlueprintLibrary::GetArduinoGsrSample()
+{
+    return AOSCReceiver::GetLatestGsrSample();
+}
+
+float UJoystickBlueprintLibrary::GetArduinoGsrConductance()
+{
+    return AOSCReceiver::GetGsrConductance();
+}
+
+bool UJoystickBlueprintLibrary::IsArduinoGsrConnected()
+{
+    return AOSCReceiver::IsGsrConnected();
+}
+
+FTrialMarker UJoystickBlueprintLibrary::MarkArduinoStimulus(const FString& Condition)
+{
+    return AOSCReceiver::AddTrialMarker(ETrialMarkerType::Stimulus, Condition);
+}
+
+FTrialMarker UJoystickBlueprintLibrary::MarkArduinoResponse(const FString& Condition)
+{
+    return AOSCReceiver::AddTrialMarker(ETrialMarkerType::Response, Condition);
+}
+
+TArray<FHandleSample> UJoystickBlueprintLibrary::GetArduinoRecentSamples(int32 MaxCount)
+{
+    return AOSCReceiver::GetRecentHandleSamples(MaxCount);
+}
+
+void UJoystickBlueprintLibrary::RequestArduinoKeyframe(int32 HandleNumber, int32 IntervalMs)
+{
+    AOSCReceiver::QueueHandleKeyframeRequest(HandleNumber, IntervalMs);
+}
+
+bool UJoystickBlueprintLibrary::IsArduinoStateSynchronized(int32 HandleNumber)
+{
+    return AOSCReceiver::IsHandleStateSynchronized(HandleNumber);
+}
+
+float UJoystickBlueprintLibrary::GetArduinoFrameLossRatio(int32 HandleNumber)
+{
+    return AOSCReceiver::GetFrameLossRatio(HandleNumber);
+}
+
+float UJoystickBlueprintLibrary::GetArduinoFeedbackLatencyMs()
+{
+    float Latency = AOSCReceiver::GetAverageFeedbackLatency();
+    return Latency < 0.0f ? -1.0f : Latency * 1000.0f;
+}
+
 // === 摇杆事件检测 ===
 
 bool UJoystickBlueprintLibrary::IsArduinoJoystickJustPressed()
@@ -473,6 +590,45 @@ bool UJoystickBlueprintLibrary::AreBothPressuresTriggered(float Threshold)
     return IsPressure1Triggered(Threshold) && IsPressure2Triggered(Threshold);
 }
 
+// === 压力个体化（百分位阈值） ===
+
+bool UJoystickBlueprintLibrary::IsArduinoPressureCalibrated(int32 SensorNumber)
+{
+    return AOSCReceiver::IsPressureCalibrated(SensorNumber);
+}
+
+float UJoystickBlueprintLibrary::GetArduinoPressureAtPercentile(int32 SensorNumber, float Percentile)
+{
+    return AOSCReceiver::GetPressureAtPercentile(SensorNumber, Percentile);
+}
+
+float UJoystickBlueprintLibrary::GetArduinoPressurePercentile(int32 SensorNumber)
+{
+    float CurrentValue = SensorNumber == 1 ? GetArduinoPressure1() : GetArduinoPressure2();
+    return AOSCReceiver::GetPressurePercentile(SensorNumber, CurrentValue);
+}
+
+float UJoystickBlueprintLibrary::GetArduinoNormalizedPressure(int32 SensorNumber)
+{
+    return AOSCReceiver::GetNormalizedPressure(SensorNumber);
+}
+
+bool UJoystickBlueprintLibrary::IsPressureAbovePercentile(int32 SensorNumber, float Percentile)
+{
+    if (!AOSCReceiver::IsPressureCalibrated(SensorNumber))
+    {
+        return false;
+    }
+    
+    float CurrentValue = SensorNumber == 1 ? GetArduinoPressure1() : GetArduinoPressure2();
+    return CurrentValue > AOSCReceiver::GetPressureAtPercentile(SensorNumber, Percentile);
+}
+
+void UJoystickBlueprintLibrary::ResetArduinoPressureCalibration()
+{
+    AOSCReceiver::ResetPressureCalibration();
+}
+
 // === 组合事件检测 ===
 
 bool UJoystickBlueprintLibrary::IsButtonAndPressureTriggered(int32 ButtonNumber, int32 PressureNumber, float Threshold)
@@ -539,7 +695,7 @@ void UJoystickBlueprintLibrary::UpdateArduinoEventStates()
     LastButton4State = GetArduinoButton4();
     
     // 更新压力传感器状态
-    float Threshold = 100.0f;
+    float Threshold = 0.5f;
     LastPressure1Triggered = GetArduinoPressure1() > Threshold;
     LastPressure2Triggered = GetArduinoPressure2() > Threshold;
     LastPressure1Value = GetArduinoPressure1();
@@ -175,6 +175,33 @@ public:
               meta = (Keywords = "arduino gyroscope rotating spinning"))
     static bool IsArduinoRotating(float Threshold = 5.0f);
 
+    // === IMU 零偏校正 ===
+
+    /** 获取当前估计的陀螺仪零偏 (度/秒)，接收路径已自动扣除 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration",
+              meta = (Keywords = "arduino gyroscope bias drift calibration"))
+    static FVector GetArduinoGyroBias();
+
+    /** 获取当前估计的加速度计偏移 (g单位)，需要在至少 6 个不同姿态下各静止一会儿才有结果，之前为零 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration",
+              meta = (Keywords = "arduino accelerometer offset calibration"))
+    static FVector GetArduinoAccelOffset();
+
+    /** 获取未经校正的原始陀螺仪3D向量 (度/秒) */
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration",
+              meta = (Keywords = "arduino gyroscope raw uncorrected"))
+    static FVector GetArduinoRawGyroVector();
+
+    /** 设备当前是否静止（零偏估计正在更新） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration",
+              meta = (Keywords = "arduino imu still stationary calibration"))
+    static bool IsArduinoImuStill();
+
+    /** 是否已获得至少一次零偏估计 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration",
+              meta = (Keywords = "arduino imu calibrated bias ready"))
+    static bool IsArduinoImuCalibrated();
+
     // === 按钮数据获取函数 ===
     
     /** 获取按钮1状态 */
@@ -229,6 +256,93 @@ public:
               meta = (Keywords = "arduino network latency delay"))
     static float GetArduinoNetworkLatency();
 
+    // === 反向通道（触觉/LED/采样率） ===
+    
+    /** 让手柄振动（HandleNumber: 1=左手柄, 2=右手柄；同一帧的指令合并发送） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback",
+              meta = (Keywords = "arduino haptic vibration rumble pulse"))
+    static void SendArduinoVibration(int32 HandleNumber, int32 DurationMs = 100, float Strength = 1.0f);
+    
+    /** 设置手柄LED颜色 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback",
+              meta = (Keywords = "arduino led color light"))
+    static void SetArduinoLedColor(int32 HandleNumber, FLinearColor Color);
+    
+    /** 设置手柄采样/发送频率 (Hz) */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback",
+              meta = (Keywords = "arduino sampling rate frequency hz"))
+    static void SetArduinoSampleRate(int32 HandleNumber, int32 RateHz);
+    
+    /** 按实验阶段切换手柄传输模式（空闲=低频仅变化，试次=高频完整帧）；RateHz 为 0 时使用手柄当前设置 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback",
+              meta = (Keywords = "arduino transmit mode idle trial phase rate"))
+    static void SetArduinoTransmitMode(int32 HandleNumber, EHandleTransmitMode Mode, int32 RateHz = 0);
+    
+    /** 同时切换两个手柄的传输模式（进入/离开计时试次时调用） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback",
+              meta = (Keywords = "arduino trial phase start end rate"))
+    static void SetArduinoTrialPhase(bool bInTrial);
+    
+    /** 获取手柄报告的当前传输频率 (Hz)，尚未收到报告时返回 0 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback",
+              meta = (Keywords = "arduino negotiated rate hz"))
+    static int32 GetArduinoNegotiatedRate(int32 HandleNumber);
+    
+    /** 获取共享传感器时钟的当前时间（秒，手柄与 GSR 数据共用）*/
+    UFUNCTION(BlueprintCallable, Category = "Arduino Basic",
+              meta = (Keywords = "arduino sensor clock time sync gsr"))
+    static double GetSensorClockTime();
+    
+    /** 获取最近一个 GSR 样本 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino GSR",
+              meta = (Keywords = "arduino gsr eda skin conductance sample"))
+    static FGsrSample GetArduinoGsrSample();
+    
+    /** 获取当前皮肤电导（μS）*/
+    UFUNCTION(BlueprintCallable, Category = "Arduino GSR",
+              meta = (Keywords = "arduino gsr eda skin conductance"))
+    static float GetArduinoGsrConductance();
+    
+    /** GSR 设备是否已连接 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino GSR",
+              meta = (Keywords = "arduino gsr connected"))
+    static bool IsArduinoGsrConnected();
+    
+    /** 标记刺激呈现（开始一个试次，打开事件相关分析窗口）*/
+    UFUNCTION(BlueprintCallable, Category = "Arduino Trial",
+              meta = (Keywords = "arduino trial stimulus onset marker event era"))
+    static FTrialMarker MarkArduinoStimulus(const FString& Condition);
+    
+    /** 标记被试反应 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Trial",
+              meta = (Keywords = "arduino trial response marker event"))
+    static FTrialMarker MarkArduinoResponse(const FString& Condition);
+    
+    /** 获取手柄定时采样的最近样本（带设备时间戳，试次模式下有效） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Samples",
+              meta = (Keywords = "arduino samples timestamp batch history"))
+    static TArray<FHandleSample> GetArduinoRecentSamples(int32 MaxCount = 100);
+    
+    /** 请求手柄立即发送完整关键帧；IntervalMs > 0 时同时修改定期关键帧间隔 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback",
+              meta = (Keywords = "arduino keyframe delta resync"))
+    static void RequestArduinoKeyframe(int32 HandleNumber, int32 IntervalMs = 0);
+    
+    /** 增量传输的状态是否完整（收到关键帧且此后没有丢帧） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Basic",
+              meta = (Keywords = "arduino delta synchronized keyframe"))
+    static bool IsArduinoStateSynchronized(int32 HandleNumber);
+    
+    /** 获取手柄数据的丢帧率（0~1） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Basic",
+              meta = (Keywords = "arduino packet loss frame gap"))
+    static float GetArduinoFrameLossRatio(int32 HandleNumber);
+    
+    /** 获取反馈指令的往返延迟（毫秒，尚无数据时返回 -1） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback",
+              meta = (Keywords = "arduino feedback latency round trip"))
+    static float GetArduinoFeedbackLatencyMs();
+
     // === 事件检测（类似键盘按键事件） ===
     
     /** 检查摇杆是否刚刚按下（从死区外移动到死区外） */
@@ -258,52 +372,84 @@ public:
 
     // === 压力传感器事件（新增） ===
     
-    /** 检查压力传感器1是否被触发（值大于阈值，默认100） */
+    /** 检查压力传感器1是否被触发（值大于阈值，默认0.5，压力值范围 0~1） */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino pressure sensor 1 triggered threshold"))
-    static bool IsPressure1Triggered(float Threshold = 100.0f);
+    static bool IsPressure1Triggered(float Threshold = 0.5f);
 
-    /** 检查压力传感器2是否被触发（值大于阈值，默认100） */
+    /** 检查压力传感器2是否被触发（值大于阈值，默认0.5，压力值范围 0~1） */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino pressure sensor 2 triggered threshold"))
-    static bool IsPressure2Triggered(float Threshold = 100.0f);
+    static bool IsPressure2Triggered(float Threshold = 0.5f);
 
     /** 检查压力传感器1是否刚刚被触发（类似按键按下事件） */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino pressure sensor 1 just triggered pressed event"))
-    static bool IsPressure1JustTriggered(float Threshold = 100.0f);
+    static bool IsPressure1JustTriggered(float Threshold = 0.5f);
 
     /** 检查压力传感器2是否刚刚被触发（类似按键按下事件） */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino pressure sensor 2 just triggered pressed event"))
-    static bool IsPressure2JustTriggered(float Threshold = 100.0f);
+    static bool IsPressure2JustTriggered(float Threshold = 0.5f);
 
     /** 检查压力传感器1是否刚刚释放（类似按键释放事件） */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino pressure sensor 1 just released event"))
-    static bool IsPressure1JustReleased(float Threshold = 100.0f);
+    static bool IsPressure1JustReleased(float Threshold = 0.5f);
 
     /** 检查压力传感器2是否刚刚释放（类似按键释放事件） */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino pressure sensor 2 just released event"))
-    static bool IsPressure2JustReleased(float Threshold = 100.0f);
+    static bool IsPressure2JustReleased(float Threshold = 0.5f);
 
     /** 检查任意压力传感器是否被触发 */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino pressure any sensor triggered"))
-    static bool IsAnyPressureTriggered(float Threshold = 100.0f);
+    static bool IsAnyPressureTriggered(float Threshold = 0.5f);
 
     /** 检查两个压力传感器是否都被触发 */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino pressure both sensors triggered"))
-    static bool AreBothPressuresTriggered(float Threshold = 100.0f);
+    static bool AreBothPressuresTriggered(float Threshold = 0.5f);
+
+    // === 压力个体化（百分位阈值） ===
+    
+    /** 压力通道是否已完成热身（已学习到被试的握压范围） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration",
+              meta = (Keywords = "arduino pressure calibrated warmup participant"))
+    static bool IsArduinoPressureCalibrated(int32 SensorNumber);
+    
+    /** 获取被试握压范围内某个百分位（0~100）对应的压力值 */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration",
+              meta = (Keywords = "arduino pressure percentile threshold quantile"))
+    static float GetArduinoPressureAtPercentile(int32 SensorNumber, float Percentile = 50.0f);
+    
+    /** 获取当前压力值在被试握压范围内的百分位（0~100） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration",
+              meta = (Keywords = "arduino pressure percentile rank"))
+    static float GetArduinoPressurePercentile(int32 SensorNumber);
+    
+    /** 获取按被试握压范围归一化后的压力值 (0.0 到 1.0) */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration",
+              meta = (Keywords = "arduino pressure normalized participant range"))
+    static float GetArduinoNormalizedPressure(int32 SensorNumber);
+    
+    /** 检查压力传感器是否超过被试握压范围的某个百分位（未完成热身时返回 false） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration",
+              meta = (Keywords = "arduino pressure triggered percentile"))
+    static bool IsPressureAbovePercentile(int32 SensorNumber, float Percentile = 50.0f);
+    
+    /** 重置压力个体化统计（更换被试时调用） */
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration",
+              meta = (Keywords = "arduino pressure calibration reset participant"))
+    static void ResetArduinoPressureCalibration();
 
     // === 组合事件检测 ===
     
     /** 检查按钮和压力传感器的组合触发（按钮按下且压力传感器触发） */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
               meta = (Keywords = "arduino button pressure combo combination"))
-    static bool IsButtonAndPressureTriggered(int32 ButtonNumber, int32 PressureNumber, float Threshold = 100.0f);
+    static bool IsButtonAndPressureTriggered(int32 ButtonNumber, int32 PressureNumber, float Threshold = 0.5f);
 
     /** 更新所有事件状态（建议在Tick或Event Graph的每帧开始时调用一次） */
     UFUNCTION(BlueprintCallable, Category = "Arduino Events",
@@ -0,0 +1,114 @@
+#include "JoystickTrajectoryAnalyzer.h"
+
+void FJoystickTrajectoryAnalyzer::Begin(float Time, const FVector2D& Position)
+{
+    Reset();
+
+    bActive = true;
+    LastTime = Time;
+    LastPosition = Position;
+    StartPosition = Position;
+    MaxExcursionSquared = 0.0f;
+    Current.StartTime = Time;
+    Current.MaxExcursionPoint = Position;
+}
+
+void FJoystickTrajectoryAnalyzer::AddSample(float Time, const FVector2D& Position)
+{
+    if (!bActive)
+    {
+        return;
+    }
+
+    const float Dt = Time - LastTime;
+    if (Dt <= 0.0f)
+    {
+        return;
+    }
+
+    const float Step = static_cast<float>(FVector2D::Distance(Position, LastPosition));
+    Current.PathLength += Step;
+
+    SmoothedSpeed = FMath::Lerp(SmoothedSpeed, Step / Dt, VelocitySmoothing);
+    if (SmoothedSpeed > Current.PeakVelocity)
+    {
+        Current.PeakVelocity = SmoothedSpeed;
+        Current.TimeToPeakVelocity = Time - Current.StartTime;
+    }
+    UpdateSubmovements(SmoothedSpeed);
+
+    // 最远点代表动作目标，直线效率按到达最远点前的路径计算
+    const float ExcursionSquared = static_cast<float>((Position - StartPosition).SizeSquared());
+    if (ExcursionSquared > MaxExcursionSquared)
+    {
+        MaxExcursionSquared = ExcursionSquared;
+        Current.MaxExcursionPoint = Position;
+        PathLengthAtMaxExcursion = Current.PathLength;
+    }
+
+    LastTime = Time;
+    LastPosition = Position;
+}
+
+FJoystickMovementMetrics FJoystickTrajectoryAnalyzer::End(float Time, const FVector2D& Position)
+{
+    AddSample(Time, Position);
+
+    // 结束时仍在上升段的速度峰也算一个子动作
+    if (bRising && LocalPeak >= MinPeakVelocity)
+    {
+        Current.SubmovementCount++;
+    }
+
+    Current.EndTime = Time;
+    Current.MovementTime = Time - Current.StartTime;
+    Current.StraightLineDistance = FMath::Sqrt(FMath::Max(MaxExcursionSquared, 0.0f));
+    Current.PathEfficiency = PathLengthAtMaxExcursion > KINDA_SMALL_NUMBER
+        ? FMath::Min(Current.StraightLineDistance / PathLengthAtMaxExcursion, 1.0f)
+        : 0.0f;
+
+    bActive = false;
+    return Current;
+}
+
+void FJoystickTrajectoryAnalyzer::UpdateSubmovements(float Speed)
+{
+    if (bRising)
+    {
+        LocalPeak = FMath::Max(LocalPeak, Speed);
+
+        // 速度明显回落：确认一个速度峰
+        if (LocalPeak >= MinPeakVelocity && Speed < LocalPeak * ValleyRatio)
+        {
+            Current.SubmovementCount++;
+            bRising = false;
+            LocalValley = Speed;
+        }
+    }
+    else
+    {
+        LocalValley = FMath::Min(LocalValley, Speed);
+
+        // 速度重新明显上升：开始下一个速度峰
+        if (Speed * ValleyRatio > LocalValley && Speed >= MinPeakVelocity)
+        {
+            bRising = true;
+            LocalPeak = Speed;
+        }
+    }
+}
+
+void FJoystickTrajectoryAnalyzer::Reset()
+{
+    bActive = false;
+    LastTime = 0.0f;
+    LastPosition = FVector2D::ZeroVector;
+    StartPosition = FVector2D::ZeroVector;
+    SmoothedSpeed = 0.0f;
+    PathLengthAtMaxExcursion = 0.0f;
+    MaxExcursionSquared = -1.0f;
+    bRising = true;
+    LocalPeak = 0.0f;
+    LocalValley = 0.0f;
+    Current = FJoystickMovementMetrics();
+}
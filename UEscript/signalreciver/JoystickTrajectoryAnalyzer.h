@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JoystickTrajectoryAnalyzer.generated.h"
+
+/** 单次摇杆动作（离开死区到回到死区）的轨迹指标 */
+USTRUCT(BlueprintType)
+struct FJoystickMovementMetrics
+{
+    GENERATED_BODY()
+
+    /** 离开死区的时间（秒，共享传感器时钟）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    float StartTime = 0.0f;
+
+    /** 回到死区的时间（秒，共享传感器时钟）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    float EndTime = 0.0f;
+
+    /** 动作时间（秒）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    float MovementTime = 0.0f;
+
+    /** 峰值速度（单位/秒，摇杆坐标 -1~1）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    float PeakVelocity = 0.0f;
+
+    /** 从开始到峰值速度的时间（秒）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    float TimeToPeakVelocity = 0.0f;
+
+    /** 总路径长度 */
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    float PathLength = 0.0f;
+
+    /** 最远点的位置（动作目标方向）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    FVector2D MaxExcursionPoint = FVector2D::ZeroVector;
+
+    /** 起点到最远点的直线距离 */
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    float StraightLineDistance = 0.0f;
+
+    /** 路径效率：直线距离 / 到达最远点前的实际路径长度（1 表示完全笔直）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    float PathEfficiency = 0.0f;
+
+    /** 速度峰个数（子动作数，1 表示一次平滑动作）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Joystick Trajectory")
+    int32 SubmovementCount = 0;
+};
+
+/**
+ * 摇杆轨迹的流式分析器
+ * 每个样本 O(1) 更新，单次动作的内存占用固定，可以在所有会话中常驻开启
+ */
+struct WORKVOILENCEGAME_API FJoystickTrajectoryAnalyzer
+{
+public:
+    /** 速度的指数平滑系数（抑制 ADC 量化噪声）*/
+    float VelocitySmoothing = 0.5f;
+
+    /** 速度峰的最小高度（单位/秒），低于此值不计为子动作 */
+    float MinPeakVelocity = 0.5f;
+
+    /** 速度需回落到峰值的多少比例以下，才认为一个速度峰结束 */
+    float ValleyRatio = 0.7f;
+
+    /** 离开死区时开始一次动作 */
+    void Begin(float Time, const FVector2D& Position);
+
+    /** 动作过程中的样本 */
+    void AddSample(float Time, const FVector2D& Position);
+
+    /** 回到死区时结束动作并返回指标 */
+    FJoystickMovementMetrics End(float Time, const FVector2D& Position);
+
+    bool IsActive() const { return bActive; }
+
+    void Reset();
+
+private:
+    void UpdateSubmovements(float Speed);
+
+    bool bActive = false;
+    float LastTime = 0.0f;
+    FVector2D LastPosition = FVector2D::ZeroVector;
+    FVector2D StartPosition = FVector2D::ZeroVector;
+    float SmoothedSpeed = 0.0f;
+    float PathLengthAtMaxExcursion = 0.0f;
+    float MaxExcursionSquared = -1.0f;
+
+    // 子动作检测：速度峰/谷跟踪
+    bool bRising = true;
+    float LocalPeak = 0.0f;
+    float LocalValley = 0.0f;
+
+    FJoystickMovementMetrics Current;
+};
@@ -0,0 +1,513 @@
+#include "LedalabSessionRecorder.h"
+#include "MatFileWriter.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    /** 写入 fileinfo.version 的 Ledalab 版本（与 Experiment 下的文件一致）*/
+    constexpr double LedalabVersion = 3.49;
+
+    const TCHAR* const TimeSuffix = TEXT(".time.part");
+    const TCHAR* const EventSuffix = TEXT(".events.part");
+
+    /** 补全时每次复制的样本数 */
+    constexpr int32 CopyBlockSamples = 8192;
+
+    TArray<FString> GetDataFieldNames()
+    {
+        return { TEXT("conductance"), TEXT("time"), TEXT("timeoff"), TEXT("samplingrate"), TEXT("event") };
+    }
+
+    /** 流式写入的 .mat 前缀中需要回填的位置 */
+    struct FDataLayout
+    {
+        /** data 的 miMATRIX 标签 */
+        int32 DataTag = 0;
+
+        /** conductance 的 miMATRIX 标签 */
+        int32 ConductanceTag = 0;
+
+        /** conductance 维度中的列数 */
+        int32 ConductanceColumns = 0;
+
+        /** conductance 的 miDOUBLE 标签 */
+        int32 ConductanceData = 0;
+
+        /** 第一个电导值 */
+        int32 DataStart = 0;
+    };
+
+    /** 文件头 + data 结构头 + conductance 矩阵头，长度先写 0，结束时回填 */
+    FDataLayout BuildPrefix(TArray<uint8>& Out)
+    {
+        FDataLayout Layout;
+        FMatFileWriter::WriteHeader(Out);
+
+        Layout.DataTag = Out.Num();
+        FMatFileWriter::WriteTag(Out, MatFormat::miMATRIX, 0);
+        const uint32 StructFlags[2] = { MatFormat::mxSTRUCT, 0 };
+        FMatFileWriter::WriteElement(Out, MatFormat::miUINT32, StructFlags, sizeof(StructFlags));
+        FMatFileWriter::WriteDimensions(Out, { 1, 1 });
+        FMatFileWriter::WriteElement(Out, MatFormat::miINT8, "data", 4);
+        FMatFileWriter::WriteFieldNames(Out, GetDataFieldNames());
+
+        Layout.ConductanceTag = Out.Num();
+        FMatFileWriter::WriteTag(Out, MatFormat::miMATRIX, 0);
+        const uint32 DoubleFlags[2] = { MatFormat::mxDOUBLE, 0 };
+        FMatFileWriter::WriteElement(Out, MatFormat::miUINT32, DoubleFlags, sizeof(DoubleFlags));
+        // 维度元素：标签 8 字节，行数 4 字节，然后是列数
+        Layout.ConductanceColumns = Out.Num() + 12;
+        FMatFileWriter::WriteDimensions(Out, { 1, 0 });
+        FMatFileWriter::WriteElement(Out, MatFormat::miINT8, nullptr, 0);
+        Layout.ConductanceData = Out.Num();
+        FMatFileWriter::WriteTag(Out, MatFormat::miDOUBLE, 0);
+        Layout.DataStart = Out.Num();
+        return Layout;
+    }
+
+    void Patch(FArchive& Archive, int64 Offset, uint32 Value)
+    {
+        Archive.Seek(Offset);
+        Archive.Serialize(&Value, sizeof(Value));
+    }
+
+    /** 事件文本中不能有制表符和换行 */
+    FString EscapeField(const FString& Text)
+    {
+        FString Result = Text;
+        for (TCHAR& Character : Result.GetCharArray())
+        {
+            if (Character == TEXT('\t') || Character == TEXT('\n') || Character == TEXT('\r'))
+            {
+                Character = TEXT(' ');
+            }
+        }
+        return Result;
+    }
+
+    /** 事件暂存文件：第一行为 session\t开始时间，之后每行为 时间\t时长\t试次\t名称\t条件 */
+    bool ReadEventJournal(const FString& Path, double& OutSessionStart, TArray<FLedalabEvent>& OutEvents)
+    {
+        FString Text;
+        if (!FFileHelper::LoadFileToString(Text, *Path))
+        {
+            return false;
+        }
+
+        TArray<FString> Lines;
+        Text.ParseIntoArray(Lines, TEXT("\n"));
+        TArray<FString> Fields;
+        for (const FString& Line : Lines)
+        {
+            Line.ParseIntoArray(Fields, TEXT("\t"), false);
+            if (Fields.Num() == 2 && Fields[0] == TEXT("session"))
+            {
+                OutSessionStart = FCString::Atod(*Fields[1]);
+            }
+            else if (Fields.Num() >= 5)
+            {
+                // 崩溃时最后一行可能不完整，字段数不足的行忽略
+                FLedalabEvent& Event = OutEvents.AddDefaulted_GetRef();
+                Event.Time = FCString::Atod(*Fields[0]);
+                Event.Duration = FCString::Atod(*Fields[1]);
+                Event.TrialIndex = FCString::Atoi(*Fields[2]);
+                Event.Name = Fields[3];
+                Event.Condition = Fields[4].TrimStartAndEnd();
+            }
+        }
+        return true;
+    }
+
+    /** 事件文件，与 Experiment/figure/batch_fix_ledalab.py 生成的格式相同 */
+    bool SaveEventsFile(const FString& Path, const TArray<FLedalabEvent>& Events, double Origin)
+    {
+        FString Text = TEXT("Onset(s)\tDuration(s)\tEventName\n");
+        for (const FLedalabEvent& Event : Events)
+        {
+            Text += FString::Printf(TEXT("%.3f\t%.3f\t%s\n"), Event.Time - Origin, Event.Duration, *Event.Name);
+        }
+        return FFileHelper::SaveStringToFile(Text, *Path);
+    }
+
+    /** data.event：time / nid / name / userdata，同名事件共用一个 nid（从 1 开始）*/
+    FMatVariable BuildEventStruct(const TArray<FLedalabEvent>& Events, double Origin)
+    {
+        TArray<FString> Names;
+        TArray<FMatVariable> Fields;
+        for (const FLedalabEvent& Event : Events)
+        {
+            const int32 Nid = Names.AddUnique(Event.Name) + 1;
+
+            TArray<FMatVariable> UserData;
+            UserData.Add(FMatFileWriter::MakeScalar(TEXT("trial"), Event.TrialIndex));
+            UserData.Add(FMatFileWriter::MakeText(TEXT("condition"), Event.Condition));
+
+            Fields.Add(FMatFileWriter::MakeScalar(TEXT("time"), Event.Time - Origin));
+            Fields.Add(FMatFileWriter::MakeScalar(TEXT("nid"), Nid));
+            Fields.Add(FMatFileWriter::MakeText(TEXT("name"), Event.Name));
+            Fields.Add(FMatFileWriter::MakeStruct(TEXT("userdata"), { TEXT("trial"), TEXT("condition") }, MoveTemp(UserData)));
+        }
+        return FMatFileWriter::MakeStruct(FString(), { TEXT("time"), TEXT("nid"), TEXT("name"), TEXT("userdata") }, MoveTemp(Fields));
+    }
+
+    /** fileinfo：Ledalab 打开文件时读取版本、日期和日志 */
+    FMatVariable BuildFileInfo(int64 SampleCount, int32 EventCount, bool bRecovered)
+    {
+        const FDateTime Now = FDateTime::Now();
+        TArray<FMatVariable> Log;
+        Log.Add(FMatFileWriter::MakeText(FString(), FString::Printf(TEXT("%s: Recorded %lld samples and %d events in game session%s"),
+            *Now.ToString(TEXT("%H:%M:%S")), SampleCount, EventCount, bRecovered ? TEXT(" (recovered after crash)") : TEXT(""))));
+
+        TArray<FMatVariable> Fields;
+        Fields.Add(FMatFileWriter::MakeScalar(TEXT("version"), LedalabVersion));
+        Fields.Add(FMatFileWriter::MakeNumbers(TEXT("date"), { static_cast<double>(Now.GetYear()), static_cast<double>(Now.GetMonth()),
+            static_cast<double>(Now.GetDay()), static_cast<double>(Now.GetHour()), static_cast<double>(Now.GetMinute()),
+            Now.GetSecond() + Now.GetMillisecond() / 1000.0 }));
+        Fields.Add(FMatFileWriter::MakeCell(TEXT("log"), MoveTemp(Log)));
+        return FMatFileWriter::MakeStruct(TEXT("fileinfo"), { TEXT("version"), TEXT("date"), TEXT("log") }, MoveTemp(Fields));
+    }
+
+    /**
+     * 补全 .mat：Mat 已经写到第 Count 个电导值之后，追加 time（从暂存文件按块复制）、timeoff、samplingrate、event
+     * 和 fileinfo，再回填 data 与 conductance 的长度
+     */
+    bool CompleteMat(FArchive& Mat, const FDataLayout& Layout, int64 Count, const FString& BasePath,
+        const TArray<FLedalabEvent>& Events, bool bRecovered, FString& OutError)
+    {
+        const FString TimePath = BasePath + TimeSuffix;
+        TUniquePtr<FArchive> TimeReader(IFileManager::Get().CreateFileReader(*TimePath));
+        if (!TimeReader || TimeReader->TotalSize() < Count * static_cast<int64>(sizeof(double)))
+        {
+            OutError = FString::Printf(TEXT("无法读取 %s"), *TimePath);
+            return false;
+        }
+
+        // time：与 conductance 相同的 1xN 行向量（矩阵头长度也相同），相对第一个样本
+        TArray<uint8> Block;
+        const int64 DataBytes = Count * static_cast<int64>(sizeof(double));
+        FMatFileWriter::WriteTag(Block, MatFormat::miMATRIX, static_cast<uint32>(Layout.DataStart - Layout.ConductanceTag - 8 + DataBytes));
+        const uint32 DoubleFlags[2] = { MatFormat::mxDOUBLE, 0 };
+        FMatFileWriter::WriteElement(Block, MatFormat::miUINT32, DoubleFlags, sizeof(DoubleFlags));
+        FMatFileWriter::WriteDimensions(Block, { 1, static_cast<int32>(Count) });
+        FMatFileWriter::WriteElement(Block, MatFormat::miINT8, nullptr, 0);
+        FMatFileWriter::WriteTag(Block, MatFormat::miDOUBLE, static_cast<uint32>(DataBytes));
+        Mat.Serialize(Block.GetData(), Block.Num());
+
+        double Origin = 0.0;
+        double Last = 0.0;
+        TArray<double> Values;
+        for (int64 Written = 0; Written < Count; Written += Values.Num())
+        {
+            Values.SetNumUninitialized(static_cast<int32>(FMath::Min<int64>(CopyBlockSamples, Count - Written)));
+            TimeReader->Serialize(Values.GetData(), Values.Num() * sizeof(double));
+            if (Written == 0)
+            {
+                Origin = Values[0];
+            }
+            for (double& Value : Values)
+            {
+                Value -= Origin;
+            }
+            Last = Values.Last();
+            Mat.Serialize(Values.GetData(), Values.Num() * sizeof(double));
+        }
+
+        Block.Reset();
+        FMatFileWriter::WriteMatrix(FMatFileWriter::MakeScalar(FString(), 0.0), FString(), Block);
+        FMatFileWriter::WriteMatrix(FMatFileWriter::MakeScalar(FString(), Count > 1 && Last > 0.0 ? (Count - 1) / Last : 0.0), FString(), Block);
+        FMatFileWriter::WriteMatrix(BuildEventStruct(Events, Origin), FString(), Block);
+        Mat.Serialize(Block.GetData(), Block.Num());
+        const int64 DataEnd = Mat.Tell();
+
+        Block.Reset();
+        FMatFileWriter::WriteMatrix(BuildFileInfo(Count, Events.Num(), bRecovered), TEXT("fileinfo"), Block);
+        Mat.Serialize(Block.GetData(), Block.Num());
+        const int64 FileEnd = Mat.Tell();
+
+        Patch(Mat, Layout.DataTag + 4, static_cast<uint32>(DataEnd - Layout.DataTag - 8));
+        Patch(Mat, Layout.ConductanceTag + 4, static_cast<uint32>(Layout.DataStart + DataBytes - Layout.ConductanceTag - 8));
+        Patch(Mat, Layout.ConductanceColumns, static_cast<uint32>(Count));
+        Patch(Mat, Layout.ConductanceData + 4, static_cast<uint32>(DataBytes));
+        Mat.Seek(FileEnd);
+        Mat.Flush();
+        return true;
+    }
+
+    /** 写出事件文件并删除暂存文件；Mat 为空时（没有样本）删除 .mat */
+    bool CompleteSession(FArchive* Mat, const FDataLayout& Layout, int64 Count, const FString& BasePath, bool bRecovered, FString& OutError)
+    {
+        double SessionStart = 0.0;
+        TArray<FLedalabEvent> Events;
+        ReadEventJournal(BasePath + EventSuffix, SessionStart, Events);
+
+        bool bSuccess = true;
+        double Origin = SessionStart;
+        if (Mat && Count > 0)
+        {
+            // 时间零点为第一个样本
+            TUniquePtr<FArchive> TimeReader(IFileManager::Get().CreateFileReader(*(BasePath + TimeSuffix)));
+            if (TimeReader && TimeReader->TotalSize() >= static_cast<int64>(sizeof(double)))
+            {
+                TimeReader->Serialize(&Origin, sizeof(Origin));
+            }
+            TimeReader.Reset();
+            bSuccess = CompleteMat(*Mat, Layout, Count, BasePath, Events, bRecovered, OutError);
+        }
+
+        const FString EventsPath = BasePath + TEXT("_events.txt");
+        if (Events.Num() > 0 && !SaveEventsFile(EventsPath, Events, Origin))
+        {
+            OutError = FString::Printf(TEXT("无法写入 %s"), *EventsPath);
+            bSuccess = false;
+        }
+
+        if (bSuccess)
+        {
+            IFileManager::Get().Delete(*(BasePath + TimeSuffix));
+            IFileManager::Get().Delete(*(BasePath + EventSuffix));
+        }
+        return bSuccess;
+    }
+}
+
+bool FLedalabSessionRecorder::Begin(const FString& InBasePath, double SessionStartTime, FString& OutError)
+{
+    if (IsOpen())
+    {
+        FString Ignored;
+        Finish(Ignored);
+    }
+
+    BasePath = InBasePath;
+    SampleCount = 0;
+    EventCount = 0;
+    LastTime = 0.0;
+    ConductanceBuffer.Reset(FlushSamples);
+    TimeBuffer.Reset(FlushSamples);
+
+    MatWriter = IFileManager::Get().CreateFileWriter(*(BasePath + TEXT(".mat")));
+    TimeWriter = IFileManager::Get().CreateFileWriter(*(BasePath + TimeSuffix));
+    EventWriter = IFileManager::Get().CreateFileWriter(*(BasePath + EventSuffix));
+    if (!MatWriter || !TimeWriter || !EventWriter)
+    {
+        OutError = FString::Printf(TEXT("无法创建 %s.mat"), *BasePath);
+        delete MatWriter;
+        delete TimeWriter;
+        delete EventWriter;
+        MatWriter = TimeWriter = EventWriter = nullptr;
+        return false;
+    }
+
+    TArray<uint8> Prefix;
+    BuildPrefix(Prefix);
+    MatWriter->Serialize(Prefix.GetData(), Prefix.Num());
+    MatWriter->Flush();
+
+    const FTCHARToUTF8 Header(*FString::Printf(TEXT("session\t%.17g\n"), SessionStartTime));
+    EventWriter->Serialize(const_cast<ANSICHAR*>(Header.Get()), Header.Length());
+    EventWriter->Flush();
+    return true;
+}
+
+void FLedalabSessionRecorder::AddSample(double Time, float InConductance)
+{
+    // Ledalab 要求时间单调递增，重连后时间回退的样本丢弃
+    if (!IsOpen() || (SampleCount > 0 && Time <= LastTime))
+    {
+        return;
+    }
+
+    LastTime = Time;
+    SampleCount++;
+    TimeBuffer.Add(Time);
+    ConductanceBuffer.Add(InConductance);
+    if (TimeBuffer.Num() >= FlushSamples)
+    {
+        FlushBuffers();
+    }
+}
+
+void FLedalabSessionRecorder::AddEvent(const FLedalabEvent& Event)
+{
+    if (!IsOpen())
+    {
+        return;
+    }
+
+    // 事件很少，每个都立即写盘
+    const FTCHARToUTF8 Line(*FString::Printf(TEXT("%.17g\t%.17g\t%d\t%s\t%s\n"), Event.Time, Event.Duration, Event.TrialIndex,
+        *SanitizeName(Event.Name), *EscapeField(Event.Condition)));
+    EventWriter->Serialize(const_cast<ANSICHAR*>(Line.Get()), Line.Length());
+    EventWriter->Flush();
+    EventCount++;
+}
+
+void FLedalabSessionRecorder::FlushBuffers()
+{
+    if (TimeBuffer.Num() == 0)
+    {
+        return;
+    }
+
+    // 先写时间再写电导，补全时取两者中较少的样本数
+    TimeWriter->Serialize(TimeBuffer.GetData(), TimeBuffer.Num() * sizeof(double));
+    TimeWriter->Flush();
+    MatWriter->Serialize(ConductanceBuffer.GetData(), ConductanceBuffer.Num() * sizeof(double));
+    MatWriter->Flush();
+    TimeBuffer.Reset();
+    ConductanceBuffer.Reset();
+}
+
+bool FLedalabSessionRecorder::Finish(FString& OutError)
+{
+    if (!IsOpen())
+    {
+        return true;
+    }
+
+    FlushBuffers();
+    delete TimeWriter;
+    delete EventWriter;
+    TimeWriter = EventWriter = nullptr;
+
+    TArray<uint8> Prefix;
+    const FDataLayout Layout = BuildPrefix(Prefix);
+    bool bSuccess = true;
+    if (SampleCount > 0)
+    {
+        bSuccess = CompleteSession(MatWriter, Layout, SampleCount, BasePath, false, OutError);
+        delete MatWriter;
+        MatWriter = nullptr;
+    }
+    else
+    {
+        delete MatWriter;
+        MatWriter = nullptr;
+        IFileManager::Get().Delete(*(BasePath + TEXT(".mat")));
+        bSuccess = CompleteSession(nullptr, Layout, 0, BasePath, false, OutError);
+    }
+    return bSuccess;
+}
+
+bool FLedalabSessionRecorder::Recover(const FString& InBasePath, FString& OutError)
+{
+    const FString MatPath = InBasePath + TEXT(".mat");
+    TArray<uint8> Prefix;
+    const FDataLayout Layout = BuildPrefix(Prefix);
+
+    // 前缀（除文件头的说明文字外）必须与流式写入的完全相同，长度仍然是占位的 0
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*MatPath));
+    TArray<uint8> Existing;
+    if (Reader && Reader->TotalSize() >= Layout.DataStart)
+    {
+        Existing.SetNumUninitialized(Layout.DataStart);
+        Reader->Serialize(Existing.GetData(), Existing.Num());
+    }
+    const int32 DescriptionBytes = 124;
+    if (Existing.Num() != Prefix.Num()
+        || FMemory::Memcmp(Existing.GetData() + DescriptionBytes, Prefix.GetData() + DescriptionBytes, Prefix.Num() - DescriptionBytes) != 0)
+    {
+        Reader.Reset();
+        IFileManager::Get().Delete(*MatPath);
+        UE_LOG(LogTemp, Warning, TEXT("%s 不完整，只补全事件"), *MatPath);
+        return CompleteSession(nullptr, Layout, 0, InBasePath, true, OutError);
+    }
+
+    const int64 ConductanceCount = (Reader->TotalSize() - Layout.DataStart) / static_cast<int64>(sizeof(double));
+    const int64 TimeCount = FMath::Max<int64>(IFileManager::Get().FileSize(*(InBasePath + TimeSuffix)), 0) / static_cast<int64>(sizeof(double));
+    const int64 Count = FMath::Min(ConductanceCount, TimeCount);
+    if (Count == 0)
+    {
+        Reader.Reset();
+        IFileManager::Get().Delete(*MatPath);
+        return CompleteSession(nullptr, Layout, 0, InBasePath, true, OutError);
+    }
+
+    // 复制前缀和完整的样本到新文件（丢弃末尾不完整的部分），再按正常结束的方式补全
+    const FString RecoveringPath = MatPath + TEXT(".recovering");
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*RecoveringPath));
+    if (!Writer)
+    {
+        OutError = FString::Printf(TEXT("无法创建 %s"), *RecoveringPath);
+        return false;
+    }
+    Writer->Serialize(Existing.GetData(), Existing.Num());
+    TArray<uint8> Block;
+    for (int64 Copied = 0; Copied < Count * static_cast<int64>(sizeof(double)); Copied += Block.Num())
+    {
+        Block.SetNumUninitialized(static_cast<int32>(FMath::Min<int64>(CopyBlockSamples * sizeof(double), Count * sizeof(double) - Copied)));
+        Reader->Serialize(Block.GetData(), Block.Num());
+        Writer->Serialize(Block.GetData(), Block.Num());
+    }
+    Reader.Reset();
+
+    const bool bSuccess = CompleteSession(Writer.Get(), Layout, Count, InBasePath, true, OutError);
+    Writer.Reset();
+    if (!bSuccess || !IFileManager::Get().Move(*MatPath, *RecoveringPath))
+    {
+        if (bSuccess)
+        {
+            OutError = FString::Printf(TEXT("无法替换 %s"), *MatPath);
+        }
+        return false;
+    }
+    return true;
+}
+
+void FLedalabSessionRecorder::RecoverDirectory(const FString& Directory, const FString& SkipBasePath)
+{
+    TArray<FString> Files;
+    IFileManager::Get().FindFiles(Files, *FPaths::Combine(Directory, FString(TEXT("*")) + TimeSuffix), true, false);
+    for (const FString& File : Files)
+    {
+        const FString BasePath = FPaths::Combine(Directory, File.LeftChop(FCString::Strlen(TimeSuffix)));
+        if (!SkipBasePath.IsEmpty() && FPaths::IsSamePath(BasePath, SkipBasePath))
+        {
+            continue;
+        }
+
+        FString Error;
+        if (Recover(BasePath, Error))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("已补全上次没有结束的会话: %s.mat"), *BasePath);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("会话补全失败: %s"), *Error);
+        }
+    }
+}
+
+FString FLedalabSessionRecorder::MakeUniqueBasePath(const FString& Directory, const FString& Prefix)
+{
+    const FString Base = FPaths::Combine(Directory, Prefix + FDateTime::Now().ToString(TEXT("_%Y%m%d_%H%M%S")));
+    auto IsUsed = [](const FString& Candidate)
+    {
+        return FPaths::FileExists(Candidate + TEXT(".mat"))
+            || FPaths::FileExists(Candidate + TimeSuffix)
+            || FPaths::FileExists(Candidate + TEXT("_events.txt"));
+    };
+
+    FString Candidate = Base;
+    for (int32 Suffix = 2; IsUsed(Candidate); Suffix++)
+    {
+        Candidate = FString::Printf(TEXT("%s_%d"), *Base, Suffix);
+    }
+    return Candidate;
+}
+
+FString FLedalabSessionRecorder::SanitizeName(const FString& Name)
+{
+    FString Result = Name.TrimStartAndEnd();
+    for (TCHAR& Character : Result.GetCharArray())
+    {
+        if (FChar::IsWhitespace(Character))
+        {
+            Character = TEXT('_');
+        }
+    }
+    return Result.IsEmpty() ? FString(TEXT("event")) : Result;
+}
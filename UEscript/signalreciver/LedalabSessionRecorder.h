@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MatFileReader.h"
+
+class FArchive;
+
+/** 一个 Ledalab 事件（对应 data.event 的一个元素和事件文件的一行）*/
+struct FLedalabEvent
+{
+    /** 共享传感器时钟上的时间（秒），导出时换算为相对第一个 GSR 样本 */
+    double Time = 0.0;
+
+    double Duration = 0.0;
+
+    /** 事件名（不含空白，Ledalab 按名称分配 nid）*/
+    FString Name;
+
+    /** 试次序号与条件，写入 userdata */
+    int32 TrialIndex = 0;
+    FString Condition;
+};
+
+/**
+ * 会话记录：采集过程中把 GSR 样本和试次事件直接写成 Ledalab 可以打开的文件，内存占用固定
+ * - <名称>.mat：data 结构（conductance、time、timeoff、samplingrate、event）与 fileinfo，与 Ledalab 保存的格式相同；
+ *   电导边采集边追加到 data.conductance，时间暂存在 <名称>.time.part，结束时追加其余字段并回填各级长度
+ * - <名称>_events.txt：Onset(s)\tDuration(s)\tEventName，可以在 Ledalab 中单独导入；事件先追加到 <名称>.events.part
+ * 进程崩溃时 .mat 的长度还没有回填，Recover 用已经写出的样本和事件补全（最多丢失 FlushSamples 个样本）
+ * 时间零点为第一个 GSR 样本（没有 GSR 时为会话开始），事件与样本使用同一个共享时钟，不需要再手工对齐
+ */
+struct WORKVOILENCEGAME_API FLedalabSessionRecorder
+{
+public:
+    /** 每积累这么多样本写盘一次（100Hz 约 2.5 秒）*/
+    static constexpr int32 FlushSamples = 256;
+
+    /** 开始新会话，创建 <BasePath>.mat 与暂存文件 */
+    bool Begin(const FString& InBasePath, double SessionStartTime, FString& OutError);
+
+    bool IsOpen() const { return MatWriter != nullptr; }
+
+    void AddSample(double Time, float Conductance);
+
+    void AddEvent(const FLedalabEvent& Event);
+
+    int64 GetSampleCount() const { return SampleCount; }
+
+    int32 GetEventCount() const { return EventCount; }
+
+    /**
+     * 结束会话：补全并回填 .mat，写出事件文件，删除暂存文件
+     * 没有 GSR 样本时 Ledalab 无法打开，只保留事件文件；样本和事件都没有时不留下任何文件
+     */
+    bool Finish(FString& OutError);
+
+    /** 补全崩溃时没有结束的会话（<BasePath>.time.part 仍然存在）*/
+    static bool Recover(const FString& InBasePath, FString& OutError);
+
+    /**
+     * 补全目录下所有没有结束的会话（只读写文件，可以在后台线程调用）
+     * SkipBasePath 为当前正在记录的会话，它的暂存文件还在写入，不能当作崩溃遗留
+     */
+    static void RecoverDirectory(const FString& Directory, const FString& SkipBasePath = FString());
+
+    /** 目录下不与已有会话重名的基础路径：<Prefix>_<日期>_<时间>，同一秒内的会话再加 _2、_3 ... */
+    static FString MakeUniqueBasePath(const FString& Directory, const FString& Prefix);
+
+    /** 把条件等文本转换为可以作为事件名的形式（空白替换为下划线）*/
+    static FString SanitizeName(const FString& Name);
+
+private:
+    /** 写出缓冲中的样本并交给操作系统 */
+    void FlushBuffers();
+
+    FString BasePath;
+    FArchive* MatWriter = nullptr;
+    FArchive* TimeWriter = nullptr;
+    FArchive* EventWriter = nullptr;
+
+    TArray<double> ConductanceBuffer;
+    TArray<double> TimeBuffer;
+
+    int64 SampleCount = 0;
+    int32 EventCount = 0;
+    double LastTime = 0.0;
+};
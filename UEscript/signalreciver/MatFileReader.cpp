@@ -0,0 +1,396 @@
+#include "MatFileReader.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Compression.h"
+
+namespace
+{
+    /** 一个数据元素（标签 + 负载）*/
+    struct FMatElement
+    {
+        uint32 Type = 0;
+        const uint8* Payload = nullptr;
+        uint32 Bytes = 0;
+    };
+
+    /** 按 8 字节对齐顺序读取数据元素 */
+    struct FMatCursor
+    {
+        const uint8* Data;
+        int64 Size;
+        int64 Offset = 0;
+
+        FMatCursor(const uint8* InData, int64 InSize) : Data(InData), Size(InSize) {}
+
+        bool AtEnd() const { return Offset + 8 > Size; }
+
+        bool Next(FMatElement& Out)
+        {
+            if (AtEnd())
+            {
+                return false;
+            }
+
+            uint32 Tag[2];
+            FMemory::Memcpy(Tag, Data + Offset, sizeof(Tag));
+
+            if (Tag[0] >> 16)
+            {
+                // 小数据元素：类型和长度共用 4 字节，负载紧随其后
+                Out.Type = Tag[0] & 0xFFFF;
+                Out.Bytes = Tag[0] >> 16;
+                Out.Payload = Data + Offset + 4;
+                if (Out.Bytes > 4)
+                {
+                    return false;
+                }
+                Offset += 8;
+                return true;
+            }
+
+            Out.Type = Tag[0];
+            Out.Bytes = Tag[1];
+            Out.Payload = Data + Offset + 8;
+            if (Offset + 8 + Out.Bytes > Size)
+            {
+                return false;
+            }
+
+            // 压缩元素没有对齐填充
+            const int64 Padded = Out.Type == MatFormat::miCOMPRESSED ? Out.Bytes : Align(Out.Bytes, 8);
+            Offset = FMath::Min(Size, Offset + 8 + Padded);
+            return true;
+        }
+    };
+
+    int32 StorageSize(uint32 Type)
+    {
+        switch (Type)
+        {
+        case MatFormat::miINT8:
+        case MatFormat::miUINT8:
+        case MatFormat::miUTF8:
+            return 1;
+        case MatFormat::miINT16:
+        case MatFormat::miUINT16:
+        case MatFormat::miUTF16:
+            return 2;
+        case MatFormat::miINT32:
+        case MatFormat::miUINT32:
+        case MatFormat::miSINGLE:
+        case MatFormat::miUTF32:
+            return 4;
+        case MatFormat::miDOUBLE:
+        case MatFormat::miINT64:
+        case MatFormat::miUINT64:
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    /** 读取第 Index 个值并转换为 double */
+    double ReadNumber(const FMatElement& Element, int32 Index)
+    {
+        const uint8* Pointer = Element.Payload + Index * StorageSize(Element.Type);
+        switch (Element.Type)
+        {
+        case MatFormat::miINT8: { int8 Value; FMemory::Memcpy(&Value, Pointer, 1); return Value; }
+        case MatFormat::miUINT8: { uint8 Value; FMemory::Memcpy(&Value, Pointer, 1); return Value; }
+        case MatFormat::miINT16: { int16 Value; FMemory::Memcpy(&Value, Pointer, 2); return Value; }
+        case MatFormat::miUINT16: { uint16 Value; FMemory::Memcpy(&Value, Pointer, 2); return Value; }
+        case MatFormat::miINT32: { int32 Value; FMemory::Memcpy(&Value, Pointer, 4); return Value; }
+        case MatFormat::miUINT32: { uint32 Value; FMemory::Memcpy(&Value, Pointer, 4); return Value; }
+        case MatFormat::miSINGLE: { float Value; FMemory::Memcpy(&Value, Pointer, 4); return Value; }
+        case MatFormat::miDOUBLE: { double Value; FMemory::Memcpy(&Value, Pointer, 8); return Value; }
+        case MatFormat::miINT64: { int64 Value; FMemory::Memcpy(&Value, Pointer, 8); return static_cast<double>(Value); }
+        case MatFormat::miUINT64: { uint64 Value; FMemory::Memcpy(&Value, Pointer, 8); return static_cast<double>(Value); }
+        default: return 0.0;
+        }
+    }
+
+    /** 解压一个 miCOMPRESSED 元素的负载（zlib 流，内含一个完整的数据元素） */
+    bool Inflate(const uint8* Data, uint32 Size, TArray<uint8>& Out)
+    {
+        // FCompression 需要准确的解压后大小，MAT 文件不记录它：先只解出开头 8 字节的元素标签
+        // （输出缓冲区不够，这次调用返回失败，引擎会记一条解压失败的日志，但标签已经写出），再按标签里的长度完整解压
+        uint32 Tag[2] = { 0, 0 };
+        FCompression::UncompressMemory(NAME_Zlib, Tag, sizeof(Tag), Data, Size);
+        if (Tag[0] == 0)
+        {
+            return false;
+        }
+
+        const int64 Total = (Tag[0] >> 16) ? 8 : 8 + static_cast<int64>(Tag[1]);
+        if (Total > MAX_int32)
+        {
+            return false;
+        }
+        Out.SetNumUninitialized(static_cast<int32>(Total));
+        return FCompression::UncompressMemory(NAME_Zlib, Out.GetData(), Out.Num(), Data, Size);
+    }
+
+    bool ParseMatrix(const uint8* Data, uint32 Size, FMatVariable& Out, FString& OutError);
+
+    bool ParseElement(const FMatElement& Element, FMatVariable& Out, FString& OutError)
+    {
+        if (Element.Type == MatFormat::miCOMPRESSED)
+        {
+            TArray<uint8> Inflated;
+            if (!Inflate(Element.Payload, Element.Bytes, Inflated))
+            {
+                OutError = TEXT("压缩数据解压失败");
+                return false;
+            }
+
+            FMatCursor Cursor(Inflated.GetData(), Inflated.Num());
+            FMatElement Inner;
+            if (!Cursor.Next(Inner))
+            {
+                OutError = TEXT("压缩元素为空");
+                return false;
+            }
+            return ParseElement(Inner, Out, OutError);
+        }
+
+        if (Element.Type != MatFormat::miMATRIX)
+        {
+            // 顶层的其他元素类型没有意义，跳过
+            Out.Type = FMatVariable::EType::Unsupported;
+            return true;
+        }
+        return ParseMatrix(Element.Payload, Element.Bytes, Out, OutError);
+    }
+
+    bool ParseMatrix(const uint8* Data, uint32 Size, FMatVariable& Out, FString& OutError)
+    {
+        Out.Type = FMatVariable::EType::Unsupported;
+        if (Size == 0)
+        {
+            // 空矩阵（结构体中未赋值的字段）
+            Out.Type = FMatVariable::EType::Numeric;
+            Out.Dimensions = { 0, 0 };
+            return true;
+        }
+
+        FMatCursor Cursor(Data, Size);
+        FMatElement Flags;
+        if (!Cursor.Next(Flags) || Flags.Bytes < 8)
+        {
+            OutError = TEXT("矩阵头不完整");
+            return false;
+        }
+
+        uint32 FlagWords[2];
+        FMemory::Memcpy(FlagWords, Flags.Payload, sizeof(FlagWords));
+        const uint8 Class = FlagWords[0] & 0xFF;
+        if (Class == MatFormat::mxOPAQUE)
+        {
+            // MATLAB 对象（table 等）的布局未公开，跳过
+            return true;
+        }
+
+        FMatElement Dimensions, Name;
+        if (!Cursor.Next(Dimensions) || !Cursor.Next(Name) || Dimensions.Type != MatFormat::miINT32)
+        {
+            OutError = TEXT("矩阵头不完整");
+            return false;
+        }
+
+        for (uint32 Index = 0; Index < Dimensions.Bytes / 4; Index++)
+        {
+            Out.Dimensions.Add(static_cast<int32>(ReadNumber(Dimensions, Index)));
+        }
+        Out.Name = FString(Name.Bytes, reinterpret_cast<const ANSICHAR*>(Name.Payload));
+
+        const int32 Count = Out.NumElements();
+
+        if (Class == MatFormat::mxCELL)
+        {
+            Out.Type = FMatVariable::EType::Cell;
+            for (int32 Index = 0; Index < Count; Index++)
+            {
+                FMatElement Child;
+                if (!Cursor.Next(Child) || !ParseElement(Child, Out.Children.AddDefaulted_GetRef(), OutError))
+                {
+                    OutError = TEXT("元胞元素不完整");
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        if (Class == MatFormat::mxSTRUCT)
+        {
+            FMatElement NameLength, Names;
+            if (!Cursor.Next(NameLength) || !Cursor.Next(Names) || NameLength.Bytes < 4)
+            {
+                OutError = TEXT("结构体字段名不完整");
+                return false;
+            }
+
+            const int32 FieldLength = static_cast<int32>(ReadNumber(NameLength, 0));
+            for (int32 Start = 0; FieldLength > 0 && Start + FieldLength <= static_cast<int32>(Names.Bytes); Start += FieldLength)
+            {
+                const ANSICHAR* Field = reinterpret_cast<const ANSICHAR*>(Names.Payload + Start);
+                Out.FieldNames.Add(FString(FCStringAnsi::Strnlen(Field, FieldLength), Field));
+            }
+
+            Out.Type = FMatVariable::EType::Struct;
+            for (int32 Index = 0; Index < Count * Out.FieldNames.Num(); Index++)
+            {
+                FMatElement Child;
+                if (!Cursor.Next(Child) || !ParseElement(Child, Out.Children.AddDefaulted_GetRef(), OutError))
+                {
+                    OutError = FString::Printf(TEXT("结构体 %s 的字段不完整"), *Out.Name);
+                    return false;
+                }
+                Out.Children.Last().Name = Out.FieldNames[Index % Out.FieldNames.Num()];
+            }
+            return true;
+        }
+
+        FMatElement Real;
+        if (!Cursor.Next(Real))
+        {
+            Out.Type = Class == MatFormat::mxCHAR ? FMatVariable::EType::Char : FMatVariable::EType::Numeric;
+            return true;
+        }
+
+        if (Class == MatFormat::mxCHAR)
+        {
+            Out.Type = FMatVariable::EType::Char;
+            if (Real.Type == MatFormat::miUTF8 || Real.Type == MatFormat::miINT8 || Real.Type == MatFormat::miUINT8)
+            {
+                Out.Text = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Real.Payload), Real.Bytes));
+            }
+            else
+            {
+                const int32 Characters = StorageSize(Real.Type) > 0 ? Real.Bytes / StorageSize(Real.Type) : 0;
+                for (int32 Index = 0; Index < Characters; Index++)
+                {
+                    Out.Text.AppendChar(static_cast<TCHAR>(ReadNumber(Real, Index)));
+                }
+            }
+            return true;
+        }
+
+        if (Class >= MatFormat::mxDOUBLE && Class <= MatFormat::mxUINT64)
+        {
+            const int32 ElementSize = StorageSize(Real.Type);
+            if (ElementSize == 0)
+            {
+                OutError = FString::Printf(TEXT("矩阵 %s 的存储类型 %u 不支持"), *Out.Name, Real.Type);
+                return false;
+            }
+
+            // MATLAB 会用更窄的整数类型存储整数值的 double 矩阵，统一转换
+            const int32 Stored = FMath::Min<int32>(Count, Real.Bytes / ElementSize);
+            Out.Type = FMatVariable::EType::Numeric;
+            Out.Numbers.SetNumUninitialized(Stored);
+            for (int32 Index = 0; Index < Stored; Index++)
+            {
+                Out.Numbers[Index] = ReadNumber(Real, Index);
+            }
+        }
+
+        // 稀疏矩阵、对象等不需要
+        return true;
+    }
+}
+
+int32 FMatVariable::NumElements() const
+{
+    if (Dimensions.Num() == 0)
+    {
+        return 0;
+    }
+
+    int64 Count = 1;
+    for (int32 Dimension : Dimensions)
+    {
+        Count *= FMath::Max(Dimension, 0);
+    }
+    return static_cast<int32>(FMath::Min<int64>(Count, MAX_int32));
+}
+
+const FMatVariable* FMatVariable::FindField(const FString& Field, int32 Element) const
+{
+    if (Type != EType::Struct)
+    {
+        return nullptr;
+    }
+
+    const int32 FieldIndex = FieldNames.IndexOfByKey(Field);
+    const int32 ChildIndex = Element * FieldNames.Num() + FieldIndex;
+    return FieldIndex != INDEX_NONE && Children.IsValidIndex(ChildIndex) ? &Children[ChildIndex] : nullptr;
+}
+
+bool FMatFileReader::Load(const FString& Path, TArray<FMatVariable>& OutVariables, FString& OutError)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+    {
+        OutError = FString::Printf(TEXT("无法读取 %s"), *Path);
+        return false;
+    }
+    return Parse(Bytes.GetData(), Bytes.Num(), OutVariables, OutError);
+}
+
+bool FMatFileReader::Parse(const uint8* Data, int64 Size, TArray<FMatVariable>& OutVariables, FString& OutError)
+{
+    if (Size < MatFormat::HeaderSize)
+    {
+        OutError = TEXT("文件太短，不是 MAT v5 文件");
+        return false;
+    }
+
+    // 字节序标记 "IM" 表示小端写入
+    if (Data[126] != 'I' || Data[127] != 'M')
+    {
+        OutError = TEXT("只支持小端 MAT v5 文件");
+        return false;
+    }
+
+    FMatCursor Cursor(Data + MatFormat::HeaderSize, Size - MatFormat::HeaderSize);
+    FMatElement Element;
+    while (Cursor.Next(Element))
+    {
+        FMatVariable Variable;
+        if (!ParseElement(Element, Variable, OutError))
+        {
+            return false;
+        }
+        if (Variable.Type != FMatVariable::EType::Unsupported)
+        {
+            OutVariables.Add(MoveTemp(Variable));
+        }
+    }
+    return true;
+}
+
+const FMatVariable* FMatFileReader::Find(const TArray<FMatVariable>& Variables, const FString& Path)
+{
+    TArray<FString> Parts;
+    Path.ParseIntoArray(Parts, TEXT("."));
+    if (Parts.Num() == 0)
+    {
+        return nullptr;
+    }
+
+    const FMatVariable* Current = Variables.FindByPredicate([&Parts](const FMatVariable& Variable)
+    {
+        return Variable.Name == Parts[0];
+    });
+
+    for (int32 Index = 1; Current && Index < Parts.Num(); Index++)
+    {
+        Current = Current->FindField(Parts[Index]);
+    }
+    return Current;
+}
+
+const TArray<double>* FMatFileReader::FindNumbers(const TArray<FMatVariable>& Variables, const FString& Path)
+{
+    const FMatVariable* Variable = Find(Variables, Path);
+    return Variable && Variable->Type == FMatVariable::EType::Numeric ? &Variable->Numbers : nullptr;
+}
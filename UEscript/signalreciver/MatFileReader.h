@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// === MAT v5 常量 ===
+
+namespace MatFormat
+{
+    enum : uint32
+    {
+        miINT8 = 1,
+        miUINT8 = 2,
+        miINT16 = 3,
+        miUINT16 = 4,
+        miINT32 = 5,
+        miUINT32 = 6,
+        miSINGLE = 7,
+        miDOUBLE = 9,
+        miINT64 = 12,
+        miUINT64 = 13,
+        miMATRIX = 14,
+        miCOMPRESSED = 15,
+        miUTF8 = 16,
+        miUTF16 = 17,
+        miUTF32 = 18
+    };
+
+    enum : uint8
+    {
+        mxCELL = 1,
+        mxSTRUCT = 2,
+        mxCHAR = 4,
+        mxDOUBLE = 6,
+        mxUINT64 = 15,
+        mxOPAQUE = 17
+    };
+
+    constexpr int32 HeaderSize = 128;
+}
+
+/** MAT v5 文件中的一个变量（数值矩阵、字符串、结构体或元胞）*/
+struct WORKVOILENCEGAME_API FMatVariable
+{
+    enum class EType : uint8
+    {
+        Numeric,
+        Char,
+        Struct,
+        Cell,
+        Unsupported
+    };
+
+    FString Name;
+    EType Type = EType::Unsupported;
+
+    /** 维度，例如行向量为 [1, N] */
+    TArray<int32> Dimensions;
+
+    /** 数值矩阵的实部（列优先），任何存储类型都转换为 double */
+    TArray<double> Numbers;
+
+    /** 字符数组的内容 */
+    FString Text;
+
+    /** 结构体的字段名 */
+    TArray<FString> FieldNames;
+
+    /** 结构体：按元素、再按字段排列；元胞：按元素排列 */
+    TArray<FMatVariable> Children;
+
+    int32 NumElements() const;
+
+    /** 结构体字段，找不到时返回 nullptr */
+    const FMatVariable* FindField(const FString& Field, int32 Element = 0) const;
+};
+
+/**
+ * MAT v5 读取器（只读，小端，支持 miCOMPRESSED）
+ * 用于读取 Ledalab 的 data/analysis 结构和 scrList 导出，例如 Experiment/keyboardGroup/test_keyboard.mat
+ * 压缩元素用 FCompression（NAME_Zlib）解压，与会话文件相同，不需要额外的模块依赖
+ */
+class WORKVOILENCEGAME_API FMatFileReader
+{
+public:
+    /** 读取整个文件的顶层变量 */
+    static bool Load(const FString& Path, TArray<FMatVariable>& OutVariables, FString& OutError);
+
+    static bool Parse(const uint8* Data, int64 Size, TArray<FMatVariable>& OutVariables, FString& OutError);
+
+    /** 按 "data.conductance" 这样的路径查找（结构体只取第一个元素）*/
+    static const FMatVariable* Find(const TArray<FMatVariable>& Variables, const FString& Path);
+
+    /** 查找数值变量，找不到或不是数值时返回 nullptr */
+    static const TArray<double>* FindNumbers(const TArray<FMatVariable>& Variables, const FString& Path);
+};
@@ -0,0 +1,193 @@
+#include "MatFileWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/DateTime.h"
+
+bool FMatFileWriter::Save(const FString& Path, const TArray<FMatVariable>& Variables, FString& OutError)
+{
+    TArray<uint8> Data;
+    Serialize(Variables, Data);
+    if (!FFileHelper::SaveArrayToFile(Data, *Path))
+    {
+        OutError = FString::Printf(TEXT("无法写入 %s"), *Path);
+        return false;
+    }
+    return true;
+}
+
+void FMatFileWriter::Serialize(const TArray<FMatVariable>& Variables, TArray<uint8>& OutData)
+{
+    WriteHeader(OutData);
+    for (const FMatVariable& Variable : Variables)
+    {
+        WriteMatrix(Variable, Variable.Name, OutData);
+    }
+}
+
+void FMatFileWriter::WriteHeader(TArray<uint8>& OutData)
+{
+    // 116 字节说明文字（空格补齐）+ 8 字节子系统偏移 + 版本 0x0100 + 字节序标记 "IM"
+    const FString Description = FString::Printf(TEXT("MATLAB 5.0 MAT-file, Platform: UnrealEngine, Created on: %s"),
+        *FDateTime::Now().ToString(TEXT("%Y-%m-%d %H:%M:%S")));
+    const FTCHARToUTF8 Text(*Description);
+    const int32 TextBytes = FMath::Min(Text.Length(), 116);
+    OutData.Append(reinterpret_cast<const uint8*>(Text.Get()), TextBytes);
+    OutData.AddUninitialized(116 - TextBytes);
+    FMemory::Memset(OutData.GetData() + TextBytes, ' ', 116 - TextBytes);
+    OutData.AddZeroed(8);
+    const uint8 Version[4] = { 0x00, 0x01, 'I', 'M' };
+    OutData.Append(Version, sizeof(Version));
+}
+
+void FMatFileWriter::WriteTag(TArray<uint8>& OutData, uint32 Type, uint32 Bytes)
+{
+    const uint32 Tag[2] = { Type, Bytes };
+    OutData.Append(reinterpret_cast<const uint8*>(Tag), sizeof(Tag));
+}
+
+void FMatFileWriter::WriteElement(TArray<uint8>& OutData, uint32 Type, const void* Data, uint32 Bytes)
+{
+    WriteTag(OutData, Type, Bytes);
+    OutData.Append(static_cast<const uint8*>(Data), Bytes);
+    OutData.AddZeroed(static_cast<int32>(Align(Bytes, 8) - Bytes));
+}
+
+void FMatFileWriter::WriteDimensions(TArray<uint8>& OutData, const TArray<int32>& Dimensions)
+{
+    TArray<int32> Padded = Dimensions;
+    while (Padded.Num() < 2)
+    {
+        Padded.Add(Padded.Num() == 0 ? 0 : 1);
+    }
+    WriteElement(OutData, MatFormat::miINT32, Padded.GetData(), Padded.Num() * sizeof(int32));
+}
+
+void FMatFileWriter::WriteFieldNames(TArray<uint8>& OutData, const TArray<FString>& FieldNames)
+{
+    int32 FieldLength = 1;
+    for (const FString& Field : FieldNames)
+    {
+        FieldLength = FMath::Max(FieldLength, FTCHARToUTF8(*Field).Length() + 1);
+    }
+    WriteElement(OutData, MatFormat::miINT32, &FieldLength, sizeof(FieldLength));
+
+    TArray<uint8> Names;
+    Names.AddZeroed(FieldLength * FieldNames.Num());
+    for (int32 Index = 0; Index < FieldNames.Num(); Index++)
+    {
+        const FTCHARToUTF8 Field(*FieldNames[Index]);
+        FMemory::Memcpy(Names.GetData() + Index * FieldLength, Field.Get(), Field.Length());
+    }
+    WriteElement(OutData, MatFormat::miINT8, Names.GetData(), Names.Num());
+}
+
+void FMatFileWriter::WriteMatrix(const FMatVariable& Variable, const FString& Name, TArray<uint8>& OutData)
+{
+    // 先写占位标签，写完内容后回填长度
+    const int32 Start = OutData.Num();
+    WriteTag(OutData, MatFormat::miMATRIX, 0);
+
+    uint8 Class = MatFormat::mxDOUBLE;
+    switch (Variable.Type)
+    {
+    case FMatVariable::EType::Char: Class = MatFormat::mxCHAR; break;
+    case FMatVariable::EType::Struct: Class = MatFormat::mxSTRUCT; break;
+    case FMatVariable::EType::Cell: Class = MatFormat::mxCELL; break;
+    default: break;
+    }
+    const uint32 Flags[2] = { Class, 0 };
+    WriteElement(OutData, MatFormat::miUINT32, Flags, sizeof(Flags));
+    WriteDimensions(OutData, Variable.Dimensions);
+
+    const FTCHARToUTF8 NameText(*Name);
+    WriteElement(OutData, MatFormat::miINT8, NameText.Get(), NameText.Length());
+
+    switch (Variable.Type)
+    {
+    case FMatVariable::EType::Char:
+    {
+        // UTF-16，与 MATLAB 保存的字符数组相同
+        TArray<uint16> Characters;
+        for (const TCHAR Character : Variable.Text)
+        {
+            Characters.Add(static_cast<uint16>(Character));
+        }
+        WriteElement(OutData, MatFormat::miUINT16, Characters.GetData(), Characters.Num() * sizeof(uint16));
+        break;
+    }
+    case FMatVariable::EType::Struct:
+    {
+        WriteFieldNames(OutData, Variable.FieldNames);
+
+        // 字段值没有名字
+        for (const FMatVariable& Child : Variable.Children)
+        {
+            WriteMatrix(Child, FString(), OutData);
+        }
+        break;
+    }
+    case FMatVariable::EType::Cell:
+        for (const FMatVariable& Child : Variable.Children)
+        {
+            WriteMatrix(Child, FString(), OutData);
+        }
+        break;
+    default:
+        WriteElement(OutData, MatFormat::miDOUBLE, Variable.Numbers.GetData(), Variable.Numbers.Num() * sizeof(double));
+        break;
+    }
+
+    const uint32 Bytes = static_cast<uint32>(OutData.Num() - Start - 8);
+    FMemory::Memcpy(OutData.GetData() + Start + 4, &Bytes, sizeof(Bytes));
+}
+
+FMatVariable FMatFileWriter::MakeNumbers(const FString& Name, const TArray<double>& Values)
+{
+    FMatVariable Variable;
+    Variable.Name = Name;
+    Variable.Type = FMatVariable::EType::Numeric;
+    Variable.Dimensions = Values.Num() > 0 ? TArray<int32>{ 1, Values.Num() } : TArray<int32>{ 0, 0 };
+    Variable.Numbers = Values;
+    return Variable;
+}
+
+FMatVariable FMatFileWriter::MakeScalar(const FString& Name, double Value)
+{
+    return MakeNumbers(Name, { Value });
+}
+
+FMatVariable FMatFileWriter::MakeText(const FString& Name, const FString& Text)
+{
+    FMatVariable Variable;
+    Variable.Name = Name;
+    Variable.Type = FMatVariable::EType::Char;
+    Variable.Dimensions = Text.Len() > 0 ? TArray<int32>{ 1, Text.Len() } : TArray<int32>{ 0, 0 };
+    Variable.Text = Text;
+    return Variable;
+}
+
+FMatVariable FMatFileWriter::MakeCell(const FString& Name, TArray<FMatVariable> Elements)
+{
+    FMatVariable Variable;
+    Variable.Name = Name;
+    Variable.Type = FMatVariable::EType::Cell;
+    Variable.Dimensions = Elements.Num() > 0 ? TArray<int32>{ 1, Elements.Num() } : TArray<int32>{ 0, 0 };
+    Variable.Children = MoveTemp(Elements);
+    return Variable;
+}
+
+FMatVariable FMatFileWriter::MakeStruct(const FString& Name, const TArray<FString>& FieldNames, TArray<FMatVariable> Children)
+{
+    FMatVariable Variable;
+    Variable.Name = Name;
+    Variable.Type = FMatVariable::EType::Struct;
+    Variable.FieldNames = FieldNames;
+
+    const int32 Count = FieldNames.Num() > 0 ? Children.Num() / FieldNames.Num() : 0;
+    Variable.Dimensions = Count > 0 ? TArray<int32>{ 1, Count } : TArray<int32>{ 0, 0 };
+    Variable.Children = MoveTemp(Children);
+    for (int32 Index = 0; Index < Variable.Children.Num(); Index++)
+    {
+        Variable.Children[Index].Name = FieldNames[Index % FieldNames.Num()];
+    }
+    return Variable;
+}
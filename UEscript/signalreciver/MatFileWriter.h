@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MatFileReader.h"
+
+/**
+ * MAT v5 写入器（小端，不压缩），MATLAB 和 Ledalab 可以直接 load
+ * 变量的表示与 FMatFileReader 相同，写出的文件可以用它读回校验
+ * 支持数值（按 double 存储）、字符串、结构体（数组）和元胞
+ */
+class WORKVOILENCEGAME_API FMatFileWriter
+{
+public:
+    static bool Save(const FString& Path, const TArray<FMatVariable>& Variables, FString& OutError);
+
+    /** 文件头 + 所有顶层变量 */
+    static void Serialize(const TArray<FMatVariable>& Variables, TArray<uint8>& OutData);
+
+    // === 构造变量 ===
+
+    /** 行向量（1xN），空数组写成 0x0（MATLAB 的 []）*/
+    static FMatVariable MakeNumbers(const FString& Name, const TArray<double>& Values);
+
+    static FMatVariable MakeScalar(const FString& Name, double Value);
+
+    static FMatVariable MakeText(const FString& Name, const FString& Text);
+
+    /** 1xN 元胞 */
+    static FMatVariable MakeCell(const FString& Name, TArray<FMatVariable> Elements);
+
+    /** 1xN 结构体数组，Children 按元素、再按字段排列（与 FMatFileReader 相同）；N 为 0 时写成 0x0 */
+    static FMatVariable MakeStruct(const FString& Name, const TArray<FString>& FieldNames, TArray<FMatVariable> Children);
+
+    // === 底层元素（流式写入时用来拼接和回填）===
+
+    /** 128 字节文件头 */
+    static void WriteHeader(TArray<uint8>& OutData);
+
+    /** 一个变量（miMATRIX 元素），Name 为空时用作结构体字段或元胞元素 */
+    static void WriteMatrix(const FMatVariable& Variable, const FString& Name, TArray<uint8>& OutData);
+
+    static void WriteTag(TArray<uint8>& OutData, uint32 Type, uint32 Bytes);
+
+    /** 标签 + 负载，补齐到 8 字节 */
+    static void WriteElement(TArray<uint8>& OutData, uint32 Type, const void* Data, uint32 Bytes);
+
+    /** 维度（至少两维）*/
+    static void WriteDimensions(TArray<uint8>& OutData, const TArray<int32>& Dimensions);
+
+    /** 结构体的字段名长度与字段名表 */
+    static void WriteFieldNames(TArray<uint8>& OutData, const TArray<FString>& FieldNames);
+};
@@ -1,10 +1,30 @@
 #include "OSCReceiver.h"
 #include "OSCManager.h"
+#include "OSCClient.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 #include "OSCAddress.h"
 #include "SocketSubsystem.h"
 #include "IPAddress.h"
+#include "SensorClock.h"
+#include "SessionIndex.h"
+#include "SessionPyramid.h"
+#include "GroupComparison.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Async/Async.h"
+
+namespace
+{
+    /** OSC bundle 头："#bundle\0" + 时间标签 */
+    constexpr int32 OSCBundleHeaderBytes = 16;
+
+    /** 一条消息在 bundle 中的编码字节数：长度前缀 + 地址 + 类型标签 + 参数（参数都是 4 字节的 int32 / float）*/
+    int32 GetFeedbackMessageBytes(const FString& Address, int32 NumArguments)
+    {
+        return 4 + Align(Address.Len() + 1, 4) + Align(NumArguments + 2, 4) + 4 * NumArguments;
+    }
+}
 
 // 静态变量定义
 int32 AOSCReceiver::MessageID = 0;
@@ -20,6 +40,7 @@ float AOSCReceiver::JoystickY = 0.0f;
 // 压力传感器数据
 float AOSCReceiver::Pressure1 = 0.0f;
 float AOSCReceiver::Pressure2 = 0.0f;
+FPressureNormalizer AOSCReceiver::PressureNormalizers[2];
 
 // 加速度数据
 float AOSCReceiver::AccelX = 0.0f;
@@ -31,11 +52,57 @@ float AOSCReceiver::GyroX = 0.0f;
 float AOSCReceiver::GyroY = 0.0f;
 float AOSCReceiver::GyroZ = 0.0f;
 
+// 原始 IMU 数据与零偏估计
+TMap<FString, FImuDeviceState> AOSCReceiver::ImuDevices;
+FString AOSCReceiver::ImuDeviceAddress = TEXT("");
+
 // 按钮状态
 bool AOSCReceiver::Button1 = false;
 bool AOSCReceiver::Button2 = false;
 bool AOSCReceiver::Button3 = false;
 bool AOSCReceiver::Button4 = false;
+double AOSCReceiver::InputSensorTime = 0.0;
+FOnHandleInputSampleNative AOSCReceiver::OnInputSample;
+double AOSCReceiver::LastInputSampleTimes[3] = { 0.0, 0.0, 0.0 };
+
+// GSR
+FGsrSample AOSCReceiver::LatestGsrSample;
+int32 AOSCReceiver::GsrSampleCount = 0;
+bool AOSCReceiver::bGsrConnected = false;
+FOnGsrSampleNative AOSCReceiver::OnGsrSampleReceived;
+
+// 试次标记
+int32 AOSCReceiver::TrialCount = 0;
+FTrialMarker AOSCReceiver::LastTrialMarker;
+FOnTrialMarkerNative AOSCReceiver::OnTrialMarker;
+FLedalabSessionRecorder AOSCReceiver::LedalabRecorder;
+FSessionRecorder AOSCReceiver::SessionRecorder;
+TFuture<void> AOSCReceiver::SessionMaintenance;
+
+// 反向通道
+TArray<FOSCBundle> AOSCReceiver::PendingFeedbackBundles;
+int32 AOSCReceiver::PendingFeedbackBytes = 0;
+int32 AOSCReceiver::PendingFeedbackCount = 0;
+int32 AOSCReceiver::DroppedFeedbackCount = 0;
+int32 AOSCReceiver::FeedbackSequence = 0;
+double AOSCReceiver::FeedbackSendTimes[AOSCReceiver::FeedbackHistorySize] = {};
+float AOSCReceiver::LastFeedbackLatency = -1.0f;
+float AOSCReceiver::AverageFeedbackLatency = -1.0f;
+int32 AOSCReceiver::NegotiatedRates[2] = { 0, 0 };
+EHandleTransmitMode AOSCReceiver::TransmitModes[2] = { EHandleTransmitMode::Idle, EHandleTransmitMode::Idle };
+FTransmitModeScheduler AOSCReceiver::TransmitModeScheduler;
+
+// 增量帧
+FFrameSequenceTracker AOSCReceiver::FrameTrackers[2];
+
+// 定时采样历史
+TArray<FHandleSample> AOSCReceiver::HandleSamples;
+int32 AOSCReceiver::HandleSampleWriteIndex = 0;
+bool AOSCReceiver::bHasDeviceTime[2] = { false, false };
+uint32 AOSCReceiver::LastDeviceMicros[2] = { 0, 0 };
+double AOSCReceiver::LatestDeviceTimes[2] = { 0.0, 0.0 };
+FDeviceClockAligner AOSCReceiver::HandleClockAligners[2];
+double AOSCReceiver::LastBatchArrivalTimes[2] = { -1.0, -1.0 };
 
 AOSCReceiver::AOSCReceiver()
 {
@@ -70,6 +137,35 @@ void AOSCReceiver::BeginPlay()
         UE_LOG(LogTemp, Error, TEXT("无法创建OSC服务器！"));
     }
 
+    // 重置反向通道
+    FeedbackClient = nullptr;
+    PendingFeedbackBundles.Reset();
+    PendingFeedbackBytes = 0;
+    PendingFeedbackCount = 0;
+    DroppedFeedbackCount = 0;
+    FeedbackSequence = 0;
+    LastFeedbackLatency = -1.0f;
+    AverageFeedbackLatency = -1.0f;
+    for (int32 Index = 0; Index < 2; Index++)
+    {
+        NegotiatedRates[Index] = 0;
+        TransmitModes[Index] = EHandleTransmitMode::Idle;
+        FrameTrackers[Index].Reset();
+        bHasDeviceTime[Index] = false;
+        LastDeviceMicros[Index] = 0;
+        LatestDeviceTimes[Index] = 0.0;
+        HandleClockAligners[Index].Reset();
+        LastBatchArrivalTimes[Index] = -1.0;
+    }
+    for (double& Time : LastInputSampleTimes)
+    {
+        Time = 0.0;
+    }
+    TransmitModeScheduler.Reset();
+    HandleSamples.Reset();
+    HandleSampleWriteIndex = 0;
+    bFramedStream = false;
+
     // 重置所有数据
     MessageID = 0;
     Timestamp = 0.0f;
@@ -83,20 +179,173 @@ void AOSCReceiver::BeginPlay()
     JoystickY = 0.0f;
     Pressure1 = 0.0f;
     Pressure2 = 0.0f;
+    for (FPressureNormalizer& Normalizer : PressureNormalizers)
+    {
+        Normalizer.Reset();
+        Normalizer.WarmupDuration = PressureWarmupDuration;
+        Normalizer.ActivityFloor = PressureActivityFloor;
+    }
     AccelX = 0.0f;
     AccelY = 0.0f;
     AccelZ = 0.0f;
     GyroX = 0.0f;
     GyroY = 0.0f;
     GyroZ = 0.0f;
+    ImuDevices.Reset();
+    ImuDeviceAddress = TEXT("");
     Button1 = false;
     Button2 = false;
     Button3 = false;
     Button4 = false;
+    InputSensorTime = 0.0;
+    TrialCount = 0;
+    LastTrialMarker = FTrialMarker();
+
+    // Ledalab 文件边采集边写盘（上一个会话没有结束时 Begin 会先结束它）
+    if (bExportLedalabSession)
+    {
+        const FString Directory = LedalabExportDirectory.IsEmpty()
+            ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Ledalab")) : LedalabExportDirectory;
+        IFileManager::Get().MakeDirectory(*Directory, true);
+
+        const FString BasePath = FLedalabSessionRecorder::MakeUniqueBasePath(Directory, TEXT("Session"));
+        FString Error;
+        if (!LedalabRecorder.Begin(BasePath, FSensorClock::Now(), Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Ledalab 会话记录失败: %s"), *Error);
+        }
+
+        // 在后台补全上次崩溃时没有结束的会话，跳过刚刚打开的这一个
+        RunSessionMaintenance([Directory, BasePath]()
+        {
+            FLedalabSessionRecorder::RecoverDirectory(Directory, BasePath);
+        });
+    }
+
+    // 启动会话记录（后台线程写盘，游戏线程只做一次拷贝）
+    if (bRecordSession)
+    {
+        const FString Directory = SessionRecordDirectory.IsEmpty()
+            ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Sessions")) : SessionRecordDirectory;
+        IFileManager::Get().MakeDirectory(*Directory, true);
+        SessionRecorder.Start(FSessionRecorder::MakeUniquePath(Directory, TEXT("Session")), FSensorClock::Now());
+    }
+
+    // 启动 GSR 采集
+    LatestGsrSample = FGsrSample();
+    GsrSampleCount = 0;
+    bGsrConnected = false;
+    if (bEnableGsr)
+    {
+        if (bGsrSynthetic)
+        {
+            FGsrSignalSynthesizer Synthesizer;
+            Synthesizer.ConfigureForProtocol(bGsrBinaryProtocol, GsrSampleRateHz);
+            GsrSource = FGsrSource::CreateSynthetic(Synthesizer, bGsrBinaryProtocol,
+                FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("GsrSyntheticTruth.txt")));
+        }
+        else if (GsrUdpPort > 0)
+        {
+            GsrSource = FGsrSource::CreateUdp(GsrUdpPort);
+        }
+        else if (!GsrSerialPort.IsEmpty())
+        {
+            // 波特率不受支持时返回 nullptr（已记录错误）
+            GsrSource = FGsrSource::CreateSerial(GsrSerialPort, GsrBaudRate, bGsrBinaryProtocol, GsrSampleRateHz);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("GSR 已启用但未设置串口或 UDP 端口！"));
+        }
+
+        if (GsrSource)
+        {
+            GsrSource->Start();
+            UE_LOG(LogTemp, Warning, TEXT("GSR 采集已启动: %s"), *GsrSource->GetDescription());
+        }
+    }
 }
 
 void AOSCReceiver::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+    if (FeedbackClient)
+    {
+        // 离开时让手柄回到空闲模式
+        if (bAutoTransmitMode)
+        {
+            QueueHandleTransmitMode(ModeSwitchHandle, EHandleTransmitMode::Idle);
+        }
+        FlushFeedback();
+        FeedbackClient->Stop();
+        FeedbackClient = nullptr;
+    }
+
+    // 停止 GSR 后台线程
+    DrainGsrSamples();
+    GsrSource.Reset();
+    bGsrConnected = false;
+
+    // 结束 Ledalab 文件（样本与事件都在共享时钟上，不需要再手工对齐）
+    if (LedalabRecorder.IsOpen())
+    {
+        const int64 SampleCount = LedalabRecorder.GetSampleCount();
+        const int32 EventCount = LedalabRecorder.GetEventCount();
+        FString Error;
+        if (LedalabRecorder.Finish(Error))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Ledalab 文件已导出（%lld 个样本，%d 个事件）"), SampleCount, EventCount);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("Ledalab 导出失败: %s"), *Error);
+        }
+    }
+
+    // GSR 已全部取出，写出剩余的列块
+    const bool bWasRecording = SessionRecorder.IsRecording();
+    SessionRecorder.Shutdown();
+
+    // 文件已完整：分析后追加到同一目录的会话索引（只追加一行，不重写索引），并在会话旁边生成时间线金字塔供查看器按像素宽度读取
+    // 两步共用一次读取，读取和 CDA 都放到后台维护里执行，不卡住游戏线程
+    if (bWasRecording && (bIndexSession || bBuildSessionPyramid))
+    {
+        RunSessionMaintenance([SessionPath = SessionRecorder.GetPath(), Participant = ParticipantId,
+            bIndex = bIndexSession, bPyramid = bBuildSessionPyramid]()
+        {
+            FSessionFile File;
+            FString Error;
+            if (!FSessionRecorder::ReadFile(SessionPath, File, Error))
+            {
+                UE_LOG(LogTemp, Error, TEXT("会话读取失败，没有加入索引和生成金字塔: %s"), *Error);
+                return;
+            }
+
+            if (bIndex)
+            {
+                FSessionIndexEntry Entry;
+                if (!FSessionIndex::Describe(SessionPath, File, FParticipantSettings(), Participant, Entry))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("会话分析失败，只索引元数据: %s"), *Entry.Error);
+                }
+                FSessionIndex Index;
+                if (Index.Load(FPaths::Combine(FPaths::GetPath(SessionPath), TEXT("SessionIndex.tsv")), Error) && Index.Add(Entry, Error))
+                {
+                    UE_LOG(LogTemp, Warning, TEXT("会话已加入索引 %s（%.1f min，SCR %d 个，反应 %d 次）"),
+                        *Index.GetPath(), Entry.DurationMinutes, Entry.ScrCount, Entry.Trials);
+                }
+                else
+                {
+                    UE_LOG(LogTemp, Error, TEXT("会话索引更新失败: %s"), *Error);
+                }
+            }
+
+            if (bPyramid && !FSessionPyramid::BuildForSession(SessionPath, File, Error))
+            {
+                UE_LOG(LogTemp, Error, TEXT("会话金字塔生成失败: %s"), *Error);
+            }
+        });
+    }
+
     // 清理OSC服务器
     if (OSCServer)
     {
@@ -105,9 +354,29 @@ void AOSCReceiver::EndPlay(const EEndPlayReason::Type EndPlayReason)
         UE_LOG(LogTemp, Warning, TEXT("OSC服务器已停止"));
     }
 
+    // 无论哪种结束方式（退出、切换关卡、结束 PIE）都等待后台维护完成：
+    // 退出时不等待，写了一半的索引和金字塔会被丢下；其他情况下也保证 EndPlay 返回时这次会话的索引和金字塔已经写好
+    if (SessionMaintenance.IsValid())
+    {
+        SessionMaintenance.Wait();
+    }
+
     Super::EndPlay(EndPlayReason);
 }
 
+void AOSCReceiver::RunSessionMaintenance(TUniqueFunction<void()> Work)
+{
+    // 等上一次提交的任务结束后再执行，两次维护不会同时读写同一个目录
+    SessionMaintenance = Async(EAsyncExecution::Thread, [Previous = MoveTemp(SessionMaintenance), Work = MoveTemp(Work)]() mutable
+    {
+        if (Previous.IsValid())
+        {
+            Previous.Wait();
+        }
+        Work();
+    });
+}
+
 void AOSCReceiver::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
@@ -124,6 +393,94 @@ void AOSCReceiver::Tick(float DeltaTime)
             UE_LOG(LogTemp, Warning, TEXT("Arduino连接超时"));
         }
     }
+
+    DrainGsrSamples();
+    UpdateTransmitMode();
+
+    // 每帧发送一次积累的指令（通常是一个数据报）
+    FlushFeedback();
+}
+
+void AOSCReceiver::UpdateTransmitMode()
+{
+    if (!bAutoTransmitMode)
+    {
+        return;
+    }
+
+    TransmitModeScheduler.TrialHoldDuration = TrialModeHoldTime;
+    bool bTrial = false;
+    if (TransmitModeScheduler.Update(FSensorClock::Now(), bTrial))
+    {
+        QueueHandleTransmitMode(ModeSwitchHandle, bTrial ? EHandleTransmitMode::Trial : EHandleTransmitMode::Idle);
+    }
+}
+
+void AOSCReceiver::DrainGsrSamples()
+{
+    if (!GsrSource)
+    {
+        return;
+    }
+
+    FGsrSample Sample;
+    while (GsrSource->DequeueSample(Sample))
+    {
+        LatestGsrSample = Sample;
+        GsrSampleCount++;
+        LedalabRecorder.AddSample(Sample.Time, Sample.Conductance);
+
+        FSessionRecord Record;
+        Record.Time = Sample.Time;
+        Record.DeviceTime = Sample.DeviceTimeMs / 1000.0;
+        Record.Channel = ESessionChannel::Gsr;
+        Record.Values[0] = static_cast<float>(Sample.Raw);
+        Record.Values[1] = Sample.Resistance;
+        Record.Values[2] = Sample.Conductance;
+        SessionRecorder.Push(Record);
+
+        OnGsrSampleReceived.Broadcast(Sample);
+    }
+
+    bGsrConnected = GsrSource->IsConnected();
+}
+
+double AOSCReceiver::GetSensorClockTime()
+{
+    return FSensorClock::Now();
+}
+
+FTrialMarker AOSCReceiver::AddTrialMarker(ETrialMarkerType Type, const FString& Condition)
+{
+    if (Type == ETrialMarkerType::Stimulus)
+    {
+        TrialCount++;
+    }
+
+    FTrialMarker Marker;
+    Marker.Time = FSensorClock::Now();
+    Marker.Type = Type;
+    Marker.Condition = Condition;
+    Marker.TrialIndex = TrialCount;
+
+    LastTrialMarker = Marker;
+    TransmitModeScheduler.NoteTrialMarker(Marker.Time);
+
+    // 事件名：类型_条件，例如 Stimulus_keyboard
+    FLedalabEvent Event;
+    Event.Time = Marker.Time;
+    Event.Name = StaticEnum<ETrialMarkerType>()->GetNameStringByValue(static_cast<int64>(Type));
+    if (!Condition.IsEmpty())
+    {
+        Event.Name += TEXT("_") + Condition;
+    }
+    Event.TrialIndex = Marker.TrialIndex;
+    Event.Condition = Condition;
+    LedalabRecorder.AddEvent(Event);
+    SessionRecorder.PushEvent(Marker.Time, static_cast<uint8>(Type), Marker.TrialIndex, Event.Name);
+
+    OnTrialMarker.Broadcast(Marker);
+    return Marker;
 }
 
 void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FString& IPAddress, int32 Port)
@@ -132,7 +489,66 @@ void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FStrin
     FOSCAddress Address = Message.GetAddress();
     FString AddressString = Address.GetFullPath();
     
+    // 手柄对反向通道指令的确认，不算作传感器数据
+    if (AddressString == TEXT("/avatar/feedback/ack"))
+    {
+        int32 AckSequence = 0;
+        if (UOSCManager::GetInt32(Message, 0, AckSequence))
+        {
+            HandleFeedbackAck(AckSequence);
+        }
+        return;
+    }
+
+    LastSenderAddress = IPAddress;
+
+    // 手柄报告的传输频率：手柄编号, 频率(Hz), 模式
+    if (AddressString == TEXT("/avatar/status/rate"))
+    {
+        int32 HandleNumber = 0;
+        int32 RateHz = 0;
+        int32 Mode = 0;
+        if (UOSCManager::GetInt32(Message, 0, HandleNumber) && UOSCManager::GetInt32(Message, 1, RateHz)
+            && UOSCManager::GetInt32(Message, 2, Mode) && HandleNumber >= 1 && HandleNumber <= 2)
+        {
+            const EHandleTransmitMode NewMode = Mode == 1 ? EHandleTransmitMode::Trial : EHandleTransmitMode::Idle;
+            if (NegotiatedRates[HandleNumber - 1] != RateHz || TransmitModes[HandleNumber - 1] != NewMode)
+            {
+                UE_LOG(LogTemp, Log, TEXT("手柄%d 传输频率: %d Hz (%s)"), HandleNumber, RateHz,
+                       NewMode == EHandleTransmitMode::Trial ? TEXT("试次") : TEXT("空闲"));
+            }
+            NegotiatedRates[HandleNumber - 1] = RateHz;
+            TransmitModes[HandleNumber - 1] = NewMode;
+            if (HandleNumber == ModeSwitchHandle)
+            {
+                TransmitModeScheduler.NoteReportedMode(NewMode == EHandleTransmitMode::Trial);
+            }
+        }
+
+        // 状态报告每秒一次：空闲模式下静止的手柄可能很久不发数据，但仍然在线
+        if (GetWorld())
+        {
+            LastUpdateTime = GetWorld()->GetTimeSeconds();
+        }
+        return;
+    }
+
+    // 帧结束标记：手柄编号, 帧序号, 是否关键帧（本帧的通道消息都在它之前）
+    if (AddressString == TEXT("/avatar/frame"))
+    {
+        int32 HandleNumber = 0;
+        int32 Sequence = 0;
+        int32 Keyframe = 0;
+        if (UOSCManager::GetInt32(Message, 0, HandleNumber) && UOSCManager::GetInt32(Message, 1, Sequence)
+            && UOSCManager::GetInt32(Message, 2, Keyframe) && HandleNumber >= 1 && HandleNumber <= 2)
+        {
+            HandleFrameEnd(HandleNumber, Sequence, Keyframe != 0, IPAddress);
+        }
+        return;
+    }
+
     // 更新基础信息
+    InputSensorTime = FSensorClock::Now();
     LocalMessageCounter++;
     MessageID = LocalMessageCounter;
     DataReceived = true;
@@ -188,7 +604,7 @@ void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FStrin
     {
         if (UOSCManager::GetFloat(Message, 0, FloatValue))
         {
-            AccelX = FloatValue;
+            AccelX = SetRawImuAxis(IPAddress, 0, FloatValue);
             bProcessed = true;
         }
     }
@@ -196,7 +612,7 @@ void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FStrin
     {
         if (UOSCManager::GetFloat(Message, 0, FloatValue))
         {
-            AccelY = FloatValue;
+            AccelY = SetRawImuAxis(IPAddress, 1, FloatValue);
             bProcessed = true;
         }
     }
@@ -204,7 +620,7 @@ void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FStrin
     {
         if (UOSCManager::GetFloat(Message, 0, FloatValue))
         {
-            AccelZ = FloatValue;
+            AccelZ = SetRawImuAxis(IPAddress, 2, FloatValue);
             bProcessed = true;
         }
     }
@@ -213,7 +629,7 @@ void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FStrin
     {
         if (UOSCManager::GetFloat(Message, 0, FloatValue))
         {
-            GyroX = FloatValue;
+            GyroX = SetRawImuAxis(IPAddress, 3, FloatValue);
             bProcessed = true;
         }
     }
@@ -221,7 +637,7 @@ void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FStrin
     {
         if (UOSCManager::GetFloat(Message, 0, FloatValue))
         {
-            GyroY = FloatValue;
+            GyroY = SetRawImuAxis(IPAddress, 4, FloatValue);
             bProcessed = true;
         }
     }
@@ -229,10 +645,24 @@ void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FStrin
     {
         if (UOSCManager::GetFloat(Message, 0, FloatValue))
         {
-            GyroZ = FloatValue;
+            GyroZ = SetRawImuAxis(IPAddress, 5, FloatValue);
+
+            // 旧固件按 accel x/y/z -> gyro x/y/z 的顺序发送，gyro/z 到达即一帧 IMU 数据完整；
+            // 带帧标记的数据流中 gyro/z 可能因未变化而不发送，改在帧结束时更新
+            if (!bFramedStream)
+            {
+                UpdateImuCorrection(IPAddress);
+                RecordControllerState(0);
+                BroadcastFrameInput(0);
+            }
             bProcessed = true;
         }
     }
+    // 定时采样批量数据
+    else if (AddressString == TEXT("/avatar/input/samples"))
+    {
+        bProcessed = HandleSampleBatch(Message);
+    }
     // 按钮数据
     else if (AddressString == TEXT("/avatar/input/button/1"))
     {
@@ -281,3 +711,508 @@ void AOSCReceiver::OnOSCMessageReceived(const FOSCMessage& Message, const FStrin
         UE_LOG(LogTemp, Warning, TEXT("未识别的OSC地址: %s"), *AddressString);
     }
 }
+
+bool AOSCReceiver::HandleSampleBatch(const FOSCMessage& Message)
+{
+    int32 HandleNumber = 0;
+    if (!UOSCManager::GetInt32(Message, 0, HandleNumber) || HandleNumber < 1 || HandleNumber > 2)
+    {
+        return false;
+    }
+    const int32 Handle = HandleNumber - 1;
+
+    if (HandleSamples.Num() == 0)
+    {
+        HandleSamples.SetNum(HandleSampleCapacity);
+    }
+
+    int32 RawTimestamp = 0;
+    for (int32 Index = 1; UOSCManager::GetInt32(Message, Index, RawTimestamp); Index += 4)
+    {
+        FHandleSample Sample;
+        Sample.HandleNumber = HandleNumber;
+        if (!UOSCManager::GetFloat(Message, Index + 1, Sample.JoystickX)
+            || !UOSCManager::GetFloat(Message, Index + 2, Sample.JoystickY)
+            || !UOSCManager::GetFloat(Message, Index + 3, Sample.Pressure2))
+        {
+            break;
+        }
+
+        // 展开 32 位微秒计数：无符号差值处理回绕，差值过大（手柄重启）时重新起算
+        const uint32 Micros = static_cast<uint32>(RawTimestamp);
+        if (!bHasDeviceTime[Handle])
+        {
+            bHasDeviceTime[Handle] = true;
+            LatestDeviceTimes[Handle] = Micros * 1.0e-6;
+        }
+        else
+        {
+            const uint32 Elapsed = Micros - LastDeviceMicros[Handle];
+            if (Elapsed < 0x80000000u)
+            {
+                LatestDeviceTimes[Handle] += Elapsed * 1.0e-6;
+            }
+            else
+            {
+                UE_LOG(LogTemp, Warning, TEXT("手柄%d 设备时间戳回退，重新起算"), HandleNumber);
+                LatestDeviceTimes[Handle] = Micros * 1.0e-6;
+            }
+        }
+        LastDeviceMicros[Handle] = Micros;
+        Sample.DeviceTime = LatestDeviceTimes[Handle];
+
+        // 同一批样本一起到达，按设备时间还原各自的采样时刻
+        const double SampleTime = HandleClockAligners[Handle].Align(Sample.DeviceTime, InputSensorTime);
+
+        HandleSamples[HandleSampleWriteIndex % HandleSampleCapacity] = Sample;
+        HandleSampleWriteIndex++;
+
+        FSessionRecord Record;
+        Record.Time = SampleTime;
+        Record.DeviceTime = Sample.DeviceTime;
+        Record.Channel = ESessionChannel::HandleSample;
+        Record.Device = static_cast<uint8>(HandleNumber);
+        Record.Values[0] = Sample.JoystickX;
+        Record.Values[1] = Sample.JoystickY;
+        Record.Values[2] = Sample.Pressure2;
+        SessionRecorder.Push(Record);
+
+        FHandleInputSample Input;
+        Input.Time = SampleTime;
+        Input.Device = static_cast<uint8>(HandleNumber);
+        Input.bHasJoystick = true;
+        Input.bHasPressure2 = true;
+        Input.Joystick = FVector2D(Sample.JoystickX, Sample.JoystickY);
+        Input.Pressure2 = Sample.Pressure2;
+        BroadcastInputSample(Input);
+    }
+    LastBatchArrivalTimes[Handle] = InputSensorTime;
+    return true;
+}
+
+void AOSCReceiver::BroadcastInputSample(const FHandleInputSample& Sample)
+{
+    double& LastTime = LastInputSampleTimes[Sample.Device];
+    if (Sample.Time < LastTime)
+    {
+        return;
+    }
+    LastTime = Sample.Time;
+
+    // 被试握压范围按共享时钟上的每个样本统计（包括批量样本）
+    if (Sample.bHasPressure1)
+    {
+        PressureNormalizers[0].AddSample(Sample.Time, Sample.Pressure1);
+    }
+    if (Sample.bHasPressure2)
+    {
+        PressureNormalizers[1].AddSample(Sample.Time, Sample.Pressure2);
+    }
+    OnInputSample.Broadcast(Sample);
+}
+
+void AOSCReceiver::BroadcastFrameInput(uint8 Device)
+{
+    FHandleInputSample Sample;
+    Sample.Device = Device;
+    Sample.bHasPressure1 = true;
+    Sample.Pressure1 = Pressure1;
+
+    const bool bBatchStream = Device >= 1 && Device <= 2 && LastBatchArrivalTimes[Device - 1] >= 0.0
+        && InputSensorTime - LastBatchArrivalTimes[Device - 1] < BatchStreamTimeout;
+    if (bBatchStream)
+    {
+        // 帧内的摇杆和压力2只是最后一个批量样本的重复；帧的时间取该样本对齐后的时间，与批量样本在同一时间轴上
+        Sample.Time = LastInputSampleTimes[Device];
+    }
+    else
+    {
+        Sample.Time = InputSensorTime;
+        Sample.bHasJoystick = true;
+        Sample.bHasPressure2 = true;
+        Sample.Joystick = FVector2D(JoystickX, JoystickY);
+        Sample.Pressure2 = Pressure2;
+    }
+    BroadcastInputSample(Sample);
+}
+
+TArray<FHandleSample> AOSCReceiver::GetRecentHandleSamples(int32 MaxCount)
+{
+    TArray<FHandleSample> Result;
+    const int32 Count = FMath::Min3(FMath::Max(MaxCount, 0), HandleSampleWriteIndex, HandleSampleCapacity);
+    Result.Reserve(Count);
+    for (int32 Index = HandleSampleWriteIndex - Count; Index < HandleSampleWriteIndex; Index++)
+    {
+        Result.Add(HandleSamples[Index % HandleSampleCapacity]);
+    }
+    return Result;
+}
+
+double AOSCReceiver::GetLatestDeviceTime(int32 HandleNumber)
+{
+    return HandleNumber >= 1 && HandleNumber <= 2 ? LatestDeviceTimes[HandleNumber - 1] : 0.0;
+}
+
+void AOSCReceiver::HandleFrameEnd(int32 HandleNumber, int32 Sequence, bool bKeyframe, const FString& IPAddress)
+{
+    bFramedStream = true;
+
+    // 关键帧包含所有在线通道：没有 IMU 通道说明 S3 离线（S3 上下线时固件会立即发送关键帧）
+    if (FImuDeviceState* Device = ImuDevices.Find(IPAddress))
+    {
+        if (bKeyframe)
+        {
+            Device->bFramedImuPresent = Device->bFrameHasImu;
+        }
+        Device->bFrameHasImu = false;
+        if (Device->bFramedImuPresent)
+        {
+            // 未变化的通道保持上一帧的值，仍然作为一个完整的 IMU 样本
+            UpdateImuCorrection(IPAddress);
+        }
+    }
+
+    // 帧内未发送的通道保持上一帧的值，帧结束时的状态就是这一帧的完整样本
+    RecordControllerState(static_cast<uint8>(HandleNumber));
+    BroadcastFrameInput(static_cast<uint8>(HandleNumber));
+
+    const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0f;
+    const FFrameSequenceResult Result = FrameTrackers[HandleNumber - 1].EndFrame(Sequence, bKeyframe, Now);
+    if (Result.bGap)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("手柄%d 丢失 %d 帧（序号 %d）"), HandleNumber, Result.LostFrames, Sequence);
+    }
+    if (Result.bNeedKeyframe)
+    {
+        QueueHandleKeyframeRequest(HandleNumber);
+    }
+}
+
+void AOSCReceiver::RecordControllerState(uint8 Device)
+{
+    FSessionRecord Record;
+    Record.Time = InputSensorTime;
+    Record.Channel = ESessionChannel::Controller;
+    Record.Device = Device;
+    Record.Values[0] = JoystickX;
+    Record.Values[1] = JoystickY;
+    Record.Values[2] = Pressure1;
+    Record.Values[3] = Pressure2;
+    Record.Values[4] = AccelX;
+    Record.Values[5] = AccelY;
+    Record.Values[6] = AccelZ;
+    Record.Values[7] = GyroX;
+    Record.Values[8] = GyroY;
+    Record.Values[9] = GyroZ;
+    Record.Buttons = static_cast<uint8>((Button1 ? 1 : 0) | (Button2 ? 2 : 0) | (Button3 ? 4 : 0) | (Button4 ? 8 : 0));
+    SessionRecorder.Push(Record);
+}
+
+void AOSCReceiver::UpdateImuCorrection(const FString& IPAddress)
+{
+    FImuDeviceState* Device = ImuDevices.Find(IPAddress);
+    if (!Device)
+    {
+        return;
+    }
+    ImuDeviceAddress = IPAddress;
+    if (!bEnableImuBiasCorrection)
+    {
+        return;
+    }
+
+    Device->Estimator.AddSample(Device->RawAccel, Device->RawGyro);
+
+    const FVector CorrectedAccel = Device->Estimator.CorrectAccel(Device->RawAccel);
+    const FVector CorrectedGyro = Device->Estimator.CorrectGyro(Device->RawGyro);
+    AccelX = static_cast<float>(CorrectedAccel.X);
+    AccelY = static_cast<float>(CorrectedAccel.Y);
+    AccelZ = static_cast<float>(CorrectedAccel.Z);
+    GyroX = static_cast<float>(CorrectedGyro.X);
+    GyroY = static_cast<float>(CorrectedGyro.Y);
+    GyroZ = static_cast<float>(CorrectedGyro.Z);
+}
+
+float AOSCReceiver::SetRawImuAxis(const FString& IPAddress, int32 Axis, float Value)
+{
+    FImuDeviceState& Device = ImuDevices.FindOrAdd(IPAddress);
+    Device.bFrameHasImu = true;
+
+    FVector& Raw = Axis < 3 ? Device.RawAccel : Device.RawGyro;
+    Raw[Axis % 3] = Value;
+    if (!bEnableImuBiasCorrection)
+    {
+        return Value;
+    }
+    const FVector& Correction = Axis < 3 ? Device.Estimator.GetAccelOffset() : Device.Estimator.GetGyroBias();
+    return Value - static_cast<float>(Correction[Axis % 3]);
+}
+
+const FImuDeviceState* AOSCReceiver::FindImuDevice(const FString& DeviceAddress)
+{
+    return ImuDevices.Find(DeviceAddress.IsEmpty() ? ImuDeviceAddress : DeviceAddress);
+}
+
+FVector AOSCReceiver::GetRawAccelVector(const FString& DeviceAddress)
+{
+    const FImuDeviceState* Device = FindImuDevice(DeviceAddress);
+    return Device ? Device->RawAccel : FVector::ZeroVector;
+}
+
+FVector AOSCReceiver::GetRawGyroVector(const FString& DeviceAddress)
+{
+    const FImuDeviceState* Device = FindImuDevice(DeviceAddress);
+    return Device ? Device->RawGyro : FVector::ZeroVector;
+}
+
+FVector AOSCReceiver::GetGyroBias(const FString& DeviceAddress)
+{
+    const FImuDeviceState* Device = FindImuDevice(DeviceAddress);
+    return Device ? Device->Estimator.GetGyroBias() : FVector::ZeroVector;
+}
+
+FVector AOSCReceiver::GetAccelOffset(const FString& DeviceAddress)
+{
+    const FImuDeviceState* Device = FindImuDevice(DeviceAddress);
+    return Device ? Device->Estimator.GetAccelOffset() : FVector::ZeroVector;
+}
+
+bool AOSCReceiver::IsImuStill(const FString& DeviceAddress)
+{
+    const FImuDeviceState* Device = FindImuDevice(DeviceAddress);
+    return Device && Device->Estimator.IsStill();
+}
+
+bool AOSCReceiver::HasImuBiasEstimate(const FString& DeviceAddress)
+{
+    const FImuDeviceState* Device = FindImuDevice(DeviceAddress);
+    return Device && Device->Estimator.HasEstimate();
+}
+
+TArray<FString> AOSCReceiver::GetImuDeviceAddresses()
+{
+    TArray<FString> Addresses;
+    ImuDevices.GetKeys(Addresses);
+    return Addresses;
+}
+
+FPressureNormalizer* AOSCReceiver::FindPressureNormalizer(int32 SensorNumber)
+{
+    if (SensorNumber < 1 || SensorNumber > 2)
+    {
+        return nullptr;
+    }
+    return &PressureNormalizers[SensorNumber - 1];
+}
+
+bool AOSCReceiver::IsPressureCalibrated(int32 SensorNumber)
+{
+    const FPressureNormalizer* Normalizer = FindPressureNormalizer(SensorNumber);
+    return Normalizer && Normalizer->IsCalibrated();
+}
+
+float AOSCReceiver::GetPressureAtPercentile(int32 SensorNumber, float Percentile)
+{
+    const FPressureNormalizer* Normalizer = FindPressureNormalizer(SensorNumber);
+    return Normalizer ? Normalizer->GetValueAtPercentile(Percentile) : 0.0f;
+}
+
+float AOSCReceiver::GetPressurePercentile(int32 SensorNumber, float PressureValue)
+{
+    const FPressureNormalizer* Normalizer = FindPressureNormalizer(SensorNumber);
+    return Normalizer ? Normalizer->GetPercentileOfValue(PressureValue) : 0.0f;
+}
+
+float AOSCReceiver::GetNormalizedPressure(int32 SensorNumber)
+{
+    const FPressureNormalizer* Normalizer = FindPressureNormalizer(SensorNumber);
+    if (!Normalizer)
+    {
+        return 0.0f;
+    }
+    return Normalizer->Normalize(SensorNumber == 1 ? Pressure1 : Pressure2);
+}
+
+void AOSCReceiver::ResetPressureCalibration()
+{
+    for (FPressureNormalizer& Normalizer : PressureNormalizers)
+    {
+        Normalizer.Reset();
+    }
+    UE_LOG(LogTemp, Warning, TEXT("压力个体化统计已重置，重新进入热身"));
+}
+
+void AOSCReceiver::AddFeedbackMessage(const FString& Address, TFunctionRef<void(FOSCMessage&)> AddArguments)
+{
+    // 等待手柄地址期间指令会一直积压，限制数量（正常每帧只有几条）
+    if (PendingFeedbackCount >= MaxPendingFeedbackMessages)
+    {
+        DroppedFeedbackCount++;
+        if (DroppedFeedbackCount == 1 || DroppedFeedbackCount % 100 == 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("反向通道积压 %d 条指令，丢弃 %s（累计丢弃 %d 条）"),
+                PendingFeedbackCount, *Address, DroppedFeedbackCount);
+        }
+        return;
+    }
+
+    FOSCMessage Message;
+    Message.SetAddress(UOSCManager::ConvertStringToOSCAddress(Address));
+    AddArguments(Message);
+
+    TArray<int32> IntArguments;
+    TArray<float> FloatArguments;
+    UOSCManager::GetAllInt32s(Message, IntArguments);
+    UOSCManager::GetAllFloats(Message, FloatArguments);
+    const int32 MessageBytes = GetFeedbackMessageBytes(Address, IntArguments.Num() + FloatArguments.Num());
+
+    // 放不下时另起一个数据报，每个数据报末尾留出 /handle/seq 的位置
+    const int32 SequenceBytes = GetFeedbackMessageBytes(TEXT("/handle/seq"), 1);
+    if (PendingFeedbackBundles.Num() == 0 || PendingFeedbackBytes + MessageBytes + SequenceBytes > MaxFeedbackBundleBytes)
+    {
+        PendingFeedbackBundles.AddDefaulted();
+        PendingFeedbackBytes = OSCBundleHeaderBytes;
+    }
+    UOSCManager::AddMessageToBundle(Message, PendingFeedbackBundles.Last());
+    PendingFeedbackBytes += MessageBytes;
+    PendingFeedbackCount++;
+}
+
+void AOSCReceiver::QueueHandleVibration(int32 HandleNumber, int32 DurationMs, float Strength)
+{
+    AddFeedbackMessage(FString::Printf(TEXT("/handle/%d/vibrate"), HandleNumber), [&](FOSCMessage& Message)
+    {
+        UOSCManager::AddInt32(Message, FMath::Clamp(DurationMs, 0, 5000));
+        UOSCManager::AddFloat(Message, FMath::Clamp(Strength, 0.0f, 1.0f));
+    });
+}
+
+void AOSCReceiver::QueueHandleLedColor(int32 HandleNumber, FLinearColor Color)
+{
+    const FColor Quantized = Color.ToFColor(true);
+    AddFeedbackMessage(FString::Printf(TEXT("/handle/%d/led"), HandleNumber), [&](FOSCMessage& Message)
+    {
+        UOSCManager::AddInt32(Message, Quantized.R);
+        UOSCManager::AddInt32(Message, Quantized.G);
+        UOSCManager::AddInt32(Message, Quantized.B);
+    });
+}
+
+void AOSCReceiver::QueueHandleSampleRate(int32 HandleNumber, int32 RateHz)
+{
+    AddFeedbackMessage(FString::Printf(TEXT("/handle/%d/rate"), HandleNumber), [&](FOSCMessage& Message)
+    {
+        UOSCManager::AddInt32(Message, FMath::Clamp(RateHz, 1, 1000));
+    });
+}
+
+void AOSCReceiver::QueueHandleTransmitMode(int32 HandleNumber, EHandleTransmitMode Mode, int32 RateHz)
+{
+    AddFeedbackMessage(FString::Printf(TEXT("/handle/%d/mode"), HandleNumber), [&](FOSCMessage& Message)
+    {
+        UOSCManager::AddInt32(Message, static_cast<int32>(Mode));
+        if (RateHz > 0)
+        {
+            UOSCManager::AddInt32(Message, FMath::Clamp(RateHz, 1, 1000));
+        }
+    });
+}
+
+void AOSCReceiver::QueueHandleKeyframeRequest(int32 HandleNumber, int32 IntervalMs)
+{
+    AddFeedbackMessage(FString::Printf(TEXT("/handle/%d/keyframe"), HandleNumber), [&](FOSCMessage& Message)
+    {
+        if (IntervalMs > 0)
+        {
+            UOSCManager::AddInt32(Message, FMath::Clamp(IntervalMs, 100, 1500));
+        }
+    });
+}
+
+bool AOSCReceiver::IsHandleStateSynchronized(int32 HandleNumber)
+{
+    return HandleNumber >= 1 && HandleNumber <= 2 && FrameTrackers[HandleNumber - 1].IsSynchronized();
+}
+
+int32 AOSCReceiver::GetLostFrameCount(int32 HandleNumber)
+{
+    return HandleNumber >= 1 && HandleNumber <= 2 ? static_cast<int32>(FrameTrackers[HandleNumber - 1].GetLostFrames()) : 0;
+}
+
+float AOSCReceiver::GetFrameLossRatio(int32 HandleNumber)
+{
+    return HandleNumber >= 1 && HandleNumber <= 2 ? FrameTrackers[HandleNumber - 1].GetLossRatio() : 0.0f;
+}
+
+int32 AOSCReceiver::GetNegotiatedRate(int32 HandleNumber)
+{
+    return HandleNumber >= 1 && HandleNumber <= 2 ? NegotiatedRates[HandleNumber - 1] : 0;
+}
+
+EHandleTransmitMode AOSCReceiver::GetTransmitMode(int32 HandleNumber)
+{
+    return HandleNumber >= 1 && HandleNumber <= 2 ? TransmitModes[HandleNumber - 1] : EHandleTransmitMode::Idle;
+}
+
+void AOSCReceiver::FlushFeedback()
+{
+    if (PendingFeedbackCount == 0)
+    {
+        return;
+    }
+
+    const FString TargetAddress = HandleIPAddress.IsEmpty() ? LastSenderAddress : HandleIPAddress;
+    if (TargetAddress.IsEmpty())
+    {
+        // 还不知道手柄地址，指令留到下一帧
+        return;
+    }
+
+    if (!FeedbackClient)
+    {
+        FeedbackClient = UOSCManager::CreateOSCClient(TargetAddress, FeedbackPort, TEXT("ArduinoFeedbackClient"), this);
+        if (!FeedbackClient)
+        {
+            UE_LOG(LogTemp, Error, TEXT("无法创建反向通道OSC客户端！"));
+            return;
+        }
+        FeedbackTargetAddress = TargetAddress;
+        UE_LOG(LogTemp, Warning, TEXT("反向通道已连接: %s:%d"), *TargetAddress, FeedbackPort);
+    }
+    else if (FeedbackTargetAddress != TargetAddress)
+    {
+        FeedbackClient->SetSendIPAddress(TargetAddress, FeedbackPort);
+        FeedbackTargetAddress = TargetAddress;
+    }
+
+    for (FOSCBundle& Bundle : PendingFeedbackBundles)
+    {
+        // 序号放在每个数据报末尾，手柄处理完整个数据报后回传确认
+        FeedbackSequence++;
+        FOSCMessage SequenceMessage;
+        SequenceMessage.SetAddress(UOSCManager::ConvertStringToOSCAddress(TEXT("/handle/seq")));
+        UOSCManager::AddInt32(SequenceMessage, FeedbackSequence);
+        UOSCManager::AddMessageToBundle(SequenceMessage, Bundle);
+
+        FeedbackSendTimes[FeedbackSequence % FeedbackHistorySize] = FPlatformTime::Seconds();
+        FeedbackClient->SendOSCBundle(Bundle);
+    }
+
+    PendingFeedbackBundles.Reset();
+    PendingFeedbackBytes = 0;
+    PendingFeedbackCount = 0;
+}
+
+void AOSCReceiver::HandleFeedbackAck(int32 Sequence)
+{
+    // 太旧的确认在环形表中已被覆盖，丢弃
+    if (Sequence <= 0 || Sequence > FeedbackSequence || FeedbackSequence - Sequence >= FeedbackHistorySize)
+    {
+        return;
+    }
+
+    LastFeedbackLatency = static_cast<float>(FPlatformTime::Seconds() - FeedbackSendTimes[Sequence % FeedbackHistorySize]);
+    AverageFeedbackLatency = AverageFeedbackLatency < 0.0f
+        ? LastFeedbackLatency
+        : FMath::Lerp(AverageFeedbackLatency, LastFeedbackLatency, 0.1f);
+}
@@ -5,8 +5,70 @@
 #include "Engine/Engine.h"
 #include "OSCServer.h"
 #include "OSCMessage.h"
+#include "OSCBundle.h"
+#include "ImuBiasEstimator.h"
+#include "PressureNormalizer.h"
+#include "FrameSequenceTracker.h"
+#include "TransmitModeScheduler.h"
+#include "GsrSource.h"
+#include "LedalabSessionRecorder.h"
+#include "SessionRecorder.h"
+#include "SensorClock.h"
+#include "Async/Future.h"
 #include "OSCReceiver.generated.h"
 
+/** 每个 GSR 样本到达时广播（游戏线程）*/
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGsrSampleNative, const FGsrSample&);
+
+/** 试次标记类型 */
+UENUM(BlueprintType)
+enum class ETrialMarkerType : uint8
+{
+    /** 刺激呈现 */
+    Stimulus = 0    UMETA(DisplayName = "Stimulus"),
+
+    /** 被试作出反应 */
+    Response = 1    UMETA(DisplayName = "Response"),
+
+    /** 其他自定义标记 */
+    Custom = 2      UMETA(DisplayName = "Custom")
+};
+
+/** 一个试次标记（共享传感器时钟上的时间）*/
+USTRUCT(BlueprintType)
+struct FTrialMarker
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Trial")
+    double Time = 0.0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Trial")
+    ETrialMarkerType Type = ETrialMarkerType::Stimulus;
+
+    /** 实验条件（例如 keyboard / joystick）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Trial")
+    FString Condition;
+
+    /** 试次序号（每个刺激标记加一，从 1 开始）*/
+    UPROPERTY(BlueprintReadOnly, Category = "Trial")
+    int32 TrialIndex = 0;
+};
+
+/** 每个试次标记发出时广播（游戏线程）*/
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTrialMarkerNative, const FTrialMarker&);
+
+/** 手柄传输模式（与固件 TransmitMode 取值一致） */
+UENUM(BlueprintType)
+enum class EHandleTransmitMode : uint8
+{
+    /** 空闲：低频，只在数据变化时发送（菜单、休息） */
+    Idle = 0    UMETA(DisplayName = "Idle"),
+
+    /** 试次：高频完整帧（计时任务） */
+    Trial = 1   UMETA(DisplayName = "Trial")
+};
+
 USTRUCT(BlueprintType)
 struct FJoystickData
 {
@@ -19,6 +81,10 @@ struct FJoystickData
     UPROPERTY(BlueprintReadOnly, Category = "Basic")
     float Timestamp = 0.0f;
 
+    // 最近一次手柄数据在共享传感器时钟上的时间（秒）
+    UPROPERTY(BlueprintReadOnly, Category = "Basic")
+    double SensorTime = 0.0;
+
     UPROPERTY(BlueprintReadOnly, Category = "Basic")
     FString DeviceName = TEXT("");
 
@@ -74,6 +140,77 @@ struct FJoystickData
 
     UPROPERTY(BlueprintReadOnly, Category = "Buttons")
     bool Button4 = false;
+
+    // 皮肤电（最近一个样本）
+    UPROPERTY(BlueprintReadOnly, Category = "GSR")
+    float GsrConductance = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "GSR")
+    float GsrResistance = 0.0f;
+
+    // GSR 样本在共享传感器时钟上的时间（秒）
+    UPROPERTY(BlueprintReadOnly, Category = "GSR")
+    double GsrTime = 0.0;
+};
+
+/** 手柄定时采样的一个本地样本（摇杆 + 压力2），带设备时间戳 */
+USTRUCT(BlueprintType)
+struct FHandleSample
+{
+    GENERATED_BODY()
+
+    /** 手柄编号 */
+    UPROPERTY(BlueprintReadOnly, Category = "Sample")
+    int32 HandleNumber = 0;
+
+    /** 设备时间（秒，该手柄 micros() 展开回绕后的值） */
+    UPROPERTY(BlueprintReadOnly, Category = "Sample")
+    double DeviceTime = 0.0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Sample")
+    float JoystickX = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Sample")
+    float JoystickY = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Sample")
+    float Pressure2 = 0.0f;
+};
+
+/**
+ * 一个时间点的手柄输入（共享传感器时钟），只有 bHas* 为 true 的通道有效
+ * 试次模式下摇杆和压力2来自定时批量样本（设备时间对齐到共享时钟），其余通道和空闲模式下的数据每帧一个样本
+ */
+struct FHandleInputSample
+{
+    double Time = 0.0;
+
+    /** 手柄编号，旧固件为 0 */
+    uint8 Device = 0;
+
+    bool bHasJoystick = false;
+    bool bHasPressure1 = false;
+    bool bHasPressure2 = false;
+
+    FVector2D Joystick = FVector2D::ZeroVector;
+    float Pressure1 = 0.0f;
+    float Pressure2 = 0.0f;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnHandleInputSampleNative, const FHandleInputSample&);
+
+/** 单个 IMU 设备（按发送端 IP 区分）的状态：原始数据、零偏估计和帧内通道标记 */
+struct FImuDeviceState
+{
+    /** 未经零偏校正的原始数据（未变化的轴保持上一次的值） */
+    FVector RawAccel = FVector::ZeroVector;
+    FVector RawGyro = FVector::ZeroVector;
+
+    FImuBiasEstimator Estimator;
+
+    /** 当前帧是否包含 IMU 通道 / 最近一次关键帧是否包含 IMU 通道 */
+    bool bFrameHasImu = false;
+    bool bFramedImuPresent = false;
 };
 
 UCLASS(BlueprintType, Blueprintable)
@@ -95,6 +232,93 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "OSC")
     class UOSCServer* OSCServer;
 
+    // 反向通道：发送触觉/LED/采样率指令的 OSC 客户端
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "OSC|Feedback")
+    class UOSCClient* FeedbackClient;
+
+    // 手柄接收指令的端口（主 ESP32 上的 udpCommand）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Feedback")
+    int32 FeedbackPort = 8889;
+
+    // 手柄 IP（留空则使用最近一次发来 OSC 数据的地址）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Feedback")
+    FString HandleIPAddress = TEXT("");
+
+    // 按实验阶段自动切换手柄2的传输模式：试次阶段（BeginTrialPhase 或试次标记之后）高频完整帧，其余时间空闲
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Feedback")
+    bool bAutoTransmitMode = true;
+
+    // 最后一个试次标记之后保持试次模式的时间（秒），应不短于响应窗口终点
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Feedback")
+    float TrialModeHoldTime = 6.0f;
+
+    // 是否在接收路径上自动扣除 IMU 零偏（静止时在线估计）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|IMU")
+    bool bEnableImuBiasCorrection = true;
+
+    // 压力个体化：热身时长（秒），热身期内学习被试的握压范围
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Pressure")
+    float PressureWarmupDuration = 20.0f;
+
+    // 压力个体化：低于此值视为静息噪声（压力值 0~1）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Pressure")
+    float PressureActivityFloor = 0.02f;
+
+    // GSR：是否在本模块内采集皮肤电（读取 gsrpifudian.ino 的输出）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|GSR")
+    bool bEnableGsr = false;
+
+    // GSR 串口（如 COM3 或 /dev/ttyUSB0）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|GSR")
+    FString GsrSerialPort = TEXT("");
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|GSR")
+    int32 GsrBaudRate = 115200;
+
+    // 串口使用二进制帧协议（固件 BINARY 命令，定时器触发 + 4 倍过采样）；关闭时使用文本 START 模式
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|GSR")
+    bool bGsrBinaryProtocol = false;
+
+    // 二进制模式的采样率（Hz，50~200）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|GSR")
+    int32 GsrSampleRateHz = 100;
+
+    // 大于 0 时改为监听 UDP 桥（数据报内容与串口输出相同）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|GSR")
+    int32 GsrUdpPort = 0;
+
+    // 没有传感器时使用合成信号测试（优先于串口和 UDP），SCR 真值写到 Saved/GsrSyntheticTruth.txt
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|GSR")
+    bool bGsrSynthetic = false;
+
+    // 采集时把 GSR 数据和试次事件写成 Ledalab 文件（<目录>/Session_<时间>.mat 与 _events.txt），崩溃后下次启动时补全
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Ledalab")
+    bool bExportLedalabSession = true;
+
+    // 导出目录，为空时使用 Saved/Ledalab
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Ledalab")
+    FString LedalabExportDirectory = TEXT("");
+
+    // 把所有传感器通道和试次事件实时写入会话记录文件（<目录>/Session_<时间>.wvsession，后台线程压缩写盘）
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Recording")
+    bool bRecordSession = true;
+
+    // 记录目录，为空时使用 Saved/Sessions
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Recording")
+    FString SessionRecordDirectory = TEXT("");
+
+    // 结束记录时分析会话并加入记录目录下的会话索引（SessionIndex.tsv），供 SessionIndex 查询和批处理工具选取
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Recording")
+    bool bIndexSession = true;
+
+    // 写入索引的被试编号，为空时使用会话文件名
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Recording")
+    FString ParticipantId = TEXT("");
+
+    // 结束记录时在会话旁边生成时间线金字塔（<会话名>.wvpyramid），查看器按像素宽度读取，不需要绘制每个样本
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "OSC|Recording")
+    bool bBuildSessionPyramid = true;
+
     // 全局可访问的传感器数据
     static int32 MessageID;
     static float Timestamp;
@@ -110,6 +334,9 @@ public:
     static float Pressure1;
     static float Pressure2;
 
+    // 每个压力通道的被试个体化统计（通道1来自左手柄 S3，通道2来自右手柄）
+    static FPressureNormalizer PressureNormalizers[2];
+
     // 加速度数据
     static float AccelX;
     static float AccelY;
@@ -120,12 +347,41 @@ public:
     static float GyroY;
     static float GyroZ;
 
+    // 每个设备（按发送端 IP 区分）的原始 IMU 数据和零偏估计 / 最近一次完成一个 IMU 样本的设备
+    static TMap<FString, FImuDeviceState> ImuDevices;
+    static FString ImuDeviceAddress;
+
     // 按钮状态
     static bool Button1;
     static bool Button2;
     static bool Button3;
     static bool Button4;
 
+    // 最近一次手柄数据的共享时钟时间
+    static double InputSensorTime;
+
+    // GSR 数据
+    static FGsrSample LatestGsrSample;
+    static int32 GsrSampleCount;
+    static bool bGsrConnected;
+
+    // 每个 GSR 样本到达时广播（C++ 订阅，ArduinoInputComponent 转发给蓝图）
+    static FOnGsrSampleNative OnGsrSampleReceived;
+
+    // 每个输入样本广播一次（同一设备按时间顺序；C++ 订阅，握压等分析按样本而不是按游戏帧处理）
+    static FOnHandleInputSampleNative OnInputSample;
+
+    // 试次标记
+    static int32 TrialCount;
+    static FTrialMarker LastTrialMarker;
+    static FOnTrialMarkerNative OnTrialMarker;
+
+    // 本次会话的 GSR 样本与试次事件（边采集边写入 Ledalab 文件）
+    static FLedalabSessionRecorder LedalabRecorder;
+
+    // 本次会话的完整记录（所有通道，边采集边写盘）
+    static FSessionRecorder SessionRecorder;
+
     // 蓝图可调用的数据获取函数
     // 基础数据
     UFUNCTION(BlueprintCallable, Category = "Arduino Basic")
@@ -163,6 +419,22 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Arduino Pressure")
     static FVector2D GetPressureVector() { return FVector2D(Pressure1, Pressure2); }
 
+    // 压力个体化（SensorNumber 为 1 或 2）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration")
+    static bool IsPressureCalibrated(int32 SensorNumber);
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration")
+    static float GetPressureAtPercentile(int32 SensorNumber, float Percentile);
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration")
+    static float GetPressurePercentile(int32 SensorNumber, float PressureValue);
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration")
+    static float GetNormalizedPressure(int32 SensorNumber);
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Pressure Calibration")
+    static void ResetPressureCalibration();
+
     // 加速度数据
     UFUNCTION(BlueprintCallable, Category = "Arduino Accelerometer")
     static float GetAccelX() { return AccelX; }
@@ -189,6 +461,41 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Arduino Gyroscope")
     static FVector GetGyroVector() { return FVector(GyroX, GyroY, GyroZ); }
 
+    // IMU 零偏校正（DeviceAddress 为空时取最近一次完成一个 IMU 样本的设备）
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration")
+    static FVector GetRawAccelVector(const FString& DeviceAddress = TEXT(""));
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration")
+    static FVector GetRawGyroVector(const FString& DeviceAddress = TEXT(""));
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration")
+    static FVector GetGyroBias(const FString& DeviceAddress = TEXT(""));
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration")
+    static FVector GetAccelOffset(const FString& DeviceAddress = TEXT(""));
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration")
+    static bool IsImuStill(const FString& DeviceAddress = TEXT(""));
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration")
+    static bool HasImuBiasEstimate(const FString& DeviceAddress = TEXT(""));
+
+    // 发送过 IMU 数据的设备地址
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration")
+    static TArray<FString> GetImuDeviceAddresses();
+
+    // 最近一次完成一个 IMU 样本的设备地址
+    UFUNCTION(BlueprintCallable, Category = "Arduino IMU Calibration")
+    static FString GetImuDeviceAddress() { return ImuDeviceAddress; }
+
+    // 定时采样历史（试次模式下手柄批量发送，按接收顺序，最多返回 MaxCount 个最新样本；各手柄的设备时间只在同一手柄内可比）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Samples")
+    static TArray<FHandleSample> GetRecentHandleSamples(int32 MaxCount = 100);
+
+    // 手柄最新样本的设备时间（秒），尚无样本时返回 0；各手柄的设备时钟互相独立
+    UFUNCTION(BlueprintCallable, Category = "Arduino Samples")
+    static double GetLatestDeviceTime(int32 HandleNumber = 2);
+
     // 按钮状态
     UFUNCTION(BlueprintCallable, Category = "Arduino Buttons")
     static bool GetButton1() { return Button1; }
@@ -202,6 +509,92 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Arduino Buttons")
     static bool GetButton4() { return Button4; }
 
+    // 反向通道指令（HandleNumber: 1=左手柄 S3，2=右手柄），同一帧内的指令合并为一个数据报发送
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static void QueueHandleVibration(int32 HandleNumber, int32 DurationMs, float Strength);
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static void QueueHandleLedColor(int32 HandleNumber, FLinearColor Color);
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static void QueueHandleSampleRate(int32 HandleNumber, int32 RateHz);
+
+    // 切换手柄传输模式，RateHz > 0 时同时设置该模式的频率
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static void QueueHandleTransmitMode(int32 HandleNumber, EHandleTransmitMode Mode, int32 RateHz = 0);
+
+    // 请求手柄下一帧发送完整关键帧；IntervalMs > 0 时同时修改定期关键帧的间隔（不超过 1.5 秒，须小于数据超时）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static void QueueHandleKeyframeRequest(int32 HandleNumber, int32 IntervalMs = 0);
+
+    // 增量帧状态是否完整（收到过关键帧且此后没有丢帧）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Basic")
+    static bool IsHandleStateSynchronized(int32 HandleNumber);
+
+    // 累计丢失的帧数
+    UFUNCTION(BlueprintCallable, Category = "Arduino Basic")
+    static int32 GetLostFrameCount(int32 HandleNumber);
+
+    // 丢帧率（0~1）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Basic")
+    static float GetFrameLossRatio(int32 HandleNumber);
+
+    // 手柄报告的当前传输频率（Hz），尚未收到报告时返回 0
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static int32 GetNegotiatedRate(int32 HandleNumber);
+
+    // 手柄报告的当前传输模式
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static EHandleTransmitMode GetTransmitMode(int32 HandleNumber);
+
+    // 最近一次指令的往返延迟（秒，发送到收到手柄确认），尚无数据时返回 -1
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static float GetFeedbackLatency() { return LastFeedbackLatency; }
+
+    // 指令往返延迟的平滑均值（秒）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Feedback")
+    static float GetAverageFeedbackLatency() { return AverageFeedbackLatency; }
+
+    // 共享传感器时钟（手柄与 GSR 共用）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Basic")
+    static double GetSensorClockTime();
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Basic")
+    static double GetInputSensorTime() { return InputSensorTime; }
+
+    // GSR 数据
+    UFUNCTION(BlueprintCallable, Category = "Arduino GSR")
+    static float GetGsrConductance() { return LatestGsrSample.Conductance; }
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino GSR")
+    static float GetGsrResistance() { return LatestGsrSample.Resistance; }
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino GSR")
+    static FGsrSample GetLatestGsrSample() { return LatestGsrSample; }
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino GSR")
+    static int32 GetGsrSampleCount() { return GsrSampleCount; }
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino GSR")
+    static bool IsGsrConnected() { return bGsrConnected; }
+
+    // 试次标记（按共享传感器时钟打时间戳）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Trial")
+    static FTrialMarker AddTrialMarker(ETrialMarkerType Type, const FString& Condition);
+
+    // 试次阶段（例如一个计时任务块）的开始和结束：阶段内手柄保持试次模式（需启用 bAutoTransmitMode）
+    UFUNCTION(BlueprintCallable, Category = "Arduino Trial")
+    static void BeginTrialPhase() { TransmitModeScheduler.SetTrialPhase(true); }
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Trial")
+    static void EndTrialPhase() { TransmitModeScheduler.SetTrialPhase(false); }
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Trial")
+    static int32 GetTrialCount() { return TrialCount; }
+
+    UFUNCTION(BlueprintCallable, Category = "Arduino Trial")
+    static FTrialMarker GetLastTrialMarker() { return LastTrialMarker; }
+
     // 检查设备是否连接且活跃
     UFUNCTION(BlueprintCallable, Category = "Arduino Basic")
     static bool IsJoystickConnected() { return DataReceived && IsActive == 1; }
@@ -213,6 +606,7 @@ public:
         FJoystickData Data;
         Data.MessageID = MessageID;
         Data.Timestamp = Timestamp;
+        Data.SensorTime = InputSensorTime;
         Data.DeviceName = DeviceName;
         Data.DataReceived = DataReceived;
         Data.IsActive = IsActive;
@@ -230,6 +624,9 @@ public:
         Data.Button2 = Button2;
         Data.Button3 = Button3;
         Data.Button4 = Button4;
+        Data.GsrConductance = LatestGsrSample.Conductance;
+        Data.GsrResistance = LatestGsrSample.Resistance;
+        Data.GsrTime = LatestGsrSample.Time;
         return Data;
     }
 
@@ -238,6 +635,110 @@ private:
     UFUNCTION()
     void OnOSCMessageReceived(const FOSCMessage& Message, const FString& IPAddress, int32 Port);
 
+    // 按编号获取压力通道的个体化统计（编号无效时返回 nullptr）
+    static FPressureNormalizer* FindPressureNormalizer(int32 SensorNumber);
+
+    // 指令数据报的字节上限，与固件 receiveCommands 的接收缓冲区相同（maxCommandBytes）
+    static constexpr int32 MaxFeedbackBundleBytes = 512;
+
+    // 还不知道手柄地址时最多保留的指令数，超过后丢弃新的指令
+    static constexpr int32 MaxPendingFeedbackMessages = 64;
+
+    // 本帧待发送的指令，超过字节上限时拆成多个数据报
+    static TArray<FOSCBundle> PendingFeedbackBundles;
+    static int32 PendingFeedbackBytes;
+    static int32 PendingFeedbackCount;
+    static int32 DroppedFeedbackCount;
+
+    // 指令序号与发送时间（按序号取模的环形表，用于计算往返延迟）
+    static constexpr int32 FeedbackHistorySize = 32;
+    static int32 FeedbackSequence;
+    static double FeedbackSendTimes[FeedbackHistorySize];
+    static float LastFeedbackLatency;
+    static float AverageFeedbackLatency;
+
+    // 每个手柄报告的传输频率与模式（下标 = HandleNumber - 1）
+    static int32 NegotiatedRates[2];
+    static EHandleTransmitMode TransmitModes[2];
+
+    // 传输模式随实验阶段切换（只有手柄2有定时采样和传输模式）
+    static constexpr int32 ModeSwitchHandle = 2;
+    static FTransmitModeScheduler TransmitModeScheduler;
+    void UpdateTransmitMode();
+
+    // 定时采样历史（环形存储）
+    static constexpr int32 HandleSampleCapacity = 2048;
+    static TArray<FHandleSample> HandleSamples;
+    static int32 HandleSampleWriteIndex;
+
+    // 每个手柄的设备时间戳展开：micros() 约 71 分钟回绕一次，各手柄的计数互相独立
+    static bool bHasDeviceTime[2];
+    static uint32 LastDeviceMicros[2];
+    static double LatestDeviceTimes[2];
+
+    // 每个手柄的设备时间到共享时钟的对齐
+    static FDeviceClockAligner HandleClockAligners[2];
+
+    // 每个手柄最近一批定时样本到达的时间：批量数据流中摇杆和压力2只取自批量样本
+    static double LastBatchArrivalTimes[2];
+    static constexpr double BatchStreamTimeout = 0.1;
+
+    // 每个设备（0: 旧固件，1/2: 手柄）最近广播的输入样本时间；补发的旧样本只写入会话记录，不再广播
+    static double LastInputSampleTimes[3];
+
+    // 按时间顺序广播一个输入样本
+    static void BroadcastInputSample(const FHandleInputSample& Sample);
+
+    // 一帧完整：广播帧内的通道（批量数据流中摇杆和压力2已随批量样本广播）
+    static void BroadcastFrameInput(uint8 Device);
+
+    // 解析一批定时样本：手柄编号, 然后每个样本为 时间戳(us), 摇杆X, 摇杆Y, 压力2
+    static bool HandleSampleBatch(const FOSCMessage& Message);
+
+    // 把当前完整的手柄状态写入会话记录（Device: 手柄编号，旧固件为 0）
+    static void RecordControllerState(uint8 Device);
+
+    // 每个手柄的增量帧序号跟踪
+    static FFrameSequenceTracker FrameTrackers[2];
+
+    // 是否收到过带帧标记的数据
+    bool bFramedStream = false;
+
+    // 最近一次发来数据的手柄地址 / 反向通道当前的目标地址
+    FString LastSenderAddress;
+    FString FeedbackTargetAddress;
+
+    // GSR 后台采集
+    TUniquePtr<FGsrSource> GsrSource;
+
+    // 会话文件的后台维护（崩溃补全等），按提交顺序在后台线程执行，不占用游戏线程
+    static TFuture<void> SessionMaintenance;
+    static void RunSessionMaintenance(TUniqueFunction<void()> Work);
+
+    // 取出 GSR 后台线程的样本并广播
+    void DrainGsrSamples();
+
+    // 添加一条指令到本帧的数据报
+    static void AddFeedbackMessage(const FString& Address, TFunctionRef<void(FOSCMessage&)> AddArguments);
+
+    // 把本帧积累的指令作为 OSC bundle 发出（每个数据报不超过 MaxFeedbackBundleBytes）
+    void FlushFeedback();
+
+    // 处理手柄的指令确认
+    void HandleFeedbackAck(int32 Sequence);
+
+    // 一帧结束：更新 IMU 校正、检测丢帧并在需要时请求关键帧
+    void HandleFrameEnd(int32 HandleNumber, int32 Sequence, bool bKeyframe, const FString& IPAddress);
+
+    // 设备的一个 IMU 样本完整：用它的原始数据更新零偏估计并写入校正后的值
+    void UpdateImuCorrection(const FString& IPAddress);
+
+    // 设备收到一个 IMU 轴：记录原始值并返回该轴校正后的值（Axis: 0-2 加速度 x/y/z，3-5 陀螺仪 x/y/z）
+    float SetRawImuAxis(const FString& IPAddress, int32 Axis, float Value);
+
+    // 查找 IMU 设备（地址为空时取最近一次完成一个 IMU 样本的设备）
+    static const FImuDeviceState* FindImuDevice(const FString& DeviceAddress);
+
     // OSC服务器设置
     FString OSCServerIP = TEXT("0.0.0.0");
     int32 OSCServerPort = 7654;
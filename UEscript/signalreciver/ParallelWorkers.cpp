@@ -0,0 +1,64 @@
+#include "ParallelWorkers.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+namespace
+{
+    class FWorker : public FRunnable
+    {
+    public:
+        FWorker(TFunctionRef<void(int32)> InBody, int32 InIndex)
+            : Body(InBody)
+            , Index(InIndex)
+        {
+        }
+
+        virtual uint32 Run() override
+        {
+            Body(Index);
+            return 0;
+        }
+
+    private:
+        TFunctionRef<void(int32)> Body;
+        const int32 Index;
+    };
+}
+
+void FParallelWorkers::Run(int32 NumThreads, const TCHAR* Name, TFunctionRef<void(int32)> Body)
+{
+    TArray<TUniquePtr<FWorker>> Workers;
+    TArray<FRunnableThread*> Threads;
+    for (int32 Index = 1; Index < NumThreads; Index++)
+    {
+        Workers.Add(MakeUnique<FWorker>(Body, Index));
+        Threads.Add(FRunnableThread::Create(Workers.Last().Get(), *FString::Printf(TEXT("%s%d"), Name, Index)));
+    }
+
+    Body(0);
+
+    for (int32 Index = 0; Index < Threads.Num(); Index++)
+    {
+        if (Threads[Index])
+        {
+            Threads[Index]->WaitForCompletion();
+            delete Threads[Index];
+        }
+        else
+        {
+            Workers[Index]->Run();
+        }
+    }
+}
+
+void FParallelWorkers::ForEach(int32 NumJobs, int32 NumThreads, const TCHAR* Name, TFunctionRef<void(int32)> Body)
+{
+    TAtomic<int32> NextJob { 0 };
+    Run(FMath::Clamp(NumThreads, 1, FMath::Max(NumJobs, 1)), Name, [&NextJob, NumJobs, Body](int32)
+    {
+        for (int32 Job = NextJob++; Job < NumJobs; Job = NextJob++)
+        {
+            Body(Job);
+        }
+    });
+}
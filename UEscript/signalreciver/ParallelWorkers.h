@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 命令行工具共用的线程池（批量分析、组间比较、索引、导出）
+ * 工作线程用 FRunnableThread 创建，当前线程也参与；不支持多线程的平台上 Create 返回空，
+ * 这些线程的工作改在当前线程依次执行，所以调用方不需要区分单线程和多线程
+ */
+struct WORKVOILENCEGAME_API FParallelWorkers
+{
+    /**
+     * 在 NumThreads 个线程上各执行一次 Body(线程序号)，全部结束后返回
+     * 序号 0 在当前线程执行，1 .. NumThreads − 1 在名为 <Name><序号> 的工作线程上执行
+     */
+    static void Run(int32 NumThreads, const TCHAR* Name, TFunctionRef<void(int32)> Body);
+
+    /** 对 0 .. NumJobs − 1 各执行一次 Body，各线程从共享计数器领取，领取顺序不确定；线程数不超过任务数 */
+    static void ForEach(int32 NumJobs, int32 NumThreads, const TCHAR* Name, TFunctionRef<void(int32)> Body);
+};
@@ -0,0 +1,94 @@
+#include "PressureNormalizer.h"
+
+void FPressureNormalizer::AddSample(double Time, float Pressure)
+{
+    if (bCalibrated && bFreezeAfterWarmup)
+    {
+        return;
+    }
+
+    if (LastTime >= 0.0)
+    {
+        const double Elapsed = Time - LastTime;
+        if (Elapsed < 0.0)
+        {
+            return;
+        }
+
+        // 上一个值一直保持到本样本：每经过一个网格间隔统计一次，平台期按时长计入
+        if (Elapsed <= MaxHoldDuration)
+        {
+            HeldDuration += Elapsed;
+            while (HeldDuration >= GridInterval)
+            {
+                HeldDuration -= GridInterval;
+                AddGridSample(Time - HeldDuration, LastPressure);
+            }
+        }
+        else
+        {
+            HeldDuration = 0.0;
+        }
+    }
+
+    LastTime = Time;
+    LastPressure = Pressure;
+}
+
+void FPressureNormalizer::AddGridSample(double Time, float Pressure)
+{
+    if (Pressure < ActivityFloor)
+    {
+        return;
+    }
+
+    if (WarmupStartTime < 0.0)
+    {
+        WarmupStartTime = Time;
+    }
+
+    Quantile.Add(Pressure);
+
+    if (!bCalibrated
+        && Time - WarmupStartTime >= WarmupDuration
+        && Quantile.GetCount() >= MinWarmupSamples)
+    {
+        bCalibrated = true;
+    }
+}
+
+float FPressureNormalizer::GetPercentileOfValue(float Pressure) const
+{
+    if (Pressure < ActivityFloor)
+    {
+        return 0.0f;
+    }
+    return Quantile.GetPercentileOfValue(Pressure);
+}
+
+float FPressureNormalizer::Normalize(float Pressure) const
+{
+    if (!bCalibrated)
+    {
+        return Pressure;
+    }
+
+    const float Low = Quantile.GetValueAtPercentile(RangeLowPercentile);
+    const float High = Quantile.GetValueAtPercentile(RangeHighPercentile);
+    if (High - Low <= KINDA_SMALL_NUMBER)
+    {
+        return Pressure;
+    }
+
+    return FMath::Clamp((Pressure - Low) / (High - Low), 0.0f, 1.0f);
+}
+
+void FPressureNormalizer::Reset()
+{
+    Quantile.Reset();
+    WarmupStartTime = -1.0;
+    bCalibrated = false;
+    LastTime = -1.0;
+    LastPressure = 0.0f;
+    HeldDuration = 0.0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StreamingQuantile.h"
+
+/**
+ * 单个压力通道的被试个体化归一化
+ * 在短暂的热身期内用流式分位数学习该被试的握压范围，之后阈值可以用百分位表达，
+ * 内存占用与会话时长无关
+ * 输入按采样保持重采样到固定时间网格后再统计：增量帧在平台期不发送数据，批量样本又比增量帧密得多，
+ * 直接按样本计数会让分位数偏向变化段和试次模式
+ */
+struct WORKVOILENCEGAME_API FPressureNormalizer
+{
+public:
+    /** 热身时长（秒，从第一次有效握压样本开始计时） */
+    float WarmupDuration = 20.0f;
+
+    /** 热身期内至少需要的有效样本数（按网格计，见 GridInterval） */
+    int32 MinWarmupSamples = 200;
+
+    /** 统计网格的间隔（秒） */
+    float GridInterval = 0.01f;
+
+    /** 相邻样本间隔超过此值（秒）时视为断线，不补中间的平台期；应大于手柄的关键帧间隔（1 秒） */
+    float MaxHoldDuration = 1.5f;
+
+    /** 低于此值视为静息噪声，不参与握压范围统计（压力值 0~1） */
+    float ActivityFloor = 0.02f;
+
+    /** 归一化范围的下/上百分位 */
+    float RangeLowPercentile = 5.0f;
+    float RangeHighPercentile = 95.0f;
+
+    /** 热身完成后是否冻结统计，保证会话中阈值稳定 */
+    bool bFreezeAfterWarmup = true;
+
+    /** 送入一个样本（Time: 共享传感器时钟，秒，应单调不减；时间回退的样本被忽略） */
+    void AddSample(double Time, float Pressure);
+
+    /** 热身是否完成 */
+    bool IsCalibrated() const { return bCalibrated; }
+
+    /** 被试握压范围内某个百分位（0~100）对应的压力值 */
+    float GetValueAtPercentile(float Percentile) const { return Quantile.GetValueAtPercentile(Percentile); }
+
+    /** 某个压力值在被试握压范围内的百分位（0~100），静息噪声返回 0 */
+    float GetPercentileOfValue(float Pressure) const;
+
+    /** 按被试范围归一化到 0~1（未完成热身时原样返回） */
+    float Normalize(float Pressure) const;
+
+    void Reset();
+
+private:
+    /** 统计一个网格点 */
+    void AddGridSample(double Time, float Pressure);
+
+    FStreamingQuantile Quantile;
+    double WarmupStartTime = -1.0;
+    bool bCalibrated = false;
+
+    // 采样保持状态
+    double LastTime = -1.0;
+    float LastPressure = 0.0f;
+    double HeldDuration = 0.0;
+};
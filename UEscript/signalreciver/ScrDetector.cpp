@@ -0,0 +1,123 @@
+#include "ScrDetector.h"
+
+FScrSampleResult FScrDetector::AddSample(double Time, float Conductance)
+{
+    FScrSampleResult Result;
+
+    if (!bHasSample || Time < LastTime || Time - LastTime > MaxSampleGap)
+    {
+        // 第一个样本，或者时间轴重新开始
+        bHasSample = true;
+        LastTime = Time;
+        Smoothed = Conductance;
+        Tonic = Conductance;
+        RestartTrough(Time);
+
+        Result.Tonic = Tonic;
+        return Result;
+    }
+
+    const float Dt = static_cast<float>(Time - LastTime);
+    if (Dt <= 0.0f)
+    {
+        Result.Tonic = Tonic;
+        Result.Phasic = GetPhasic();
+        return Result;
+    }
+    LastTime = Time;
+
+    const float Alpha = SmoothingTime > 0.0f ? 1.0f - FMath::Exp(-Dt / SmoothingTime) : 1.0f;
+    Smoothed += Alpha * (Conductance - Smoothed);
+
+    if (!bRising)
+    {
+        if (Smoothed <= TroughLevel)
+        {
+            TroughLevel = Smoothed;
+            TroughTime = Time;
+        }
+        else if (Smoothed > TroughLevel + Hysteresis)
+        {
+            bRising = true;
+            bOnsetReported = false;
+            PeakLevel = Smoothed;
+            PeakTime = Time;
+        }
+    }
+    else
+    {
+        if (Smoothed >= PeakLevel)
+        {
+            PeakLevel = Smoothed;
+            PeakTime = Time;
+        }
+
+        const float RiseTime = static_cast<float>(PeakTime - TroughTime);
+        if (!bOnsetReported && PeakLevel - TroughLevel >= AmplitudeThreshold && RiseTime >= MinRiseTime)
+        {
+            bOnsetReported = true;
+            OnsetDetectionTime = Time;
+
+            Result.bOnset = true;
+            Result.Event.OnsetTime = TroughTime;
+            Result.Event.OnsetDetectionTime = Time;
+            Result.Event.TonicLevel = Tonic;
+        }
+
+        if (Smoothed < PeakLevel - Hysteresis)
+        {
+            // 已越过峰值
+            if (bOnsetReported)
+            {
+                Result.bPeak = true;
+                Result.Event.OnsetTime = TroughTime;
+                Result.Event.PeakTime = PeakTime;
+                Result.Event.OnsetDetectionTime = OnsetDetectionTime;
+                Result.Event.DetectionTime = Time;
+                Result.Event.Amplitude = PeakLevel - TroughLevel;
+                Result.Event.TonicLevel = Tonic;
+                Result.Event.RiseTime = RiseTime;
+            }
+            RestartTrough(Time);
+        }
+        else if (!bOnsetReported && Time - TroughTime > MaxRiseTime)
+        {
+            // 缓慢上升没有形成反应，视为张力漂移
+            RestartTrough(Time);
+        }
+    }
+
+    // 张力分量只在静息段跟随，反应上升期间保持不变；任何时候都不高于平滑信号
+    if (!bRising)
+    {
+        Tonic += (1.0f - FMath::Exp(-Dt / TonicTimeConstant)) * (Smoothed - Tonic);
+    }
+    Tonic = FMath::Min(Tonic, Smoothed);
+
+    Result.Tonic = Tonic;
+    Result.Phasic = GetPhasic();
+    return Result;
+}
+
+void FScrDetector::RestartTrough(double Time)
+{
+    bRising = false;
+    bOnsetReported = false;
+    TroughLevel = Smoothed;
+    TroughTime = Time;
+}
+
+void FScrDetector::Reset()
+{
+    bHasSample = false;
+    LastTime = 0.0;
+    Smoothed = 0.0f;
+    Tonic = 0.0f;
+    bRising = false;
+    bOnsetReported = false;
+    TroughLevel = 0.0f;
+    TroughTime = 0.0;
+    PeakLevel = 0.0f;
+    PeakTime = 0.0;
+    OnsetDetectionTime = 0.0;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScrDetector.generated.h"
+
+/** 一次皮肤电反应（SCR，谷到峰）*/
+USTRUCT(BlueprintType)
+struct FScrEvent
+{
+    GENERATED_BODY()
+
+    /** 起始时间：反应前谷底所在的样本（秒，共享传感器时钟）*/
+    UPROPERTY(BlueprintReadOnly, Category = "SCR")
+    double OnsetTime = 0.0;
+
+    /** 峰值时间（秒）*/
+    UPROPERTY(BlueprintReadOnly, Category = "SCR")
+    double PeakTime = 0.0;
+
+    /** 检测到起始的时间（上升幅度首次超过阈值，秒）*/
+    UPROPERTY(BlueprintReadOnly, Category = "SCR")
+    double OnsetDetectionTime = 0.0;
+
+    /** 确认峰值的时间（秒），减去 PeakTime 即峰值确认延迟 */
+    UPROPERTY(BlueprintReadOnly, Category = "SCR")
+    double DetectionTime = 0.0;
+
+    /** 谷到峰幅度（μS）*/
+    UPROPERTY(BlueprintReadOnly, Category = "SCR")
+    float Amplitude = 0.0f;
+
+    /** 起始时的张力水平（μS）*/
+    UPROPERTY(BlueprintReadOnly, Category = "SCR")
+    float TonicLevel = 0.0f;
+
+    /** 上升时间（秒）*/
+    UPROPERTY(BlueprintReadOnly, Category = "SCR")
+    float RiseTime = 0.0f;
+};
+
+/** 单个样本的检测结果 */
+struct FScrSampleResult
+{
+    /** 本样本确认了一次 SCR 的起始（上升幅度已超过阈值）*/
+    bool bOnset = false;
+
+    /** 本样本确认了峰值，Event 完整有效 */
+    bool bPeak = false;
+
+    /** bOnset 时 Event 中只有起始相关字段有效 */
+    FScrEvent Event;
+
+    /** 当前的张力（tonic）与位相（phasic）分量（μS）*/
+    float Tonic = 0.0f;
+    float Phasic = 0.0f;
+};
+
+/**
+ * 皮肤电导的流式 SCR 检测器（因果，每个样本 O(1)）
+ * 平滑：单极点低通；张力分量：平滑信号的下包络，静息时以长时间常数缓慢跟随；
+ * 位相分量：平滑信号 - 张力分量
+ * 检测：谷底之后上升超过 Hysteresis 进入上升段，幅度超过 AmplitudeThreshold 时报告起始，
+ * 从峰值回落超过 Hysteresis 时确认峰值并报告完整事件（与 Ledalab 的 TTP 口径一致）
+ */
+struct WORKVOILENCEGAME_API FScrDetector
+{
+public:
+    // === 检测参数（电导单位 μS，时间单位秒）===
+
+    /** 最小 SCR 幅度（Ledalab 常用 0.01~0.05）*/
+    float AmplitudeThreshold = 0.01f;
+
+    /** 谷底/峰值的滞回量，用于抑制 ADC 量化抖动 */
+    float Hysteresis = 0.005f;
+
+    /** 平滑时间常数，群延迟约为此值 */
+    float SmoothingTime = 0.2f;
+
+    /** 张力分量的跟随时间常数 */
+    float TonicTimeConstant = 10.0f;
+
+    /** 最短上升时间，更快的上升视为噪声 */
+    float MinRiseTime = 0.0f;
+
+    /** 最长上升时间，仍未达到阈值的缓慢上升归入张力漂移 */
+    float MaxRiseTime = 6.0f;
+
+    /** 样本间隔超过此值（设备断开或重连）时重新开始 */
+    float MaxSampleGap = 2.0f;
+
+    // === 接口 ===
+
+    /** 输入一个样本 */
+    FScrSampleResult AddSample(double Time, float Conductance);
+
+    bool IsRising() const { return bRising; }
+
+    float GetTonic() const { return Tonic; }
+
+    float GetPhasic() const { return Smoothed - Tonic; }
+
+    void Reset();
+
+private:
+    /** 以当前样本为新的谷底 */
+    void RestartTrough(double Time);
+
+    bool bHasSample = false;
+    double LastTime = 0.0;
+    float Smoothed = 0.0f;
+    float Tonic = 0.0f;
+
+    bool bRising = false;
+    bool bOnsetReported = false;
+    float TroughLevel = 0.0f;
+    double TroughTime = 0.0;
+    float PeakLevel = 0.0f;
+    double PeakTime = 0.0;
+    double OnsetDetectionTime = 0.0;
+};
@@ -0,0 +1,29 @@
+#include "SensorClock.h"
+
+double FSensorClock::Now()
+{
+    // 首次调用时确定起点，之后所有线程共用（C++11 保证局部静态变量线程安全初始化）
+    static const double Epoch = FPlatformTime::Seconds();
+    return FPlatformTime::Seconds() - Epoch;
+}
+
+double FDeviceClockAligner::Align(double DeviceTime, double ArrivalTime)
+{
+    const double Offset = ArrivalTime - DeviceTime;
+
+    if (!bHasOffset || DeviceTime < LastDeviceTime)
+    {
+        // 第一个样本或设备重新开始计时
+        ClockOffset = Offset;
+        bHasOffset = true;
+    }
+    else
+    {
+        // 下包络：延迟更小的样本立即拉低偏移，否则按晶振频差上限缓慢上漂
+        const double Elapsed = DeviceTime - LastDeviceTime;
+        ClockOffset = FMath::Min(Offset, ClockOffset + Elapsed * OffsetDriftPerSecond);
+    }
+    LastDeviceTime = DeviceTime;
+
+    return DeviceTime + ClockOffset;
+}
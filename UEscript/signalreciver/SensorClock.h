@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 所有传感器数据共用的单调时钟（秒）
+ * 基于 FPlatformTime，不受游戏暂停和时间膨胀影响；手柄 OSC 数据和 GSR 样本都用它打时间戳，
+ * 因此两路数据可以直接对齐，不再需要事后手工修正
+ */
+struct WORKVOILENCEGAME_API FSensorClock
+{
+    /** 当前时间（秒，从进程内第一次调用起算）*/
+    static double Now();
+};
+
+/**
+ * 把设备时间戳映射到共享传感器时钟
+ * 偏移取"到达时间 − 设备时间"的下包络：延迟更小的样本立即拉低偏移，否则按晶振频差上限缓慢上漂，
+ * 因此成批到达的样本保持设备上的采样间隔，而不是全部落在到达时刻
+ */
+struct WORKVOILENCEGAME_API FDeviceClockAligner
+{
+    /** 设备时间（秒）和到达时的共享时钟（秒）→ 共享时钟上的采样时间；设备时间回退时重新起算 */
+    double Align(double DeviceTime, double ArrivalTime);
+
+    /** 设备重新开始计时时调用 */
+    void Reset() { bHasOffset = false; }
+
+    /** 偏移每秒允许上漂的量（秒/秒），覆盖常见晶振的频差 */
+    static constexpr double OffsetDriftPerSecond = 0.0005;
+
+private:
+    bool bHasOffset = false;
+    double ClockOffset = 0.0;
+    double LastDeviceTime = 0.0;
+};
@@ -0,0 +1,321 @@
+#include "SessionCodecBenchmarkCommandlet.h"
+#include "BenchmarkTiming.h"
+#include "GorillaCodec.h"
+#include "SessionRecorder.h"
+#include "MatFileReader.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+    /** 一列 double 数据（时间列按时间戳编码）*/
+    struct FCodecColumn
+    {
+        FString Name;
+        bool bTimestamp = false;
+        TArray<double> Values;
+    };
+
+    struct FCodecResult
+    {
+        int64 RawBytes = 0;
+        int64 GorillaBytes = 0;
+        int64 ZlibBytes = 0;
+        double EncodeSeconds = 0.0;
+        double DecodeSeconds = 0.0;
+        double ZlibEncodeSeconds = 0.0;
+        double ZlibDecodeSeconds = 0.0;
+        bool bLossless = true;
+    };
+
+    bool LoadMatColumns(const FString& Path, TArray<FCodecColumn>& OutColumns, FString& OutError)
+    {
+        TArray<FMatVariable> Variables;
+        if (!FMatFileReader::Load(Path, Variables, OutError))
+        {
+            return false;
+        }
+        for (const TCHAR* Name : { TEXT("data.time"), TEXT("data.conductance") })
+        {
+            if (const TArray<double>* Values = FMatFileReader::FindNumbers(Variables, Name))
+            {
+                FCodecColumn& Column = OutColumns.AddDefaulted_GetRef();
+                Column.Name = Name;
+                Column.bTimestamp = FCString::Strcmp(Name, TEXT("data.time")) == 0;
+                Column.Values = *Values;
+            }
+        }
+        if (OutColumns.Num() == 0)
+        {
+            OutError = TEXT("缺少 data.time / data.conductance");
+            return false;
+        }
+        return true;
+    }
+
+    bool LoadTextColumns(const FString& Path, TArray<FCodecColumn>& OutColumns, FString& OutError)
+    {
+        FString Text;
+        if (!FFileHelper::LoadFileToString(Text, *Path))
+        {
+            OutError = TEXT("无法读取");
+            return false;
+        }
+
+        TArray<FString> Lines;
+        Text.ParseIntoArray(Lines, TEXT("\n"));
+        TArray<FString> Fields;
+        for (const FString& Line : Lines)
+        {
+            Line.TrimStartAndEnd().ParseIntoArray(Fields, TEXT("\t"));
+            // 跳过表头
+            if (Fields.Num() == 0 || !Fields[0].IsNumeric())
+            {
+                continue;
+            }
+            if (OutColumns.Num() == 0)
+            {
+                for (int32 Index = 0; Index < Fields.Num(); Index++)
+                {
+                    FCodecColumn& Column = OutColumns.AddDefaulted_GetRef();
+                    Column.Name = FString::Printf(TEXT("列 %d"), Index + 1);
+                    Column.bTimestamp = Index == 0;
+                }
+            }
+            for (int32 Index = 0; Index < OutColumns.Num(); Index++)
+            {
+                OutColumns[Index].Values.Add(Fields.IsValidIndex(Index) ? FCString::Atod(*Fields[Index]) : 0.0);
+            }
+        }
+        if (OutColumns.Num() == 0)
+        {
+            OutError = TEXT("没有数据行");
+            return false;
+        }
+        return true;
+    }
+
+    FCodecResult BenchmarkColumns(const TArray<FCodecColumn>& Columns, int32 Repeat)
+    {
+        FCodecResult Result;
+        TArray<uint8> Raw;
+        for (const FCodecColumn& Column : Columns)
+        {
+            Raw.Append(reinterpret_cast<const uint8*>(Column.Values.GetData()), Column.Values.Num() * sizeof(double));
+        }
+        Result.RawBytes = Raw.Num();
+
+        TArray<uint8> Encoded;
+        Result.EncodeSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+        {
+            Encoded.Reset();
+            FGorillaBitWriter Writer(Encoded);
+            for (const FCodecColumn& Column : Columns)
+            {
+                if (Column.bTimestamp)
+                {
+                    FGorillaCodec::EncodeTimestamps(Column.Values.GetData(), Column.Values.Num(), Writer);
+                }
+                else
+                {
+                    FGorillaCodec::EncodeDoubles(Column.Values.GetData(), Column.Values.Num(), Writer);
+                }
+            }
+            Writer.Flush();
+        });
+        Result.GorillaBytes = Encoded.Num();
+
+        TArray<TArray<double>> Decoded;
+        Decoded.SetNum(Columns.Num());
+        Result.DecodeSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+        {
+            FGorillaBitReader Reader(Encoded.GetData(), Encoded.Num());
+            for (int32 Index = 0; Index < Columns.Num(); Index++)
+            {
+                const int32 Count = Columns[Index].Values.Num();
+                Decoded[Index].SetNumUninitialized(Count);
+                Result.bLossless &= Columns[Index].bTimestamp
+                    ? FGorillaCodec::DecodeTimestamps(Reader, Count, Decoded[Index].GetData())
+                    : FGorillaCodec::DecodeDoubles(Reader, Count, Decoded[Index].GetData());
+            }
+        });
+        for (int32 Index = 0; Index < Columns.Num(); Index++)
+        {
+            Result.bLossless &= FMemory::Memcmp(Decoded[Index].GetData(), Columns[Index].Values.GetData(), Columns[Index].Values.Num() * sizeof(double)) == 0;
+        }
+
+        // 对照：整块 zlib
+        TArray<uint8> Compressed;
+        Result.ZlibEncodeSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+        {
+            int32 CompressedBytes = FCompression::CompressMemoryBound(NAME_Zlib, Raw.Num());
+            Compressed.SetNumUninitialized(CompressedBytes);
+            FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedBytes, Raw.GetData(), Raw.Num());
+            Compressed.SetNum(CompressedBytes);
+        });
+        Result.ZlibBytes = Compressed.Num();
+        TArray<uint8> Inflated;
+        Inflated.SetNumUninitialized(Raw.Num());
+        Result.ZlibDecodeSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+        {
+            FCompression::UncompressMemory(NAME_Zlib, Inflated.GetData(), Inflated.Num(), Compressed.GetData(), Compressed.Num());
+        });
+        return Result;
+    }
+
+    FCodecResult BenchmarkSession(const FSessionFile& File, int32 Repeat)
+    {
+        FCodecResult Result;
+        TArray<uint8> Encoded;
+        for (const FSessionChunk& Chunk : File.Chunks)
+        {
+            Result.RawBytes += FSessionRecorder::GetRawColumnBytes(Chunk.Channel, Chunk.NumRows());
+        }
+
+        for (const ESessionCodec Codec : { ESessionCodec::Gorilla, ESessionCodec::Zlib })
+        {
+            int64 Bytes = 0;
+            TArray<TArray<uint8>> Chunks;
+            Chunks.SetNum(File.Chunks.Num());
+            const double EncodeSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+            {
+                Bytes = 0;
+                for (int32 Index = 0; Index < File.Chunks.Num(); Index++)
+                {
+                    FSessionRecorder::EncodeChunk(File.Chunks[Index], Codec, Chunks[Index]);
+                    Bytes += Chunks[Index].Num();
+                }
+            });
+
+            // 块头之后为负载，解码并逐列比较
+            constexpr int32 HeaderBytes = 24;
+            TArray<FSessionChunk> Decoded;
+            Decoded.SetNum(File.Chunks.Num());
+            const double DecodeSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+            {
+                for (int32 Index = 0; Index < File.Chunks.Num(); Index++)
+                {
+                    const TArray<uint8>& Data = Chunks[Index];
+                    uint32 RawBytes;
+                    FMemory::Memcpy(&RawBytes, Data.GetData() + 12, sizeof(RawBytes));
+                    FSessionChunk& Chunk = Decoded[Index];
+                    Chunk = FSessionChunk();
+                    Chunk.Channel = File.Chunks[Index].Channel;
+                    Result.bLossless &= FSessionRecorder::DecodeChunkPayload(static_cast<ESessionCodec>(Data[6]), Data.GetData() + HeaderBytes,
+                        Data.Num() - HeaderBytes, static_cast<int32>(RawBytes), File.Chunks[Index].NumRows(), Chunk);
+                }
+            });
+            for (int32 Index = 0; Index < File.Chunks.Num(); Index++)
+            {
+                const FSessionChunk& Original = File.Chunks[Index];
+                const FSessionChunk& Chunk = Decoded[Index];
+                Result.bLossless &= Chunk.NumRows() == Original.NumRows()
+                    && FMemory::Memcmp(Chunk.Time.GetData(), Original.Time.GetData(), Original.Time.Num() * sizeof(double)) == 0
+                    && Chunk.DeviceTime.Num() == Original.DeviceTime.Num()
+                    && FMemory::Memcmp(Chunk.DeviceTime.GetData(), Original.DeviceTime.GetData(), Original.DeviceTime.Num() * sizeof(double)) == 0
+                    && Chunk.Buttons.Num() == Original.Buttons.Num()
+                    && FMemory::Memcmp(Chunk.Buttons.GetData(), Original.Buttons.GetData(), Original.Buttons.Num()) == 0
+                    && Chunk.Names == Original.Names;
+                for (int32 Column = 0; Column < FSessionRecord::MaxValues; Column++)
+                {
+                    Result.bLossless &= Chunk.Values[Column].Num() == Original.Values[Column].Num()
+                        && FMemory::Memcmp(Chunk.Values[Column].GetData(), Original.Values[Column].GetData(), Original.Values[Column].Num() * sizeof(float)) == 0;
+                }
+            }
+
+            if (Codec == ESessionCodec::Gorilla)
+            {
+                Result.GorillaBytes = Bytes;
+                Result.EncodeSeconds = EncodeSeconds;
+                Result.DecodeSeconds = DecodeSeconds;
+            }
+            else
+            {
+                Result.ZlibBytes = Bytes;
+                Result.ZlibEncodeSeconds = EncodeSeconds;
+                Result.ZlibDecodeSeconds = DecodeSeconds;
+            }
+        }
+        return Result;
+    }
+
+    double GigabytesPerSecond(int64 Bytes, double Seconds)
+    {
+        return Seconds > 0.0 ? Bytes / Seconds / 1.0e9 : 0.0;
+    }
+}
+
+USessionCodecBenchmarkCommandlet::USessionCodecBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 USessionCodecBenchmarkCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Files;
+    TArray<FString> Switches;
+    ParseCommandLine(*Params, Files, Switches);
+
+    int32 Repeat = 20;
+    FParse::Value(*Params, TEXT("Repeat="), Repeat);
+    Repeat = FMath::Max(Repeat, 1);
+
+    if (Files.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("用法: -run=SessionCodecBenchmark <会话.wvsession | 会话.mat | 导出.txt> [...] [-Repeat=20]"));
+        return 1;
+    }
+
+    int32 Failures = 0;
+    for (const FString& File : Files)
+    {
+        const FString Extension = FPaths::GetExtension(File).ToLower();
+        FCodecResult Result;
+        FString Error;
+        if (Extension == TEXT("wvsession"))
+        {
+            FSessionFile Session;
+            if (!FSessionRecorder::ReadFile(File, Session, Error))
+            {
+                UE_LOG(LogTemp, Error, TEXT("%s: %s"), *File, *Error);
+                Failures++;
+                continue;
+            }
+            Result = BenchmarkSession(Session, Repeat);
+        }
+        else
+        {
+            TArray<FCodecColumn> Columns;
+            if (!(Extension == TEXT("mat") ? LoadMatColumns(File, Columns, Error) : LoadTextColumns(File, Columns, Error)))
+            {
+                UE_LOG(LogTemp, Error, TEXT("%s: %s"), *File, *Error);
+                Failures++;
+                continue;
+            }
+            Result = BenchmarkColumns(Columns, Repeat);
+        }
+
+        const int64 FileBytes = IFileManager::Get().FileSize(*File);
+        UE_LOG(LogTemp, Display, TEXT("%s: 原始 %lld 字节（文件 %lld 字节）"), *FPaths::GetCleanFilename(File), Result.RawBytes, FileBytes);
+        UE_LOG(LogTemp, Display, TEXT("  Gorilla %lld 字节，压缩率 %.2f（相对文件 %.2f），编码 %.2f GB/s，解码 %.2f GB/s，%s"),
+            Result.GorillaBytes, Result.RawBytes / static_cast<double>(FMath::Max<int64>(Result.GorillaBytes, 1)),
+            FileBytes / static_cast<double>(FMath::Max<int64>(Result.GorillaBytes, 1)),
+            GigabytesPerSecond(Result.RawBytes, Result.EncodeSeconds), GigabytesPerSecond(Result.RawBytes, Result.DecodeSeconds),
+            Result.bLossless ? TEXT("逐位一致") : TEXT("解码不一致！"));
+        UE_LOG(LogTemp, Display, TEXT("  zlib    %lld 字节，压缩率 %.2f，编码 %.2f GB/s，解码 %.2f GB/s"),
+            Result.ZlibBytes, Result.RawBytes / static_cast<double>(FMath::Max<int64>(Result.ZlibBytes, 1)),
+            GigabytesPerSecond(Result.RawBytes, Result.ZlibEncodeSeconds), GigabytesPerSecond(Result.RawBytes, Result.ZlibDecodeSeconds));
+        if (!Result.bLossless)
+        {
+            Failures++;
+        }
+    }
+    return Failures > 0 ? 1 : 0;
+}
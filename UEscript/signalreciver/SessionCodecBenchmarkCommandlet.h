@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SessionCodecBenchmarkCommandlet.generated.h"
+
+/**
+ * 会话列编码的基准测试：在已有的记录上比较 Gorilla 编码与 zlib 的大小和速度，并检查逐位无损
+ * - <会话>.wvsession：每个列块分别用 Gorilla 和 zlib 编码后解码
+ * - Ledalab 的 .mat（data.time / data.conductance）与导出的 .txt（制表符分隔，第一列为时间）：
+ *   时间列按时间戳编码，其他列按 double 异或编码
+ * 输出原始二进制大小、ASCII 大小（.txt）、编码后大小、压缩率和编码 / 解码速度（按原始字节计 GB/s）
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=SessionCodecBenchmark <文件> [...] [-Repeat=20]
+ */
+UCLASS()
+class WORKVOILENCEGAME_API USessionCodecBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USessionCodecBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,355 @@
+#include "SessionExportCommandlet.h"
+#include "BenchmarkTiming.h"
+#include "SessionExporter.h"
+#include "SessionImporter.h"
+#include "SessionRecorder.h"
+#include "GsrSignalSynthesizer.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    /** 合成会话每个列块的行数（与 FSessionRecorder::ChunkRows 的默认值相同）*/
+    constexpr int32 SyntheticChunkRows = 4096;
+
+    void AddSyntheticRecord(FSessionFile& OutFile, const FSessionRecord& Record, const TCHAR* Name = nullptr)
+    {
+        if (OutFile.Chunks.Num() == 0 || OutFile.Chunks.Last().Channel != Record.Channel || OutFile.Chunks.Last().NumRows() >= SyntheticChunkRows)
+        {
+            FSessionChunk& Chunk = OutFile.Chunks.AddDefaulted_GetRef();
+            Chunk.Channel = Record.Channel;
+            Chunk.Device = Record.Device;
+        }
+        OutFile.Chunks.Last().AddRecord(Record);
+        if (Name)
+        {
+            OutFile.Chunks.Last().Names.Add(Name);
+        }
+    }
+
+    /** 生成 Hours 小时的会话：GSR（FGsrSignalSynthesizer）、手柄 1（60 Hz，摇杆和压力为正弦，按钮每秒切换）、每 30 秒一对刺激 / 反应 */
+    void MakeSyntheticSession(double Hours, int32 RateHz, const FString& Params, FSessionFile& OutFile)
+    {
+        OutFile = FSessionFile();
+        OutFile.StartedAt = FDateTime::UtcNow();
+
+        FGsrSignalSynthesizer Synthesizer;
+        Synthesizer.ParseCommandLine(*Params);
+        Synthesizer.SampleRateHz = static_cast<float>(RateHz);
+        Synthesizer.DropoutsPerMinute = 0.0f;
+        Synthesizer.Reset();
+
+        FSessionRecord Record;
+        Record.Channel = ESessionChannel::Gsr;
+        FGsrBinarySample Sample;
+        const int64 GsrRows = static_cast<int64>(Hours * 3600.0 * RateHz);
+        for (int64 Row = 0; Row < GsrRows; Row++)
+        {
+            Synthesizer.Next(Sample);
+            Record.Time = static_cast<double>(Row) / RateHz;
+            Record.DeviceTime = Sample.DeviceTime;
+            Record.Values[0] = Sample.Raw;
+            Record.Values[1] = Sample.Resistance;
+            Record.Values[2] = Sample.Conductance;
+            AddSyntheticRecord(OutFile, Record);
+        }
+
+        Record = FSessionRecord();
+        Record.Channel = ESessionChannel::Controller;
+        Record.Device = 1;
+        const int64 ControllerRows = static_cast<int64>(Hours * 3600.0 * 60.0);
+        for (int64 Row = 0; Row < ControllerRows; Row++)
+        {
+            const double Time = Row / 60.0;
+            Record.Time = Time;
+            Record.Values[0] = static_cast<float>(FMath::Sin(Time * 0.7));
+            Record.Values[1] = static_cast<float>(FMath::Cos(Time * 0.3));
+            Record.Values[2] = static_cast<float>(0.5 + 0.5 * FMath::Sin(Time * 2.1));
+            Record.Values[3] = static_cast<float>(0.5 + 0.5 * FMath::Cos(Time * 1.3));
+            Record.Values[6] = 9.81f;
+            Record.Buttons = static_cast<uint8>(static_cast<int64>(Time) & 1);
+            AddSyntheticRecord(OutFile, Record);
+        }
+
+        Record = FSessionRecord();
+        Record.Channel = ESessionChannel::Event;
+        for (int32 Trial = 1; Trial * 30.0 < Hours * 3600.0; Trial++)
+        {
+            Record.Time = Trial * 30.0;
+            Record.Values[0] = 0.0f;
+            Record.Values[1] = static_cast<float>(Trial);
+            AddSyntheticRecord(OutFile, Record, TEXT("Stimulus_synthetic"));
+            Record.Time += 0.4 + 0.01 * (Trial % 20);
+            Record.Values[0] = 1.0f;
+            AddSyntheticRecord(OutFile, Record, TEXT("Response_synthetic"));
+        }
+    }
+
+    /** 对照：与 gsr_collector.py 的 save_to_csv 相同，每行 Printf（%.6f）后追加到整个文件的字符串，最后一次保存 */
+    bool ExportBaseline(const FSessionFile& File, const FString& BasePath, int64& OutBytes)
+    {
+        OutBytes = 0;
+        TArray<TPair<ESessionChannel, uint8>> Tables;
+        for (const FSessionChunk& Chunk : File.Chunks)
+        {
+            Tables.AddUnique(TPair<ESessionChannel, uint8>(Chunk.Channel, Chunk.Device));
+        }
+
+        for (const TPair<ESessionChannel, uint8>& Table : Tables)
+        {
+            const ESessionChannel Channel = Table.Key;
+            FString Text = FSessionRecorder::HasDeviceTime(Channel) ? TEXT("Time,DeviceTime") : TEXT("Time");
+            for (int32 Index = 0; Index < FSessionRecorder::GetValueCount(Channel); Index++)
+            {
+                Text += FString::Printf(TEXT(",%s"), FSessionRecorder::GetValueName(Channel, Index));
+            }
+            Text += FSessionRecorder::HasButtons(Channel) ? TEXT(",Buttons") : TEXT("");
+            Text += Channel == ESessionChannel::Event ? TEXT(",Name\n") : TEXT("\n");
+
+            for (const FSessionChunk& Chunk : File.Chunks)
+            {
+                if (Chunk.Channel != Channel || Chunk.Device != Table.Value)
+                {
+                    continue;
+                }
+                for (int32 Row = 0; Row < Chunk.NumRows(); Row++)
+                {
+                    FString Line = FString::Printf(TEXT("%.6f"), Chunk.Time[Row]);
+                    if (FSessionRecorder::HasDeviceTime(Channel))
+                    {
+                        Line += FString::Printf(TEXT(",%.6f"), Chunk.DeviceTime[Row]);
+                    }
+                    for (int32 Index = 0; Index < FSessionRecorder::GetValueCount(Channel); Index++)
+                    {
+                        Line += FString::Printf(TEXT(",%.6f"), Chunk.Values[Index][Row]);
+                    }
+                    if (FSessionRecorder::HasButtons(Channel))
+                    {
+                        Line += FString::Printf(TEXT(",%d"), Chunk.Buttons[Row]);
+                    }
+                    if (Channel == ESessionChannel::Event)
+                    {
+                        Line += FString::Printf(TEXT(",%s"), Chunk.Names.IsValidIndex(Row) ? *Chunk.Names[Row] : TEXT(""));
+                    }
+                    Text += Line + TEXT("\n");
+                }
+            }
+
+            const FString Path = FString::Printf(TEXT("%s_%s%s.csv"), *BasePath, FSessionRecorder::GetChannelName(Channel),
+                Table.Value != 0 ? *FString::Printf(TEXT("%d"), Table.Value) : TEXT(""));
+            if (!FFileHelper::SaveStringToFile(Text, *Path))
+            {
+                return false;
+            }
+            OutBytes += IFileManager::Get().FileSize(*Path);
+        }
+        return true;
+    }
+
+    /** 读回导出的 CSV，统计与记录不一致的数值个数（事件表含名称，跳过）*/
+    int64 CountRoundTripMismatches(const FSessionFile& File, const TArray<FSessionExportTable>& Tables)
+    {
+        int64 Mismatches = 0;
+        for (const FSessionExportTable& Table : Tables)
+        {
+            if (Table.Channel == ESessionChannel::Event)
+            {
+                continue;
+            }
+
+            FImportedTable Imported;
+            FString Error;
+            if (!FSessionImporter::LoadText(Table.Path, Imported, Error) || Imported.NumRows() != Table.Rows)
+            {
+                Mismatches += Table.Rows;
+                continue;
+            }
+
+            int32 Row = 0;
+            for (const FSessionChunk& Chunk : File.Chunks)
+            {
+                if (Chunk.Channel != Table.Channel || Chunk.Device != Table.Device)
+                {
+                    continue;
+                }
+                const bool bDeviceTime = FSessionRecorder::HasDeviceTime(Chunk.Channel);
+                const int32 FirstValue = bDeviceTime ? 2 : 1;
+                for (int32 ChunkRow = 0; ChunkRow < Chunk.NumRows(); ChunkRow++, Row++)
+                {
+                    Mismatches += Imported.Columns[0][Row] != Chunk.Time[ChunkRow];
+                    if (bDeviceTime)
+                    {
+                        Mismatches += Imported.Columns[1][Row] != Chunk.DeviceTime[ChunkRow];
+                    }
+                    for (int32 Index = 0; Index < FSessionRecorder::GetValueCount(Chunk.Channel); Index++)
+                    {
+                        Mismatches += static_cast<float>(Imported.Columns[FirstValue + Index][Row]) != Chunk.Values[Index][ChunkRow];
+                    }
+                }
+            }
+        }
+        return Mismatches;
+    }
+
+    double MegabytesPerSecond(int64 Bytes, double Seconds)
+    {
+        return Seconds > 0.0 ? Bytes / Seconds / 1.0e6 : 0.0;
+    }
+
+    int64 TotalBytes(const TArray<FSessionExportTable>& Tables)
+    {
+        int64 Bytes = 0;
+        for (const FSessionExportTable& Table : Tables)
+        {
+            Bytes += Table.Bytes;
+        }
+        return Bytes;
+    }
+}
+
+USessionExportCommandlet::USessionExportCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 USessionExportCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Files;
+    TArray<FString> Switches;
+    ParseCommandLine(*Params, Files, Switches);
+
+    FSessionExportSettings Settings;
+    FString OutputDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Sessions"), TEXT("Exported"));
+    FString FormatName = TEXT("csv");
+    double SyntheticHours = 0.0;
+    int32 SyntheticRate = 100;
+    Settings.NumThreads = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+    FParse::Value(*Params, TEXT("Format="), FormatName);
+    FParse::Value(*Params, TEXT("Threads="), Settings.NumThreads);
+    FParse::Value(*Params, TEXT("RangeRows="), Settings.RangeRows);
+    FParse::Value(*Params, TEXT("SyntheticHours="), SyntheticHours);
+    FParse::Value(*Params, TEXT("SyntheticRate="), SyntheticRate);
+    const bool bBenchmark = FParse::Param(*Params, TEXT("Benchmark"));
+    int32 Repeat = bBenchmark ? 3 : 1;
+    FParse::Value(*Params, TEXT("Repeat="), Repeat);
+    Repeat = FMath::Max(Repeat, 1);
+    Settings.NumThreads = FMath::Max(Settings.NumThreads, 1);
+
+    TArray<ESessionExportFormat> Formats;
+    FormatName = FormatName.ToLower();
+    if (FormatName == TEXT("csv") || FormatName == TEXT("all"))
+    {
+        Formats.Add(ESessionExportFormat::Csv);
+    }
+    if (FormatName == TEXT("json") || FormatName == TEXT("all"))
+    {
+        Formats.Add(ESessionExportFormat::Json);
+    }
+
+    if (SyntheticHours > 0.0)
+    {
+        FSessionFile Synthetic;
+        MakeSyntheticSession(SyntheticHours, FMath::Max(SyntheticRate, 1), Params, Synthetic);
+        const FString Path = FPaths::Combine(FPaths::ProjectSavedDir(), FString::Printf(TEXT("SessionExportSynthetic_%gh.wvsession"), SyntheticHours));
+        FString Error;
+        if (!FSessionRecorder::WriteFile(Path, Synthetic, ESessionCodec::Gorilla, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: %s"), *Path, *Error);
+            return 1;
+        }
+        UE_LOG(LogTemp, Display, TEXT("已生成 %s（%.1f 小时）"), *Path, SyntheticHours);
+        Files.Add(Path);
+    }
+
+    if (Files.Num() == 0 || Formats.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("用法: -run=SessionExport [<会话.wvsession> ...] [-Output=<目录>] [-Format=csv|json|all] [-Threads=<线程数>] [-RangeRows=65536] [-Benchmark] [-Repeat=3] [-SyntheticHours=8] [-SyntheticRate=100]"));
+        return 1;
+    }
+
+    IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+    int32 Failures = 0;
+    for (const FString& File : Files)
+    {
+        FSessionFile Session;
+        FString Error;
+        if (!FSessionRecorder::ReadFile(File, Session, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: %s"), *File, *Error);
+            Failures++;
+            continue;
+        }
+        int64 Rows = 0;
+        for (const FSessionChunk& Chunk : Session.Chunks)
+        {
+            Rows += Chunk.NumRows();
+        }
+        UE_LOG(LogTemp, Display, TEXT("%s：%d 个列块，%lld 行%s"), *FPaths::GetCleanFilename(File), Session.Chunks.Num(), Rows,
+            Session.bTruncated ? TEXT("（文件末尾不完整）") : TEXT(""));
+
+        const FString BasePath = FPaths::Combine(OutputDirectory, FPaths::GetBaseFilename(File));
+        for (const ESessionExportFormat Format : Formats)
+        {
+            Settings.Format = Format;
+            TArray<FSessionExportTable> Tables;
+            bool bExported = true;
+            const double Seconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+            {
+                bExported &= FSessionExporter::Export(Session, BasePath, Settings, Tables, Error);
+            });
+            if (!bExported)
+            {
+                UE_LOG(LogTemp, Error, TEXT("  %s"), *Error);
+                Failures++;
+                continue;
+            }
+
+            const int64 Bytes = TotalBytes(Tables);
+            UE_LOG(LogTemp, Display, TEXT("  %s：%d 个文件，%.1f MB，%.3f s（%d 线程），%.1f MB/s，%.2f 百万行/s"),
+                FSessionExporter::GetExtension(Format), Tables.Num(), Bytes / 1.0e6, Seconds, Settings.NumThreads,
+                MegabytesPerSecond(Bytes, Seconds), Seconds > 0.0 ? Rows / Seconds / 1.0e6 : 0.0);
+            for (const FSessionExportTable& Table : Tables)
+            {
+                UE_LOG(LogTemp, Display, TEXT("    %s：%lld 行，%.1f MB"), *FPaths::GetCleanFilename(Table.Path), Table.Rows, Table.Bytes / 1.0e6);
+            }
+
+            if (!bBenchmark || Format != ESessionExportFormat::Csv)
+            {
+                continue;
+            }
+
+            FSessionExportSettings SingleThreaded = Settings;
+            SingleThreaded.NumThreads = 1;
+            const double SingleSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+            {
+                FSessionExporter::Export(Session, BasePath, SingleThreaded, Tables, Error);
+            });
+
+            int64 BaselineBytes = 0;
+            bool bBaseline = true;
+            const double BaselineSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+            {
+                bBaseline &= ExportBaseline(Session, BasePath + TEXT("_baseline"), BaselineBytes);
+            });
+
+            const int64 Mismatches = CountRoundTripMismatches(Session, Tables);
+            UE_LOG(LogTemp, Display, TEXT("    单线程 %.3f s（并行加速 %.2f 倍）"), SingleSeconds, Seconds > 0.0 ? SingleSeconds / Seconds : 0.0);
+            UE_LOG(LogTemp, Display, TEXT("    对照（逐行 Printf，%%.6f）%.3f s，%.1f MB，%.1f MB/s，加速 %.1f 倍%s"),
+                BaselineSeconds, BaselineBytes / 1.0e6, MegabytesPerSecond(BaselineBytes, BaselineSeconds),
+                Seconds > 0.0 ? BaselineSeconds / Seconds : 0.0, bBaseline ? TEXT("") : TEXT("（写入失败）"));
+            UE_LOG(LogTemp, Display, TEXT("    读回：%s"), Mismatches == 0 ? TEXT("数值与记录逐位相同") : *FString::Printf(TEXT("%lld 个数值不一致！"), Mismatches));
+            if (Mismatches > 0)
+            {
+                Failures++;
+            }
+        }
+    }
+    return Failures > 0 ? 1 : 0;
+}
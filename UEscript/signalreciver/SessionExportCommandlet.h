@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SessionExportCommandlet.generated.h"
+
+/**
+ * 把会话记录（.wvsession）导出为 CSV / JSON（FSessionExporter），每个 (通道, 设备) 一个文件，写到 -Output 目录
+ * （默认 Saved/Sessions/Exported）下的 <会话名>_<通道>[<设备>].csv / .json，报告每种格式的耗时和吞吐量
+ * -Benchmark：同时用逐行 Printf 拼接字符串再一次保存的方式（与 datacollection/gsr_collector.py 的 save_to_csv 相同，
+ *   每个数值 %.6f）导出 CSV 作为对照，以及单线程导出，报告加速比；并把导出的 CSV 读回（FSessionImporter::ParseText），
+ *   检查数值与记录逐位相同；各项耗时取 -Repeat 次（-Benchmark 时默认 3 次，否则 1 次）中最快的一次
+ * -SyntheticHours=<小时>：先生成一个同样时长的会话（GSR 按 -SyntheticRate 采样，一个手柄 60 Hz，每 30 秒一对刺激 / 反应事件）再导出
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=SessionExport [<会话.wvsession> ...] [-Output=<目录>] [-Format=csv|json|all]
+ *       [-Threads=<线程数>] [-RangeRows=65536] [-Benchmark] [-Repeat=3] [-SyntheticHours=8] [-SyntheticRate=100]
+ */
+UCLASS()
+class WORKVOILENCEGAME_API USessionExportCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USessionExportCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
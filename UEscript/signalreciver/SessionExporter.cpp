@@ -0,0 +1,421 @@
+#include "SessionExporter.h"
+#include "ParallelWorkers.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+
+#include <charconv>
+
+namespace
+{
+    /** 工作线程领先写盘太多时的等待间隔（秒）*/
+    constexpr float PollInterval = 0.0002f;
+
+    /** 一个 (通道, 设备) 的所有列块，按写出顺序 */
+    struct FExportLayout
+    {
+        ESessionChannel Channel = ESessionChannel::Controller;
+        uint8 Device = 0;
+        TArray<const FSessionChunk*> Chunks;
+    };
+
+    /** 区间中来自同一列块的连续行 */
+    struct FRowSlice
+    {
+        const FSessionChunk* Chunk = nullptr;
+        int32 First = 0;
+        int32 Count = 0;
+    };
+
+    void CollectLayouts(const FSessionFile& File, TArray<FExportLayout>& OutLayouts)
+    {
+        for (const FSessionChunk& Chunk : File.Chunks)
+        {
+            FExportLayout* Layout = OutLayouts.FindByPredicate([&Chunk](const FExportLayout& Existing)
+            {
+                return Existing.Channel == Chunk.Channel && Existing.Device == Chunk.Device;
+            });
+            if (!Layout)
+            {
+                Layout = &OutLayouts.AddDefaulted_GetRef();
+                Layout->Channel = Chunk.Channel;
+                Layout->Device = Chunk.Device;
+            }
+            Layout->Chunks.Add(&Chunk);
+        }
+        OutLayouts.Sort([](const FExportLayout& A, const FExportLayout& B)
+        {
+            return A.Channel != B.Channel ? A.Channel < B.Channel : A.Device < B.Device;
+        });
+    }
+
+    /** 按行数切分，一个区间可以跨多个列块 */
+    void SplitRanges(const FExportLayout& Layout, int32 RangeRows, TArray<TArray<FRowSlice>>& OutRanges)
+    {
+        int32 Filled = RangeRows;
+        for (const FSessionChunk* Chunk : Layout.Chunks)
+        {
+            for (int32 First = 0; First < Chunk->NumRows();)
+            {
+                if (Filled >= RangeRows)
+                {
+                    OutRanges.AddDefaulted();
+                    Filled = 0;
+                }
+                FRowSlice& Slice = OutRanges.Last().AddDefaulted_GetRef();
+                Slice.Chunk = Chunk;
+                Slice.First = First;
+                Slice.Count = FMath::Min(Chunk->NumRows() - First, RangeRows - Filled);
+                First += Slice.Count;
+                Filled += Slice.Count;
+            }
+        }
+    }
+
+    void AppendAnsi(TArray<ANSICHAR>& Out, const ANSICHAR* Text)
+    {
+        Out.Append(Text, FCStringAnsi::Strlen(Text));
+    }
+
+    /** 带引号的列名或事件名：JSON 转义引号、反斜杠和控制字符，CSV 只在含分隔符、引号或换行时加引号（引号写两次）*/
+    void AppendString(TArray<ANSICHAR>& Out, const FString& Text, ESessionExportFormat Format)
+    {
+        const FTCHARToUTF8 Utf8(*Text);
+        const ANSICHAR* const Begin = Utf8.Get();
+        const ANSICHAR* const End = Begin + Utf8.Length();
+
+        if (Format == ESessionExportFormat::Json)
+        {
+            Out.Add('"');
+            for (const ANSICHAR* Cursor = Begin; Cursor < End; Cursor++)
+            {
+                if (*Cursor == '"' || *Cursor == '\\')
+                {
+                    Out.Add('\\');
+                    Out.Add(*Cursor);
+                }
+                else if (static_cast<uint8>(*Cursor) < 0x20)
+                {
+                    ANSICHAR Escaped[8];
+                    Out.Append(Escaped, FCStringAnsi::Snprintf(Escaped, sizeof(Escaped), "\\u%04x", static_cast<uint8>(*Cursor)));
+                }
+                else
+                {
+                    Out.Add(*Cursor);
+                }
+            }
+            Out.Add('"');
+            return;
+        }
+
+        bool bQuote = false;
+        for (const ANSICHAR* Cursor = Begin; Cursor < End; Cursor++)
+        {
+            bQuote |= *Cursor == ',' || *Cursor == '"' || *Cursor == '\n' || *Cursor == '\r';
+        }
+        if (!bQuote)
+        {
+            Out.Append(Begin, static_cast<int32>(End - Begin));
+            return;
+        }
+        Out.Add('"');
+        for (const ANSICHAR* Cursor = Begin; Cursor < End; Cursor++)
+        {
+            if (*Cursor == '"')
+            {
+                Out.Add('"');
+            }
+            Out.Add(*Cursor);
+        }
+        Out.Add('"');
+    }
+
+    /** JSON 没有 NaN / Inf，写成 null */
+    ANSICHAR* WriteDouble(ANSICHAR* Cursor, double Value, bool bJson)
+    {
+        if (bJson && !FMath::IsFinite(Value))
+        {
+            FMemory::Memcpy(Cursor, "null", 4);
+            return Cursor + 4;
+        }
+        return Cursor + FSessionExporter::FormatDouble(Value, Cursor);
+    }
+
+    ANSICHAR* WriteFloat(ANSICHAR* Cursor, float Value, bool bJson)
+    {
+        if (bJson && !FMath::IsFinite(Value))
+        {
+            FMemory::Memcpy(Cursor, "null", 4);
+            return Cursor + 4;
+        }
+        return Cursor + FSessionExporter::FormatFloat(Value, Cursor);
+    }
+
+    void AppendHeader(TArray<ANSICHAR>& Out, const FExportLayout& Layout, ESessionExportFormat Format)
+    {
+        TArray<FString> Columns = { TEXT("Time") };
+        if (FSessionRecorder::HasDeviceTime(Layout.Channel))
+        {
+            Columns.Add(TEXT("DeviceTime"));
+        }
+        for (int32 Index = 0; Index < FSessionRecorder::GetValueCount(Layout.Channel); Index++)
+        {
+            Columns.Add(FSessionRecorder::GetValueName(Layout.Channel, Index));
+        }
+        if (FSessionRecorder::HasButtons(Layout.Channel))
+        {
+            Columns.Add(TEXT("Buttons"));
+        }
+        if (Layout.Channel == ESessionChannel::Event)
+        {
+            Columns.Add(TEXT("Name"));
+        }
+
+        if (Format == ESessionExportFormat::Json)
+        {
+            AppendAnsi(Out, "{\"channel\":");
+            AppendString(Out, FSessionRecorder::GetChannelName(Layout.Channel), Format);
+            ANSICHAR Device[32];
+            Out.Append(Device, FCStringAnsi::Snprintf(Device, sizeof(Device), ",\"device\":%d,\"columns\":[", Layout.Device));
+        }
+        for (int32 Index = 0; Index < Columns.Num(); Index++)
+        {
+            if (Index > 0)
+            {
+                Out.Add(',');
+            }
+            AppendString(Out, Columns[Index], Format);
+        }
+        AppendAnsi(Out, Format == ESessionExportFormat::Json ? "],\"rows\":[" : "\n");
+    }
+
+    /** 格式化一个区间；JSON 的行之间用逗号分隔，整个表的第一行前面没有逗号 */
+    void FormatRange(const FExportLayout& Layout, const TArray<FRowSlice>& Range, bool bFirstRange, ESessionExportFormat Format, TArray<ANSICHAR>& Out)
+    {
+        Out.Reset();
+        const bool bJson = Format == ESessionExportFormat::Json;
+        const bool bDeviceTime = FSessionRecorder::HasDeviceTime(Layout.Channel);
+        const bool bButtons = FSessionRecorder::HasButtons(Layout.Channel);
+        const bool bNames = Layout.Channel == ESessionChannel::Event;
+        const int32 ValueCount = FSessionRecorder::GetValueCount(Layout.Channel);
+
+        // 数值部分先写到行缓冲，每行只追加一次
+        ANSICHAR Line[(FSessionRecord::MaxValues + 3) * (FSessionExporter::MaxNumberLength + 1) + 8];
+        bool bFirstRow = bFirstRange;
+        for (const FRowSlice& Slice : Range)
+        {
+            const FSessionChunk& Chunk = *Slice.Chunk;
+            for (int32 Row = Slice.First; Row < Slice.First + Slice.Count; Row++)
+            {
+                ANSICHAR* Cursor = Line;
+                if (bJson)
+                {
+                    if (!bFirstRow)
+                    {
+                        *Cursor++ = ',';
+                    }
+                    *Cursor++ = '\n';
+                    *Cursor++ = '[';
+                }
+                bFirstRow = false;
+
+                Cursor = WriteDouble(Cursor, Chunk.Time[Row], bJson);
+                if (bDeviceTime)
+                {
+                    *Cursor++ = ',';
+                    Cursor = WriteDouble(Cursor, Chunk.DeviceTime[Row], bJson);
+                }
+                for (int32 Index = 0; Index < ValueCount; Index++)
+                {
+                    *Cursor++ = ',';
+                    Cursor = WriteFloat(Cursor, Chunk.Values[Index][Row], bJson);
+                }
+                if (bButtons)
+                {
+                    *Cursor++ = ',';
+                    Cursor = std::to_chars(Cursor, Cursor + FSessionExporter::MaxNumberLength, static_cast<uint32>(Chunk.Buttons[Row])).ptr;
+                }
+                if (bNames)
+                {
+                    *Cursor++ = ',';
+                    Out.Append(Line, static_cast<int32>(Cursor - Line));
+                    AppendString(Out, Chunk.Names.IsValidIndex(Row) ? Chunk.Names[Row] : FString(), Format);
+                    Cursor = Line;
+                }
+                *Cursor++ = bJson ? ']' : '\n';
+                Out.Append(Line, static_cast<int32>(Cursor - Line));
+            }
+        }
+    }
+
+    /**
+     * 一个表的格式化和写盘：工作线程从计数器领取区间，格式化到环形的槽位（Window 个），
+     * 当前线程按区间顺序等待槽位就绪后写盘，等待时自己也领取区间格式化（单线程时全部由当前线程完成）
+     */
+    class FRangePipeline
+    {
+    public:
+        FRangePipeline(const FExportLayout& InLayout, const TArray<TArray<FRowSlice>>& InRanges, ESessionExportFormat InFormat, int32 InWindow)
+            : Layout(InLayout)
+            , Ranges(InRanges)
+            , Format(InFormat)
+            , Window(FMath::Max(InWindow, 1))
+        {
+            for (int32 Index = 0; Index < Window; Index++)
+            {
+                Slots.Add(MakeUnique<FSlot>());
+            }
+        }
+
+        void Run(FArchive& Writer, int32 NumThreads)
+        {
+            FParallelWorkers::Run(FMath::Clamp(NumThreads, 1, FMath::Max(Ranges.Num(), 1)), TEXT("SessionExport"), [this, &Writer](int32 Worker)
+            {
+                if (Worker == 0)
+                {
+                    WriteAll(Writer);
+                }
+                else
+                {
+                    FormatAll();
+                }
+            });
+        }
+
+    private:
+        struct FSlot
+        {
+            TArray<ANSICHAR> Text;
+
+            /** 已格式化的区间序号 + 1 */
+            TAtomic<int32> Ready { 0 };
+        };
+
+        /** 当前线程：按区间顺序等待槽位就绪后写盘，等待时自己也领取区间格式化 */
+        void WriteAll(FArchive& Writer)
+        {
+            for (int32 Range = 0; Range < Ranges.Num(); Range++)
+            {
+                FSlot& Slot = *Slots[Range % Window];
+                while (Slot.Ready != Range + 1)
+                {
+                    if (!FormatNext())
+                    {
+                        FPlatformProcess::Sleep(PollInterval);
+                    }
+                }
+                Writer.Serialize(Slot.Text.GetData(), Slot.Text.Num());
+                Written = Range + 1;
+            }
+        }
+
+        /** 工作线程：领取区间格式化，直到全部领完 */
+        void FormatAll()
+        {
+            while (NextRange < Ranges.Num())
+            {
+                if (!FormatNext())
+                {
+                    FPlatformProcess::Sleep(PollInterval);
+                }
+            }
+        }
+
+        /** 领取并格式化下一个区间；全部领完，或者它的槽位还没有写盘时返回 false */
+        bool FormatNext()
+        {
+            int32 Range = NextRange;
+            if (Range >= Ranges.Num() || Range >= Written + Window || !NextRange.CompareExchange(Range, Range + 1))
+            {
+                return false;
+            }
+            FSlot& Slot = *Slots[Range % Window];
+            FormatRange(Layout, Ranges[Range], Range == 0, Format, Slot.Text);
+            Slot.Ready = Range + 1;
+            return true;
+        }
+
+        const FExportLayout& Layout;
+        const TArray<TArray<FRowSlice>>& Ranges;
+        const ESessionExportFormat Format;
+        const int32 Window;
+        TArray<TUniquePtr<FSlot>> Slots;
+        TAtomic<int32> NextRange { 0 };
+        TAtomic<int32> Written { 0 };
+    };
+}
+
+bool FSessionExporter::Export(const FSessionFile& File, const FString& BasePath, const FSessionExportSettings& Settings,
+    TArray<FSessionExportTable>& OutTables, FString& OutError)
+{
+    OutTables.Reset();
+    const int32 NumThreads = Settings.NumThreads > 0 ? Settings.NumThreads : FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    const int32 Window = NumThreads * FMath::Max(Settings.RangesPerThread, 1);
+
+    TArray<FExportLayout> Layouts;
+    CollectLayouts(File, Layouts);
+    for (const FExportLayout& Layout : Layouts)
+    {
+        FSessionExportTable& Table = OutTables.AddDefaulted_GetRef();
+        Table.Channel = Layout.Channel;
+        Table.Device = Layout.Device;
+        Table.Path = FString::Printf(TEXT("%s_%s%s.%s"), *BasePath, FSessionRecorder::GetChannelName(Layout.Channel),
+            Layout.Device != 0 ? *FString::Printf(TEXT("%d"), Layout.Device) : TEXT(""), GetExtension(Settings.Format));
+        for (const FSessionChunk* Chunk : Layout.Chunks)
+        {
+            Table.Rows += Chunk->NumRows();
+        }
+
+        TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Table.Path));
+        if (!Writer)
+        {
+            OutError = FString::Printf(TEXT("无法写入 %s"), *Table.Path);
+            return false;
+        }
+
+        TArray<ANSICHAR> Text;
+        AppendHeader(Text, Layout, Settings.Format);
+        Writer->Serialize(Text.GetData(), Text.Num());
+
+        TArray<TArray<FRowSlice>> Ranges;
+        SplitRanges(Layout, FMath::Max(Settings.RangeRows, 1), Ranges);
+        FRangePipeline(Layout, Ranges, Settings.Format, Window).Run(*Writer, NumThreads);
+
+        if (Settings.Format == ESessionExportFormat::Json)
+        {
+            Text.Reset();
+            AppendAnsi(Text, "\n]}\n");
+            Writer->Serialize(Text.GetData(), Text.Num());
+        }
+        Table.Bytes = Writer->Tell();
+        if (!Writer->Close())
+        {
+            OutError = FString::Printf(TEXT("写入 %s 失败"), *Table.Path);
+            return false;
+        }
+    }
+    return true;
+}
+
+int32 FSessionExporter::FormatDouble(double Value, ANSICHAR* Out)
+{
+#if defined(__cpp_lib_to_chars)
+    return static_cast<int32>(std::to_chars(Out, Out + MaxNumberLength, Value).ptr - Out);
+#else
+    return FCStringAnsi::Snprintf(Out, MaxNumberLength, "%.17g", Value);
+#endif
+}
+
+int32 FSessionExporter::FormatFloat(float Value, ANSICHAR* Out)
+{
+#if defined(__cpp_lib_to_chars)
+    return static_cast<int32>(std::to_chars(Out, Out + MaxNumberLength, Value).ptr - Out);
+#else
+    return FCStringAnsi::Snprintf(Out, MaxNumberLength, "%.9g", static_cast<double>(Value));
+#endif
+}
+
+const TCHAR* FSessionExporter::GetExtension(ESessionExportFormat Format)
+{
+    return Format == ESessionExportFormat::Json ? TEXT("json") : TEXT("csv");
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SessionRecorder.h"
+
+enum class ESessionExportFormat : uint8
+{
+    /** 逗号分隔，第一行为列名 */
+    Csv,
+
+    /** {"channel", "device", "columns", "rows": [[...], ...]}，每行一个数组 */
+    Json
+};
+
+struct FSessionExportSettings
+{
+    ESessionExportFormat Format = ESessionExportFormat::Csv;
+
+    /** 每个行区间的行数，区间是格式化和写盘的单位 */
+    int32 RangeRows = 65536;
+
+    /** 格式化线程数（含写盘的当前线程），0 为逻辑核数 */
+    int32 NumThreads = 0;
+
+    /** 每个线程最多领先写盘多少个区间，限制同时在内存中的文本量 */
+    int32 RangesPerThread = 2;
+};
+
+/** 一个导出的文件 */
+struct FSessionExportTable
+{
+    ESessionChannel Channel = ESessionChannel::Controller;
+    uint8 Device = 0;
+
+    FString Path;
+    int64 Rows = 0;
+    int64 Bytes = 0;
+};
+
+/**
+ * 把会话记录导出为 CSV / JSON：每个 (通道, 设备) 一个文件 <BasePath>_<通道>[<设备>].csv / .json，
+ * 列为 Time、DeviceTime（有设备时间的通道）、各数值列（FSessionRecorder::GetValueName）、Buttons（Controller）、Name（Event）
+ * 每个表按 RangeRows 切成行区间，由工作线程领取并格式化到各自的缓冲，当前线程按顺序把整个区间一次写盘，
+ * 工作线程最多领先 NumThreads × RangesPerThread 个区间
+ * 数值按最短往返格式输出（std::to_chars，读回后与记录中的 double / float 逐位相同）；
+ * 标准库不支持浮点 to_chars 时退回 %.17g / %.9g，同样可以往返，只是更长
+ */
+class WORKVOILENCEGAME_API FSessionExporter
+{
+public:
+    /** 一个数值最多占用的字符数 */
+    static constexpr int32 MaxNumberLength = 32;
+
+    static bool Export(const FSessionFile& File, const FString& BasePath, const FSessionExportSettings& Settings,
+        TArray<FSessionExportTable>& OutTables, FString& OutError);
+
+    /** 最短往返格式，Out 至少 MaxNumberLength 个字符，返回写入的字符数（不含结尾的 0）*/
+    static int32 FormatDouble(double Value, ANSICHAR* Out);
+
+    static int32 FormatFloat(float Value, ANSICHAR* Out);
+
+    static const TCHAR* GetExtension(ESessionExportFormat Format);
+};
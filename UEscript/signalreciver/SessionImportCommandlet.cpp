@@ -0,0 +1,223 @@
+#include "SessionImportCommandlet.h"
+#include "BenchmarkTiming.h"
+#include "SessionImporter.h"
+#include "SessionRecorder.h"
+#include "GsrSignalSynthesizer.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    /** 对照：整个文件读成 FString，逐行拆分后用 Atod 解析（与 SessionCodecBenchmark 读取文本的方式相同）*/
+    bool LoadTextBaseline(const FString& Path, TArray<TArray<double>>& OutColumns)
+    {
+        FString Text;
+        if (!FFileHelper::LoadFileToString(Text, *Path))
+        {
+            return false;
+        }
+
+        OutColumns.Reset();
+        TArray<FString> Lines;
+        Text.ParseIntoArray(Lines, TEXT("\n"));
+        TArray<FString> Fields;
+        for (const FString& Line : Lines)
+        {
+            Line.TrimStartAndEnd().ParseIntoArray(Fields, TEXT("\t"));
+            if (Fields.Num() == 0 || !Fields[0].IsNumeric())
+            {
+                continue;
+            }
+            if (OutColumns.Num() == 0)
+            {
+                OutColumns.SetNum(Fields.Num());
+            }
+            for (int32 Index = 0; Index < OutColumns.Num(); Index++)
+            {
+                OutColumns[Index].Add(Fields.IsValidIndex(Index) ? FCString::Atod(*Fields[Index]) : 0.0);
+            }
+        }
+        return OutColumns.Num() > 0;
+    }
+
+    /**
+     * 生成与 Experiment/figure/test_keyboard.txt 格式相同的长记录：残缺表头 "Onset(s)Du"，
+     * 之后每行 时间\t电导\t标记（CRLF），每 30 秒一个持续一个采样的标记（1~4 循环）
+     */
+    bool WriteSyntheticText(const FString& Path, double Hours, int32 RateHz, const FString& Params, int64& OutRows)
+    {
+        TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+        if (!Writer)
+        {
+            return false;
+        }
+
+        FGsrSignalSynthesizer Synthesizer;
+        Synthesizer.ParseCommandLine(*Params);
+        Synthesizer.SampleRateHz = static_cast<float>(RateHz);
+        Synthesizer.DropoutsPerMinute = 0.0f;
+        Synthesizer.Reset();
+
+        const int64 Rows = static_cast<int64>(Hours * 3600.0 * RateHz);
+        const int64 MarkerInterval = static_cast<int64>(30) * RateHz;
+        TArray<ANSICHAR> Buffer;
+        Buffer.Reserve(1 << 20);
+        const ANSICHAR Header[] = "Onset(s)Du\t\n";
+        Buffer.Append(Header, UE_ARRAY_COUNT(Header) - 1);
+
+        FGsrBinarySample Sample;
+        ANSICHAR Line[64];
+        for (int64 Row = 0; Row < Rows; Row++)
+        {
+            Synthesizer.Next(Sample);
+            const int32 Marker = Row > 0 && Row % MarkerInterval == 0 ? static_cast<int32>((Row / MarkerInterval - 1) % 4 + 1) : 0;
+            const int32 Length = FCStringAnsi::Snprintf(Line, sizeof(Line), "%.10g\t%.4f\t%d\r\n",
+                static_cast<double>(Row) / RateHz, Sample.Conductance, Marker);
+            Buffer.Append(Line, Length);
+            if (Buffer.Num() >= (1 << 20) - 64)
+            {
+                Writer->Serialize(Buffer.GetData(), Buffer.Num());
+                Buffer.Reset();
+            }
+        }
+        Writer->Serialize(Buffer.GetData(), Buffer.Num());
+        OutRows = Rows;
+        return Writer->Close();
+    }
+
+    double MegabytesPerSecond(int64 Bytes, double Seconds)
+    {
+        return Seconds > 0.0 ? Bytes / Seconds / 1.0e6 : 0.0;
+    }
+}
+
+USessionImportCommandlet::USessionImportCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 USessionImportCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Files;
+    TArray<FString> Switches;
+    ParseCommandLine(*Params, Files, Switches);
+
+    int32 Repeat = 5;
+    double SyntheticHours = 0.0;
+    int32 SyntheticRate = 100;
+    FString OutputDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Sessions"), TEXT("Imported"));
+    FParse::Value(*Params, TEXT("Repeat="), Repeat);
+    FParse::Value(*Params, TEXT("SyntheticHours="), SyntheticHours);
+    FParse::Value(*Params, TEXT("SyntheticRate="), SyntheticRate);
+    FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+    Repeat = FMath::Max(Repeat, 1);
+
+    if (SyntheticHours > 0.0)
+    {
+        const FString Path = FPaths::Combine(FPaths::ProjectSavedDir(), FString::Printf(TEXT("SessionImportSynthetic_%gh.txt"), SyntheticHours));
+        int64 Rows = 0;
+        if (!WriteSyntheticText(Path, SyntheticHours, FMath::Max(SyntheticRate, 1), Params, Rows))
+        {
+            UE_LOG(LogTemp, Error, TEXT("无法写入 %s"), *Path);
+            return 1;
+        }
+        UE_LOG(LogTemp, Display, TEXT("已生成 %s（%.1f 小时，%lld 行）"), *Path, SyntheticHours, Rows);
+        Files.Add(Path);
+    }
+
+    if (Files.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("用法: -run=SessionImport [<文件.txt | 文件.mat> ...] [-Output=<目录>] [-Repeat=5] [-SyntheticHours=4] [-SyntheticRate=100]"));
+        return 1;
+    }
+
+    IFileManager::Get().MakeDirectory(*OutputDirectory, true);
+    int32 Failures = 0;
+    for (const FString& File : Files)
+    {
+        FImportedTable Table;
+        FString Error;
+        bool bLoaded = true;
+        const double ImportSeconds = FBenchmarkTiming::TimeBest(Repeat, [&]()
+        {
+            bLoaded &= FSessionImporter::Load(File, Table, Error);
+        });
+        if (!bLoaded)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: %s"), *File, *Error);
+            Failures++;
+            continue;
+        }
+
+        const int32 Rows = Table.NumRows();
+        UE_LOG(LogTemp, Display, TEXT("%s: %lld 字节，%d 行 x %d 列，%d 个事件，跳过 %d 行，字段数不一致 %d 行"),
+            *FPaths::GetCleanFilename(File), Table.SourceBytes, Rows, Table.Columns.Num(), Table.Events.Num(),
+            Table.SkippedLines, Table.IrregularLines);
+        UE_LOG(LogTemp, Display, TEXT("  导入 %.2f ms，%.1f MB/s，%.2f 百万行/s"),
+            ImportSeconds * 1000.0, MegabytesPerSecond(Table.SourceBytes, ImportSeconds), ImportSeconds > 0.0 ? Rows / ImportSeconds / 1.0e6 : 0.0);
+
+        if (FPaths::GetExtension(File).ToLower() != TEXT("mat"))
+        {
+            TArray<TArray<double>> Baseline;
+            const double BaselineSeconds = FBenchmarkTiming::TimeBest(FMath::Min(Repeat, 3), [&]()
+            {
+                LoadTextBaseline(File, Baseline);
+            });
+
+            bool bIdentical = Baseline.Num() == Table.Columns.Num();
+            for (int32 Column = 0; bIdentical && Column < Baseline.Num(); Column++)
+            {
+                bIdentical = Baseline[Column].Num() == Table.Columns[Column].Num()
+                    && FMemory::Memcmp(Baseline[Column].GetData(), Table.Columns[Column].GetData(), Baseline[Column].Num() * sizeof(double)) == 0;
+            }
+            UE_LOG(LogTemp, Display, TEXT("  对照（FString + Atod）%.2f ms，%.1f MB/s，加速 %.1f 倍，%s"),
+                BaselineSeconds * 1000.0, MegabytesPerSecond(Table.SourceBytes, BaselineSeconds),
+                ImportSeconds > 0.0 ? BaselineSeconds / ImportSeconds : 0.0, bIdentical ? TEXT("数值逐位一致") : TEXT("数值不一致！"));
+            if (!bIdentical)
+            {
+                Failures++;
+            }
+        }
+
+        // 转换为会话记录并读回检查
+        FSessionFile Session;
+        const uint64 ConvertStart = FPlatformTime::Cycles64();
+        FSessionImporter::ToSessionFile(Table, Session);
+        Session.StartedAt = IFileManager::Get().GetTimeStamp(*File);
+        const FString OutputPath = FPaths::Combine(OutputDirectory, FPaths::GetBaseFilename(File) + TEXT(".wvsession"));
+        if (!FSessionRecorder::WriteFile(OutputPath, Session, ESessionCodec::Gorilla, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: %s"), *File, *Error);
+            Failures++;
+            continue;
+        }
+        const double ConvertSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - ConvertStart);
+
+        FSessionFile ReadBack;
+        int32 ReadRows = 0;
+        int32 ReadEvents = 0;
+        if (FSessionRecorder::ReadFile(OutputPath, ReadBack, Error))
+        {
+            for (const FSessionChunk& Chunk : ReadBack.Chunks)
+            {
+                (Chunk.Channel == ESessionChannel::Event ? ReadEvents : ReadRows) += Chunk.NumRows();
+            }
+        }
+        const bool bComplete = ReadRows == Rows && ReadEvents == Table.Events.Num() && !ReadBack.bTruncated;
+        UE_LOG(LogTemp, Display, TEXT("  会话记录 %s：%lld 字节（源文件的 %.1f%%），编码写出 %.2f ms，%s"),
+            *OutputPath, IFileManager::Get().FileSize(*OutputPath),
+            100.0 * IFileManager::Get().FileSize(*OutputPath) / FMath::Max<int64>(Table.SourceBytes, 1),
+            ConvertSeconds * 1000.0, bComplete ? TEXT("读回行数一致") : TEXT("读回行数不一致！"));
+        if (!bComplete)
+        {
+            Failures++;
+        }
+    }
+    return Failures > 0 ? 1 : 0;
+}
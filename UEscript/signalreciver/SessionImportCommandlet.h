@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SessionImportCommandlet.generated.h"
+
+/**
+ * 把 Experiment 下旧的 Ledalab 文本（figure 中的 .txt）和 .mat 转换为会话记录文件，并测量导入速度
+ * 每个文件按 FSessionImporter（内存映射 + SIMD 换行查找 + 直接解析数值）导入 -Repeat 次取最快的一次；
+ * 文本文件同时用逐行构造 FString、Atod 的方式导入作为对照，并检查两者逐位一致
+ * 转换结果写到 -Output 目录（默认 Saved/Sessions/Imported）下的 <文件名>.wvsession，写完后读回检查行数
+ * -SyntheticHours=<小时>：先用 FGsrSignalSynthesizer 生成一个同样格式（残缺表头、CRLF）的长记录再导入，
+ *   用于测量数小时记录的吞吐量
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=SessionImport [<文件.txt | 文件.mat> ...] [-Output=<目录>] [-Repeat=5]
+ *       [-SyntheticHours=4] [-SyntheticRate=100]
+ */
+UCLASS()
+class WORKVOILENCEGAME_API USessionImportCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USessionImportCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,523 @@
+#include "SessionImporter.h"
+#include "SessionRecorder.h"
+#include "MatFileReader.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#elif PLATFORM_CPU_ARM_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    /** 导入时每个列块的行数（与 FSessionRecorder::ChunkRows 的默认值相同）*/
+    constexpr int32 ImportChunkRows = 4096;
+
+    /** 可以精确表示的 10 的幂 */
+    const double ExactPowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+    /** 有效数字超过 2^53 时不再是精确的整数 */
+    constexpr uint64 MaxExactMantissa = uint64(1) << 53;
+
+    bool IsDigit(ANSICHAR Character)
+    {
+        return static_cast<uint8>(Character - '0') < 10;
+    }
+
+    bool IsDelimiter(ANSICHAR Character)
+    {
+        return Character == '\t' || Character == ' ' || Character == ',' || Character == ';' || Character == '\r';
+    }
+
+    /** 只读映射整个文件；平台不支持映射时读入内存 */
+    class FMappedFile
+    {
+    public:
+        bool Open(const FString& Path)
+        {
+            IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+            Handle.Reset(PlatformFile.OpenMapped(*Path));
+            if (Handle && Handle->GetFileSize() > 0)
+            {
+                Region.Reset(Handle->MapRegion(0, Handle->GetFileSize()));
+            }
+            if (Region)
+            {
+                Data = Region->GetMappedPtr();
+                Size = Region->GetMappedSize();
+                return true;
+            }
+
+            if (!FFileHelper::LoadFileToArray(Fallback, *Path))
+            {
+                return false;
+            }
+            Data = Fallback.GetData();
+            Size = Fallback.Num();
+            return true;
+        }
+
+        const uint8* GetData() const { return Data; }
+        int64 GetSize() const { return Size; }
+
+    private:
+        // 先释放映射区域，再关闭文件
+        TUniquePtr<IMappedFileHandle> Handle;
+        TUniquePtr<IMappedFileRegion> Region;
+        TArray<uint8> Fallback;
+        const uint8* Data = nullptr;
+        int64 Size = 0;
+    };
+
+    void AddEventRecord(FSessionFile& OutFile, const FLedalabEvent& Event)
+    {
+        FSessionChunk* Chunk = OutFile.Chunks.Num() > 0 ? &OutFile.Chunks.Last() : nullptr;
+        if (!Chunk || Chunk->Channel != ESessionChannel::Event || Chunk->NumRows() >= ImportChunkRows)
+        {
+            Chunk = &OutFile.Chunks.AddDefaulted_GetRef();
+            Chunk->Channel = ESessionChannel::Event;
+        }
+
+        // 导入的标记没有刺激 / 反应之分，按自定义标记（ETrialMarkerType::Custom）记录
+        FSessionRecord Record;
+        Record.Channel = ESessionChannel::Event;
+        Record.Time = Event.Time;
+        Record.Values[0] = 2.0f;
+        Record.Values[1] = static_cast<float>(Event.TrialIndex);
+        Chunk->AddRecord(Record);
+        Chunk->Names.Add(Event.Name);
+    }
+}
+
+const TArray<double>* FImportedTable::FindColumn(const FString& Name) const
+{
+    const int32 Index = ColumnNames.IndexOfByKey(Name);
+    return Index != INDEX_NONE ? &Columns[Index] : nullptr;
+}
+
+bool FSessionImporter::Load(const FString& Path, FImportedTable& OutTable, FString& OutError)
+{
+    const FString Extension = FPaths::GetExtension(Path).ToLower();
+    if (Extension == TEXT("mat"))
+    {
+        return LoadMat(Path, OutTable, OutError);
+    }
+    if (Extension == TEXT("wvsession"))
+    {
+        return LoadSession(Path, OutTable, OutError);
+    }
+    return LoadText(Path, OutTable, OutError);
+}
+
+bool FSessionImporter::LoadText(const FString& Path, FImportedTable& OutTable, FString& OutError)
+{
+    FMappedFile File;
+    if (!File.Open(Path))
+    {
+        OutError = FString::Printf(TEXT("无法读取 %s"), *Path);
+        return false;
+    }
+
+    ParseText(reinterpret_cast<const ANSICHAR*>(File.GetData()), File.GetSize(), OutTable);
+    OutTable.SourceBytes = File.GetSize();
+    if (OutTable.NumRows() == 0)
+    {
+        OutError = FString::Printf(TEXT("%s 没有数据行"), *Path);
+        return false;
+    }
+    return true;
+}
+
+bool FSessionImporter::LoadMat(const FString& Path, FImportedTable& OutTable, FString& OutError)
+{
+    FMappedFile File;
+    if (!File.Open(Path))
+    {
+        OutError = FString::Printf(TEXT("无法读取 %s"), *Path);
+        return false;
+    }
+
+    TArray<FMatVariable> Variables;
+    if (!FMatFileReader::Parse(File.GetData(), File.GetSize(), Variables, OutError))
+    {
+        return false;
+    }
+
+    const TArray<double>* Conductance = FMatFileReader::FindNumbers(Variables, TEXT("data.conductance"));
+    if (!Conductance || Conductance->Num() == 0)
+    {
+        OutError = FString::Printf(TEXT("%s 缺少 data.conductance"), *Path);
+        return false;
+    }
+
+    OutTable = FImportedTable();
+    OutTable.SourceBytes = File.GetSize();
+    OutTable.ColumnNames = { TEXT("time"), TEXT("conductance") };
+    OutTable.Columns.SetNum(2);
+
+    // 没有 data.time 时按采样率生成
+    const TArray<double>* Times = FMatFileReader::FindNumbers(Variables, TEXT("data.time"));
+    const TArray<double>* SamplingRate = FMatFileReader::FindNumbers(Variables, TEXT("data.samplingrate"));
+    const int32 Rows = Times ? FMath::Min(Times->Num(), Conductance->Num()) : Conductance->Num();
+    if (Times)
+    {
+        OutTable.Columns[0].Append(Times->GetData(), Rows);
+    }
+    else
+    {
+        const double Rate = SamplingRate && SamplingRate->Num() > 0 && (*SamplingRate)[0] > 0.0 ? (*SamplingRate)[0] : 1.0;
+        OutTable.Columns[0].SetNumUninitialized(Rows);
+        for (int32 Row = 0; Row < Rows; Row++)
+        {
+            OutTable.Columns[0][Row] = Row / Rate;
+        }
+    }
+    OutTable.Columns[1].Append(Conductance->GetData(), Rows);
+
+    // data.event：time / nid / name / userdata.trial
+    if (const FMatVariable* Events = FMatFileReader::Find(Variables, TEXT("data.event")))
+    {
+        const int32 Count = Events->Type == FMatVariable::EType::Struct ? Events->NumElements() : 0;
+        for (int32 Element = 0; Element < Count; Element++)
+        {
+            const FMatVariable* Time = Events->FindField(TEXT("time"), Element);
+            if (!Time || Time->Numbers.Num() == 0)
+            {
+                continue;
+            }
+
+            FLedalabEvent& Event = OutTable.Events.AddDefaulted_GetRef();
+            Event.Time = Time->Numbers[0];
+            Event.TrialIndex = Element;
+            if (const FMatVariable* Name = Events->FindField(TEXT("name"), Element))
+            {
+                Event.Name = Name->Text;
+            }
+            if (const FMatVariable* UserData = Events->FindField(TEXT("userdata"), Element))
+            {
+                const FMatVariable* Trial = UserData->FindField(TEXT("trial"));
+                if (Trial && Trial->Numbers.Num() > 0)
+                {
+                    Event.TrialIndex = static_cast<int32>(Trial->Numbers[0]);
+                }
+            }
+            if (Event.Name.IsEmpty())
+            {
+                const FMatVariable* Nid = Events->FindField(TEXT("nid"), Element);
+                Event.Name = Nid && Nid->Numbers.Num() > 0 ? FString::Printf(TEXT("%d"), static_cast<int32>(Nid->Numbers[0])) : FString(TEXT("event"));
+            }
+        }
+    }
+    return true;
+}
+
+void FSessionImporter::ParseText(const ANSICHAR* Data, int64 Size, FImportedTable& OutTable)
+{
+    OutTable = FImportedTable();
+    const ANSICHAR* Cursor = Data;
+    const ANSICHAR* const End = Data + Size;
+
+    // UTF-8 BOM
+    if (Size >= 3 && FMemory::Memcmp(Data, "\xEF\xBB\xBF", 3) == 0)
+    {
+        Cursor += 3;
+    }
+
+    TArray<double> Fields;
+    int32 NumColumns = 0;
+    while (Cursor < End)
+    {
+        const ANSICHAR* const LineStart = Cursor;
+        const ANSICHAR* const LineEnd = FindLineEnd(Cursor, End);
+        Cursor = LineEnd < End ? LineEnd + 1 : End;
+
+        Fields.Reset();
+        bool bNumeric = true;
+        const ANSICHAR* Field = LineStart;
+        while (true)
+        {
+            while (Field < LineEnd && IsDelimiter(*Field))
+            {
+                Field++;
+            }
+            if (Field >= LineEnd)
+            {
+                break;
+            }
+
+            // 数字后面必须是分隔符或行尾，"Onset(s)Du" 这样的表头和 "12:30" 这样的字段都不是数值行
+            double Value;
+            if (!ParseNumber(Field, LineEnd, Value) || (Field < LineEnd && !IsDelimiter(*Field)))
+            {
+                bNumeric = false;
+                break;
+            }
+            Fields.Add(Value);
+        }
+
+        if (!bNumeric)
+        {
+            OutTable.SkippedLines++;
+            continue;
+        }
+        if (Fields.Num() == 0)
+        {
+            continue;
+        }
+
+        if (NumColumns == 0)
+        {
+            // 按 Ledalab 文本格式 2 命名：时间、电导、标记
+            NumColumns = Fields.Num();
+            const TCHAR* const KnownNames[] = { TEXT("time"), TEXT("conductance"), TEXT("marker") };
+            const int64 EstimatedRows = Size / FMath::Max<int64>(LineEnd - LineStart + 1, 1);
+            OutTable.Columns.SetNum(NumColumns);
+            for (int32 Column = 0; Column < NumColumns; Column++)
+            {
+                OutTable.ColumnNames.Add(Column < UE_ARRAY_COUNT(KnownNames) ? FString(KnownNames[Column]) : FString::Printf(TEXT("column%d"), Column + 1));
+                OutTable.Columns[Column].Reserve(static_cast<int32>(FMath::Min<int64>(EstimatedRows + 16, MAX_int32)));
+            }
+        }
+        if (Fields.Num() != NumColumns)
+        {
+            OutTable.IrregularLines++;
+        }
+        for (int32 Column = 0; Column < NumColumns; Column++)
+        {
+            OutTable.Columns[Column].Add(Column < Fields.Num() ? Fields[Column] : 0.0);
+        }
+    }
+
+    // 标记列：值变为非 0 时记一个事件（同一个值持续多个采样只算一次）
+    const TArray<double>* Times = OutTable.FindColumn(TEXT("time"));
+    const TArray<double>* Markers = OutTable.FindColumn(TEXT("marker"));
+    if (Times && Markers)
+    {
+        double Previous = 0.0;
+        for (int32 Row = 0; Row < Markers->Num(); Row++)
+        {
+            const double Marker = (*Markers)[Row];
+            if (Marker != 0.0 && Marker != Previous)
+            {
+                FLedalabEvent& Event = OutTable.Events.AddDefaulted_GetRef();
+                Event.Time = (*Times)[Row];
+                Event.Name = FString::Printf(TEXT("%g"), Marker);
+                Event.TrialIndex = OutTable.Events.Num() - 1;
+            }
+            Previous = Marker;
+        }
+    }
+}
+
+void FSessionImporter::ToSessionFile(const FImportedTable& Table, FSessionFile& OutFile)
+{
+    OutFile = FSessionFile();
+    const TArray<double>* Times = Table.FindColumn(TEXT("time"));
+    const TArray<double>* Conductance = Table.FindColumn(TEXT("conductance"));
+    if (!Times || Times->Num() == 0)
+    {
+        return;
+    }
+    OutFile.SessionStart = (*Times)[0];
+
+    // 旧数据只有电导，电阻由电导换算（kΩ = 1000 / μS），ADC 原始值为 0
+    FSessionRecord Record;
+    Record.Channel = ESessionChannel::Gsr;
+    for (int32 Row = 0; Row < Times->Num(); Row++)
+    {
+        if (OutFile.Chunks.Num() == 0 || OutFile.Chunks.Last().NumRows() >= ImportChunkRows)
+        {
+            OutFile.Chunks.AddDefaulted_GetRef().Channel = ESessionChannel::Gsr;
+        }
+
+        const float Value = Conductance ? static_cast<float>((*Conductance)[Row]) : 0.0f;
+        Record.Time = (*Times)[Row];
+        Record.DeviceTime = Record.Time;
+        Record.Values[1] = Value > 0.0f ? 1000.0f / Value : 0.0f;
+        Record.Values[2] = Value;
+        OutFile.Chunks.Last().AddRecord(Record);
+    }
+
+    for (const FLedalabEvent& Event : Table.Events)
+    {
+        AddEventRecord(OutFile, Event);
+    }
+}
+
+bool FSessionImporter::LoadSession(const FString& Path, FImportedTable& OutTable, FString& OutError)
+{
+    FSessionFile File;
+    if (!FSessionRecorder::ReadFile(Path, File, OutError))
+    {
+        return false;
+    }
+    FromSessionFile(File, OutTable);
+    OutTable.SourceBytes = IFileManager::Get().FileSize(*Path);
+    return true;
+}
+
+void FSessionImporter::FromSessionFile(const FSessionFile& File, FImportedTable& OutTable)
+{
+    OutTable = FImportedTable();
+    OutTable.ColumnNames = { TEXT("time"), TEXT("conductance") };
+    OutTable.Columns.SetNum(2);
+
+    for (const FSessionChunk& Chunk : File.Chunks)
+    {
+        if (Chunk.Channel == ESessionChannel::Gsr)
+        {
+            OutTable.Columns[0].Append(Chunk.Time);
+            for (int32 Row = 0; Row < Chunk.NumRows(); Row++)
+            {
+                OutTable.Columns[1].Add(Chunk.Values[2][Row]);
+            }
+        }
+        else if (Chunk.Channel == ESessionChannel::Event)
+        {
+            for (int32 Row = 0; Row < Chunk.NumRows(); Row++)
+            {
+                FLedalabEvent& Event = OutTable.Events.AddDefaulted_GetRef();
+                Event.Time = Chunk.Time[Row];
+                Event.TrialIndex = static_cast<int32>(Chunk.Values[1][Row]);
+                Event.Name = Chunk.Names.IsValidIndex(Row) ? Chunk.Names[Row] : FString(TEXT("event"));
+
+                FString Type;
+                Event.Name.Split(TEXT("_"), &Type, &Event.Condition);
+            }
+        }
+    }
+}
+
+const ANSICHAR* FSessionImporter::FindLineEnd(const ANSICHAR* Cursor, const ANSICHAR* End)
+{
+#if PLATFORM_CPU_X86_FAMILY
+    const __m128i Newline = _mm_set1_epi8('\n');
+    while (End - Cursor >= 16)
+    {
+        const __m128i Block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Cursor));
+        const uint32 Mask = static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(Block, Newline)));
+        if (Mask != 0)
+        {
+            return Cursor + FMath::CountTrailingZeros(Mask);
+        }
+        Cursor += 16;
+    }
+#elif PLATFORM_CPU_ARM_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+    const uint8x16_t Newline = vdupq_n_u8('\n');
+    while (End - Cursor >= 16)
+    {
+        const uint8x16_t Equal = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8*>(Cursor)), Newline);
+        // 每个字节收窄为 4 位，得到 64 位掩码
+        const uint64 Mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(Equal), 4)), 0);
+        if (Mask != 0)
+        {
+            return Cursor + (FMath::CountTrailingZeros64(Mask) >> 2);
+        }
+        Cursor += 16;
+    }
+#endif
+    while (Cursor < End && *Cursor != '\n')
+    {
+        Cursor++;
+    }
+    return Cursor;
+}
+
+bool FSessionImporter::ParseNumber(const ANSICHAR*& Cursor, const ANSICHAR* End, double& OutValue)
+{
+    const ANSICHAR* Position = Cursor;
+    bool bNegative = false;
+    if (Position < End && (*Position == '-' || *Position == '+'))
+    {
+        bNegative = *Position == '-';
+        Position++;
+    }
+
+    uint64 Mantissa = 0;
+    int32 Exponent = 0;
+    bool bAnyDigit = false;
+    bool bExact = true;
+    const auto AddDigit = [&](ANSICHAR Digit, bool bFraction)
+    {
+        bAnyDigit = true;
+        if (Mantissa <= (MaxExactMantissa - 9) / 10)
+        {
+            Mantissa = Mantissa * 10 + static_cast<uint64>(Digit - '0');
+            Exponent -= bFraction ? 1 : 0;
+        }
+        else
+        {
+            bExact = false;
+        }
+    };
+
+    while (Position < End && IsDigit(*Position))
+    {
+        AddDigit(*Position++, false);
+    }
+    if (Position < End && *Position == '.')
+    {
+        Position++;
+        while (Position < End && IsDigit(*Position))
+        {
+            AddDigit(*Position++, true);
+        }
+    }
+    if (!bAnyDigit)
+    {
+        return false;
+    }
+
+    // 指数（"1e" 这样没有数字的不算指数）
+    if (Position < End && (*Position == 'e' || *Position == 'E'))
+    {
+        const ANSICHAR* ExponentStart = Position + 1;
+        bool bNegativeExponent = false;
+        if (ExponentStart < End && (*ExponentStart == '-' || *ExponentStart == '+'))
+        {
+            bNegativeExponent = *ExponentStart == '-';
+            ExponentStart++;
+        }
+        if (ExponentStart < End && IsDigit(*ExponentStart))
+        {
+            int32 ExponentValue = 0;
+            Position = ExponentStart;
+            while (Position < End && IsDigit(*Position))
+            {
+                ExponentValue = FMath::Min(ExponentValue * 10 + (*Position++ - '0'), 100000);
+            }
+            Exponent += bNegativeExponent ? -ExponentValue : ExponentValue;
+        }
+    }
+
+    const int32 MaxPower = UE_ARRAY_COUNT(ExactPowersOfTen) - 1;
+    if (bExact && Mantissa <= MaxExactMantissa && Exponent >= -MaxPower && Exponent <= MaxPower)
+    {
+        // 两个操作数都是精确的，一次 IEEE 乘除的舍入结果就是正确舍入的结果
+        const double Value = static_cast<double>(Mantissa);
+        OutValue = Exponent < 0 ? Value / ExactPowersOfTen[-Exponent] : Value * ExactPowersOfTen[Exponent];
+    }
+    else
+    {
+        ANSICHAR Buffer[128];
+        const int64 Length = Position - Cursor;
+        if (Length >= static_cast<int64>(sizeof(Buffer)))
+        {
+            return false;
+        }
+        FMemory::Memcpy(Buffer, Cursor, Length);
+        Buffer[Length] = '\0';
+        OutValue = FCStringAnsi::Atod(Buffer);
+        bNegative = false;
+    }
+    OutValue = bNegative ? -OutValue : OutValue;
+    Cursor = Position;
+    return true;
+}
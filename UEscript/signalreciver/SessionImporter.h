@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LedalabSessionRecorder.h"
+
+struct FSessionFile;
+
+/** 导入的旧数据：按列存放的数值和事件 */
+struct FImportedTable
+{
+    /** 列名（文本按 Ledalab 文本格式 2 的顺序：time、conductance、marker）*/
+    TArray<FString> ColumnNames;
+
+    TArray<TArray<double>> Columns;
+
+    /** 事件（文本中 marker 列不为 0 的行，MAT 中的 data.event），时间与 time 列相同 */
+    TArray<FLedalabEvent> Events;
+
+    /** 跳过的非数值行（表头、损坏的行）*/
+    int32 SkippedLines = 0;
+
+    /** 字段数与第一行数据不同的行（缺少的字段按 0 处理，多出的忽略）*/
+    int32 IrregularLines = 0;
+
+    /** 源文件大小 */
+    int64 SourceBytes = 0;
+
+    int32 NumRows() const { return Columns.Num() > 0 ? Columns[0].Num() : 0; }
+
+    const TArray<double>* FindColumn(const FString& Name) const;
+};
+
+/**
+ * 旧数据导入：Experiment 下的 Ledalab 文本（例如 figure/test_keyboard.txt，表头为残缺的 "Onset(s)Du"）
+ * 和 .mat（data.time / data.conductance / data.event），转换为会话记录文件（.wvsession）
+ * 文件通过内存映射读取，不拷贝整个文件；换行用 SIMD 一次查找 16 字节（SSE2 / NEON，其他平台逐字节），
+ * 数值在映射的内存上直接解析，不构造字符串
+ * 不能解析为数值的行都当作表头跳过，所以残缺或重复的表头、CRLF、空行、行尾多余的分隔符都不需要事先修复
+ */
+class WORKVOILENCEGAME_API FSessionImporter
+{
+public:
+    /** 按扩展名导入 .txt / .mat / .wvsession */
+    static bool Load(const FString& Path, FImportedTable& OutTable, FString& OutError);
+
+    static bool LoadText(const FString& Path, FImportedTable& OutTable, FString& OutError);
+
+    static bool LoadMat(const FString& Path, FImportedTable& OutTable, FString& OutError);
+
+    /** 读取会话记录，转换为与 .mat 相同的 time / conductance 列和事件（FromSessionFile）*/
+    static bool LoadSession(const FString& Path, FImportedTable& OutTable, FString& OutError);
+
+    /** 解析内存中的文本（制表符、空格、逗号或分号分隔）*/
+    static void ParseText(const ANSICHAR* Data, int64 Size, FImportedTable& OutTable);
+
+    /** 转换为会话记录：time / conductance 写入 Gsr 通道（设备时间同为 time），事件写入 Event 通道 */
+    static void ToSessionFile(const FImportedTable& Table, FSessionFile& OutFile);
+
+    /**
+     * ToSessionFile 的逆变换：Gsr 通道的共享时钟时间和电导作为 time / conductance 列（与事件时间在同一时钟上），
+     * Event 通道的每一行作为一个事件，条件取事件名中第一个下划线之后的部分（OSCReceiver 的命名为 类型_条件）
+     */
+    static void FromSessionFile(const FSessionFile& File, FImportedTable& OutTable);
+
+    /** 查找下一个换行符，没有时返回 End */
+    static const ANSICHAR* FindLineEnd(const ANSICHAR* Cursor, const ANSICHAR* End);
+
+    /**
+     * 解析一个十进制数（可带符号、小数和指数），成功时 Cursor 移到数字之后
+     * 有效数字不超过 2^53、十的幂不超过 22 时直接由整数与精确的 10^k 相乘或相除得到（结果与 strtod 相同），
+     * 其他情况交给 strtod
+     */
+    static bool ParseNumber(const ANSICHAR*& Cursor, const ANSICHAR* End, double& OutValue);
+};
@@ -0,0 +1,653 @@
+#include "SessionIndex.h"
+#include "GroupComparison.h"
+#include "SessionImporter.h"
+#include "SessionRecorder.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    /** 索引的列（文件中的列顺序以表头为准，新增的列追加在最后）*/
+    enum class EIndexField : uint8
+    {
+        Path,
+        Participant,
+        Condition,
+        Devices,
+        Format,
+        Started,
+        Duration,
+        Samples,
+        Rate,
+        ScrCount,
+        ScrPerMinute,
+        ScrAmplitudeMean,
+        TonicMean,
+        Trials,
+        ReactionTimeMean,
+        Error,
+        Bytes,
+        Modified,
+
+        Count
+    };
+
+    struct FIndexFieldInfo
+    {
+        const TCHAR* Name;
+        bool bNumeric;
+
+        /** 值是用 + 连接的列表 */
+        bool bList;
+    };
+
+    const FIndexFieldInfo FieldInfos[] =
+    {
+        { TEXT("path"), false, false },
+        { TEXT("participant"), false, false },
+        { TEXT("condition"), false, true },
+        { TEXT("devices"), false, true },
+        { TEXT("format"), false, false },
+        { TEXT("started"), false, false },
+        { TEXT("duration_min"), true, false },
+        { TEXT("samples"), true, false },
+        { TEXT("rate_hz"), true, false },
+        { TEXT("scr_count"), true, false },
+        { TEXT("scr_per_min"), true, false },
+        { TEXT("scr_amp_mean"), true, false },
+        { TEXT("scl_mean"), true, false },
+        { TEXT("trials"), true, false },
+        { TEXT("rt_mean"), true, false },
+        { TEXT("error"), false, false },
+        { TEXT("bytes"), true, false },
+        { TEXT("modified"), true, false },
+    };
+    static_assert(UE_ARRAY_COUNT(FieldInfos) == static_cast<int32>(EIndexField::Count), "每个列都要有名称");
+
+    const TCHAR* const TimeFormat = TEXT("%Y-%m-%d %H:%M:%S");
+
+    int32 FindField(const FString& Name)
+    {
+        for (int32 Field = 0; Field < static_cast<int32>(EIndexField::Count); Field++)
+        {
+            if (Name.Equals(FieldInfos[Field].Name, ESearchCase::IgnoreCase))
+            {
+                return Field;
+            }
+        }
+        return INDEX_NONE;
+    }
+
+    double GetNumber(const FSessionIndexEntry& Entry, EIndexField Field)
+    {
+        switch (Field)
+        {
+        case EIndexField::Duration:         return Entry.DurationMinutes;
+        case EIndexField::Samples:          return static_cast<double>(Entry.Samples);
+        case EIndexField::Rate:             return Entry.SampleRateHz;
+        case EIndexField::ScrCount:         return Entry.ScrCount;
+        case EIndexField::ScrPerMinute:     return Entry.ScrPerMinute;
+        case EIndexField::ScrAmplitudeMean: return Entry.ScrAmplitudeMean;
+        case EIndexField::TonicMean:        return Entry.TonicMean;
+        case EIndexField::Trials:           return Entry.Trials;
+        case EIndexField::ReactionTimeMean: return Entry.ReactionTimeMean;
+        case EIndexField::Bytes:            return static_cast<double>(Entry.FileBytes);
+        case EIndexField::Modified:         return static_cast<double>(Entry.ModifiedTicks);
+        default:                            return 0.0;
+        }
+    }
+
+    FString GetText(const FSessionIndexEntry& Entry, EIndexField Field)
+    {
+        switch (Field)
+        {
+        case EIndexField::Path:        return Entry.Path;
+        case EIndexField::Participant: return Entry.Participant;
+        case EIndexField::Condition:   return Entry.Condition;
+        case EIndexField::Devices:     return Entry.Devices;
+        case EIndexField::Format:      return Entry.Format;
+        case EIndexField::Started:     return Entry.StartedAt;
+        case EIndexField::Error:       return Entry.Error;
+        case EIndexField::Samples:     return FString::Printf(TEXT("%lld"), Entry.Samples);
+        case EIndexField::ScrCount:    return FString::Printf(TEXT("%d"), Entry.ScrCount);
+        case EIndexField::Trials:      return FString::Printf(TEXT("%d"), Entry.Trials);
+        case EIndexField::Bytes:       return FString::Printf(TEXT("%lld"), Entry.FileBytes);
+        case EIndexField::Modified:    return FString::Printf(TEXT("%lld"), Entry.ModifiedTicks);
+        default:                       return FString::Printf(TEXT("%.10g"), GetNumber(Entry, Field));
+        }
+    }
+
+    void SetText(FSessionIndexEntry& Entry, EIndexField Field, const FString& Text)
+    {
+        switch (Field)
+        {
+        case EIndexField::Path:             Entry.Path = Text; break;
+        case EIndexField::Participant:      Entry.Participant = Text; break;
+        case EIndexField::Condition:        Entry.Condition = Text; break;
+        case EIndexField::Devices:          Entry.Devices = Text; break;
+        case EIndexField::Format:           Entry.Format = Text; break;
+        case EIndexField::Started:          Entry.StartedAt = Text; break;
+        case EIndexField::Error:            Entry.Error = Text; break;
+        case EIndexField::Duration:         Entry.DurationMinutes = FCString::Atod(*Text); break;
+        case EIndexField::Samples:          Entry.Samples = FCString::Atoi64(*Text); break;
+        case EIndexField::Rate:             Entry.SampleRateHz = FCString::Atod(*Text); break;
+        case EIndexField::ScrCount:         Entry.ScrCount = FCString::Atoi(*Text); break;
+        case EIndexField::ScrPerMinute:     Entry.ScrPerMinute = FCString::Atod(*Text); break;
+        case EIndexField::ScrAmplitudeMean: Entry.ScrAmplitudeMean = FCString::Atod(*Text); break;
+        case EIndexField::TonicMean:        Entry.TonicMean = FCString::Atod(*Text); break;
+        case EIndexField::Trials:           Entry.Trials = FCString::Atoi(*Text); break;
+        case EIndexField::ReactionTimeMean: Entry.ReactionTimeMean = FCString::Atod(*Text); break;
+        case EIndexField::Bytes:            Entry.FileBytes = FCString::Atoi64(*Text); break;
+        case EIndexField::Modified:         Entry.ModifiedTicks = FCString::Atoi64(*Text); break;
+        default:                            break;
+        }
+    }
+
+    /** 表头 */
+    FString FormatHeader()
+    {
+        FString Line;
+        for (int32 Field = 0; Field < static_cast<int32>(EIndexField::Count); Field++)
+        {
+            Line += Field > 0 ? TEXT("\t") : TEXT("");
+            Line += FieldInfos[Field].Name;
+        }
+        return Line + TEXT("\n");
+    }
+
+    /** 一个条目一行，文本中的制表符和换行换成空格 */
+    FString FormatLine(const FSessionIndexEntry& Entry)
+    {
+        FString Line;
+        for (int32 Field = 0; Field < static_cast<int32>(EIndexField::Count); Field++)
+        {
+            FString Text = GetText(Entry, static_cast<EIndexField>(Field));
+            Text.ReplaceCharInline(TEXT('\t'), TEXT(' '));
+            Text.ReplaceCharInline(TEXT('\r'), TEXT(' '));
+            Text.ReplaceCharInline(TEXT('\n'), TEXT(' '));
+            Line += Field > 0 ? TEXT("\t") : TEXT("");
+            Line += Text;
+        }
+        return Line + TEXT("\n");
+    }
+
+    enum class EIndexOperator : uint8
+    {
+        Equal,
+        NotEqual,
+        Greater,
+        GreaterEqual,
+        Less,
+        LessEqual,
+        Contains
+    };
+
+    struct FIndexCondition
+    {
+        EIndexField Field = EIndexField::Path;
+        EIndexOperator Operator = EIndexOperator::Equal;
+        FString Text;
+        double Number = 0.0;
+    };
+
+    bool ParseFilter(const FString& Filter, TArray<FIndexCondition>& OutConditions, FString& OutError)
+    {
+        TArray<FString> Terms;
+        Filter.ParseIntoArray(Terms, TEXT(","));
+        for (const FString& Term : Terms)
+        {
+            int32 OperatorStart = INDEX_NONE;
+            for (int32 Char = 0; Char < Term.Len(); Char++)
+            {
+                if (FCString::Strchr(TEXT("=!<>~"), Term[Char]))
+                {
+                    OperatorStart = Char;
+                    break;
+                }
+            }
+            if (OperatorStart <= 0)
+            {
+                OutError = FString::Printf(TEXT("条件 %s 缺少列名或运算符"), *Term);
+                return false;
+            }
+
+            FIndexCondition& Condition = OutConditions.AddDefaulted_GetRef();
+            const FString Name = Term.Left(OperatorStart).TrimStartAndEnd();
+            const int32 Field = FindField(Name);
+            if (Field == INDEX_NONE)
+            {
+                OutError = FString::Printf(TEXT("未知的列 %s"), *Name);
+                return false;
+            }
+            Condition.Field = static_cast<EIndexField>(Field);
+
+            const TCHAR First = Term[OperatorStart];
+            const bool bTwoChars = OperatorStart + 1 < Term.Len() && Term[OperatorStart + 1] == TEXT('=') && First != TEXT('=') && First != TEXT('~');
+            switch (First)
+            {
+            case TEXT('='): Condition.Operator = EIndexOperator::Equal; break;
+            case TEXT('~'): Condition.Operator = EIndexOperator::Contains; break;
+            case TEXT('>'): Condition.Operator = bTwoChars ? EIndexOperator::GreaterEqual : EIndexOperator::Greater; break;
+            case TEXT('<'): Condition.Operator = bTwoChars ? EIndexOperator::LessEqual : EIndexOperator::Less; break;
+            default:
+                if (!bTwoChars)
+                {
+                    OutError = FString::Printf(TEXT("条件 %s 的运算符无效"), *Term);
+                    return false;
+                }
+                Condition.Operator = EIndexOperator::NotEqual;
+                break;
+            }
+
+            Condition.Text = Term.Mid(OperatorStart + (bTwoChars ? 2 : 1)).TrimStartAndEnd();
+            if (FieldInfos[Field].bNumeric && Condition.Operator != EIndexOperator::Contains)
+            {
+                if (!Condition.Text.IsNumeric())
+                {
+                    OutError = FString::Printf(TEXT("列 %s 需要数值：%s"), FieldInfos[Field].Name, *Condition.Text);
+                    return false;
+                }
+                Condition.Number = FCString::Atod(*Condition.Text);
+            }
+        }
+        return true;
+    }
+
+    bool Matches(const FSessionIndexEntry& Entry, const FIndexCondition& Condition)
+    {
+        const FIndexFieldInfo& Info = FieldInfos[static_cast<int32>(Condition.Field)];
+
+        int32 Order = 0;
+        if (Condition.Operator == EIndexOperator::Contains)
+        {
+            return GetText(Entry, Condition.Field).Contains(Condition.Text);
+        }
+        if (Info.bNumeric)
+        {
+            const double Value = GetNumber(Entry, Condition.Field);
+            Order = Value < Condition.Number ? -1 : (Value > Condition.Number ? 1 : 0);
+        }
+        else
+        {
+            const FString Text = GetText(Entry, Condition.Field);
+            Order = Text.Compare(Condition.Text, ESearchCase::IgnoreCase);
+            if (Order != 0 && Info.bList && (Condition.Operator == EIndexOperator::Equal || Condition.Operator == EIndexOperator::NotEqual))
+            {
+                TArray<FString> Items;
+                Text.ParseIntoArray(Items, TEXT("+"));
+                for (const FString& Item : Items)
+                {
+                    if (Item.Equals(Condition.Text, ESearchCase::IgnoreCase))
+                    {
+                        Order = 0;
+                        break;
+                    }
+                }
+            }
+        }
+
+        switch (Condition.Operator)
+        {
+        case EIndexOperator::Equal:        return Order == 0;
+        case EIndexOperator::NotEqual:     return Order != 0;
+        case EIndexOperator::Greater:      return Order > 0;
+        case EIndexOperator::GreaterEqual: return Order >= 0;
+        case EIndexOperator::Less:         return Order < 0;
+        case EIndexOperator::LessEqual:    return Order <= 0;
+        default:                           return false;
+        }
+    }
+
+    /** 会话记录中的通道和设备，例如 Controller1+Gsr */
+    FString DescribeDevices(const FSessionFile& File)
+    {
+        TArray<FString> Devices;
+        for (const FSessionChunk& Chunk : File.Chunks)
+        {
+            if (Chunk.Channel == ESessionChannel::Event)
+            {
+                continue;
+            }
+            const TCHAR* Name = FSessionRecorder::GetChannelName(Chunk.Channel);
+            Devices.AddUnique(Chunk.Device > 0 ? FString::Printf(TEXT("%s%d"), Name, Chunk.Device) : FString(Name));
+        }
+        Devices.Sort();
+        return FString::Join(Devices, TEXT("+"));
+    }
+
+    /** 文件本身的元数据：路径、被试、格式、大小和修改时间（开始时间先用修改时间）*/
+    void DescribeMetadata(const FString& SessionPath, const FString& Participant, FSessionIndexEntry& OutEntry)
+    {
+        OutEntry = FSessionIndexEntry();
+        OutEntry.Path = FPaths::ConvertRelativePathToFull(SessionPath);
+        OutEntry.Participant = Participant.IsEmpty() ? FPaths::GetBaseFilename(SessionPath) : Participant;
+        OutEntry.Format = FPaths::GetExtension(SessionPath).ToLower();
+        OutEntry.Devices = TEXT("Gsr");
+        OutEntry.FileBytes = IFileManager::Get().FileSize(*SessionPath);
+        const FDateTime Modified = IFileManager::Get().GetTimeStamp(*SessionPath);
+        OutEntry.ModifiedTicks = Modified.GetTicks();
+        OutEntry.StartedAt = Modified.ToString(TimeFormat);
+    }
+
+    /** 从导入的表格取得条件、样本数和时长，并分析指标 */
+    bool DescribeTable(const FImportedTable& Table, const FParticipantSettings& Settings, FSessionIndexEntry& OutEntry)
+    {
+        TArray<FString> Conditions;
+        for (const FLedalabEvent& Event : Table.Events)
+        {
+            if (!Event.Condition.IsEmpty())
+            {
+                Conditions.AddUnique(Event.Condition);
+            }
+        }
+        Conditions.Sort();
+        OutEntry.Condition = Conditions.Num() > 0 ? FString::Join(Conditions, TEXT("+")) : FPaths::GetCleanFilename(FPaths::GetPath(OutEntry.Path));
+
+        const TArray<double>* Times = Table.FindColumn(TEXT("time"));
+        if (Times && Times->Num() > 1)
+        {
+            const double Seconds = Times->Last() - (*Times)[0];
+            OutEntry.Samples = Times->Num();
+            OutEntry.DurationMinutes = Seconds / 60.0;
+            OutEntry.SampleRateHz = Seconds > 0.0 ? (Times->Num() - 1) / Seconds : 0.0;
+        }
+
+        FParticipantMetrics Metrics;
+        Metrics.Path = OutEntry.Path;
+        if (!FGroupComparison::AnalyzeParticipant(Table, Settings, Metrics))
+        {
+            OutEntry.Error = Metrics.Error;
+            return false;
+        }
+        OutEntry.ScrCount = Metrics.ScrAmplitudes.Num();
+        OutEntry.ScrPerMinute = Metrics.ScrPerMinute;
+        OutEntry.ScrAmplitudeMean = Metrics.ScrAmplitudeMean;
+        OutEntry.TonicMean = Metrics.TonicMean;
+        OutEntry.Trials = Metrics.ReactionTimes.Num();
+        OutEntry.ReactionTimeMean = Metrics.ReactionTimeMean;
+        return true;
+    }
+}
+
+FString FSessionIndex::GetDefaultPath()
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Sessions"), TEXT("SessionIndex.tsv"));
+}
+
+bool FSessionIndex::Load(const FString& InPath, FString& OutError)
+{
+    Path = InPath;
+    Entries.Reset();
+    EntryIndices.Reset();
+    Superseded = 0;
+
+    if (!FPaths::FileExists(Path))
+    {
+        return true;
+    }
+    FString Text;
+    if (!FFileHelper::LoadFileToString(Text, *Path))
+    {
+        OutError = FString::Printf(TEXT("无法读取索引 %s"), *Path);
+        return false;
+    }
+
+    TArray<FString> Lines;
+    Text.ParseIntoArrayLines(Lines);
+    if (Lines.Num() == 0)
+    {
+        return true;
+    }
+
+    // 按表头找到每一列，旧索引缺少的列保持默认值
+    TArray<FString> Cells;
+    Lines[0].ParseIntoArray(Cells, TEXT("\t"), false);
+    TArray<int32> Columns;
+    for (const FString& Cell : Cells)
+    {
+        Columns.Add(FindField(Cell));
+    }
+    if (!Columns.Contains(static_cast<int32>(EIndexField::Path)))
+    {
+        OutError = FString::Printf(TEXT("%s 不是会话索引（没有 path 列）"), *Path);
+        return false;
+    }
+
+    for (int32 Line = 1; Line < Lines.Num(); Line++)
+    {
+        Lines[Line].ParseIntoArray(Cells, TEXT("\t"), false);
+        FSessionIndexEntry Entry;
+        for (int32 Column = 0; Column < FMath::Min(Cells.Num(), Columns.Num()); Column++)
+        {
+            if (Columns[Column] != INDEX_NONE)
+            {
+                SetText(Entry, static_cast<EIndexField>(Columns[Column]), Cells[Column]);
+            }
+        }
+        if (Entry.Path.IsEmpty())
+        {
+            continue;
+        }
+
+        if (const int32* Existing = EntryIndices.Find(Entry.Path))
+        {
+            Entries[*Existing] = MoveTemp(Entry);
+            Superseded++;
+        }
+        else
+        {
+            EntryIndices.Add(Entry.Path, Entries.Num());
+            Entries.Add(MoveTemp(Entry));
+        }
+    }
+    return true;
+}
+
+bool FSessionIndex::Add(const FSessionIndexEntry& Entry, FString& OutError)
+{
+    FString Text = FormatLine(Entry);
+    if (IFileManager::Get().FileSize(*Path) <= 0)
+    {
+        IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+        Text = FormatHeader() + Text;
+    }
+    if (!FFileHelper::SaveStringToFile(Text, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM,
+        &IFileManager::Get(), FILEWRITE_Append))
+    {
+        OutError = FString::Printf(TEXT("无法写入索引 %s"), *Path);
+        return false;
+    }
+
+    if (const int32* Existing = EntryIndices.Find(Entry.Path))
+    {
+        Entries[*Existing] = Entry;
+        Superseded++;
+    }
+    else
+    {
+        EntryIndices.Add(Entry.Path, Entries.Num());
+        Entries.Add(Entry);
+    }
+    return true;
+}
+
+bool FSessionIndex::Compact(FString& OutError)
+{
+    TArray<FSessionIndexEntry> Kept;
+    for (FSessionIndexEntry& Entry : Entries)
+    {
+        if (FPaths::FileExists(Entry.Path))
+        {
+            Kept.Add(MoveTemp(Entry));
+        }
+    }
+    Entries = MoveTemp(Kept);
+    EntryIndices.Reset();
+    for (int32 Index = 0; Index < Entries.Num(); Index++)
+    {
+        EntryIndices.Add(Entries[Index].Path, Index);
+    }
+    Superseded = 0;
+
+    // 先写完整的临时文件再替换，写到一半中断时原索引不受影响
+    const FString TempPath = Path + TEXT(".tmp");
+    if (!WriteAll(TempPath, OutError))
+    {
+        return false;
+    }
+    if (!IFileManager::Get().Move(*Path, *TempPath, true, true))
+    {
+        OutError = FString::Printf(TEXT("无法替换索引 %s"), *Path);
+        return false;
+    }
+    return true;
+}
+
+bool FSessionIndex::WriteAll(const FString& InPath, FString& OutError) const
+{
+    FString Text = FormatHeader();
+    for (const FSessionIndexEntry& Entry : Entries)
+    {
+        Text += FormatLine(Entry);
+    }
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(InPath), true);
+    if (!FFileHelper::SaveStringToFile(Text, *InPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+    {
+        OutError = FString::Printf(TEXT("无法写入 %s"), *InPath);
+        return false;
+    }
+    return true;
+}
+
+const FSessionIndexEntry* FSessionIndex::Find(const FString& SessionPath) const
+{
+    const int32* Index = EntryIndices.Find(FPaths::ConvertRelativePathToFull(SessionPath));
+    return Index ? &Entries[*Index] : nullptr;
+}
+
+bool FSessionIndex::IsCurrent(const FString& SessionPath) const
+{
+    const FSessionIndexEntry* Entry = Find(SessionPath);
+    return Entry
+        && IFileManager::Get().FileSize(*SessionPath) == Entry->FileBytes
+        && IFileManager::Get().GetTimeStamp(*SessionPath).GetTicks() == Entry->ModifiedTicks;
+}
+
+bool FSessionIndex::Query(const FString& Filter, TArray<const FSessionIndexEntry*>& OutEntries, FString& OutError) const
+{
+    OutEntries.Reset();
+    TArray<FIndexCondition> Conditions;
+    if (!ParseFilter(Filter, Conditions, OutError))
+    {
+        return false;
+    }
+
+    for (const FSessionIndexEntry& Entry : Entries)
+    {
+        bool bMatches = true;
+        for (const FIndexCondition& Condition : Conditions)
+        {
+            if (!Matches(Entry, Condition))
+            {
+                bMatches = false;
+                break;
+            }
+        }
+        if (bMatches)
+        {
+            OutEntries.Add(&Entry);
+        }
+    }
+    OutEntries.Sort([](const FSessionIndexEntry& A, const FSessionIndexEntry& B)
+    {
+        return A.StartedAt != B.StartedAt ? A.StartedAt < B.StartedAt : A.Path < B.Path;
+    });
+    return true;
+}
+
+bool FSessionIndex::SelectInputs(const FString& Argument, TArray<FString>& OutPaths, FString& OutError) const
+{
+    if (Argument.StartsWith(TEXT("@")))
+    {
+        TArray<const FSessionIndexEntry*> Matched;
+        if (!Query(Argument.Mid(1), Matched, OutError))
+        {
+            return false;
+        }
+        for (const FSessionIndexEntry* Entry : Matched)
+        {
+            OutPaths.Add(Entry->Path);
+        }
+        return true;
+    }
+
+    if (FPaths::DirectoryExists(Argument))
+    {
+        FindSessionFiles(Argument, OutPaths);
+        return true;
+    }
+    if (!FPaths::FileExists(Argument))
+    {
+        OutError = FString::Printf(TEXT("找不到 %s"), *Argument);
+        return false;
+    }
+    OutPaths.Add(Argument);
+    return true;
+}
+
+void FSessionIndex::FindSessionFiles(const FString& Directory, TArray<FString>& OutPaths)
+{
+    TArray<FString> Names;
+    for (const TCHAR* Extension : { TEXT("wvsession"), TEXT("mat"), TEXT("txt") })
+    {
+        TArray<FString> Found;
+        IFileManager::Get().FindFiles(Found, *FPaths::Combine(Directory, FString::Printf(TEXT("*.%s"), Extension)), true, false);
+        Names.Append(Found);
+    }
+    Names.Sort();
+    for (const FString& Name : Names)
+    {
+        if (!Name.ToLower().EndsWith(TEXT("_scrlist.mat")))
+        {
+            OutPaths.Add(FPaths::Combine(Directory, Name));
+        }
+    }
+}
+
+bool FSessionIndex::Describe(const FString& SessionPath, const FParticipantSettings& Settings, const FString& Participant,
+    FSessionIndexEntry& OutEntry)
+{
+    // 会话记录直接读取，通道和开始时间要从文件本身取得
+    if (FPaths::GetExtension(SessionPath).ToLower() == TEXT("wvsession"))
+    {
+        FSessionFile File;
+        FString Error;
+        if (!FSessionRecorder::ReadFile(SessionPath, File, Error))
+        {
+            DescribeMetadata(SessionPath, Participant, OutEntry);
+            OutEntry.Error = Error;
+            return false;
+        }
+        return Describe(SessionPath, File, Settings, Participant, OutEntry);
+    }
+
+    DescribeMetadata(SessionPath, Participant, OutEntry);
+    FImportedTable Table;
+    if (!FSessionImporter::Load(SessionPath, Table, OutEntry.Error))
+    {
+        return false;
+    }
+    return DescribeTable(Table, Settings, OutEntry);
+}
+
+bool FSessionIndex::Describe(const FString& SessionPath, const FSessionFile& File, const FParticipantSettings& Settings,
+    const FString& Participant, FSessionIndexEntry& OutEntry)
+{
+    DescribeMetadata(SessionPath, Participant, OutEntry);
+    OutEntry.StartedAt = File.StartedAt.ToString(TimeFormat);
+    OutEntry.Devices = DescribeDevices(File);
+    FImportedTable Table;
+    FSessionImporter::FromSessionFile(File, Table);
+    return DescribeTable(Table, Settings, OutEntry);
+}
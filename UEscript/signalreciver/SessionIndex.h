@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FParticipantSettings;
+struct FSessionFile;
+
+/** 索引中的一个会话 */
+struct FSessionIndexEntry
+{
+    /** 会话文件的完整路径（索引的键）*/
+    FString Path;
+
+    /** 被试编号，没有指定时为文件名 */
+    FString Participant;
+
+    /** 事件名中的条件（OSCReceiver 的命名为 类型_条件），去重后用 + 连接；没有事件时为所在目录名（例如 keyboardGroup）*/
+    FString Condition;
+
+    /** 记录的通道和设备，用 + 连接（例如 Controller1+Gsr）；旧数据只有 Gsr */
+    FString Devices;
+
+    /** 扩展名（wvsession / mat / txt）*/
+    FString Format;
+
+    /** 开始时间 yyyy-mm-dd HH:MM:SS：会话记录的开始 UTC 时间，旧数据为文件修改时间 */
+    FString StartedAt;
+
+    double DurationMinutes = 0.0;
+
+    /** 电导的采样数和平均采样率 */
+    int64 Samples = 0;
+    double SampleRateHz = 0.0;
+
+    /** SCR 和反应时指标（FGroupComparison::AnalyzeParticipant，默认的预处理、分解设置和阈值）*/
+    int32 ScrCount = 0;
+    double ScrPerMinute = 0.0;
+    double ScrAmplitudeMean = 0.0;
+    double TonicMean = 0.0;
+    int32 Trials = 0;
+    double ReactionTimeMean = 0.0;
+
+    /** 读取或分析失败的原因，成功时为空（失败时指标都为 0，元数据仍然可以查询）*/
+    FString Error;
+
+    /** 建立条目时文件的大小和修改时间（FDateTime ticks），任一变化时条目过期 */
+    int64 FileBytes = 0;
+    int64 ModifiedTicks = 0;
+};
+
+/**
+ * 跨会话的元数据索引：每个会话一行（被试、条件、设备、时长和摘要指标），按条件查询时不需要读取会话文件
+ * 存储为 UTF-8 制表符分隔文本（默认 Saved/Sessions/SessionIndex.tsv），第一行为列名，之后每个条目一行；
+ * 更新只在末尾追加一行，同一路径后面的行覆盖前面的行，过时的行超过有效行时 Compact 重写整个文件
+ * 整个索引读入内存，查询是对条目的线性扫描，几千个会话也在毫秒以内
+ *
+ * 查询条件写法：逗号分隔的 <列><运算符><值>，全部满足才匹配，例如 condition=joystick,scr_count>20
+ * - 运算符：= != > >= < <= ~（包含）；文本列不区分大小写，数值列按数值比较
+ * - condition 和 devices 的 = 匹配整列或其中任意一项（condition=joystick 匹配 keyboard+joystick）
+ * - 列名：path participant condition devices format started duration_min samples rate_hz scr_count scr_per_min
+ *   scr_amp_mean scl_mean trials rt_mean error bytes
+ */
+class WORKVOILENCEGAME_API FSessionIndex
+{
+public:
+    /** Saved/Sessions/SessionIndex.tsv */
+    static FString GetDefaultPath();
+
+    /** 读取索引，文件不存在时为空索引 */
+    bool Load(const FString& InPath, FString& OutError);
+
+    /** 加入或更新一个条目（追加一行）*/
+    bool Add(const FSessionIndexEntry& Entry, FString& OutError);
+
+    /** 去掉过时的行和已经删除的会话，写到临时文件后替换原文件 */
+    bool Compact(FString& OutError);
+
+    const FSessionIndexEntry* Find(const FString& SessionPath) const;
+
+    /** 文件存在且大小和修改时间与条目相同 */
+    bool IsCurrent(const FString& SessionPath) const;
+
+    /** 满足条件的条目（按开始时间排序），条件为空时返回全部 */
+    bool Query(const FString& Filter, TArray<const FSessionIndexEntry*>& OutEntries, FString& OutError) const;
+
+    /**
+     * 批处理工具的输入：以 @ 开头的参数是查询条件（@condition=joystick,scr_count>20），返回匹配的会话；
+     * 否则是目录（FindSessionFiles）或单个文件
+     */
+    bool SelectInputs(const FString& Argument, TArray<FString>& OutPaths, FString& OutError) const;
+
+    const TArray<FSessionIndexEntry>& GetEntries() const { return Entries; }
+
+    const FString& GetPath() const { return Path; }
+
+    /** 文件中被后面的行覆盖的行数 */
+    int32 GetSupersededCount() const { return Superseded; }
+
+    /** 目录中的会话文件（.wvsession / .mat / .txt，跳过 Ledalab 导出的 *_scrlist.mat），按名称排序 */
+    static void FindSessionFiles(const FString& Directory, TArray<FString>& OutPaths);
+
+    /** 读取会话文件，分析指标并填写条目；Participant 为空时用文件名。读取或分析失败时返回 false，条目仍带有元数据和 Error */
+    static bool Describe(const FString& SessionPath, const FParticipantSettings& Settings, const FString& Participant,
+        FSessionIndexEntry& OutEntry);
+
+    /** 同上，会话记录（.wvsession）已经读入时使用，不再读一遍文件 */
+    static bool Describe(const FString& SessionPath, const FSessionFile& File, const FParticipantSettings& Settings,
+        const FString& Participant, FSessionIndexEntry& OutEntry);
+
+private:
+    bool WriteAll(const FString& InPath, FString& OutError) const;
+
+    FString Path;
+
+    TArray<FSessionIndexEntry> Entries;
+
+    /** 完整路径 -> Entries 的下标 */
+    TMap<FString, int32> EntryIndices;
+
+    int32 Superseded = 0;
+};
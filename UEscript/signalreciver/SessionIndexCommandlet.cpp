@@ -0,0 +1,132 @@
+#include "SessionIndexCommandlet.h"
+#include "SessionIndex.h"
+#include "GroupComparison.h"
+#include "ParallelWorkers.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+
+USessionIndexCommandlet::USessionIndexCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 USessionIndexCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Arguments;
+    TArray<FString> Switches;
+    ParseCommandLine(*Params, Arguments, Switches);
+
+    FString IndexPath = FSessionIndex::GetDefaultPath();
+    FString Filter;
+    int32 NumThreads = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    FParse::Value(*Params, TEXT("Index="), IndexPath);
+    FParse::Value(*Params, TEXT("Threads="), NumThreads);
+    const bool bWhere = FParse::Value(*Params, TEXT("Where="), Filter, false);
+    const bool bForce = FParse::Param(*Params, TEXT("Force"));
+    const bool bCompact = FParse::Param(*Params, TEXT("Compact"));
+    NumThreads = FMath::Max(NumThreads, 1);
+
+    FSessionIndex Index;
+    FString Error;
+    const uint64 LoadStart = FPlatformTime::Cycles64();
+    if (!Index.Load(IndexPath, Error))
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("索引 %s：%d 个会话，读取用时 %.2f ms"), *IndexPath, Index.GetEntries().Num(),
+        FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - LoadStart));
+
+    // === 加入会话 ===
+
+    int32 Failures = 0;
+    TArray<FString> Paths;
+    for (const FString& Argument : Arguments)
+    {
+        TArray<FString> Found;
+        if (!Index.SelectInputs(Argument, Found, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+            Failures++;
+            continue;
+        }
+        for (const FString& Path : Found)
+        {
+            if (bForce || !Index.IsCurrent(Path))
+            {
+                Paths.AddUnique(Path);
+            }
+        }
+    }
+
+    if (Paths.Num() > 0)
+    {
+        TArray<FSessionIndexEntry> Added;
+        Added.SetNum(Paths.Num());
+        const FParticipantSettings Settings;
+        const uint64 DescribeStart = FPlatformTime::Cycles64();
+        FParallelWorkers::ForEach(Paths.Num(), NumThreads, TEXT("SessionIndex"), [&Paths, &Added, &Settings](int32 Job)
+        {
+            FSessionIndex::Describe(Paths[Job], Settings, FString(), Added[Job]);
+        });
+        UE_LOG(LogTemp, Display, TEXT("分析 %d 个会话，用时 %.3f s"), Paths.Num(), FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - DescribeStart));
+
+        for (const FSessionIndexEntry& Entry : Added)
+        {
+            if (!Entry.Error.IsEmpty())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("  %s: %s（只索引元数据）"), *Entry.Path, *Entry.Error);
+            }
+            if (!Index.Add(Entry, Error))
+            {
+                UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+                return 1;
+            }
+        }
+    }
+    else if (Arguments.Num() > 0)
+    {
+        UE_LOG(LogTemp, Display, TEXT("索引已是最新"));
+    }
+
+    if (bCompact || Index.GetSupersededCount() > Index.GetEntries().Num())
+    {
+        const int32 Before = Index.GetEntries().Num();
+        const int32 Superseded = Index.GetSupersededCount();
+        if (!Index.Compact(Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+            return 1;
+        }
+        UE_LOG(LogTemp, Display, TEXT("整理索引：去掉 %d 个过时的行、%d 个已删除的会话"), Superseded, Before - Index.GetEntries().Num());
+    }
+
+    // === 查询 ===
+
+    if (bWhere || Arguments.Num() == 0)
+    {
+        TArray<const FSessionIndexEntry*> Matched;
+        const uint64 QueryStart = FPlatformTime::Cycles64();
+        if (!Index.Query(Filter, Matched, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+            return 1;
+        }
+        const double QueryMilliseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - QueryStart);
+
+        for (const FSessionIndexEntry* Entry : Matched)
+        {
+            UE_LOG(LogTemp, Display, TEXT("  %s  %-12s %-20s %-24s %6.1f min  SCR %4d（%.2f/min）  反应 %3d 次（平均 %.3f s）  %s"),
+                *Entry->StartedAt, *Entry->Participant, *Entry->Condition, *Entry->Devices, Entry->DurationMinutes,
+                Entry->ScrCount, Entry->ScrPerMinute, Entry->Trials, Entry->ReactionTimeMean, *Entry->Path);
+        }
+        UE_LOG(LogTemp, Display, TEXT("%d / %d 个会话满足 \"%s\"，查询用时 %.3f ms"), Matched.Num(), Index.GetEntries().Num(), *Filter, QueryMilliseconds);
+    }
+
+    return Failures > 0 ? 1 : 0;
+}
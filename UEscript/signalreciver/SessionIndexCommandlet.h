@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SessionIndexCommandlet.generated.h"
+
+/**
+ * 维护和查询会话索引（FSessionIndex，默认 Saved/Sessions/SessionIndex.tsv）
+ * 位置参数是要加入索引的目录（其中的 .wvsession / .mat / .txt）或文件；大小和修改时间没有变化的会话跳过（-Force 时全部重新分析），
+ * 其余的并行读取、分解（默认设置，与 GroupComparison 相同）后追加到索引。OSCReceiver 结束记录时会自动加入，
+ * 这里用于补充 Experiment 下的旧数据和其他位置的文件
+ * -Where=<条件>：列出满足条件的会话并报告查询耗时（写法见 FSessionIndex），没有位置参数时不带 -Where 列出全部
+ * -Compact：去掉过时的行和已删除的会话；过时的行多于有效行时自动进行
+ * 批处理工具（GsrBatchAnalysis、GroupComparison）的位置参数写成 @<条件> 时从索引选取输入，例如
+ *   -run=GroupComparison @condition=keyboard @condition=joystick,scr_count>20
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=SessionIndex [<目录或文件> ...] [-Index=<索引.tsv>] [-Force]
+ *       [-Where=<条件>] [-Compact] [-Threads=<线程数>]
+ * 例如 Experiment/keyboardGroup Experiment/joystickgroup，然后 -Where=condition=joystickgroup,scr_count>20
+ */
+UCLASS()
+class WORKVOILENCEGAME_API USessionIndexCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USessionIndexCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,498 @@
+#include "SessionPyramid.h"
+#include "SessionImporter.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    const uint8 FileMagic[7] = { 'W', 'V', 'P', 'Y', 'R', 'M', 'D' };
+
+    /** 文件头：魔数 7 + 版本 1 + 源文件大小 8 + 修改时间 8 + BaseBucket / Fanout / 表数 12 */
+    constexpr int32 FileHeaderBytes = 36;
+
+    /** 表头：通道/设备/列数/保留 4 + 样本数 8 + 开始/结束时间 16 + 层数 4 */
+    constexpr int32 TableHeaderBytes = 32;
+
+    /** 层头：每桶样本数 8 + 桶数 4 */
+    constexpr int32 LevelHeaderBytes = 12;
+
+    template <typename T>
+    void AppendValue(TArray<uint8>& Out, const T& Value)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+    }
+
+    template <typename T>
+    void AppendColumn(TArray<uint8>& Out, const TArray<T>& Column)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(Column.GetData()), Column.Num() * sizeof(T));
+    }
+
+    /** 顺序读取，越界后所有读取都返回 false */
+    struct FPyramidReader
+    {
+        const TArray<uint8>& Data;
+        int64 Offset = 0;
+
+        template <typename T>
+        bool Read(T& OutValue)
+        {
+            if (Offset + static_cast<int64>(sizeof(T)) > Data.Num())
+            {
+                Offset = Data.Num() + 1;
+                return false;
+            }
+            FMemory::Memcpy(&OutValue, Data.GetData() + Offset, sizeof(T));
+            Offset += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        bool ReadColumn(TArray<T>& OutColumn, int32 Count)
+        {
+            const int64 Bytes = static_cast<int64>(Count) * sizeof(T);
+            if (Count < 0 || Offset + Bytes > Data.Num())
+            {
+                Offset = Data.Num() + 1;
+                return false;
+            }
+            OutColumn.SetNumUninitialized(Count);
+            FMemory::Memcpy(OutColumn.GetData(), Data.GetData() + Offset, Bytes);
+            Offset += Bytes;
+            return true;
+        }
+    };
+
+    /** 第一个大于 Value 的位置 */
+    int32 UpperBound(const TArray<double>& Sorted, double Value)
+    {
+        int32 Low = 0;
+        int32 High = Sorted.Num();
+        while (Low < High)
+        {
+            const int32 Middle = (Low + High) / 2;
+            if (Sorted[Middle] <= Value)
+            {
+                Low = Middle + 1;
+            }
+            else
+            {
+                High = Middle;
+            }
+        }
+        return Low;
+    }
+
+    /** 第一个不小于 Value 的位置 */
+    int32 LowerBound(const TArray<double>& Sorted, double Value)
+    {
+        int32 Low = 0;
+        int32 High = Sorted.Num();
+        while (Low < High)
+        {
+            const int32 Middle = (Low + High) / 2;
+            if (Sorted[Middle] < Value)
+            {
+                Low = Middle + 1;
+            }
+            else
+            {
+                High = Middle;
+            }
+        }
+        return Low;
+    }
+
+    /** 第 Bucket 个桶的样本数（只有最后一个桶可能不满）*/
+    int64 GetBucketSamples(const FSessionPyramidLevel& Level, int64 NumSamples, int32 Bucket)
+    {
+        return FMath::Min(Level.SamplesPerBucket, NumSamples - Bucket * Level.SamplesPerBucket);
+    }
+
+    /** 每 Factor 个桶合并为一个：最小值取最小，最大值取最大，均值按样本数加权 */
+    void MergeBuckets(const FSessionPyramidLevel& Source, int64 NumSamples, int32 NumColumns, int32 Factor, FSessionPyramidLevel& OutLevel)
+    {
+        const int32 SourceBuckets = Source.NumBuckets();
+        const int32 Buckets = (SourceBuckets + Factor - 1) / Factor;
+        OutLevel.SamplesPerBucket = Source.SamplesPerBucket * Factor;
+        OutLevel.Time.SetNumUninitialized(Buckets);
+        OutLevel.Min.SetNum(NumColumns);
+        OutLevel.Max.SetNum(NumColumns);
+        OutLevel.Mean.SetNum(NumColumns);
+        for (int32 Bucket = 0; Bucket < Buckets; Bucket++)
+        {
+            OutLevel.Time[Bucket] = Source.Time[Bucket * Factor];
+        }
+
+        // 原始样本层只有均值，最小值和最大值就是样本本身
+        const bool bSamples = Source.Min.Num() == 0;
+        for (int32 Column = 0; Column < NumColumns; Column++)
+        {
+            const TArray<float>& SourceMean = Source.Mean[Column];
+            const TArray<float>& SourceMin = bSamples ? SourceMean : Source.Min[Column];
+            const TArray<float>& SourceMax = bSamples ? SourceMean : Source.Max[Column];
+            TArray<float>& Min = OutLevel.Min[Column];
+            TArray<float>& Max = OutLevel.Max[Column];
+            TArray<float>& Mean = OutLevel.Mean[Column];
+            Min.SetNumUninitialized(Buckets);
+            Max.SetNumUninitialized(Buckets);
+            Mean.SetNumUninitialized(Buckets);
+
+            for (int32 Bucket = 0; Bucket < Buckets; Bucket++)
+            {
+                const int32 First = Bucket * Factor;
+                const int32 Last = FMath::Min(First + Factor, SourceBuckets);
+                float BucketMin = SourceMin[First];
+                float BucketMax = SourceMax[First];
+                double Sum = 0.0;
+                double Count = 0.0;
+                for (int32 Index = First; Index < Last; Index++)
+                {
+                    const double Samples = static_cast<double>(GetBucketSamples(Source, NumSamples, Index));
+                    BucketMin = FMath::Min(BucketMin, SourceMin[Index]);
+                    BucketMax = FMath::Max(BucketMax, SourceMax[Index]);
+                    Sum += SourceMean[Index] * Samples;
+                    Count += Samples;
+                }
+                Min[Bucket] = BucketMin;
+                Max[Bucket] = BucketMax;
+                Mean[Bucket] = static_cast<float>(Sum / Count);
+            }
+        }
+    }
+}
+
+void FSessionPyramid::Build(const FSessionFile& File, bool bKeepSamples)
+{
+    Tables.Reset();
+
+    // 同一 (通道, 设备) 的块按时间先后拼接为原始样本层
+    TArray<FSessionPyramidLevel> Samples;
+    for (const FSessionChunk& Chunk : File.Chunks)
+    {
+        if (Chunk.Channel == ESessionChannel::Event || Chunk.NumRows() == 0)
+        {
+            continue;
+        }
+
+        int32 TableIndex = INDEX_NONE;
+        for (int32 Index = 0; Index < Tables.Num(); Index++)
+        {
+            if (Tables[Index].Channel == Chunk.Channel && Tables[Index].Device == Chunk.Device)
+            {
+                TableIndex = Index;
+                break;
+            }
+        }
+        if (TableIndex == INDEX_NONE)
+        {
+            TableIndex = Tables.Num();
+            FSessionPyramidTable& Table = Tables.AddDefaulted_GetRef();
+            Table.Channel = Chunk.Channel;
+            Table.Device = Chunk.Device;
+            Table.NumColumns = FSessionRecorder::GetValueCount(Chunk.Channel);
+            Samples.AddDefaulted_GetRef().Mean.SetNum(Table.NumColumns);
+        }
+
+        FSessionPyramidLevel& Level = Samples[TableIndex];
+        Level.Time.Append(Chunk.Time);
+        for (int32 Column = 0; Column < Tables[TableIndex].NumColumns; Column++)
+        {
+            Level.Mean[Column].Append(Chunk.Values[Column]);
+        }
+    }
+
+    for (int32 TableIndex = 0; TableIndex < Tables.Num(); TableIndex++)
+    {
+        FSessionPyramidTable& Table = Tables[TableIndex];
+        FSessionPyramidLevel& Level = Samples[TableIndex];
+        Table.NumSamples = Level.NumBuckets();
+        Table.StartTime = Level.Time[0];
+        Table.EndTime = Level.Time.Last();
+
+        MergeBuckets(Level, Table.NumSamples, Table.NumColumns, BaseBucket, Table.Levels.AddDefaulted_GetRef());
+        while (Table.Levels.Last().NumBuckets() > Fanout)
+        {
+            FSessionPyramidLevel Coarser;
+            MergeBuckets(Table.Levels.Last(), Table.NumSamples, Table.NumColumns, Fanout, Coarser);
+            Table.Levels.Add(MoveTemp(Coarser));
+        }
+        if (bKeepSamples)
+        {
+            Table.Levels.Insert(MoveTemp(Level), 0);
+        }
+    }
+}
+
+bool FSessionPyramid::Save(const FString& Path, FString& OutError) const
+{
+    TArray<uint8> Data;
+    Data.Append(FileMagic, sizeof(FileMagic));
+    Data.Add(static_cast<uint8>(FileVersion));
+    AppendValue(Data, SourceBytes);
+    AppendValue(Data, SourceModifiedTicks);
+    AppendValue(Data, static_cast<uint32>(BaseBucket));
+    AppendValue(Data, static_cast<uint32>(Fanout));
+    AppendValue(Data, static_cast<uint32>(Tables.Num()));
+
+    for (const FSessionPyramidTable& Table : Tables)
+    {
+        // 原始样本层与会话记录重复，不写出
+        const int32 FirstLevel = Table.Levels.Num() > 0 && Table.Levels[0].Min.Num() == 0 ? 1 : 0;
+        Data.Add(static_cast<uint8>(Table.Channel));
+        Data.Add(Table.Device);
+        Data.Add(static_cast<uint8>(Table.NumColumns));
+        Data.Add(0);
+        AppendValue(Data, Table.NumSamples);
+        AppendValue(Data, Table.StartTime);
+        AppendValue(Data, Table.EndTime);
+        AppendValue(Data, static_cast<uint32>(Table.Levels.Num() - FirstLevel));
+
+        for (int32 LevelIndex = FirstLevel; LevelIndex < Table.Levels.Num(); LevelIndex++)
+        {
+            const FSessionPyramidLevel& Level = Table.Levels[LevelIndex];
+            AppendValue(Data, Level.SamplesPerBucket);
+            AppendValue(Data, static_cast<uint32>(Level.NumBuckets()));
+            AppendColumn(Data, Level.Time);
+            for (const TArray<TArray<float>>* Columns : { &Level.Min, &Level.Max, &Level.Mean })
+            {
+                for (const TArray<float>& Column : *Columns)
+                {
+                    AppendColumn(Data, Column);
+                }
+            }
+        }
+    }
+
+    if (!FFileHelper::SaveArrayToFile(Data, *Path))
+    {
+        OutError = FString::Printf(TEXT("无法写入 %s"), *Path);
+        return false;
+    }
+    return true;
+}
+
+bool FSessionPyramid::Load(const FString& Path, FString& OutError)
+{
+    Tables.Reset();
+
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *Path))
+    {
+        OutError = FString::Printf(TEXT("无法读取 %s"), *Path);
+        return false;
+    }
+    if (Data.Num() < FileHeaderBytes || FMemory::Memcmp(Data.GetData(), FileMagic, sizeof(FileMagic)) != 0)
+    {
+        OutError = FString::Printf(TEXT("%s 不是会话金字塔文件"), *Path);
+        return false;
+    }
+    if (Data[7] != FileVersion)
+    {
+        OutError = FString::Printf(TEXT("不支持的会话金字塔版本 %d"), Data[7]);
+        return false;
+    }
+
+    FPyramidReader Reader{ Data, 8 };
+    uint32 FileBaseBucket = 0;
+    uint32 FileFanout = 0;
+    uint32 NumTables = 0;
+    Reader.Read(SourceBytes);
+    Reader.Read(SourceModifiedTicks);
+    Reader.Read(FileBaseBucket);
+    Reader.Read(FileFanout);
+    Reader.Read(NumTables);
+
+    for (uint32 TableIndex = 0; TableIndex < NumTables && Reader.Offset + TableHeaderBytes <= Data.Num(); TableIndex++)
+    {
+        FSessionPyramidTable& Table = Tables.AddDefaulted_GetRef();
+        uint8 Channel = 0;
+        uint8 NumColumns = 0;
+        uint8 Reserved = 0;
+        uint32 NumLevels = 0;
+        Reader.Read(Channel);
+        Reader.Read(Table.Device);
+        Reader.Read(NumColumns);
+        Reader.Read(Reserved);
+        Reader.Read(Table.NumSamples);
+        Reader.Read(Table.StartTime);
+        Reader.Read(Table.EndTime);
+        Reader.Read(NumLevels);
+        Table.Channel = static_cast<ESessionChannel>(Channel);
+        Table.NumColumns = NumColumns;
+        if (Channel >= static_cast<uint8>(ESessionChannel::Count) || NumColumns > FSessionRecord::MaxValues)
+        {
+            break;
+        }
+
+        for (uint32 LevelIndex = 0; LevelIndex < NumLevels && Reader.Offset + LevelHeaderBytes <= Data.Num(); LevelIndex++)
+        {
+            FSessionPyramidLevel& Level = Table.Levels.AddDefaulted_GetRef();
+            uint32 Buckets = 0;
+            Reader.Read(Level.SamplesPerBucket);
+            Reader.Read(Buckets);
+            const int32 Count = Buckets <= static_cast<uint32>(MAX_int32) ? static_cast<int32>(Buckets) : -1;
+            Reader.ReadColumn(Level.Time, Count);
+            for (TArray<TArray<float>>* Columns : { &Level.Min, &Level.Max, &Level.Mean })
+            {
+                Columns->SetNum(NumColumns);
+                for (TArray<float>& Column : *Columns)
+                {
+                    Reader.ReadColumn(Column, Count);
+                }
+            }
+        }
+    }
+
+    if (Reader.Offset != Data.Num() || Tables.Num() != static_cast<int32>(NumTables))
+    {
+        Tables.Reset();
+        OutError = FString::Printf(TEXT("%s 已损坏"), *Path);
+        return false;
+    }
+    return true;
+}
+
+bool FSessionPyramid::Query(ESessionChannel Channel, uint8 Device, int32 Column, double StartTime, double EndTime, int32 Pixels,
+    FSessionPyramidSeries& OutSeries) const
+{
+    OutSeries = FSessionPyramidSeries();
+    const FSessionPyramidTable* Table = FindTable(Channel, Device);
+    if (!Table || Table->Levels.Num() == 0 || Column < 0 || Column >= Table->NumColumns || !(EndTime > StartTime) || Pixels <= 0)
+    {
+        return false;
+    }
+
+    // 从最粗的层开始，找到范围内的桶数不少于像素数的层；都不够时用最细的层
+    // 第一个桶可能在 StartTime 之前开始，也包含进来，这样范围内的每个样本都被覆盖
+    int32 LevelIndex = Table->Levels.Num() - 1;
+    int32 First = 0;
+    int32 Last = 0;
+    for (; LevelIndex >= 0; LevelIndex--)
+    {
+        const TArray<double>& Time = Table->Levels[LevelIndex].Time;
+        First = FMath::Max(UpperBound(Time, StartTime) - 1, 0);
+        Last = LowerBound(Time, EndTime);
+        if (Last - First >= Pixels || LevelIndex == 0)
+        {
+            break;
+        }
+    }
+
+    const FSessionPyramidLevel& Level = Table->Levels[LevelIndex];
+    const TArray<float>& Means = Level.Mean[Column];
+    const TArray<float>& Mins = Level.Min.Num() > 0 ? Level.Min[Column] : Means;
+    const TArray<float>& Maxs = Level.Max.Num() > 0 ? Level.Max[Column] : Means;
+    OutSeries.Level = LevelIndex;
+    OutSeries.SamplesPerBucket = Level.SamplesPerBucket;
+    OutSeries.BucketsRead = FMath::Max(Last - First, 0);
+
+    // 按桶的开始时间归入像素，同一像素内的桶合并
+    const double PixelWidth = (EndTime - StartTime) / Pixels;
+    int32 CurrentPixel = INDEX_NONE;
+    double Sum = 0.0;
+    double Count = 0.0;
+    for (int32 Bucket = First; Bucket < Last; Bucket++)
+    {
+        const int32 Pixel = FMath::Clamp(FMath::FloorToInt((Level.Time[Bucket] - StartTime) / PixelWidth), 0, Pixels - 1);
+        if (Pixel != CurrentPixel)
+        {
+            if (Count > 0.0)
+            {
+                OutSeries.Mean.Add(static_cast<float>(Sum / Count));
+            }
+            OutSeries.Time.Add(Level.Time[Bucket]);
+            OutSeries.Min.Add(Mins[Bucket]);
+            OutSeries.Max.Add(Maxs[Bucket]);
+            CurrentPixel = Pixel;
+            Sum = 0.0;
+            Count = 0.0;
+        }
+        else
+        {
+            OutSeries.Min.Last() = FMath::Min(OutSeries.Min.Last(), Mins[Bucket]);
+            OutSeries.Max.Last() = FMath::Max(OutSeries.Max.Last(), Maxs[Bucket]);
+        }
+        const double Samples = static_cast<double>(GetBucketSamples(Level, Table->NumSamples, Bucket));
+        Sum += Means[Bucket] * Samples;
+        Count += Samples;
+    }
+    if (Count > 0.0)
+    {
+        OutSeries.Mean.Add(static_cast<float>(Sum / Count));
+    }
+    return true;
+}
+
+const FSessionPyramidTable* FSessionPyramid::FindTable(ESessionChannel Channel, uint8 Device) const
+{
+    for (const FSessionPyramidTable& Table : Tables)
+    {
+        if (Table.Channel == Channel && Table.Device == Device)
+        {
+            return &Table;
+        }
+    }
+    return nullptr;
+}
+
+FString FSessionPyramid::GetPyramidPath(const FString& SessionPath)
+{
+    return FPaths::ChangeExtension(SessionPath, TEXT("wvpyramid"));
+}
+
+bool FSessionPyramid::BuildForSession(const FString& SessionPath, bool bForce, bool& OutBuilt, FString& OutError)
+{
+    OutBuilt = false;
+    const FString PyramidPath = GetPyramidPath(SessionPath);
+    const int64 Bytes = IFileManager::Get().FileSize(*SessionPath);
+    const int64 ModifiedTicks = IFileManager::Get().GetTimeStamp(*SessionPath).GetTicks();
+    if (!bForce && FPaths::FileExists(PyramidPath))
+    {
+        FSessionPyramid Existing;
+        FString Ignored;
+        if (Existing.Load(PyramidPath, Ignored) && Existing.SourceBytes == Bytes && Existing.SourceModifiedTicks == ModifiedTicks)
+        {
+            return true;
+        }
+    }
+
+    FSessionFile File;
+    if (!ReadSource(SessionPath, File, OutError) || !BuildForSession(SessionPath, File, OutError))
+    {
+        return false;
+    }
+    OutBuilt = true;
+    return true;
+}
+
+bool FSessionPyramid::BuildForSession(const FString& SessionPath, const FSessionFile& File, FString& OutError)
+{
+    FSessionPyramid Pyramid;
+    Pyramid.Build(File, false);
+    if (Pyramid.Tables.Num() == 0)
+    {
+        OutError = TEXT("没有连续通道的数据");
+        return false;
+    }
+    Pyramid.SourceBytes = IFileManager::Get().FileSize(*SessionPath);
+    Pyramid.SourceModifiedTicks = IFileManager::Get().GetTimeStamp(*SessionPath).GetTicks();
+    return Pyramid.Save(GetPyramidPath(SessionPath), OutError);
+}
+
+bool FSessionPyramid::ReadSource(const FString& SessionPath, FSessionFile& OutFile, FString& OutError)
+{
+    if (FPaths::GetExtension(SessionPath).ToLower() == TEXT("wvsession"))
+    {
+        return FSessionRecorder::ReadFile(SessionPath, OutFile, OutError);
+    }
+
+    FImportedTable Table;
+    if (!FSessionImporter::Load(SessionPath, Table, OutError))
+    {
+        return false;
+    }
+    FSessionImporter::ToSessionFile(Table, OutFile);
+    return true;
+}
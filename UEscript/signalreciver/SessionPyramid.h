@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SessionRecorder.h"
+
+/** 金字塔的一层：每个桶是连续 SamplesPerBucket 个样本的最小值、最大值和均值 */
+struct FSessionPyramidLevel
+{
+    /** 每个桶的样本数（最后一个桶可能不满）*/
+    int64 SamplesPerBucket = 1;
+
+    /** 每个桶第一个样本的时间（共享时钟，秒）*/
+    TArray<double> Time;
+
+    /** 按列存放，每列每个桶一个值；原始样本层（SamplesPerBucket 为 1）只有 Mean */
+    TArray<TArray<float>> Min;
+    TArray<TArray<float>> Max;
+    TArray<TArray<float>> Mean;
+
+    int32 NumBuckets() const { return Time.Num(); }
+};
+
+/** 一个 (通道, 设备) 的金字塔，各层由细到粗 */
+struct FSessionPyramidTable
+{
+    ESessionChannel Channel = ESessionChannel::Gsr;
+    uint8 Device = 0;
+
+    /** 数值列数（FSessionRecorder::GetValueCount）*/
+    int32 NumColumns = 0;
+
+    int64 NumSamples = 0;
+    double StartTime = 0.0;
+    double EndTime = 0.0;
+
+    TArray<FSessionPyramidLevel> Levels;
+};
+
+/** 查询结果：每个像素一个点，没有样本的像素不输出 */
+struct FSessionPyramidSeries
+{
+    /** 像素内第一个样本的时间 */
+    TArray<double> Time;
+
+    TArray<float> Min;
+    TArray<float> Max;
+    TArray<float> Mean;
+
+    /** 使用的层（FSessionPyramidTable::Levels 的下标）和它每个桶的样本数 */
+    int32 Level = 0;
+    int64 SamplesPerBucket = 1;
+
+    /** 读取的桶数，不超过像素数 × Fanout（缩放到比最细的层还细时为范围内的桶数）*/
+    int32 BucketsRead = 0;
+};
+
+/**
+ * 会话时间线的多分辨率金字塔，用于快速绘制长会话（替代在 MATLAB 中绘制每个样本）
+ * 每个连续通道（不含 Event）的每个数值列按样本数分层：第 1 层每 BaseBucket 个样本一个桶，之后每层把 Fanout 个桶合并为一个，
+ * 直到不多于 Fanout 个桶；每个桶保存最小值、最大值和均值，各层合计约为样本数的 1 / 12 个桶
+ * 查询给定时间范围和像素宽度时，从最粗的层开始找到第一个在范围内每个像素至少有一个桶的层，再按时间把桶归入像素，
+ * 读取的桶数与像素数成正比，与范围内的样本数无关
+ * 保存在会话旁边的 <会话名>.wvpyramid（FSessionPyramid::GetPyramidPath），只写聚合层；内存中构建时可以保留原始样本层，
+ * 放大到单个样本时仍然精确
+ *
+ * 文件格式（小端）：
+ *   文件头："WVPYRMD" + 版本 u8 | 源文件大小 i64 | 源文件修改时间 i64（FDateTime ticks）| BaseBucket u32 | Fanout u32 | 表数 u32
+ *   每个表： 通道 u8 | 设备 u8 | 列数 u8 | 保留 u8 | 样本数 i64 | 开始时间 f64 | 结束时间 f64 | 层数 u32
+ *   每层：   每桶样本数 i64 | 桶数 u32 | 时间 f64[] | 各列最小值 f32[] | 各列最大值 f32[] | 各列均值 f32[]
+ */
+class WORKVOILENCEGAME_API FSessionPyramid
+{
+public:
+    static constexpr int32 FileVersion = 1;
+
+    /** 第 1 层每个桶的样本数 */
+    static constexpr int32 BaseBucket = 16;
+
+    /** 相邻两层桶数之比 */
+    static constexpr int32 Fanout = 4;
+
+    /** 源文件的大小和修改时间，BuildForSession 用它判断金字塔是否过期 */
+    int64 SourceBytes = 0;
+    int64 SourceModifiedTicks = 0;
+
+    /** 由会话记录构建；bKeepSamples 时保留原始样本作为第 0 层 */
+    void Build(const FSessionFile& File, bool bKeepSamples);
+
+    bool Save(const FString& Path, FString& OutError) const;
+
+    bool Load(const FString& Path, FString& OutError);
+
+    /**
+     * 取 [StartTime, EndTime) 内 Column 列的序列，每个像素最多一个点
+     * 没有这个通道或设备、列号越界、范围为空或像素数不为正时返回 false
+     */
+    bool Query(ESessionChannel Channel, uint8 Device, int32 Column, double StartTime, double EndTime, int32 Pixels,
+        FSessionPyramidSeries& OutSeries) const;
+
+    const FSessionPyramidTable* FindTable(ESessionChannel Channel, uint8 Device) const;
+
+    const TArray<FSessionPyramidTable>& GetTables() const { return Tables; }
+
+    /** <会话名>.wvpyramid */
+    static FString GetPyramidPath(const FString& SessionPath);
+
+    /**
+     * 读取会话文件（.wvsession，或 FSessionImporter 支持的旧数据），构建并保存到 GetPyramidPath；
+     * 已有的金字塔与源文件大小和修改时间一致时不重建（bForce 时总是重建），OutBuilt 表示是否重建
+     */
+    static bool BuildForSession(const FString& SessionPath, bool bForce, bool& OutBuilt, FString& OutError);
+
+    /** 会话记录已经读入时使用：总是重建并保存到 GetPyramidPath，不再读一遍文件 */
+    static bool BuildForSession(const FString& SessionPath, const FSessionFile& File, FString& OutError);
+
+    /** 读取会话记录；旧数据由 FSessionImporter 导入后转换（FSessionImporter::ToSessionFile）*/
+    static bool ReadSource(const FString& SessionPath, FSessionFile& OutFile, FString& OutError);
+
+private:
+    TArray<FSessionPyramidTable> Tables;
+};
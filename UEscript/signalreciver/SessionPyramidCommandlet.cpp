@@ -0,0 +1,314 @@
+#include "SessionPyramidCommandlet.h"
+#include "SessionPyramid.h"
+#include "SessionIndex.h"
+#include "ParallelWorkers.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+
+namespace
+{
+    /** 一个会话的构建结果 */
+    struct FBuildResult
+    {
+        FString Path;
+        bool bSucceeded = false;
+        bool bBuilt = false;
+        FString Error;
+        double Seconds = 0.0;
+    };
+
+    /** 对照的每个像素：逐个样本取最小值、最大值和均值 */
+    struct FPixelScan
+    {
+        TArray<float> Min;
+        TArray<float> Max;
+        TArray<float> Mean;
+        int32 Samples = 0;
+    };
+
+    /** 对照：二分查找范围后把范围内的每个样本按时间归入像素（绘制每个样本时的工作量）*/
+    void ScanSamples(const TArray<double>& Time, const TArray<float>& Values, double StartTime, double EndTime, int32 Pixels, FPixelScan& OutScan)
+    {
+        OutScan.Min.Init(MAX_flt, Pixels);
+        OutScan.Max.Init(-MAX_flt, Pixels);
+        OutScan.Mean.Init(0.0f, Pixels);
+        OutScan.Samples = 0;
+        TArray<double> Sums;
+        TArray<int32> Counts;
+        Sums.Init(0.0, Pixels);
+        Counts.Init(0, Pixels);
+
+        int32 Low = 0;
+        int32 High = Time.Num();
+        while (Low < High)
+        {
+            const int32 Middle = (Low + High) / 2;
+            if (Time[Middle] < StartTime)
+            {
+                Low = Middle + 1;
+            }
+            else
+            {
+                High = Middle;
+            }
+        }
+
+        const double PixelWidth = (EndTime - StartTime) / Pixels;
+        for (int32 Index = Low; Index < Time.Num() && Time[Index] < EndTime; Index++)
+        {
+            const int32 Pixel = FMath::Min(FMath::FloorToInt((Time[Index] - StartTime) / PixelWidth), Pixels - 1);
+            OutScan.Min[Pixel] = FMath::Min(OutScan.Min[Pixel], Values[Index]);
+            OutScan.Max[Pixel] = FMath::Max(OutScan.Max[Pixel], Values[Index]);
+            Sums[Pixel] += Values[Index];
+            Counts[Pixel]++;
+            OutScan.Samples++;
+        }
+        for (int32 Pixel = 0; Pixel < Pixels; Pixel++)
+        {
+            OutScan.Mean[Pixel] = Counts[Pixel] > 0 ? static_cast<float>(Sums[Pixel] / Counts[Pixel]) : 0.0f;
+        }
+    }
+
+    float MinOf(const TArray<float>& Values)
+    {
+        float Result = MAX_flt;
+        for (const float Value : Values)
+        {
+            Result = FMath::Min(Result, Value);
+        }
+        return Result;
+    }
+
+    float MaxOf(const TArray<float>& Values)
+    {
+        float Result = -MAX_flt;
+        for (const float Value : Values)
+        {
+            Result = FMath::Max(Result, Value);
+        }
+        return Result;
+    }
+
+    /** 逐级放大比较金字塔查询和逐样本扫描，返回不一致的次数 */
+    int32 Benchmark(const FString& Path, ESessionChannel Channel, uint8 Device, int32 Column, int32 Pixels, int32 Repeat)
+    {
+        FSessionPyramid Saved;
+        FSessionFile File;
+        FString Error;
+        if (!Saved.Load(FSessionPyramid::GetPyramidPath(Path), Error) || !FSessionPyramid::ReadSource(Path, File, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("  %s: %s"), *Path, *Error);
+            return 1;
+        }
+
+        // 保留原始样本层的金字塔：第 0 层就是逐样本扫描的数据
+        FSessionPyramid Full;
+        Full.Build(File, true);
+        const FSessionPyramidTable* Table = Full.FindTable(Channel, Device);
+        if (!Table || Column >= Table->NumColumns)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("  %s: 没有 %s%d 的第 %d 列"), *FPaths::GetCleanFilename(Path),
+                FSessionRecorder::GetChannelName(Channel), Device, Column);
+            return 0;
+        }
+        const TArray<double>& Time = Table->Levels[0].Time;
+        const TArray<float>& Values = Table->Levels[0].Mean[Column];
+
+        UE_LOG(LogTemp, Display, TEXT("  %s：%s.%s，%lld 个样本，%.1f min，%d 层"), *FPaths::GetCleanFilename(Path),
+            FSessionRecorder::GetChannelName(Channel), FSessionRecorder::GetValueName(Channel, Column), Table->NumSamples,
+            (Table->EndTime - Table->StartTime) / 60.0, Saved.FindTable(Channel, Device)->Levels.Num());
+
+        int32 Mismatches = 0;
+        const double Center = 0.5 * (Table->StartTime + Table->EndTime);
+        const double Duration = Table->EndTime - Table->StartTime;
+        for (int32 Zoom = 1; Zoom <= 4096; Zoom *= 8)
+        {
+            // 整段时结束时间稍微后移，让最后一个样本落在范围内
+            const double StartTime = Zoom == 1 ? Table->StartTime : Center - 0.5 * Duration / Zoom;
+            const double EndTime = Zoom == 1 ? Table->EndTime + Duration * 1e-9 + 1e-9 : Center + 0.5 * Duration / Zoom;
+
+            FSessionPyramidSeries Series;
+            uint64 Start = FPlatformTime::Cycles64();
+            for (int32 Pass = 0; Pass < Repeat; Pass++)
+            {
+                Saved.Query(Channel, Device, Column, StartTime, EndTime, Pixels, Series);
+            }
+            const double QuerySeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start) / Repeat;
+
+            FPixelScan Scan;
+            Start = FPlatformTime::Cycles64();
+            for (int32 Pass = 0; Pass < Repeat; Pass++)
+            {
+                ScanSamples(Time, Values, StartTime, EndTime, Pixels, Scan);
+            }
+            const double ScanSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start) / Repeat;
+
+            // 整段查询覆盖所有样本，最小值和最大值必须与原始样本相同
+            bool bExact = true;
+            if (Zoom == 1)
+            {
+                bExact = MinOf(Series.Min) == MinOf(Values) && MaxOf(Series.Max) == MaxOf(Values);
+                Mismatches += bExact ? 0 : 1;
+            }
+            UE_LOG(LogTemp, Display, TEXT("    1/%-5d %8d 个样本：金字塔第 %d 层（每桶 %lld 个样本）读 %5d 个桶 → %4d 点 %8.1f µs，逐样本 %9.1f µs（%.0f 倍）%s"),
+                Zoom, Scan.Samples, Series.Level, Series.SamplesPerBucket, Series.BucketsRead, Series.Time.Num(),
+                QuerySeconds * 1e6, ScanSeconds * 1e6, QuerySeconds > 0.0 ? ScanSeconds / QuerySeconds : 0.0,
+                Zoom == 1 ? (bExact ? TEXT("，最值一致") : TEXT("，最值不一致")) : TEXT(""));
+        }
+        return Mismatches;
+    }
+}
+
+USessionPyramidCommandlet::USessionPyramidCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 USessionPyramidCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Arguments;
+    TArray<FString> Switches;
+    ParseCommandLine(*Params, Arguments, Switches);
+
+    FString IndexPath = FSessionIndex::GetDefaultPath();
+    FString ChannelName = TEXT("Gsr");
+    FString ColumnName = TEXT("Conductance");
+    int32 Device = 0;
+    int32 Pixels = 1920;
+    int32 Repeat = 20;
+    int32 NumThreads = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    FParse::Value(*Params, TEXT("Index="), IndexPath);
+    FParse::Value(*Params, TEXT("Channel="), ChannelName);
+    FParse::Value(*Params, TEXT("Column="), ColumnName);
+    FParse::Value(*Params, TEXT("Device="), Device);
+    FParse::Value(*Params, TEXT("Pixels="), Pixels);
+    FParse::Value(*Params, TEXT("Repeat="), Repeat);
+    FParse::Value(*Params, TEXT("Threads="), NumThreads);
+    const bool bForce = FParse::Param(*Params, TEXT("Force"));
+    const bool bBenchmark = FParse::Param(*Params, TEXT("Benchmark"));
+    NumThreads = FMath::Max(NumThreads, 1);
+    Pixels = FMath::Max(Pixels, 1);
+    Repeat = FMath::Max(Repeat, 1);
+
+    if (Arguments.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("用法: -run=SessionPyramid <目录、文件或 @条件> [...] [-Index=<索引.tsv>] [-Force] [-Threads=<线程数>] [-Benchmark] [-Pixels=1920] [-Repeat=20] [-Channel=Gsr] [-Device=0] [-Column=Conductance]"));
+        return 1;
+    }
+
+    ESessionChannel Channel = ESessionChannel::Count;
+    int32 Column = INDEX_NONE;
+    for (int32 Index = 0; Index < static_cast<int32>(ESessionChannel::Count); Index++)
+    {
+        if (ChannelName.Equals(FSessionRecorder::GetChannelName(static_cast<ESessionChannel>(Index)), ESearchCase::IgnoreCase))
+        {
+            Channel = static_cast<ESessionChannel>(Index);
+        }
+    }
+    for (int32 Index = 0; Channel != ESessionChannel::Count && Index < FSessionRecorder::GetValueCount(Channel); Index++)
+    {
+        if (ColumnName.Equals(FSessionRecorder::GetValueName(Channel, Index), ESearchCase::IgnoreCase))
+        {
+            Column = Index;
+        }
+    }
+    if (Channel == ESessionChannel::Count || Channel == ESessionChannel::Event || Column == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Error, TEXT("没有连续通道 %s 或列 %s"), *ChannelName, *ColumnName);
+        return 1;
+    }
+
+    FSessionIndex Index;
+    FString Error;
+    if (Arguments.ContainsByPredicate([](const FString& Argument) { return Argument.StartsWith(TEXT("@")); })
+        && !Index.Load(IndexPath, Error))
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+        return 1;
+    }
+
+    int32 Failures = 0;
+    TArray<FBuildResult> Results;
+    for (const FString& Argument : Arguments)
+    {
+        TArray<FString> Paths;
+        if (!Index.SelectInputs(Argument, Paths, Error))
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+            Failures++;
+            continue;
+        }
+        for (const FString& Path : Paths)
+        {
+            Results.AddDefaulted_GetRef().Path = Path;
+        }
+    }
+    if (Results.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("没有可处理的文件"));
+        return 1;
+    }
+
+    // === 构建 ===
+
+    const uint64 BuildStart = FPlatformTime::Cycles64();
+    FParallelWorkers::ForEach(Results.Num(), NumThreads, TEXT("SessionPyramid"), [&Results, bForce](int32 Job)
+    {
+        FBuildResult& Result = Results[Job];
+        const uint64 Start = FPlatformTime::Cycles64();
+        Result.bSucceeded = FSessionPyramid::BuildForSession(Result.Path, bForce, Result.bBuilt, Result.Error);
+        Result.Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - Start);
+    });
+
+    int32 Built = 0;
+    int32 UpToDate = 0;
+    int64 SessionBytes = 0;
+    int64 PyramidBytes = 0;
+    for (const FBuildResult& Result : Results)
+    {
+        if (!Result.bSucceeded)
+        {
+            UE_LOG(LogTemp, Error, TEXT("  %s: %s"), *Result.Path, *Result.Error);
+            Failures++;
+            continue;
+        }
+        const int64 Bytes = IFileManager::Get().FileSize(*FSessionPyramid::GetPyramidPath(Result.Path));
+        SessionBytes += IFileManager::Get().FileSize(*Result.Path);
+        PyramidBytes += Bytes;
+        if (!Result.bBuilt)
+        {
+            UpToDate++;
+        }
+        else
+        {
+            Built++;
+            UE_LOG(LogTemp, Display, TEXT("  %s → %s（%.1f KB，%.1f ms）"), *FPaths::GetCleanFilename(Result.Path),
+                *FPaths::GetCleanFilename(FSessionPyramid::GetPyramidPath(Result.Path)), Bytes / 1024.0, Result.Seconds * 1000.0);
+        }
+    }
+    UE_LOG(LogTemp, Display, TEXT("构建 %d 个金字塔（%d 个已是最新），用时 %.3f s；金字塔共 %.1f KB，为会话文件的 %.1f%%"),
+        Built, UpToDate, FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - BuildStart),
+        PyramidBytes / 1024.0, SessionBytes > 0 ? 100.0 * PyramidBytes / SessionBytes : 0.0);
+
+    // === 查询耗时 ===
+
+    if (bBenchmark)
+    {
+        UE_LOG(LogTemp, Display, TEXT("查询 %d 像素，每项 %d 次取平均："), Pixels, Repeat);
+        for (const FBuildResult& Result : Results)
+        {
+            if (Result.bSucceeded)
+            {
+                Failures += Benchmark(Result.Path, Channel, static_cast<uint8>(Device), Column, Pixels, Repeat);
+            }
+        }
+    }
+
+    return Failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SessionPyramidCommandlet.generated.h"
+
+/**
+ * 为会话构建时间线金字塔（FSessionPyramid），写到会话旁边的 <会话名>.wvpyramid，供编辑器内或外部的查看器按像素宽度取数据
+ * 位置参数与 GsrBatchAnalysis 相同：目录、单个文件或 @<条件>（从 -Index 会话索引选取）；金字塔与源文件一致时跳过（-Force 时重建）
+ * OSCReceiver 结束记录时会自动构建，这里用于已有的会话和 Experiment 下的旧数据
+ * -Benchmark：对每个会话的 -Channel / -Device / -Column 序列，从整段依次放大到 1/8、1/64、1/512、1/4096，
+ *   比较金字塔查询与逐个样本按像素取最小 / 最大 / 均值的耗时（各 -Repeat 次取平均），并检查整段的最小值和最大值与原始样本相同
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=SessionPyramid <目录、文件或 @条件> [...] [-Index=<索引.tsv>] [-Force]
+ *       [-Threads=<线程数>] [-Benchmark] [-Pixels=1920] [-Repeat=20] [-Channel=Gsr] [-Device=0] [-Column=Conductance]
+ */
+UCLASS()
+class WORKVOILENCEGAME_API USessionPyramidCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USessionPyramidCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,676 @@
+#include "SessionRecorder.h"
+#include "GorillaCodec.h"
+#include "HAL/FileManager.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Compression.h"
+#include "Misc/Crc.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    const uint8 FileMagic[7] = { 'W', 'V', 'S', 'E', 'S', 'S', 'N' };
+    const uint8 ChunkMagic[4] = { 'W', 'V', 'C', 'K' };
+
+    /** 文件头：魔数 7 + 版本 1 + 开始时间 8 + UTC ticks 8 */
+    constexpr int32 FileHeaderBytes = 24;
+
+    /** 块头：魔数 4 + 通道/设备/编码/保留 4 + 行数/原始字节数/存储字节数/CRC 16 */
+    constexpr int32 ChunkHeaderBytes = 24;
+
+    /** 后台线程空闲时的轮询间隔（秒）*/
+    constexpr float WriterPollInterval = 0.02f;
+
+    const TCHAR* const ControllerValues[] = { TEXT("JoystickX"), TEXT("JoystickY"), TEXT("Pressure1"), TEXT("Pressure2"),
+        TEXT("AccelX"), TEXT("AccelY"), TEXT("AccelZ"), TEXT("GyroX"), TEXT("GyroY"), TEXT("GyroZ") };
+    const TCHAR* const HandleSampleValues[] = { TEXT("JoystickX"), TEXT("JoystickY"), TEXT("Pressure2") };
+    const TCHAR* const GsrValues[] = { TEXT("Raw"), TEXT("Resistance"), TEXT("Conductance") };
+    const TCHAR* const EventValues[] = { TEXT("Type"), TEXT("TrialIndex") };
+
+    template <typename T>
+    void AppendValue(TArray<uint8>& Out, const T& Value)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+    }
+
+    template <typename T>
+    void AppendColumn(TArray<uint8>& Out, const TArray<T>& Column)
+    {
+        Out.Append(reinterpret_cast<const uint8*>(Column.GetData()), Column.Num() * sizeof(T));
+    }
+
+    void AppendFileHeader(TArray<uint8>& Out, double SessionStart, const FDateTime& StartedAt)
+    {
+        Out.Append(FileMagic, sizeof(FileMagic));
+        Out.Add(static_cast<uint8>(FSessionRecorder::FileVersion));
+        AppendValue(Out, SessionStart);
+        AppendValue(Out, StartedAt.GetTicks());
+    }
+
+    template <typename T>
+    T ReadValue(const uint8* Data)
+    {
+        T Value;
+        FMemory::Memcpy(&Value, Data, sizeof(T));
+        return Value;
+    }
+
+    /** 从负载中取出一列，越界返回 false */
+    template <typename T>
+    bool ReadColumn(const TArray<uint8>& Payload, int32& Offset, int32 Rows, TArray<T>& OutColumn)
+    {
+        const int64 Bytes = static_cast<int64>(Rows) * sizeof(T);
+        if (Offset + Bytes > Payload.Num())
+        {
+            return false;
+        }
+        OutColumn.SetNumUninitialized(Rows);
+        FMemory::Memcpy(OutColumn.GetData(), Payload.GetData() + Offset, Bytes);
+        Offset += static_cast<int32>(Bytes);
+        return true;
+    }
+}
+
+// === 列块 ===
+
+void FSessionChunk::AddRecord(const FSessionRecord& Record)
+{
+    Time.Add(Record.Time);
+    if (FSessionRecorder::HasDeviceTime(Channel))
+    {
+        DeviceTime.Add(Record.DeviceTime);
+    }
+    const int32 ValueCount = FSessionRecorder::GetValueCount(Channel);
+    for (int32 Index = 0; Index < ValueCount; Index++)
+    {
+        Values[Index].Add(Record.Values[Index]);
+    }
+    if (FSessionRecorder::HasButtons(Channel))
+    {
+        Buttons.Add(Record.Buttons);
+    }
+}
+
+void FSessionChunk::Reset()
+{
+    // 保留内存，下一块继续使用
+    Time.Reset();
+    DeviceTime.Reset();
+    for (TArray<float>& Column : Values)
+    {
+        Column.Reset();
+    }
+    Buttons.Reset();
+    Names.Reset();
+}
+
+// === 通道定义 ===
+
+const TCHAR* FSessionRecorder::GetChannelName(ESessionChannel Channel)
+{
+    switch (Channel)
+    {
+    case ESessionChannel::Controller: return TEXT("Controller");
+    case ESessionChannel::HandleSample: return TEXT("HandleSample");
+    case ESessionChannel::Gsr: return TEXT("Gsr");
+    case ESessionChannel::Event: return TEXT("Event");
+    default: return TEXT("Unknown");
+    }
+}
+
+int32 FSessionRecorder::GetValueCount(ESessionChannel Channel)
+{
+    switch (Channel)
+    {
+    case ESessionChannel::Controller: return UE_ARRAY_COUNT(ControllerValues);
+    case ESessionChannel::HandleSample: return UE_ARRAY_COUNT(HandleSampleValues);
+    case ESessionChannel::Gsr: return UE_ARRAY_COUNT(GsrValues);
+    case ESessionChannel::Event: return UE_ARRAY_COUNT(EventValues);
+    default: return 0;
+    }
+}
+
+const TCHAR* FSessionRecorder::GetValueName(ESessionChannel Channel, int32 Index)
+{
+    if (Index < 0 || Index >= GetValueCount(Channel))
+    {
+        return TEXT("");
+    }
+    switch (Channel)
+    {
+    case ESessionChannel::Controller: return ControllerValues[Index];
+    case ESessionChannel::HandleSample: return HandleSampleValues[Index];
+    case ESessionChannel::Gsr: return GsrValues[Index];
+    default: return EventValues[Index];
+    }
+}
+
+bool FSessionRecorder::HasDeviceTime(ESessionChannel Channel)
+{
+    return Channel == ESessionChannel::HandleSample || Channel == ESessionChannel::Gsr;
+}
+
+bool FSessionRecorder::HasButtons(ESessionChannel Channel)
+{
+    return Channel == ESessionChannel::Controller;
+}
+
+// === 记录 ===
+
+FSessionRecorder::FSessionRecorder()
+{
+}
+
+FSessionRecorder::~FSessionRecorder()
+{
+    Shutdown();
+}
+
+bool FSessionRecorder::Start(const FString& InPath, double SessionStartTime)
+{
+    if (Thread)
+    {
+        return true;
+    }
+
+    Writer = IFileManager::Get().CreateFileWriter(*InPath);
+    if (!Writer)
+    {
+        UE_LOG(LogTemp, Error, TEXT("无法创建会话记录文件: %s"), *InPath);
+        return false;
+    }
+    Path = InPath;
+
+    TArray<uint8> Header;
+    AppendFileHeader(Header, SessionStartTime, FDateTime::UtcNow());
+    Writer->Serialize(Header.GetData(), Header.Num());
+    Writer->Flush();
+    BytesWritten = Header.Num();
+
+    // 游戏线程只做一次拷贝，所有内存在这里分配好
+    const int32 Capacity = static_cast<int32>(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(StagingCapacity, 1024))));
+    Staging.SetNum(Capacity);
+    StagingMask = static_cast<uint64>(Capacity - 1);
+    Head = 0;
+    Tail = 0;
+    DroppedCount = 0;
+    ChunkCount = 0;
+    MaxQueued = 0;
+    Pending.Reset();
+
+    bStopRequested = false;
+    Thread = FRunnableThread::Create(this, TEXT("SessionRecorder"), 0, TPri_BelowNormal);
+    UE_LOG(LogTemp, Log, TEXT("会话记录: %s"), *Path);
+    return true;
+}
+
+void FSessionRecorder::Shutdown()
+{
+    if (Thread)
+    {
+        // Run 退出前会写出所有剩余的块
+        Stop();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+
+        UE_LOG(LogTemp, Log, TEXT("会话记录结束: %lld 行，%lld 块，%lld 字节，丢弃 %lld 行"),
+            GetRecordCount(), GetChunkCount(), GetBytesWritten(), GetDroppedCount());
+    }
+
+    if (Writer)
+    {
+        Writer->Close();
+        delete Writer;
+        Writer = nullptr;
+    }
+}
+
+bool FSessionRecorder::Push(const FSessionRecord& Record)
+{
+    if (!Thread)
+    {
+        return false;
+    }
+
+    const uint64 Write = Head.Load(EMemoryOrder::Relaxed);
+    if (Write - Tail.Load() > StagingMask)
+    {
+        // 后台线程跟不上时丢弃，不能阻塞游戏线程
+        DroppedCount++;
+        return false;
+    }
+    Staging[static_cast<int32>(Write & StagingMask)] = Record;
+    Head = Write + 1;
+    return true;
+}
+
+void FSessionRecorder::PushEvent(double Time, uint8 Type, int32 TrialIndex, const FString& Name)
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    FEventRecord Event;
+    Event.Time = Time;
+    Event.Type = Type;
+    Event.TrialIndex = TrialIndex;
+    Event.Name = Name;
+    Events.Enqueue(MoveTemp(Event));
+}
+
+uint32 FSessionRecorder::Run()
+{
+    while (!bStopRequested)
+    {
+        Drain(false);
+        FPlatformProcess::Sleep(WriterPollInterval);
+    }
+    Drain(true);
+    return 0;
+}
+
+void FSessionRecorder::Drain(bool bFlushAll)
+{
+    const uint64 End = Head.Load();
+    uint64 Read = Tail.Load(EMemoryOrder::Relaxed);
+    if (static_cast<int64>(End - Read) > MaxQueued)
+    {
+        MaxQueued = static_cast<int64>(End - Read);
+    }
+
+    for (; Read != End; Read++)
+    {
+        AddToChunk(Staging[static_cast<int32>(Read & StagingMask)], nullptr);
+
+        // 尽早归还空间
+        if ((Read & 1023) == 1023)
+        {
+            Tail = Read + 1;
+        }
+    }
+    Tail = End;
+
+    FEventRecord Event;
+    while (Events.Dequeue(Event))
+    {
+        FSessionRecord Record;
+        Record.Time = Event.Time;
+        Record.Channel = ESessionChannel::Event;
+        Record.Values[0] = Event.Type;
+        Record.Values[1] = static_cast<float>(Event.TrialIndex);
+        AddToChunk(Record, &Event.Name);
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    for (TPair<uint16, FPendingChunk>& Pair : Pending)
+    {
+        FPendingChunk& Entry = Pair.Value;
+        if (Entry.Chunk.NumRows() > 0 && (bFlushAll || Now - Entry.OpenedAt >= ChunkSeconds))
+        {
+            WriteChunk(Entry.Chunk);
+        }
+    }
+}
+
+void FSessionRecorder::AddToChunk(const FSessionRecord& Record, const FString* Name)
+{
+    const uint16 Key = static_cast<uint16>(static_cast<uint16>(Record.Channel) << 8 | Record.Device);
+    FPendingChunk& Entry = Pending.FindOrAdd(Key);
+    if (Entry.Chunk.NumRows() == 0)
+    {
+        Entry.Chunk.Channel = Record.Channel;
+        Entry.Chunk.Device = Record.Device;
+        Entry.OpenedAt = FPlatformTime::Seconds();
+    }
+
+    Entry.Chunk.AddRecord(Record);
+    if (Name)
+    {
+        Entry.Chunk.Names.Add(*Name);
+    }
+
+    if (Entry.Chunk.NumRows() >= ChunkRows)
+    {
+        WriteChunk(Entry.Chunk);
+    }
+}
+
+void FSessionRecorder::WriteChunk(FSessionChunk& Chunk)
+{
+    EncodeChunk(Chunk, Codec, EncodeBuffer);
+    Writer->Serialize(EncodeBuffer.GetData(), EncodeBuffer.Num());
+
+    // 每块写完都交给操作系统，进程崩溃时已写出的块不会丢失
+    Writer->Flush();
+
+    BytesWritten += EncodeBuffer.Num();
+    ChunkCount++;
+    Chunk.Reset();
+}
+
+// === 文件格式 ===
+
+namespace
+{
+    void AppendNames(TArray<uint8>& Out, const FSessionChunk& Chunk)
+    {
+        for (int32 Row = 0; Row < Chunk.NumRows(); Row++)
+        {
+            const FTCHARToUTF8 Name(Chunk.Names.IsValidIndex(Row) ? *Chunk.Names[Row] : TEXT(""));
+            const uint16 Length = static_cast<uint16>(FMath::Min(Name.Length(), 65535));
+            AppendValue(Out, Length);
+            Out.Append(reinterpret_cast<const uint8*>(Name.Get()), Length);
+        }
+    }
+
+    bool ReadNames(const uint8* Data, int32 NumBytes, int32& Offset, int32 Rows, TArray<FString>& OutNames)
+    {
+        for (int32 Row = 0; Row < Rows; Row++)
+        {
+            if (Offset + 2 > NumBytes)
+            {
+                return false;
+            }
+            const uint16 Length = ReadValue<uint16>(Data + Offset);
+            if (Offset + 2 + Length > NumBytes)
+            {
+                return false;
+            }
+            const FUTF8ToTCHAR Name(reinterpret_cast<const ANSICHAR*>(Data + Offset + 2), Length);
+            OutNames.Add(FString(Name.Length(), Name.Get()));
+            Offset += 2 + Length;
+        }
+        return true;
+    }
+
+    /** 原始列数据：按列拼接，同一列的相邻值相近，压缩率比按行高得多 */
+    void AppendRawColumns(TArray<uint8>& Out, const FSessionChunk& Chunk)
+    {
+        AppendColumn(Out, Chunk.Time);
+        if (FSessionRecorder::HasDeviceTime(Chunk.Channel))
+        {
+            AppendColumn(Out, Chunk.DeviceTime);
+        }
+        for (int32 Index = 0; Index < FSessionRecorder::GetValueCount(Chunk.Channel); Index++)
+        {
+            AppendColumn(Out, Chunk.Values[Index]);
+        }
+        if (FSessionRecorder::HasButtons(Chunk.Channel))
+        {
+            AppendColumn(Out, Chunk.Buttons);
+        }
+    }
+
+    void AppendGorillaColumns(TArray<uint8>& Out, const FSessionChunk& Chunk)
+    {
+        const int32 Rows = Chunk.NumRows();
+        FGorillaBitWriter Writer(Out);
+        FGorillaCodec::EncodeTimestamps(Chunk.Time.GetData(), Rows, Writer);
+        if (FSessionRecorder::HasDeviceTime(Chunk.Channel))
+        {
+            FGorillaCodec::EncodeTimestamps(Chunk.DeviceTime.GetData(), Rows, Writer);
+        }
+        for (int32 Index = 0; Index < FSessionRecorder::GetValueCount(Chunk.Channel); Index++)
+        {
+            FGorillaCodec::EncodeFloats(Chunk.Values[Index].GetData(), Rows, Writer);
+        }
+        if (FSessionRecorder::HasButtons(Chunk.Channel))
+        {
+            FGorillaCodec::EncodeBytes(Chunk.Buttons.GetData(), Rows, Writer);
+        }
+        Writer.Flush();
+    }
+
+    bool ReadGorillaColumns(const uint8* Data, int32 NumBytes, int32& Offset, int32 Rows, FSessionChunk& OutChunk)
+    {
+        FGorillaBitReader Reader(Data, NumBytes);
+        OutChunk.Time.SetNumUninitialized(Rows);
+        bool bValid = FGorillaCodec::DecodeTimestamps(Reader, Rows, OutChunk.Time.GetData());
+        if (bValid && FSessionRecorder::HasDeviceTime(OutChunk.Channel))
+        {
+            OutChunk.DeviceTime.SetNumUninitialized(Rows);
+            bValid = FGorillaCodec::DecodeTimestamps(Reader, Rows, OutChunk.DeviceTime.GetData());
+        }
+        for (int32 Index = 0; bValid && Index < FSessionRecorder::GetValueCount(OutChunk.Channel); Index++)
+        {
+            OutChunk.Values[Index].SetNumUninitialized(Rows);
+            bValid = FGorillaCodec::DecodeFloats(Reader, Rows, OutChunk.Values[Index].GetData());
+        }
+        if (bValid && FSessionRecorder::HasButtons(OutChunk.Channel))
+        {
+            OutChunk.Buttons.SetNumUninitialized(Rows);
+            bValid = FGorillaCodec::DecodeBytes(Reader, Rows, OutChunk.Buttons.GetData());
+        }
+        Offset = Reader.GetBytePosition();
+        return bValid;
+    }
+}
+
+int64 FSessionRecorder::GetRawColumnBytes(ESessionChannel Channel, int32 Rows)
+{
+    return static_cast<int64>(Rows) * (sizeof(double) * (HasDeviceTime(Channel) ? 2 : 1)
+        + sizeof(float) * GetValueCount(Channel) + (HasButtons(Channel) ? 1 : 0));
+}
+
+void FSessionRecorder::EncodeChunk(const FSessionChunk& Chunk, ESessionCodec InCodec, TArray<uint8>& OutData)
+{
+    const int32 Rows = Chunk.NumRows();
+
+    // Gorilla 块只需要原始列数据的大小，不必拼接一份原始数据
+    const int32 RawBytes = static_cast<int32>(GetRawColumnBytes(Chunk.Channel, Rows));
+
+    TArray<uint8> Raw;
+    TArray<uint8> Encoded;
+    ESessionCodec Codec = InCodec;
+    if (Codec == ESessionCodec::Gorilla)
+    {
+        Encoded.Reserve(RawBytes / 2);
+        AppendGorillaColumns(Encoded, Chunk);
+        if (Chunk.Channel == ESessionChannel::Event)
+        {
+            AppendNames(Encoded, Chunk);
+        }
+    }
+    else
+    {
+        Raw.Reserve(RawBytes);
+        AppendRawColumns(Raw, Chunk);
+        if (Chunk.Channel == ESessionChannel::Event)
+        {
+            AppendNames(Raw, Chunk);
+        }
+        int32 CompressedBytes = FCompression::CompressMemoryBound(NAME_Zlib, Raw.Num());
+        Encoded.SetNumUninitialized(CompressedBytes);
+        if (Codec == ESessionCodec::Zlib && FCompression::CompressMemory(NAME_Zlib, Encoded.GetData(), CompressedBytes, Raw.GetData(), Raw.Num())
+            && CompressedBytes < Raw.Num())
+        {
+            Encoded.SetNum(CompressedBytes);
+        }
+        else
+        {
+            Codec = ESessionCodec::Stored;
+            Encoded = MoveTemp(Raw);
+        }
+    }
+    const int32 StoredBytes = Encoded.Num();
+
+    // 块头中的原始字节数：zlib 为解压后的大小，Gorilla 为原始列数据的大小（只用于统计）
+    const int32 DecodedBytes = Codec == ESessionCodec::Gorilla ? RawBytes : Codec == ESessionCodec::Zlib ? Raw.Num() : StoredBytes;
+
+    OutData.Reset(ChunkHeaderBytes + StoredBytes);
+    OutData.Append(ChunkMagic, sizeof(ChunkMagic));
+    OutData.Add(static_cast<uint8>(Chunk.Channel));
+    OutData.Add(Chunk.Device);
+    OutData.Add(static_cast<uint8>(Codec));
+    OutData.Add(0);
+    AppendValue(OutData, static_cast<uint32>(Rows));
+    AppendValue(OutData, static_cast<uint32>(DecodedBytes));
+    AppendValue(OutData, static_cast<uint32>(StoredBytes));
+    AppendValue(OutData, FCrc::MemCrc32(Encoded.GetData(), StoredBytes));
+    OutData.Append(Encoded.GetData(), StoredBytes);
+}
+
+bool FSessionRecorder::DecodeChunkPayload(ESessionCodec InCodec, const uint8* Stored, int32 StoredBytes, int32 RawBytes, int32 Rows, FSessionChunk& OutChunk)
+{
+    if (InCodec == ESessionCodec::Gorilla)
+    {
+        int32 Offset = 0;
+        if (!ReadGorillaColumns(Stored, StoredBytes, Offset, Rows, OutChunk))
+        {
+            return false;
+        }
+        if (OutChunk.Channel == ESessionChannel::Event && !ReadNames(Stored, StoredBytes, Offset, Rows, OutChunk.Names))
+        {
+            return false;
+        }
+        return Offset == StoredBytes;
+    }
+
+    TArray<uint8> Payload;
+    if (InCodec == ESessionCodec::Stored)
+    {
+        if (StoredBytes != RawBytes)
+        {
+            return false;
+        }
+        Payload.Append(Stored, StoredBytes);
+    }
+    else if (InCodec == ESessionCodec::Zlib)
+    {
+        Payload.SetNumUninitialized(RawBytes);
+        if (!FCompression::UncompressMemory(NAME_Zlib, Payload.GetData(), RawBytes, Stored, StoredBytes))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    int32 Read = 0;
+    bool bValid = ReadColumn(Payload, Read, Rows, OutChunk.Time);
+    if (bValid && HasDeviceTime(OutChunk.Channel))
+    {
+        bValid = ReadColumn(Payload, Read, Rows, OutChunk.DeviceTime);
+    }
+    for (int32 Index = 0; bValid && Index < GetValueCount(OutChunk.Channel); Index++)
+    {
+        bValid = ReadColumn(Payload, Read, Rows, OutChunk.Values[Index]);
+    }
+    if (bValid && HasButtons(OutChunk.Channel))
+    {
+        bValid = ReadColumn(Payload, Read, Rows, OutChunk.Buttons);
+    }
+    if (bValid && OutChunk.Channel == ESessionChannel::Event)
+    {
+        bValid = ReadNames(Payload.GetData(), Payload.Num(), Read, Rows, OutChunk.Names);
+    }
+    return bValid && Read == Payload.Num();
+}
+
+bool FSessionRecorder::ReadFile(const FString& InPath, FSessionFile& OutFile, FString& OutError)
+{
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *InPath))
+    {
+        OutError = FString::Printf(TEXT("无法读取 %s"), *InPath);
+        return false;
+    }
+    if (Data.Num() < FileHeaderBytes || FMemory::Memcmp(Data.GetData(), FileMagic, sizeof(FileMagic)) != 0)
+    {
+        OutError = FString::Printf(TEXT("%s 不是会话记录文件"), *InPath);
+        return false;
+    }
+    if (Data[7] != FileVersion)
+    {
+        OutError = FString::Printf(TEXT("不支持的会话记录版本 %d"), Data[7]);
+        return false;
+    }
+
+    OutFile = FSessionFile();
+    OutFile.SessionStart = ReadValue<double>(Data.GetData() + 8);
+    OutFile.StartedAt = FDateTime(ReadValue<int64>(Data.GetData() + 16));
+
+    int32 Offset = FileHeaderBytes;
+    while (Offset < Data.Num())
+    {
+        const uint8* Header = Data.GetData() + Offset;
+        if (Data.Num() - Offset < ChunkHeaderBytes || FMemory::Memcmp(Header, ChunkMagic, sizeof(ChunkMagic)) != 0)
+        {
+            OutFile.bTruncated = true;
+            break;
+        }
+
+        const ESessionChannel Channel = static_cast<ESessionChannel>(Header[4]);
+        const uint32 Rows = ReadValue<uint32>(Header + 8);
+        const uint32 RawBytes = ReadValue<uint32>(Header + 12);
+        const uint32 StoredBytes = ReadValue<uint32>(Header + 16);
+        const uint32 Crc = ReadValue<uint32>(Header + 20);
+        const uint8* Stored = Header + ChunkHeaderBytes;
+        if (Channel >= ESessionChannel::Count || Rows > MAX_int32 || RawBytes > MAX_int32
+            || StoredBytes > static_cast<uint32>(Data.Num() - Offset - ChunkHeaderBytes)
+            || FCrc::MemCrc32(Stored, static_cast<int32>(StoredBytes)) != Crc)
+        {
+            OutFile.bTruncated = true;
+            break;
+        }
+
+        FSessionChunk& Chunk = OutFile.Chunks.AddDefaulted_GetRef();
+        Chunk.Channel = Channel;
+        Chunk.Device = Header[5];
+        if (!DecodeChunkPayload(static_cast<ESessionCodec>(Header[6]), Stored, static_cast<int32>(StoredBytes),
+            static_cast<int32>(RawBytes), static_cast<int32>(Rows), Chunk))
+        {
+            OutFile.Chunks.Pop();
+            OutFile.bTruncated = true;
+            break;
+        }
+        Offset += ChunkHeaderBytes + static_cast<int32>(StoredBytes);
+    }
+    return true;
+}
+
+bool FSessionRecorder::WriteFile(const FString& InPath, const FSessionFile& File, ESessionCodec InCodec, FString& OutError)
+{
+    TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*InPath));
+    if (!FileWriter)
+    {
+        OutError = FString::Printf(TEXT("无法创建 %s"), *InPath);
+        return false;
+    }
+
+    TArray<uint8> Data;
+    AppendFileHeader(Data, File.SessionStart, File.StartedAt);
+    FileWriter->Serialize(Data.GetData(), Data.Num());
+    for (const FSessionChunk& Chunk : File.Chunks)
+    {
+        if (Chunk.NumRows() > 0)
+        {
+            EncodeChunk(Chunk, InCodec, Data);
+            FileWriter->Serialize(Data.GetData(), Data.Num());
+        }
+    }
+    if (!FileWriter->Close())
+    {
+        OutError = FString::Printf(TEXT("写入 %s 失败"), *InPath);
+        return false;
+    }
+    return true;
+}
+
+FString FSessionRecorder::MakeUniquePath(const FString& Directory, const FString& Prefix)
+{
+    const FString Base = FPaths::Combine(Directory, Prefix + FDateTime::Now().ToString(TEXT("_%Y%m%d_%H%M%S")));
+    FString Candidate = Base + TEXT(".wvsession");
+    for (int32 Suffix = 2; FPaths::FileExists(Candidate); Suffix++)
+    {
+        Candidate = FString::Printf(TEXT("%s_%d.wvsession"), *Base, Suffix);
+    }
+    return Candidate;
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+
+class FRunnableThread;
+class FArchive;
+
+/** 会话记录的通道，每个通道按固定的列存储 */
+enum class ESessionChannel : uint8
+{
+    /** 手柄完整状态（每帧一行）：摇杆 XY、压力 1/2、加速度 XYZ、陀螺仪 XYZ、按钮 */
+    Controller,
+
+    /** 手柄定时采样（/avatar/input/samples）：设备时间、摇杆 XY、压力 2 */
+    HandleSample,
+
+    /** 皮肤电：设备时间、ADC 原始值、电阻、电导 */
+    Gsr,
+
+    /** 试次事件：类型、试次序号、名称 */
+    Event,
+
+    Count
+};
+
+/** 列块的编码方式（写在块头里）*/
+enum class ESessionCodec : uint8
+{
+    /** 原始列数据 zlib 压缩 */
+    Zlib = 0,
+
+    /** 原始列数据（zlib 没有收益时自动使用）*/
+    Stored = 1,
+
+    /** 时间戳二阶差分、数值异或、按钮位图按位编码（FGorillaCodec）*/
+    Gorilla = 2,
+};
+
+/** 一行记录（定长，游戏线程写入暂存缓冲时不分配内存）*/
+struct FSessionRecord
+{
+    static constexpr int32 MaxValues = 10;
+
+    /** 共享传感器时钟（秒）*/
+    double Time = 0.0;
+
+    /** 设备时钟（秒，没有设备时间的通道为 0）*/
+    double DeviceTime = 0.0;
+
+    ESessionChannel Channel = ESessionChannel::Controller;
+
+    /** 设备编号（手柄 1/2，GSR 为 0）*/
+    uint8 Device = 0;
+
+    /** 按钮位图（bit0 = 按钮 1）*/
+    uint8 Buttons = 0;
+
+    float Values[MaxValues] = {};
+};
+
+/** 一个列块：某个通道、某个设备的连续若干行，按列存放 */
+struct FSessionChunk
+{
+    ESessionChannel Channel = ESessionChannel::Controller;
+    uint8 Device = 0;
+
+    TArray<double> Time;
+    TArray<double> DeviceTime;
+    TArray<float> Values[FSessionRecord::MaxValues];
+    TArray<uint8> Buttons;
+
+    /** 事件名（只有 Event 通道）*/
+    TArray<FString> Names;
+
+    int32 NumRows() const { return Time.Num(); }
+
+    void AddRecord(const FSessionRecord& Record);
+
+    void Reset();
+};
+
+/** 读回的会话文件 */
+struct FSessionFile
+{
+    /** 会话开始时间（共享时钟）*/
+    double SessionStart = 0.0;
+
+    /** 会话开始的 UTC 时间 */
+    FDateTime StartedAt;
+
+    /** 按写出顺序排列的列块（同一通道、设备的块按时间先后）*/
+    TArray<FSessionChunk> Chunks;
+
+    /** 文件末尾有不完整或校验失败的块（记录过程中崩溃）*/
+    bool bTruncated = false;
+};
+
+/**
+ * 异步会话记录器：把所有传感器通道和游戏事件按列块写入一个文件
+ * 游戏线程调用 Push 写入预先分配的单生产者/单消费者环形缓冲（无锁、不分配内存，满时丢弃并计数），
+ * 后台线程取出后按 (通道, 设备) 组装列块，满 ChunkRows 行或超过 ChunkSeconds 秒时压缩写盘并 flush，
+ * 进程崩溃时最多丢失每个通道尚未写出的最后一块
+ *
+ * 文件格式（小端）：
+ *   文件头："WVSESSN" + 版本 u8 | 会话开始时间 f64（共享时钟）| 开始的 UTC 时间 i64（FDateTime ticks）
+ *   列块：   "WVCK" | 通道 u8 | 设备 u8 | 编码 u8 | 保留 u8 | 行数 u32 | 原始字节数 u32 | 存储字节数 u32 | CRC32 u32 | 负载
+ *   负载为按列拼接的数据：时间 f64[]，设备时间 f64[]（有设备时间的通道），各数值列 f32[]，按钮 u8[]（Controller），
+ *   事件名（u16 长度 + UTF-8）；编码见 ESessionCodec，Gorilla 编码时各列依次写入同一个位流，事件名跟在位流之后
+ */
+class WORKVOILENCEGAME_API FSessionRecorder : public FRunnable
+{
+public:
+    static constexpr int32 FileVersion = 1;
+
+    // === 通道定义 ===
+
+    static const TCHAR* GetChannelName(ESessionChannel Channel);
+
+    static int32 GetValueCount(ESessionChannel Channel);
+
+    static const TCHAR* GetValueName(ESessionChannel Channel, int32 Index);
+
+    static bool HasDeviceTime(ESessionChannel Channel);
+
+    static bool HasButtons(ESessionChannel Channel);
+
+    // === 参数（Start 之前设置）===
+
+    /** 暂存缓冲的行数（取 2 的幂），按 1kHz x 4 个设备约可缓冲 16 秒 */
+    int32 StagingCapacity = 65536;
+
+    /** 单个列块的最大行数 */
+    int32 ChunkRows = 4096;
+
+    /** 列块最长停留时间（秒），也是崩溃时最多丢失的数据长度 */
+    float ChunkSeconds = 1.0f;
+
+    /** 列块编码，Gorilla 比 zlib 更小、更快，可以在写盘线程上直接编码 */
+    ESessionCodec Codec = ESessionCodec::Gorilla;
+
+    FSessionRecorder();
+    virtual ~FSessionRecorder() override;
+
+    /** 创建文件并启动后台线程 */
+    bool Start(const FString& InPath, double SessionStartTime);
+
+    /** 写出剩余数据，关闭文件并等待后台线程退出 */
+    void Shutdown();
+
+    bool IsRecording() const { return Thread != nullptr; }
+
+    const FString& GetPath() const { return Path; }
+
+    // === 游戏线程 ===
+
+    /** 写入一行（只能在一个线程调用），暂存缓冲满时丢弃并返回 false */
+    bool Push(const FSessionRecord& Record);
+
+    /** 事件名需要字符串，走单独的队列（事件很少，分配可以接受）*/
+    void PushEvent(double Time, uint8 Type, int32 TrialIndex, const FString& Name);
+
+    // === 统计（任意线程读取）===
+
+    int64 GetRecordCount() const { return static_cast<int64>(Head.Load()); }
+    int64 GetDroppedCount() const { return DroppedCount; }
+    int64 GetBytesWritten() const { return BytesWritten; }
+    int64 GetChunkCount() const { return ChunkCount; }
+
+    /** 暂存缓冲的最高占用行数 */
+    int64 GetMaxQueued() const { return MaxQueued; }
+
+    // === 文件读写 ===
+
+    /** 编码一个完整的列块（块头 + 负载）*/
+    static void EncodeChunk(const FSessionChunk& Chunk, ESessionCodec InCodec, TArray<uint8>& OutData);
+
+    /** 解码块负载，Rows 与块头中的行数一致 */
+    static bool DecodeChunkPayload(ESessionCodec InCodec, const uint8* Stored, int32 StoredBytes, int32 RawBytes, int32 Rows, FSessionChunk& OutChunk);
+
+    /** 未压缩的列数据字节数（不含事件名）*/
+    static int64 GetRawColumnBytes(ESessionChannel Channel, int32 Rows);
+
+    /**
+     * 读取会话文件的所有列块；文件末尾不完整或校验失败的块（崩溃时正在写的块）被忽略，
+     * 并设置 bTruncated，前面已经写完的块仍然可以使用
+     */
+    static bool ReadFile(const FString& InPath, FSessionFile& OutFile, FString& OutError);
+
+    /** 一次写出整个会话文件（导入旧数据时使用，不经过后台线程）*/
+    static bool WriteFile(const FString& InPath, const FSessionFile& File, ESessionCodec InCodec, FString& OutError);
+
+    /** 目录下不与已有记录重名的会话文件路径：<Prefix>_<日期>_<时间>.wvsession，同一秒内的会话再加 _2、_3 ... */
+    static FString MakeUniquePath(const FString& Directory, const FString& Prefix);
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override { bStopRequested = true; }
+
+private:
+    struct FEventRecord
+    {
+        double Time = 0.0;
+        uint8 Type = 0;
+        int32 TrialIndex = 0;
+        FString Name;
+    };
+
+    struct FPendingChunk
+    {
+        FSessionChunk Chunk;
+        double OpenedAt = 0.0;
+    };
+
+    /** 取出暂存的记录，写出到期的列块（后台线程）*/
+    void Drain(bool bFlushAll);
+
+    void AddToChunk(const FSessionRecord& Record, const FString* Name);
+
+    void WriteChunk(FSessionChunk& Chunk);
+
+    /** 写块时复用的缓冲 */
+    TArray<uint8> EncodeBuffer;
+
+    FString Path;
+    FArchive* Writer = nullptr;
+    FRunnableThread* Thread = nullptr;
+    TAtomic<bool> bStopRequested { false };
+
+    // 环形缓冲：Head 只由生产者写，Tail 只由后台线程写
+    TArray<FSessionRecord> Staging;
+    uint64 StagingMask = 0;
+    TAtomic<uint64> Head { 0 };
+    TAtomic<uint64> Tail { 0 };
+
+    TQueue<FEventRecord, EQueueMode::Spsc> Events;
+
+    // 列块（后台线程独占），键为 通道 << 8 | 设备
+    TMap<uint16, FPendingChunk> Pending;
+
+    TAtomic<int64> DroppedCount { 0 };
+    TAtomic<int64> BytesWritten { 0 };
+    TAtomic<int64> ChunkCount { 0 };
+    TAtomic<int64> MaxQueued { 0 };
+};
@@ -0,0 +1,206 @@
+#include "SessionRecorderBenchmarkCommandlet.h"
+#include "SessionRecorder.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "Math/RandomStream.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+    /** 手柄 ADC 为 12 位，摇杆和压力按固件的分辨率量化（与真实数据的压缩率接近）*/
+    float Quantize(float Value)
+    {
+        return FMath::RoundToFloat(Value * 2048.0f) / 2048.0f;
+    }
+
+    /** 一个模拟手柄的状态：摇杆慢速画圈，压力按呼吸节奏变化，IMU 为小幅噪声 */
+    FSessionRecord MakeControllerRecord(uint8 Device, double Time, FRandomStream& Random)
+    {
+        const float Phase = static_cast<float>(Time * (0.5 + 0.1 * Device));
+        FSessionRecord Record;
+        Record.Time = Time;
+        Record.Channel = ESessionChannel::Controller;
+        Record.Device = Device;
+        Record.Values[0] = Quantize(0.8f * FMath::Cos(Phase) + 0.01f * Random.FRandRange(-1.0f, 1.0f));
+        Record.Values[1] = Quantize(0.8f * FMath::Sin(Phase) + 0.01f * Random.FRandRange(-1.0f, 1.0f));
+        Record.Values[2] = Quantize(0.5f + 0.3f * FMath::Sin(Phase * 0.3f));
+        Record.Values[3] = Quantize(0.5f + 0.3f * FMath::Cos(Phase * 0.3f));
+        Record.Values[4] = 0.02f * Random.FRandRange(-1.0f, 1.0f);
+        Record.Values[5] = 0.02f * Random.FRandRange(-1.0f, 1.0f);
+        Record.Values[6] = 1.0f + 0.02f * Random.FRandRange(-1.0f, 1.0f);
+        Record.Values[7] = 0.5f * Random.FRandRange(-1.0f, 1.0f);
+        Record.Values[8] = 0.5f * Random.FRandRange(-1.0f, 1.0f);
+        Record.Values[9] = 0.5f * Random.FRandRange(-1.0f, 1.0f);
+        Record.Buttons = FMath::Frac(Time * 0.2) < 0.1 ? 1 : 0;
+        return Record;
+    }
+
+    double Percentile(TArray<double> Values, double Fraction)
+    {
+        if (Values.Num() == 0)
+        {
+            return 0.0;
+        }
+        Values.Sort();
+        return Values[FMath::Clamp(static_cast<int32>(Fraction * (Values.Num() - 1) + 0.5), 0, Values.Num() - 1)];
+    }
+}
+
+USessionRecorderBenchmarkCommandlet::USessionRecorderBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 USessionRecorderBenchmarkCommandlet::Main(const FString& Params)
+{
+    int32 Devices = 2;
+    int32 RateHz = 1000;
+    int32 Fps = 60;
+    double Duration = 10.0;
+    FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SessionRecorderBenchmark.wvsession"));
+    FParse::Value(*Params, TEXT("Devices="), Devices);
+    FParse::Value(*Params, TEXT("Rate="), RateHz);
+    FParse::Value(*Params, TEXT("Fps="), Fps);
+    FParse::Value(*Params, TEXT("Duration="), Duration);
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+    Devices = FMath::Clamp(Devices, 1, 255);
+    RateHz = FMath::Max(RateHz, 1);
+    Fps = FMath::Max(Fps, 1);
+
+    constexpr int32 GsrRateHz = 100;
+    FSessionRecorder Recorder;
+    if (!Recorder.Start(OutputPath, 0.0))
+    {
+        return 1;
+    }
+
+    FRandomStream Random(1);
+    TArray<double> FrameMicros;
+    TArray<FSessionRecord> FrameRecords;
+    int64 Pushed = 0;
+    int64 Events = 0;
+    int64 SampleIndex = 0;
+    int64 GsrIndex = 0;
+    double TotalPushSeconds = 0.0;
+
+    const double FrameTime = 1.0 / Fps;
+    const int32 Frames = FMath::CeilToInt(Duration * Fps);
+    const double WallStart = FPlatformTime::Seconds();
+    for (int32 Frame = 0; Frame < Frames; Frame++)
+    {
+        // 本帧到达的样本：与游戏线程的 OSC / GSR 回调相同，在一帧内集中写入（先生成，只统计写入的耗时）
+        const double FrameEnd = (Frame + 1) * FrameTime;
+        FrameRecords.Reset();
+        for (; (SampleIndex + 1) / static_cast<double>(RateHz) <= FrameEnd; SampleIndex++)
+        {
+            const double Time = SampleIndex / static_cast<double>(RateHz);
+            for (int32 Device = 1; Device <= Devices; Device++)
+            {
+                const FSessionRecord Controller = MakeControllerRecord(static_cast<uint8>(Device), Time, Random);
+                FrameRecords.Add(Controller);
+
+                FSessionRecord Sample;
+                Sample.Time = Time;
+                Sample.DeviceTime = Time + Device;
+                Sample.Channel = ESessionChannel::HandleSample;
+                Sample.Device = static_cast<uint8>(Device);
+                Sample.Values[0] = Controller.Values[0];
+                Sample.Values[1] = Controller.Values[1];
+                Sample.Values[2] = Controller.Values[3];
+                FrameRecords.Add(Sample);
+            }
+        }
+        for (; (GsrIndex + 1) / static_cast<double>(GsrRateHz) <= FrameEnd; GsrIndex++)
+        {
+            const double Time = GsrIndex / static_cast<double>(GsrRateHz);
+            const float Conductance = 5.0f + FMath::Sin(static_cast<float>(Time * 0.05)) + 0.003f * Random.FRandRange(-1.0f, 1.0f);
+            FSessionRecord Gsr;
+            Gsr.Time = Time;
+            Gsr.DeviceTime = Time;
+            Gsr.Channel = ESessionChannel::Gsr;
+            Gsr.Values[0] = FMath::RoundToFloat(Conductance * 40.0f);
+            Gsr.Values[1] = 1000.0f / Conductance;
+            Gsr.Values[2] = Conductance;
+            FrameRecords.Add(Gsr);
+        }
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        for (const FSessionRecord& Record : FrameRecords)
+        {
+            Recorder.Push(Record);
+        }
+        Pushed += FrameRecords.Num();
+        if (Frame % Fps == 0)
+        {
+            Recorder.PushEvent(Frame * FrameTime, 0, Frame / Fps + 1, TEXT("Stimulus_benchmark"));
+            Events++;
+        }
+        const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+        TotalPushSeconds += Seconds;
+        FrameMicros.Add(Seconds * 1.0e6);
+
+        // 按实时节奏推进，后台线程与游戏运行时一样并发写盘
+        const double Wait = WallStart + FrameEnd - FPlatformTime::Seconds();
+        if (Wait > 0.0)
+        {
+            FPlatformProcess::Sleep(static_cast<float>(Wait));
+        }
+    }
+    Recorder.Shutdown();
+
+    double MeanMicros = 0.0;
+    double MaxMicros = 0.0;
+    for (const double Micros : FrameMicros)
+    {
+        MeanMicros += Micros;
+        MaxMicros = FMath::Max(MaxMicros, Micros);
+    }
+    MeanMicros /= FMath::Max(FrameMicros.Num(), 1);
+
+    UE_LOG(LogTemp, Display, TEXT("%d 个手柄 x %dHz（完整状态 + 定时采样）+ GSR %dHz，%.1fs，%d 帧/秒"),
+        Devices, RateHz, GsrRateHz, Duration, Fps);
+    UE_LOG(LogTemp, Display, TEXT("游戏线程：每帧 平均 %.2fus / p99 %.2fus / 最大 %.2fus，每行 %.1fns；暂存最高 %lld 行，丢弃 %lld 行"),
+        MeanMicros, Percentile(FrameMicros, 0.99), MaxMicros, TotalPushSeconds * 1.0e9 / FMath::Max<int64>(Pushed, 1),
+        Recorder.GetMaxQueued(), Recorder.GetDroppedCount());
+
+    // 读回核对
+    FSessionFile File;
+    FString Error;
+    if (!FSessionRecorder::ReadFile(OutputPath, File, Error))
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), *Error);
+        return 1;
+    }
+
+    int64 Rows[static_cast<int32>(ESessionChannel::Count)] = {};
+    int64 RawBytes = 0;
+    for (const FSessionChunk& Chunk : File.Chunks)
+    {
+        const ESessionChannel Channel = Chunk.Channel;
+        Rows[static_cast<int32>(Channel)] += Chunk.NumRows();
+        RawBytes += static_cast<int64>(Chunk.NumRows()) * (sizeof(double) * (FSessionRecorder::HasDeviceTime(Channel) ? 2 : 1)
+            + sizeof(float) * FSessionRecorder::GetValueCount(Channel) + (FSessionRecorder::HasButtons(Channel) ? 1 : 0));
+    }
+    const int64 FileBytes = Recorder.GetBytesWritten();
+    UE_LOG(LogTemp, Display, TEXT("文件：%lld 字节（%.1f KB/s），%lld 块，原始列数据 %lld 字节，压缩率 %.2f"),
+        FileBytes, FileBytes / 1024.0 / FMath::Max(Duration, 0.001), Recorder.GetChunkCount(), RawBytes,
+        RawBytes / static_cast<double>(FMath::Max<int64>(FileBytes, 1)));
+
+    bool bMatched = !File.bTruncated && Rows[static_cast<int32>(ESessionChannel::Event)] == Events
+        && Rows[static_cast<int32>(ESessionChannel::Controller)] + Rows[static_cast<int32>(ESessionChannel::HandleSample)]
+            + Rows[static_cast<int32>(ESessionChannel::Gsr)] + Recorder.GetDroppedCount() == Pushed;
+    for (int32 Channel = 0; Channel < static_cast<int32>(ESessionChannel::Count); Channel++)
+    {
+        UE_LOG(LogTemp, Display, TEXT("  %-12s %lld 行"), FSessionRecorder::GetChannelName(static_cast<ESessionChannel>(Channel)), Rows[Channel]);
+    }
+    if (!bMatched)
+    {
+        UE_LOG(LogTemp, Error, TEXT("读回的行数与写入不一致（写入 %lld 行 + %lld 个事件）"), Pushed, Events);
+        return 1;
+    }
+    return 0;
+}
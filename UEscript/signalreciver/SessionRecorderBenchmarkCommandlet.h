@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SessionRecorderBenchmarkCommandlet.generated.h"
+
+/**
+ * 会话记录器的基准测试：按游戏帧节奏模拟多个手柄（每个手柄 -Rate Hz 的完整状态和定时采样）、
+ * 100Hz 的 GSR 和每秒一个试次事件，实时写入 FSessionRecorder
+ * 输出游戏线程每帧写入的耗时（平均 / p99 / 最大）、每行耗时、文件字节率、压缩率和丢弃行数，
+ * 结束后读回文件核对每个通道的行数
+ *
+ * 用法：UnrealEditor-Cmd <项目>.uproject -run=SessionRecorderBenchmark [-Devices=2] [-Rate=1000]
+ *       [-Duration=10] [-Fps=60] [-Output=<文件>]
+ */
+UCLASS()
+class WORKVOILENCEGAME_API USessionRecorderBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USessionRecorderBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,179 @@
+#include "SqueezeAnalyzer.h"
+
+FSqueezeSampleResult FSqueezeAnalyzer::AddSample(float Time, float Force)
+{
+    FSqueezeSampleResult Result;
+
+    // 忽略重复或乱序的样本（例如同一帧内未收到新数据）
+    const float Dt = bHasLastSample ? Time - LastTime : 0.0f;
+    if (bHasLastSample && Dt <= 0.0f)
+    {
+        return Result;
+    }
+
+    if (!bActive)
+    {
+        if (Force > OnsetThreshold)
+        {
+            // 握压开始
+            bActive = true;
+            Result.bOnset = true;
+
+            Current = FSqueezeMetrics();
+            Current.SensorNumber = SensorNumber;
+            Current.OnsetTime = Time;
+            Current.PeakTime = Time;
+            Current.PeakForce = Force;
+            OnsetForce = Force;
+
+            bSustainedReported = false;
+            bTremorReported = false;
+            bDoubleReported = false;
+
+            Direction = 1;
+            ExtremumForce = Force;
+            LastReversalTime = -1.0f;
+            TremorReversals = 0;
+
+            // 双握压：上一次是短握压且刚刚释放
+            if (LastReleaseTime >= 0.0f
+                && Time - LastReleaseTime <= DoubleSqueezeInterval
+                && LastSqueezeDuration < SustainedDuration)
+            {
+                Result.PatternMask |= 1 << static_cast<uint8>(ESqueezePattern::DoubleSqueeze);
+                bDoubleReported = true;
+            }
+        }
+    }
+    else
+    {
+        // 梯形积分得到冲量
+        Current.Impulse += 0.5f * (Force + LastForce) * Dt;
+
+        const float InstantRFD = (Force - LastForce) / Dt;
+        Current.PeakRateOfForceDevelopment = FMath::Max(Current.PeakRateOfForceDevelopment, InstantRFD);
+
+        if (Force > Current.PeakForce)
+        {
+            Current.PeakForce = Force;
+            Current.PeakTime = Time;
+        }
+
+        if (LastForce >= HoldFraction * Current.PeakForce)
+        {
+            Current.HoldDuration += Dt;
+        }
+
+        UpdateTremor(Time, Force, Result);
+
+        if (!bSustainedReported && Time - Current.OnsetTime >= SustainedDuration)
+        {
+            Result.PatternMask |= 1 << static_cast<uint8>(ESqueezePattern::SustainedSqueeze);
+            bSustainedReported = true;
+        }
+
+        if (Force < ReleaseThreshold)
+        {
+            // 握压释放，结算指标
+            bActive = false;
+
+            Current.ReleaseTime = Time;
+            Current.Duration = Time - Current.OnsetTime;
+            Current.TimeToPeak = Current.PeakTime - Current.OnsetTime;
+            Current.RateOfForceDevelopment = Current.TimeToPeak > KINDA_SMALL_NUMBER
+                ? (Current.PeakForce - OnsetForce) / Current.TimeToPeak
+                : 0.0f;
+
+            Result.bReleased = true;
+            Result.Metrics = Current;
+
+            // 已组成双握压的第二次握压不再参与下一次配对，避免三连握被报告两次
+            LastReleaseTime = bDoubleReported ? -1.0f : Time;
+            LastSqueezeDuration = Current.Duration;
+        }
+    }
+
+    LastTime = Time;
+    LastForce = Force;
+    bHasLastSample = true;
+
+    return Result;
+}
+
+void FSqueezeAnalyzer::UpdateTremor(float Time, float Force, FSqueezeSampleResult& Result)
+{
+    // 带幅度滞回的极值跟踪：只有反向变化超过 TremorMinAmplitude 才算一次反转
+    bool bReversal = false;
+    if (Direction > 0)
+    {
+        if (Force > ExtremumForce)
+        {
+            ExtremumForce = Force;
+        }
+        else if (ExtremumForce - Force >= TremorMinAmplitude)
+        {
+            Direction = -1;
+            ExtremumForce = Force;
+            bReversal = true;
+        }
+    }
+    else
+    {
+        if (Force < ExtremumForce)
+        {
+            ExtremumForce = Force;
+        }
+        else if (Force - ExtremumForce >= TremorMinAmplitude)
+        {
+            Direction = 1;
+            ExtremumForce = Force;
+            bReversal = true;
+        }
+    }
+
+    if (!bReversal)
+    {
+        return;
+    }
+
+    // 两次反转之间为半个周期
+    if (LastReversalTime >= 0.0f)
+    {
+        const float HalfPeriod = Time - LastReversalTime;
+        const float Frequency = HalfPeriod > KINDA_SMALL_NUMBER ? 0.5f / HalfPeriod : 0.0f;
+        if (Frequency >= TremorMinFrequency && Frequency <= TremorMaxFrequency)
+        {
+            TremorReversals++;
+        }
+        else
+        {
+            TremorReversals = 0;
+        }
+    }
+    LastReversalTime = Time;
+
+    if (!bTremorReported && TremorReversals >= 2 * TremorMinCycles)
+    {
+        Result.PatternMask |= 1 << static_cast<uint8>(ESqueezePattern::Tremor);
+        bTremorReported = true;
+    }
+}
+
+void FSqueezeAnalyzer::Reset()
+{
+    bActive = false;
+    bHasLastSample = false;
+    LastTime = 0.0f;
+    LastForce = 0.0f;
+    Current = FSqueezeMetrics();
+    OnsetForce = 0.0f;
+    LastReleaseTime = -1.0f;
+    LastSqueezeDuration = 0.0f;
+    bSustainedReported = false;
+    bTremorReported = false;
+    bDoubleReported = false;
+    ExtremumForce = 0.0f;
+    LastReversalTime = -1.0f;
+    Direction = 0;
+    TremorReversals = 0;
+}
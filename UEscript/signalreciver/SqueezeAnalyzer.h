@@ -0,0 +1,160 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SqueezeAnalyzer.generated.h"
+
+/** 握压模式 */
+UENUM(BlueprintType)
+enum class ESqueezePattern : uint8
+{
+    /** 两次短握压间隔很短 */
+    DoubleSqueeze   UMETA(DisplayName = "Double Squeeze"),
+
+    /** 握压持续时间超过阈值 */
+    SustainedSqueeze UMETA(DisplayName = "Sustained Squeeze"),
+
+    /** 握压过程中出现 4-12Hz 的力值震颤 */
+    Tremor          UMETA(DisplayName = "Tremor")
+};
+
+/** 单次握压的力曲线指标 */
+USTRUCT(BlueprintType)
+struct FSqueezeMetrics
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    int32 SensorNumber = 0;
+
+    /** 起始时间（秒） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float OnsetTime = 0.0f;
+
+    /** 峰值时间（秒） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float PeakTime = 0.0f;
+
+    /** 释放时间（秒） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float ReleaseTime = 0.0f;
+
+    /** 峰值力 */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float PeakForce = 0.0f;
+
+    /** 达峰时间（秒） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float TimeToPeak = 0.0f;
+
+    /** 平均发力速率（从起始到峰值，力/秒） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float RateOfForceDevelopment = 0.0f;
+
+    /** 最大瞬时发力速率（力/秒） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float PeakRateOfForceDevelopment = 0.0f;
+
+    /** 冲量（力 x 秒，梯形积分） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float Impulse = 0.0f;
+
+    /** 保持时间：力值不低于峰值 HoldFraction 的累计时长（秒） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float HoldDuration = 0.0f;
+
+    /** 握压总时长（秒） */
+    UPROPERTY(BlueprintReadOnly, Category = "Squeeze")
+    float Duration = 0.0f;
+};
+
+/** 单个样本的分析结果 */
+struct FSqueezeSampleResult
+{
+    /** 本样本检测到握压起始 */
+    bool bOnset = false;
+
+    /** 本样本检测到握压释放，Metrics 有效 */
+    bool bReleased = false;
+    FSqueezeMetrics Metrics;
+
+    /** 本样本检测到的模式（按 ESqueezePattern 取位） */
+    uint8 PatternMask = 0;
+
+    bool HasPattern(ESqueezePattern Pattern) const
+    {
+        return (PatternMask & (1 << static_cast<uint8>(Pattern))) != 0;
+    }
+};
+
+/**
+ * 压力通道的流式握压分析器
+ * 每个样本 O(1) 更新：分段（起始/峰值/释放）、计算力曲线指标并识别握压模式
+ */
+struct WORKVOILENCEGAME_API FSqueezeAnalyzer
+{
+public:
+    // === 分段参数（与压力值同单位，固件输出为 0~1）===
+
+    /** 超过此值视为握压开始 */
+    float OnsetThreshold = 0.1f;
+
+    /** 低于此值视为握压释放（滞回，应小于 OnsetThreshold） */
+    float ReleaseThreshold = 0.05f;
+
+    /** 计算保持时间时相对峰值的比例 */
+    float HoldFraction = 0.8f;
+
+    // === 模式参数 ===
+
+    /** 双握压：上次释放到本次起始的最大间隔（秒） */
+    float DoubleSqueezeInterval = 0.4f;
+
+    /** 持续握压：持续时间阈值（秒） */
+    float SustainedDuration = 2.0f;
+
+    /** 震颤：极值间最小幅度 */
+    float TremorMinAmplitude = 0.02f;
+
+    /** 震颤频率范围（Hz） */
+    float TremorMinFrequency = 4.0f;
+    float TremorMaxFrequency = 12.0f;
+
+    /** 判定震颤所需的连续周期数 */
+    int32 TremorMinCycles = 3;
+
+    // === 接口 ===
+
+    /** 输入一个样本（时间单位秒） */
+    FSqueezeSampleResult AddSample(float Time, float Force);
+
+    bool IsSqueezing() const { return bActive; }
+
+    void Reset();
+
+    int32 SensorNumber = 0;
+
+private:
+    void UpdateTremor(float Time, float Force, FSqueezeSampleResult& Result);
+
+    bool bActive = false;
+    bool bHasLastSample = false;
+    float LastTime = 0.0f;
+    float LastForce = 0.0f;
+
+    // 当前握压的累积量
+    FSqueezeMetrics Current;
+    float OnsetForce = 0.0f;
+
+    // 模式检测状态
+    float LastReleaseTime = -1.0f;
+    float LastSqueezeDuration = 0.0f;
+    bool bSustainedReported = false;
+    bool bTremorReported = false;
+    bool bDoubleReported = false;
+
+    // 震颤检测：跟踪局部极值与方向反转
+    float ExtremumForce = 0.0f;
+    float LastReversalTime = -1.0f;
+    int8 Direction = 0;
+    int32 TremorReversals = 0;
+};
@@ -0,0 +1,143 @@
+#include "StreamingQuantile.h"
+
+void FStreamingQuantile::Add(float Value)
+{
+    // 前 NumMarkers 个样本直接插入排序作为初始标记
+    if (Count < NumMarkers)
+    {
+        int32 Index = static_cast<int32>(Count);
+        while (Index > 0 && Heights[Index - 1] > Value)
+        {
+            Heights[Index] = Heights[Index - 1];
+            Index--;
+        }
+        Heights[Index] = Value;
+        Count++;
+
+        if (Count == NumMarkers)
+        {
+            for (int32 Marker = 0; Marker < NumMarkers; Marker++)
+            {
+                Positions[Marker] = Marker;
+            }
+        }
+        return;
+    }
+
+    // 找到样本所在的分箱，必要时扩展两端的极值
+    int32 Cell = 0;
+    if (Value < Heights[0])
+    {
+        Heights[0] = Value;
+        Cell = 0;
+    }
+    else if (Value >= Heights[NumBins])
+    {
+        Heights[NumBins] = Value;
+        Cell = NumBins - 1;
+    }
+    else
+    {
+        while (Cell < NumBins - 1 && Value >= Heights[Cell + 1])
+        {
+            Cell++;
+        }
+    }
+
+    for (int32 Marker = Cell + 1; Marker < NumMarkers; Marker++)
+    {
+        Positions[Marker] += 1.0;
+    }
+    Count++;
+
+    // 调整中间标记，使其位置接近期望位置 (Count - 1) * i / NumBins
+    for (int32 Marker = 1; Marker < NumBins; Marker++)
+    {
+        const double Desired = static_cast<double>(Count - 1) * Marker / NumBins;
+        const double Delta = Desired - Positions[Marker];
+
+        if ((Delta >= 1.0 && Positions[Marker + 1] - Positions[Marker] > 1.0)
+            || (Delta <= -1.0 && Positions[Marker - 1] - Positions[Marker] < -1.0))
+        {
+            const double Step = Delta >= 0.0 ? 1.0 : -1.0;
+
+            const double Np = Positions[Marker + 1];
+            const double N = Positions[Marker];
+            const double Nm = Positions[Marker - 1];
+            const double Qp = Heights[Marker + 1];
+            const double Q = Heights[Marker];
+            const double Qm = Heights[Marker - 1];
+
+            // 分段抛物线 (P²) 预测
+            double Candidate = Q + Step / (Np - Nm)
+                * ((N - Nm + Step) * (Qp - Q) / (Np - N) + (Np - N - Step) * (Q - Qm) / (N - Nm));
+
+            if (Candidate <= Qm || Candidate >= Qp)
+            {
+                // 抛物线越界时退化为线性插值
+                const int32 Neighbor = Step > 0.0 ? Marker + 1 : Marker - 1;
+                Candidate = Q + Step * (Heights[Neighbor] - Q) / (Positions[Neighbor] - N);
+            }
+
+            Heights[Marker] = static_cast<float>(Candidate);
+            Positions[Marker] += Step;
+        }
+    }
+}
+
+float FStreamingQuantile::GetValueAtPercentile(float Percentile) const
+{
+    if (Count == 0)
+    {
+        return 0.0f;
+    }
+
+    const float Fraction = FMath::Clamp(Percentile, 0.0f, 100.0f) / 100.0f;
+
+    // 样本不足时按已排序的初始样本插值
+    const int32 LastMarker = Count < NumMarkers ? static_cast<int32>(Count) - 1 : NumBins;
+    const float Scaled = Fraction * LastMarker;
+    const int32 Lower = FMath::Min(FMath::FloorToInt(Scaled), FMath::Max(LastMarker - 1, 0));
+    const int32 Upper = FMath::Min(Lower + 1, LastMarker);
+    const float Alpha = Scaled - Lower;
+
+    return FMath::Lerp(Heights[Lower], Heights[Upper], Alpha);
+}
+
+float FStreamingQuantile::GetPercentileOfValue(float Value) const
+{
+    if (Count == 0)
+    {
+        return 0.0f;
+    }
+
+    const int32 LastMarker = Count < NumMarkers ? static_cast<int32>(Count) - 1 : NumBins;
+    if (LastMarker == 0 || Value <= Heights[0])
+    {
+        return 0.0f;
+    }
+    if (Value >= Heights[LastMarker])
+    {
+        return 100.0f;
+    }
+
+    int32 Lower = 0;
+    while (Lower < LastMarker - 1 && Value >= Heights[Lower + 1])
+    {
+        Lower++;
+    }
+
+    const float Span = Heights[Lower + 1] - Heights[Lower];
+    const float Alpha = Span > KINDA_SMALL_NUMBER ? (Value - Heights[Lower]) / Span : 0.0f;
+    return 100.0f * (Lower + Alpha) / LastMarker;
+}
+
+void FStreamingQuantile::Reset()
+{
+    for (int32 Marker = 0; Marker < NumMarkers; Marker++)
+    {
+        Heights[Marker] = 0.0f;
+        Positions[Marker] = 0.0;
+    }
+    Count = 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 扩展 P² 流式分位数估计器（Raatikainen 的多标记 P² 算法）
+ * 用 NumBins + 1 个标记跟踪等概率分箱的边界，内存固定，
+ * 可以在任意百分位上插值查询，也可以反查某个值对应的百分位
+ */
+struct WORKVOILENCEGAME_API FStreamingQuantile
+{
+public:
+    /** 分箱数（标记数 = NumBins + 1），20 箱即 5% 分辨率 */
+    static constexpr int32 NumBins = 20;
+    static constexpr int32 NumMarkers = NumBins + 1;
+
+    void Add(float Value);
+
+    /** 查询百分位（0~100）对应的值 */
+    float GetValueAtPercentile(float Percentile) const;
+
+    /** 反查某个值对应的百分位（0~100） */
+    float GetPercentileOfValue(float Value) const;
+
+    int64 GetCount() const { return Count; }
+
+    /** 样本数足够时标记才有意义 */
+    bool IsReady() const { return Count >= NumMarkers; }
+
+    void Reset();
+
+private:
+    float Heights[NumMarkers] = {};
+    double Positions[NumMarkers] = {};
+    int64 Count = 0;
+};
@@ -0,0 +1,41 @@
+#include "TransmitModeScheduler.h"
+
+void FTransmitModeScheduler::NoteReportedMode(bool bTrial)
+{
+    bHasReport = true;
+    bReportedTrial = bTrial;
+}
+
+bool FTransmitModeScheduler::WantsTrialMode(double Now) const
+{
+    return bTrialPhase || (LastMarkerTime >= 0.0 && Now - LastMarkerTime < TrialHoldDuration);
+}
+
+bool FTransmitModeScheduler::Update(double Now, bool& bOutTrial)
+{
+    bOutTrial = WantsTrialMode(Now);
+
+    // 目标变化立即发送；目标未变但手柄尚未确认（指令丢失、手柄重启回到空闲）时按间隔重发
+    const bool bChanged = !bHasSent || bOutTrial != bSentTrial;
+    const bool bUnconfirmed = !bHasReport || bReportedTrial != bOutTrial;
+    if (!bChanged && !(bUnconfirmed && Now - LastSendTime >= ResendInterval))
+    {
+        return false;
+    }
+
+    bHasSent = true;
+    bSentTrial = bOutTrial;
+    LastSendTime = Now;
+    return true;
+}
+
+void FTransmitModeScheduler::Reset()
+{
+    bTrialPhase = false;
+    LastMarkerTime = -1.0;
+    bHasReport = false;
+    bReportedTrial = false;
+    bHasSent = false;
+    bSentTrial = false;
+    LastSendTime = 0.0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 按实验阶段决定手柄的传输模式
+ * 手柄上电处于空闲模式（低频增量帧），进入试次阶段（显式开始，或刺激标记）后切换到试次模式
+ * （500Hz 完整帧 + 定时批量样本），最后一个标记之后保持一段时间再回到空闲，覆盖响应窗口；
+ * 指令走不可靠的反向通道，手柄报告的模式与目标不一致时按间隔重发
+ */
+struct WORKVOILENCEGAME_API FTransmitModeScheduler
+{
+public:
+    /** 最后一个试次标记之后保持试次模式的时间（秒），应不短于响应窗口终点 */
+    float TrialHoldDuration = 6.0f;
+
+    /** 指令发出后等待手柄确认的时间（秒），超时后重发 */
+    float ResendInterval = 1.0f;
+
+    /** 显式的试次阶段（例如一个计时任务块的开始和结束），阶段内始终为试次模式 */
+    void SetTrialPhase(bool bInTrial) { bTrialPhase = bInTrial; }
+
+    /** 收到试次标记（Time: 共享传感器时钟，秒） */
+    void NoteTrialMarker(double Time) { LastMarkerTime = Time; }
+
+    /** 手柄报告的当前模式（/avatar/status/rate） */
+    void NoteReportedMode(bool bTrial);
+
+    /** 当前应处于试次模式 */
+    bool WantsTrialMode(double Now) const;
+
+    /** 每帧调用：需要发送模式指令时返回 true，bOutTrial 为目标模式 */
+    bool Update(double Now, bool& bOutTrial);
+
+    /** 手柄报告的模式与目标一致 */
+    bool IsConfirmed() const { return bHasSent && bHasReport && bReportedTrial == bSentTrial; }
+
+    void Reset();
+
+private:
+    bool bTrialPhase = false;
+    double LastMarkerTime = -1.0;
+
+    bool bHasReport = false;
+    bool bReportedTrial = false;
+
+    bool bHasSent = false;
+    bool bSentTrial = false;
+    double LastSendTime = 0.0;
+};
@@ -6,6 +6,13 @@
  * 
  * 采样率：10Hz（每100ms采集一次）
  * 这个采样率适合皮肤电反应分析
+ *
+ * 二进制模式（BINARY 命令）：
+ * - 采样率 50~200Hz 可配置，Timer1 定时触发 ADC，每个样本过采样 OVERSAMPLE 次
+ * - 只输出原始ADC累加值，电阻/电导在上位机计算
+ * - 帧格式（11字节，小端）：
+ *   0xA5 0x5A | 序号(uint8) | 累加次数(uint8) | ADC累加值(uint16) | 时间戳(uint32, micros) | CRC8
+ *   CRC8 多项式 0x07，覆盖序号到时间戳的 8 个字节
  */
 
 const int GSR_PIN = A0;
@@ -17,6 +24,29 @@ unsigned long lastSampleTime = 0;
 unsigned long startTime = 0;
 bool isRecording = false;
 
+// ✨ 二进制模式 ✨
+const int OVERSAMPLE = 4;
+const int MIN_BINARY_RATE = 50;
+const int MAX_BINARY_RATE = 200;
+const uint8_t SYNC0 = 0xA5;
+const uint8_t SYNC1 = 0x5A;
+bool isBinary = false;
+volatile uint8_t sampleSequence = 0;
+
+// 中断中完成的样本（单生产者/单消费者环形缓冲，索引为单字节，读写天然原子）
+struct BinarySample {
+  uint8_t sequence;
+  uint16_t sum;
+  uint32_t timestampUs;
+};
+const uint8_t SAMPLE_QUEUE_SIZE = 16;
+volatile BinarySample sampleQueue[SAMPLE_QUEUE_SIZE];
+volatile uint8_t sampleHead = 0;
+volatile uint8_t sampleTail = 0;
+volatile uint16_t adcSum = 0;
+volatile uint8_t adcCount = 0;
+volatile uint32_t sampleStartUs = 0;
+
 void setup() {
   Serial.begin(115200);
   pinMode(GSR_PIN, INPUT);
@@ -41,17 +71,37 @@ void loop() {
     command.toUpperCase();
     
     if (command == "START") {
+      stopBinary();
       isRecording = true;
       startTime = millis();
       lastSampleTime = startTime;
       Serial.println("RECORDING_STARTED");
       Serial.println("HEADER:Time(ms),GSR_Raw,GSR_Resistance(kohm),GSR_Conductance(uS)");
+    } else if (command.startsWith("BINARY")) {
+      // BINARY [采样率Hz]，默认100Hz
+      int rate = command.length() > 6 ? command.substring(6).toInt() : 100;
+      isRecording = false;
+      Serial.println("BINARY_STARTED");
+      Serial.flush();
+      startBinary(constrain(rate, MIN_BINARY_RATE, MAX_BINARY_RATE));
     } else if (command == "STOP") {
       isRecording = false;
+      stopBinary();
       Serial.println("RECORDING_STOPPED");
     }
   }
   
+  // 二进制模式：把中断采到的样本编码成帧发送
+  if (isBinary) {
+    while (sampleTail != sampleHead) {
+      uint8_t sequence = sampleQueue[sampleTail].sequence;
+      uint16_t sum = sampleQueue[sampleTail].sum;
+      uint32_t timestampUs = sampleQueue[sampleTail].timestampUs;
+      sampleTail = (sampleTail + 1) % SAMPLE_QUEUE_SIZE;
+      writeFrame(sequence, sum, timestampUs);
+    }
+  }
+  
   // 如果正在记录，按固定采样率采集数据
   if (isRecording) {
     unsigned long currentTime = millis();
@@ -92,4 +142,97 @@ void loop() {
       Serial.println(conductance, 4);
     }
   }
-}
\ No newline at end of file
+}
+
+// ✨✨✨ 二进制模式 ✨✨✨
+
+void startBinary(int rateHz) {
+  noInterrupts();
+  
+  // ADC：AVcc参考电压，通道A0，分频128（16MHz下约104us一次转换），转换完成中断
+  ADMUX = _BV(REFS0) | ((GSR_PIN - A0) & 0x07);
+  ADCSRA = _BV(ADEN) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+  
+  // Timer1 CTC：每个子样本触发一次，频率 = 采样率 x OVERSAMPLE（分频8，2MHz计数）
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11);
+  TCNT1 = 0;
+  OCR1A = (uint16_t)(F_CPU / 8 / ((unsigned long)rateHz * OVERSAMPLE) - 1);
+  TIMSK1 = _BV(OCIE1A);
+  
+  adcSum = 0;
+  adcCount = 0;
+  sampleHead = 0;
+  sampleTail = 0;
+  sampleSequence = 0;
+  isBinary = true;
+  
+  interrupts();
+}
+
+void stopBinary() {
+  if (!isBinary) {
+    return;
+  }
+  noInterrupts();
+  TIMSK1 = 0;
+  TCCR1B = 0;
+  ADCSRA &= ~_BV(ADIE);
+  isBinary = false;
+  interrupts();
+}
+
+// 定时器到点启动一次ADC转换
+ISR(TIMER1_COMPA_vect) {
+  ADCSRA |= _BV(ADSC);
+}
+
+// 转换完成：累加，凑满 OVERSAMPLE 次写入队列（时间戳取第一次转换的时间）
+ISR(ADC_vect) {
+  if (adcCount == 0) {
+    sampleStartUs = micros();
+  }
+  adcSum += ADC;
+  if (++adcCount < OVERSAMPLE) {
+    return;
+  }
+  
+  // 队列满时丢弃，序号照常递增，上位机通过序号缺口发现
+  uint8_t next = (sampleHead + 1) % SAMPLE_QUEUE_SIZE;
+  if (next != sampleTail) {
+    sampleQueue[sampleHead].sequence = sampleSequence;
+    sampleQueue[sampleHead].sum = adcSum;
+    sampleQueue[sampleHead].timestampUs = sampleStartUs;
+    sampleHead = next;
+  }
+  sampleSequence++;
+  adcSum = 0;
+  adcCount = 0;
+}
+
+uint8_t crc8(const uint8_t* data, uint8_t length) {
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+void writeFrame(uint8_t sequence, uint16_t sum, uint32_t timestampUs) {
+  uint8_t frame[11];
+  frame[0] = SYNC0;
+  frame[1] = SYNC1;
+  frame[2] = sequence;
+  frame[3] = OVERSAMPLE;
+  frame[4] = sum & 0xFF;
+  frame[5] = sum >> 8;
+  frame[6] = timestampUs & 0xFF;
+  frame[7] = (timestampUs >> 8) & 0xFF;
+  frame[8] = (timestampUs >> 16) & 0xFF;
+  frame[9] = (timestampUs >> 24) & 0xFF;
+  frame[10] = crc8(frame + 2, 8);
+  Serial.write(frame, sizeof(frame));
+}
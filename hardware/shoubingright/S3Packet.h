@@ -0,0 +1,185 @@
+#pragma once
+
+// ✨✨✨ ESP32S3 -> 主ESP32 的传感器数据包 ✨✨✨
+// 不依赖 Arduino API，可以单独在主机上编译检查
+//
+// v1（旧格式）："S3DT" + 7个float + 按钮 + 1字节异或校验
+// v2：        "S3D2" + 序号(uint16) + S3时间戳(uint32, micros) + 7个float + 按钮 + CRC16-CCITT
+// 均为小端、紧凑排列；校验/CRC覆盖除校验字段以外的所有字节
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+struct S3PacketV1 {
+    char header[4];
+    float accelX, accelY, accelZ;
+    float gyroX, gyroY, gyroZ;
+    float pressure1;
+    uint8_t buttons;
+    uint8_t checksum;
+} __attribute__((packed));
+
+struct S3PacketV2 {
+    char header[4];
+    uint16_t sequence;
+    uint32_t timestampUs;
+    float accelX, accelY, accelZ;
+    float gyroX, gyroY, gyroZ;
+    float pressure1;
+    uint8_t buttons;
+    uint16_t crc;
+} __attribute__((packed));
+
+// 解析后的S3数据（两种格式共用）
+struct S3Reading {
+    float accelX, accelY, accelZ;
+    float gyroX, gyroY, gyroZ;
+    float pressure1;
+    uint8_t buttons;
+    bool hasSequence;     // v1 没有序号和时间戳
+    uint16_t sequence;
+    uint32_t timestampUs;
+};
+
+enum S3PacketStatus {
+    S3_PACKET_OK = 0,
+    S3_PACKET_BAD_SIZE,
+    S3_PACKET_BAD_HEADER,
+    S3_PACKET_BAD_CHECKSUM
+};
+
+inline uint8_t xorChecksum(const uint8_t* data, size_t length) {
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum ^= data[i];
+    }
+    return sum;
+}
+
+// CRC16-CCITT（多项式 0x1021，初值 0xFFFF）
+inline uint16_t crc16Ccitt(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// 按长度和包头识别格式并校验，成功时写入 reading
+inline S3PacketStatus parseS3Packet(const uint8_t* data, size_t length, S3Reading& reading) {
+    if (length == sizeof(S3PacketV2)) {
+        S3PacketV2 packet;
+        memcpy(&packet, data, sizeof(packet));
+        if (memcmp(packet.header, "S3D2", 4) != 0) {
+            return S3_PACKET_BAD_HEADER;
+        }
+        if (crc16Ccitt(data, sizeof(packet) - sizeof(packet.crc)) != packet.crc) {
+            return S3_PACKET_BAD_CHECKSUM;
+        }
+        reading.accelX = packet.accelX;
+        reading.accelY = packet.accelY;
+        reading.accelZ = packet.accelZ;
+        reading.gyroX = packet.gyroX;
+        reading.gyroY = packet.gyroY;
+        reading.gyroZ = packet.gyroZ;
+        reading.pressure1 = packet.pressure1;
+        reading.buttons = packet.buttons;
+        reading.hasSequence = true;
+        reading.sequence = packet.sequence;
+        reading.timestampUs = packet.timestampUs;
+        return S3_PACKET_OK;
+    }
+
+    if (length == sizeof(S3PacketV1)) {
+        S3PacketV1 packet;
+        memcpy(&packet, data, sizeof(packet));
+        if (memcmp(packet.header, "S3DT", 4) != 0) {
+            return S3_PACKET_BAD_HEADER;
+        }
+        if (xorChecksum(data, sizeof(packet) - 1) != packet.checksum) {
+            return S3_PACKET_BAD_CHECKSUM;
+        }
+        reading.accelX = packet.accelX;
+        reading.accelY = packet.accelY;
+        reading.accelZ = packet.accelZ;
+        reading.gyroX = packet.gyroX;
+        reading.gyroY = packet.gyroY;
+        reading.gyroZ = packet.gyroZ;
+        reading.pressure1 = packet.pressure1;
+        reading.buttons = packet.buttons;
+        reading.hasSequence = false;
+        reading.sequence = 0;
+        reading.timestampUs = 0;
+        return S3_PACKET_OK;
+    }
+
+    return S3_PACKET_BAD_SIZE;
+}
+
+// 序号比较（处理 uint16 回绕）：返回 seq 相对 last 前进了多少，<= 0 表示重复或乱序
+inline int sequenceAdvance(uint16_t last, uint16_t seq) {
+    return (int16_t)(uint16_t)(seq - last);
+}
+
+// 序号跟踪：丢弃重复或乱序的旧包，按序号缺口统计丢包
+// S3重启后序号从 0 重新开始，会落在“旧包”的范围内；以下两种情况重新同步，接受新的序号：
+//   - 距上一个接受的包已超过 timeoutMs（S3离线，重启至少要这么久）
+//   - 连续 restartPackets 个旧包且它们自身的序号依次递增（重复或乱序的旧包不会这样）
+class S3SequenceTracker {
+public:
+    static const uint8_t restartPackets = 3;
+
+    uint32_t lost = 0;
+    uint32_t discarded = 0;
+    uint32_t resyncs = 0;
+
+    // 返回 true 表示接受这个包
+    bool accept(uint16_t sequence, uint32_t nowMs, uint32_t timeoutMs) {
+        if (!hasLast_) {
+            return take(sequence, nowMs);
+        }
+        if (nowMs - lastAcceptMs_ >= timeoutMs) {
+            resyncs++;
+            return take(sequence, nowMs);
+        }
+
+        int advance = sequenceAdvance(last_, sequence);
+        if (advance > 0) {
+            lost += advance - 1;
+            return take(sequence, nowMs);
+        }
+
+        staleRun_ = staleRun_ > 0 && sequence == (uint16_t)(lastStale_ + 1) ? staleRun_ + 1 : 1;
+        lastStale_ = sequence;
+        if (staleRun_ >= restartPackets) {
+            resyncs++;
+            return take(sequence, nowMs);
+        }
+        discarded++;
+        return false;
+    }
+
+    void reset() {
+        hasLast_ = false;
+        staleRun_ = 0;
+    }
+
+private:
+    bool take(uint16_t sequence, uint32_t nowMs) {
+        hasLast_ = true;
+        last_ = sequence;
+        lastAcceptMs_ = nowMs;
+        staleRun_ = 0;
+        return true;
+    }
+
+    bool hasLast_ = false;
+    uint16_t last_ = 0;
+    uint32_t lastAcceptMs_ = 0;
+    uint16_t lastStale_ = 0;
+    uint8_t staleRun_ = 0;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+// ✨✨✨ 定时采样的缓冲与抽取逻辑 ✨✨✨
+// 不依赖 Arduino API，可以单独在主机上编译检查
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// 单生产者/单消费者环形缓冲：采样任务 push，网络循环 pop
+// 容量 Capacity 必须是 2 的幂；满时丢弃新样本并计数，不覆盖未读数据
+template <typename T, size_t Capacity>
+class SampleRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // startIndex 只用于主机测试下标回绕
+    explicit SampleRing(uint32_t startIndex = 0) : head_(startIndex), tail_(startIndex) {}
+
+    bool push(const T& item) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail >= Capacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t head = head_.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;
+        }
+        item = items_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    T items_[Capacity];
+    std::atomic<uint32_t> head_;
+    std::atomic<uint32_t> tail_;
+    std::atomic<uint32_t> dropped_{0};
+};
+
+// 过采样抽取：每个通道累加 Factor 次原始读数后输出一次平均值
+template <size_t Channels>
+class Oversampler {
+public:
+    explicit Oversampler(uint8_t factor) : factor_(factor ? factor : 1) {}
+
+    // 加入一组原始读数；凑满 factor 次时写出平均值并返回 true
+    bool add(const uint16_t* raw, float* averaged) {
+        for (size_t i = 0; i < Channels; i++) {
+            sums_[i] += raw[i];
+        }
+        if (++count_ < factor_) {
+            return false;
+        }
+        for (size_t i = 0; i < Channels; i++) {
+            averaged[i] = (float)sums_[i] / factor_;
+            sums_[i] = 0;
+        }
+        count_ = 0;
+        return true;
+    }
+
+    uint8_t factor() const { return factor_; }
+
+private:
+    uint8_t factor_;
+    uint8_t count_ = 0;
+    uint32_t sums_[Channels] = {0};
+};
+
+// 平均窗口中点的时间戳：窗口在 nowUs 结束、长 windowUs；micros() 回绕时按无符号运算仍然正确
+inline uint32_t windowMidpointUs(uint32_t nowUs, uint32_t windowUs) {
+    return nowUs - windowUs / 2;
+}
+
+// 一个抽取后的本地样本：设备时间戳（micros，平均窗口的中点）+ 摇杆和压力2的原始ADC均值
+struct LocalSample {
+    uint32_t timestampUs;
+    float joyX;
+    float joyY;
+    float pressure2;
+};
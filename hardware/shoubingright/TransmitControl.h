@@ -0,0 +1,92 @@
+#pragma once
+
+// ✨✨✨ 传输模式与发送节拍 ✨✨✨
+// 不依赖 Arduino API，可以单独在主机上编译检查（test/ 下的主机测试）
+//
+// 空闲：低频且只在数据变化时发送；试次：高频发送完整帧
+// UE按实验阶段通过 /handle/2/mode、/handle/2/rate、/handle/2/keyframe 切换，无需重启
+
+#include <stdint.h>
+
+enum TransmitMode { MODE_IDLE = 0, MODE_TRIAL = 1 };
+
+class TransmitControl {
+public:
+    // 上电进入空闲模式，UE在试次阶段开始时切换到试次模式（AOSCReceiver::bAutoTransmitMode）
+    TransmitMode mode = MODE_IDLE;
+    int idleRateHz = 10;
+    int trialRateHz = 500;
+
+    // 空闲模式的关键帧间隔，须小于UE的2秒数据超时
+    uint32_t keyframeIntervalMs = 1000;
+    bool keyframeRequested = true;
+
+    int rateHz() const {
+        return mode == MODE_TRIAL ? trialRateHz : idleRateHz;
+    }
+
+    uint32_t intervalUs() const {
+        return 1000000UL / (uint32_t)rateHz();
+    }
+
+    // 修改当前模式的频率（/handle/2/rate）
+    void setRate(int newRateHz) {
+        int rate = clampRate(newRateHz);
+        if (mode == MODE_TRIAL) {
+            trialRateHz = rate;
+        } else {
+            idleRateHz = rate;
+        }
+    }
+
+    // 切换模式，hasRate 时同时设置该模式的频率（/handle/2/mode）；进入新模式先发一帧完整数据
+    void setMode(int newMode, bool hasRate, int newRateHz) {
+        mode = newMode == MODE_TRIAL ? MODE_TRIAL : MODE_IDLE;
+        if (hasRate) {
+            setRate(newRateHz);
+        }
+        keyframeRequested = true;
+    }
+
+    // 请求下一帧发送关键帧（/handle/2/keyframe）；intervalMs > 0 时同时修改关键帧间隔
+    void requestKeyframe(int intervalMs) {
+        if (intervalMs > 0) {
+            keyframeIntervalMs = intervalMs < 100 ? 100 : (intervalMs > 1500 ? 1500 : intervalMs);
+        }
+        keyframeRequested = true;
+    }
+
+    // 是否到了下一个发送周期；按固定节拍推进，落后超过一个周期时重新对齐，避免追帧
+    bool tick(uint32_t nowUs) {
+        uint32_t interval = intervalUs();
+        if (nowUs - lastTickUs < interval) {
+            return false;
+        }
+        lastTickUs += interval;
+        if (nowUs - lastTickUs >= interval) {
+            lastTickUs = nowUs;
+        }
+        return true;
+    }
+
+    // 本帧是否发送关键帧：试次模式总是完整帧，空闲模式在请求时或到期时
+    bool keyframeDue(uint32_t nowMs) const {
+        return mode == MODE_TRIAL || keyframeRequested || nowMs - lastKeyframeMs >= keyframeIntervalMs;
+    }
+
+    // 一帧实际发出后调用
+    void frameSent(bool keyframe, uint32_t nowMs) {
+        if (keyframe) {
+            lastKeyframeMs = nowMs;
+            keyframeRequested = false;
+        }
+    }
+
+private:
+    static int clampRate(int rateHz) {
+        return rateHz < 1 ? 1 : (rateHz > 1000 ? 1000 : rateHz);
+    }
+
+    uint32_t lastTickUs = 0;
+    uint32_t lastKeyframeMs = 0;
+};
@@ -5,6 +5,10 @@
 #include <WiFi.h>
 #include <WiFiUdp.h>
 #include <OSCMessage.h>
+#include <OSCBundle.h>
+#include "SampleBuffer.h"
+#include "S3Packet.h"
+#include "TransmitControl.h"
 
 // WiFi 配置
 const char* ssid = "Qifei";
@@ -12,6 +16,9 @@ const char* password = "88888888";
 const char* ueHost = "172.20.10.14"; // UE5 OSC 监听 IP
 const int uePort = 7654;
 const int listenPort = 8888; // 监听ESP32S3数据的端口
+const int commandPort = 8889; // 监听UE反向指令的端口
+const int s3CommandPort = 8890; // 转发给ESP32S3的指令端口
+const int maxCommandBytes = 512; // 指令数据报上限，UE 端按同一上限拆分（AOSCReceiver::MaxFeedbackBundleBytes）
 
 // 硬件引脚定义
 const int joyXPin = 34;
@@ -19,39 +26,134 @@ const int joyYPin = 35;
 const int pressure2Pin = 33;
 const int button4Pin = 14;
 
+// 反馈输出引脚（振动马达 + RGB LED，均用 LEDC PWM 驱动）
+const int vibrationPin = 25;
+const int ledRPin = 26;
+const int ledGPin = 27;
+const int ledBPin = 13;
+const int vibrationChannel = 0;
+const int ledRChannel = 1;
+const int ledGChannel = 2;
+const int ledBChannel = 3;
+
+// ✨✨✨ 硬件定时器驱动的本地采样 ✨✨✨
+// 定时器按 sampleRateHz * oversampleFactor 触发，采样任务每次读一组ADC，
+// 每 oversampleFactor 组取平均写入环形缓冲；网络循环按传输频率批量取出
+const int sampleRateHz = 500;
+const uint8_t oversampleFactor = 4;
+const int maxBatchSamples = 32; // 每条批量消息的样本上限，保证数据报不超过MTU
+
+hw_timer_t* sampleTimer = NULL;
+TaskHandle_t samplingTaskHandle = NULL;
+SampleRing<LocalSample, 256> sampleRing;
+Oversampler<3> oversampler(oversampleFactor);
+volatile uint32_t missedSampleTicks = 0;
+
+LocalSample batchSamples[maxBatchSamples];
+int batchCount = 0;
+
 WiFiUDP udpSend;
 WiFiUDP udpReceive;
+WiFiUDP udpCommand;
+
+// 振动脉冲：只记录结束时间，由loop关闭，不阻塞采样
+bool vibrationActive = false;
+unsigned long vibrationEndTime = 0;
+
+// ✨✨✨ 传输模式（UE按实验阶段通过 /handle/2/mode 切换，无需重启，见 TransmitControl.h）✨✨✨
+// ✨✨✨ 增量传输：空闲模式只发送量化值变化的通道，并定期发送完整关键帧 ✨✨✨
+// 每帧末尾附 /avatar/frame（手柄编号, 帧序号, 是否关键帧），UE据此重建完整状态并检测丢帧
+TransmitControl transmit;
+int32_t frameSequence = 0;
+bool lastS3Online = false;
+
+// 定期向UE报告当前协商的频率
+unsigned long lastRateReportTime = 0;
+const unsigned long rateReportInterval = 1000;
+
+// 调试打印限频，避免高频模式下串口阻塞采样
+unsigned long lastDebugPrintTime = 0;
+const unsigned long debugPrintInterval = 200;
+
+// ✨✨✨ 一帧的通道定义 ✨✨✨
+enum FloatChannel {
+    CH_JOY_X = 0, CH_JOY_Y, CH_PRESSURE2,
+    CH_ACCEL_X, CH_ACCEL_Y, CH_ACCEL_Z,
+    CH_GYRO_X, CH_GYRO_Y, CH_GYRO_Z,
+    CH_PRESSURE1,
+    NUM_FLOAT_CHANNELS
+};
+const int FIRST_S3_CHANNEL = CH_ACCEL_X;
+
+const char* floatChannelAddress[NUM_FLOAT_CHANNELS] = {
+    "/avatar/input/joystick/x", "/avatar/input/joystick/y", "/avatar/input/pressure/2",
+    "/avatar/input/accel/x", "/avatar/input/accel/y", "/avatar/input/accel/z",
+    "/avatar/input/gyro/x", "/avatar/input/gyro/y", "/avatar/input/gyro/z",
+    "/avatar/input/pressure/1"
+};
+
+const char* buttonAddress[4] = {
+    "/avatar/input/button/1", "/avatar/input/button/2",
+    "/avatar/input/button/3", "/avatar/input/button/4"
+};
+
+// 每个通道的量化步长：量化后的值变化才算变化（摇杆/压力为归一化单位，加速度g，陀螺仪度/秒）
+const float channelEpsilon[NUM_FLOAT_CHANNELS] = {
+    0.01, 0.01, 0.005,
+    0.02, 0.02, 0.02,
+    1.0, 1.0, 1.0,
+    0.005
+};
+
+float frameValues[NUM_FLOAT_CHANNELS] = {0};
+long lastSentQuantized[NUM_FLOAT_CHANNELS] = {0};
+uint8_t lastSentButtons = 0;
 
 // 按钮状态跟踪
 bool button4State = false, button4LastState = false;
 unsigned long lastDebounceTime = 0;
 const unsigned long debounceDelay = 50;
 
-// ESP32S3数据包结构
-struct SensorDataPacket {
-    char header[4];
-    float accelX, accelY, accelZ;
-    float gyroX, gyroY, gyroZ;
-    float pressure1;
-    uint8_t buttons;
-    uint8_t checksum;
-} __attribute__((packed));
-
-SensorDataPacket s3Data = {0};
+// ESP32S3数据（包格式见 S3Packet.h，同时接受旧的异或校验格式和带序号/CRC的新格式）
+S3Reading s3Data = {0};
 bool s3DataValid = false;
+
+// S3链路统计：收到的包数、校验失败；序号缺口（丢包）、乱序/重复丢弃和重启后的重新同步在 s3Sequence 中
+uint32_t s3PacketsReceived = 0;
+uint32_t s3ChecksumErrors = 0;
+S3SequenceTracker s3Sequence;
+IPAddress s3Address;
+bool s3AddressKnown = false;
 unsigned long lastS3DataTime = 0;
 const unsigned long s3Timeout = 200;
 
-// WiFi重连管理
-unsigned long lastWiFiCheck = 0;
-const unsigned long wifiCheckInterval = 5000; // 每5秒检查一次WiFi
+// ✨✨✨ WiFi连接状态机（非阻塞）✨✨✨
+// 先用缓存的BSSID/信道直连（跳过扫描，通常1秒内连上），失败再完整扫描，之后间隔重试；
+// 断线期间采样照常进行，样本进入离线缓冲，重连后带原始时间戳补发
+enum LinkState { LINK_FAST_CONNECT, LINK_FULL_CONNECT, LINK_WAIT_RETRY, LINK_CONNECTED };
+LinkState linkState = LINK_WAIT_RETRY;
+unsigned long linkStateTime = 0;
+unsigned long linkLostTime = 0;
+const unsigned long fastConnectTimeout = 3000;
+const unsigned long fullConnectTimeout = 15000;
+const unsigned long retryDelay = 1000;
+
+// 上次连接的AP，放在RTC内存中，软件重启后仍然有效
+const uint32_t apCacheMagic = 0x57494649;
+RTC_NOINIT_ATTR uint32_t cachedApMagic;
+RTC_NOINIT_ATTR uint8_t cachedBssid[6];
+RTC_NOINIT_ATTR int32_t cachedChannel;
+
+// 离线缓冲：约 4 秒 @ 500Hz（32KB），满时丢弃新样本并计数
+SampleRing<LocalSample, 2048> offlineSamples;
+const int maxFlushMessagesPerPass = 8;
 
 void setup() {
     // ✨✨✨ 关键第一步：禁用brownout检测 ✨✨✨
     WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 0);
     
-    // ✨✨✨ 关键第二步：长延迟让电源完全稳定 ✨✨✨
-    delay(5000); // 5秒延迟
+    // ✨✨✨ 关键第二步：短延迟让电源稳定（brownout已禁用，不再需要5秒）✨✨✨
+    delay(500);
     
     // ✨✨✨ 串口初始化但不等待 ✨✨✨
     Serial.begin(115200);
@@ -63,90 +165,231 @@ void setup() {
     // 初始化按钮引脚
     pinMode(button4Pin, INPUT_PULLUP);
     
-    // ✨✨✨ WiFi初始化 ✨✨✨
-    connectWiFi();
+    // 启动定时采样（采样任务与loop同在核心1，但优先级更高，定时到达时立即抢占）
+    xTaskCreatePinnedToCore(samplingTask, "sampling", 2048, NULL, 3, &samplingTaskHandle, 1);
+    sampleTimer = timerBegin(0, 80, true); // 80MHz / 80 = 1MHz 计数
+    timerAttachInterrupt(sampleTimer, &onSampleTimer, true);
+    timerAlarmWrite(sampleTimer, 1000000UL / (sampleRateHz * oversampleFactor), true);
+    timerAlarmEnable(sampleTimer);
     
-    // 开始监听UDP端口
-    if (WiFi.status() == WL_CONNECTED) {
-        udpReceive.begin(listenPort);
-        Serial.print("Listening on port ");
-        Serial.println(listenPort);
-    }
+    // 初始化反馈输出
+    ledcSetup(vibrationChannel, 5000, 8);
+    ledcSetup(ledRChannel, 5000, 8);
+    ledcSetup(ledGChannel, 5000, 8);
+    ledcSetup(ledBChannel, 5000, 8);
+    ledcAttachPin(vibrationPin, vibrationChannel);
+    ledcAttachPin(ledRPin, ledRChannel);
+    ledcAttachPin(ledGPin, ledGChannel);
+    ledcAttachPin(ledBPin, ledBChannel);
+    
+    // ✨✨✨ WiFi初始化（不等待连接，由loop中的状态机推进）✨✨✨
+    startWiFi();
 }
 
 void loop() {
-    // ✨✨✨ 定期检查WiFi连接状态 ✨✨✨
-    if (millis() - lastWiFiCheck > wifiCheckInterval) {
-        lastWiFiCheck = millis();
-        if (WiFi.status() != WL_CONNECTED) {
-            Serial.println("WiFi disconnected! Reconnecting...");
-            connectWiFi();
-        }
+    // ✨✨✨ 推进WiFi状态机（非阻塞）✨✨✨
+    updateWiFi();
+    bool online = linkState == LINK_CONNECTED;
+    
+    // ========== 处理UE反向指令和S3数据（每轮都检查，不受采样周期限制）==========
+    if (online) {
+        receiveCommands();
+        receiveS3Data();
+        flushOfflineSamples();
     }
+    updateVibration();
     
-    // 只在WiFi连接时执行主要功能
-    if (WiFi.status() != WL_CONNECTED) {
-        delay(100);
+    // ========== 定期报告传输频率 ==========
+    if (online && millis() - lastRateReportTime > rateReportInterval) {
+        sendRateStatus();
+    }
+    
+    // ========== 按采样周期执行采样和发送 ==========
+    if (!transmit.tick(micros())) {
         return;
     }
     
-    // ========== 接收ESP32S3数据 ==========
-    receiveS3Data();
+    // ========== ESP32S3在线状态 ==========
+    bool s3Online = s3DataValid && (millis() - lastS3DataTime < s3Timeout);
     
-    // ========== 读取摇杆数据 ==========
-    int joyX = analogRead(joyXPin);
-    int joyY = analogRead(joyYPin);
+    // ========== 取出定时采样的摇杆和压力数据 ==========
+    drainSamples();
     
-    float normalizedX = (joyX - 2048.0) / 2048.0;
-    float normalizedY = (joyY - 2048.0) / 2048.0;
-    normalizedX = constrain(normalizedX, -1.0, 1.0);
-    normalizedY = constrain(normalizedY, -1.0, 1.0);
+    // ========== ESP32S3的数据 ==========
+    if (s3Online) {
+        frameValues[CH_ACCEL_X] = s3Data.accelX;
+        frameValues[CH_ACCEL_Y] = s3Data.accelY;
+        frameValues[CH_ACCEL_Z] = s3Data.accelZ;
+        frameValues[CH_GYRO_X] = s3Data.gyroX;
+        frameValues[CH_GYRO_Y] = s3Data.gyroY;
+        frameValues[CH_GYRO_Z] = s3Data.gyroZ;
+        frameValues[CH_PRESSURE1] = s3Data.pressure1;
+    }
     
-    sendOSCFloat("/avatar/input/joystick/x", normalizedX);
-    sendOSCFloat("/avatar/input/joystick/y", normalizedY);
+    // ========== 读取本地按钮4 ==========
+    readButton(button4Pin, button4State, button4LastState);
+    uint8_t buttons = (s3Online ? (s3Data.buttons & 0x07) : 0) | (button4State ? 0x08 : 0);
     
-    // ========== 读取压力传感器数据 ==========
-    int pressure2Raw = analogRead(pressure2Pin);
-    float pressure2 = pressure2Raw / 4095.0;
-    pressure2 = constrain(pressure2, 0.0, 1.0);
+    // ========== 发送一帧 ==========
+    // 试次模式每个周期都发送完整帧；空闲模式发送变化的通道，到期或S3上下线时发送关键帧
+    if (s3Online != lastS3Online) {
+        transmit.keyframeRequested = true;
+        lastS3Online = s3Online;
+    }
+    bool keyframe = transmit.keyframeDue(millis());
+    if (online) {
+        sendFrame(buttons, s3Online, keyframe);
+    }
     
-    sendOSCFloat("/avatar/input/pressure/2", pressure2);
+    // 调试打印
+    if (millis() - lastDebugPrintTime > debugPrintInterval) {
+        lastDebugPrintTime = millis();
+        printDebug(s3Online);
+    }
+}
+
+// 一帧打包成一个OSC bundle，一个数据报发出
+// 关键帧包含所有通道；增量帧只包含量化值变化的通道，没有变化时不发送
+void sendFrame(uint8_t buttons, bool s3Online, bool keyframe) {
+    OSCBundle frame;
+    int channelCount = s3Online ? NUM_FLOAT_CHANNELS : FIRST_S3_CHANNEL;
+    int changedCount = 0;
+    for (int i = 0; i < channelCount; i++) {
+        long quantized = lroundf(frameValues[i] / channelEpsilon[i]);
+        if (keyframe || quantized != lastSentQuantized[i]) {
+            frame.add(floatChannelAddress[i]).add(frameValues[i]);
+            lastSentQuantized[i] = quantized;
+            changedCount++;
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        // S3离线时不发送按钮1-3，避免UE误判为释放
+        if (i < 3 && !s3Online) {
+            continue;
+        }
+        uint8_t mask = 1 << i;
+        if (keyframe || ((buttons ^ lastSentButtons) & mask)) {
+            frame.add(buttonAddress[i]).add((int32_t)((buttons >> i) & 0x01));
+            changedCount++;
+        }
+    }
+    lastSentButtons = buttons;
     
-    // ========== 发送ESP32S3的数据 ==========
-    if (s3DataValid && (millis() - lastS3DataTime < s3Timeout)) {
-        sendOSCFloat("/avatar/input/accel/x", s3Data.accelX);
-        sendOSCFloat("/avatar/input/accel/y", s3Data.accelY);
-        sendOSCFloat("/avatar/input/accel/z", s3Data.accelZ);
-        
-        sendOSCFloat("/avatar/input/gyro/x", s3Data.gyroX);
-        sendOSCFloat("/avatar/input/gyro/y", s3Data.gyroY);
-        sendOSCFloat("/avatar/input/gyro/z", s3Data.gyroZ);
-        
-        sendOSCFloat("/avatar/input/pressure/1", s3Data.pressure1);
+    // 试次模式附带自上一帧以来的所有定时样本（每个样本带设备时间戳）
+    if (transmit.mode == MODE_TRIAL && batchCount > 0) {
+        OSCMessage& batch = frame.add("/avatar/input/samples");
+        batch.add((int32_t)2);
+        for (int i = 0; i < batchCount; i++) {
+            batch.add((int32_t)batchSamples[i].timestampUs);
+            batch.add(normalizeJoystick(batchSamples[i].joyX));
+            batch.add(normalizeJoystick(batchSamples[i].joyY));
+            batch.add(normalizePressure(batchSamples[i].pressure2));
+        }
+        changedCount++;
+    }
+    
+    if (changedCount == 0) {
+        return;
+    }
+    
+    transmit.frameSent(keyframe, millis());
+    
+    // 帧信息放在末尾：UE收到它时本帧的所有通道都已更新
+    frameSequence++;
+    frame.add("/avatar/frame").add((int32_t)2).add(frameSequence).add((int32_t)(keyframe ? 1 : 0));
+    
+    udpSend.beginPacket(ueHost, uePort);
+    frame.send(udpSend);
+    udpSend.endPacket();
+}
+
+// 定时器中断只负责唤醒采样任务（ESP32上analogRead不能在中断里调用）
+void IRAM_ATTR onSampleTimer() {
+    BaseType_t higherPriorityWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(samplingTaskHandle, &higherPriorityWoken);
+    if (higherPriorityWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void samplingTask(void* parameter) {
+    const uint32_t windowUs = 1000000UL / sampleRateHz;
+    uint16_t raw[3];
+    float averaged[3];
+    for (;;) {
+        // 返回值大于1说明任务被阻塞时漏掉了定时节拍
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (ticks > 1) {
+            missedSampleTicks += ticks - 1;
+        }
         
-        bool button1 = s3Data.buttons & 0x01;
-        bool button2 = s3Data.buttons & 0x02;
-        bool button3 = s3Data.buttons & 0x04;
+        raw[0] = analogRead(joyXPin);
+        raw[1] = analogRead(joyYPin);
+        raw[2] = analogRead(pressure2Pin);
         
-        sendOSCBool("/avatar/input/button/1", button1);
-        sendOSCBool("/avatar/input/button/2", button2);
-        sendOSCBool("/avatar/input/button/3", button3);
+        if (oversampler.add(raw, averaged)) {
+            LocalSample sample;
+            sample.timestampUs = windowMidpointUs(micros(), windowUs);
+            sample.joyX = averaged[0];
+            sample.joyY = averaged[1];
+            sample.pressure2 = averaged[2];
+            sampleRing.push(sample);
+        }
+    }
+}
+
+// 取出环形缓冲中的样本：最多 maxBatchSamples 个放入本帧的批量消息，最新的一个作为本帧的通道值
+// 剩余样本留到下一帧；空闲模式不发送批量消息，只保留最新值
+void drainSamples() {
+    batchCount = 0;
+    LocalSample sample;
+    bool hasSample = false;
+    if (linkState != LINK_CONNECTED || offlineSamples.size() > 0) {
+        // 断线中，或离线缓冲尚未补发完：样本按顺序进入离线缓冲，保证UE收到的时间戳单调
+        while (sampleRing.pop(sample)) {
+            offlineSamples.push(sample);
+            hasSample = true;
+        }
+    } else if (transmit.mode == MODE_TRIAL) {
+        while (batchCount < maxBatchSamples && sampleRing.pop(sample)) {
+            batchSamples[batchCount++] = sample;
+            hasSample = true;
+        }
+    } else {
+        while (sampleRing.pop(sample)) {
+            hasSample = true;
+        }
+    }
+    if (!hasSample) {
+        return;
     }
     
-    // ========== 读取本地按钮4 ==========
-    readAndSendButton(button4Pin, "/avatar/input/button/4", button4State, button4LastState);
-    
-    // 调试打印
-    Serial.print("Joystick X=");
-    Serial.print(normalizedX, 2);
+    frameValues[CH_JOY_X] = normalizeJoystick(sample.joyX);
+    frameValues[CH_JOY_Y] = normalizeJoystick(sample.joyY);
+    frameValues[CH_PRESSURE2] = normalizePressure(sample.pressure2);
+}
+
+float normalizeJoystick(float raw) {
+    return constrain((raw - 2048.0) / 2048.0, -1.0, 1.0);
+}
+
+float normalizePressure(float raw) {
+    return constrain(raw / 4095.0, 0.0, 1.0);
+}
+
+void printDebug(bool s3Online) {
+    Serial.print(transmit.mode == MODE_TRIAL ? "[TRIAL " : "[IDLE ");
+    Serial.print(transmit.rateHz());
+    Serial.print("Hz] Joystick X=");
+    Serial.print(frameValues[CH_JOY_X], 2);
     Serial.print(" Y=");
-    Serial.print(normalizedY, 2);
+    Serial.print(frameValues[CH_JOY_Y], 2);
     
-    if (s3DataValid && (millis() - lastS3DataTime < s3Timeout)) {
+    if (s3Online) {
         Serial.print(" | Pressure1=");
         Serial.print(s3Data.pressure1, 2);
         Serial.print(" Pressure2=");
-        Serial.print(pressure2, 2);
+        Serial.print(frameValues[CH_PRESSURE2], 2);
         Serial.print(" | Accel X=");
         Serial.print(s3Data.accelX, 2);
         Serial.print(" Y=");
@@ -165,96 +408,208 @@ void loop() {
         Serial.print((s3Data.buttons & 0x04) ? 1 : 0);
     } else {
         Serial.print(" | Pressure1=0.00 Pressure2=");
-        Serial.print(pressure2, 2);
+        Serial.print(frameValues[CH_PRESSURE2], 2);
         Serial.print(" | [S3_OFFLINE] | Buttons: 000");
     }
     
-    Serial.println(button4State);
+    Serial.print(button4State);
     
-    delay(20);
+    // 采样健康状况：缓冲积压 / 缓冲满丢弃 / 漏掉的定时节拍
+    Serial.print(" | Samples q=");
+    Serial.print(sampleRing.size());
+    Serial.print(" drop=");
+    Serial.print(sampleRing.dropped());
+    Serial.print(" miss=");
+    Serial.print(missedSampleTicks);
+    Serial.print(" offline=");
+    Serial.print(offlineSamples.size());
+    Serial.print("/");
+    Serial.print(offlineSamples.dropped());
+    
+    // S3链路：收到 / 校验失败 / 丢失 / 乱序丢弃 / 重新同步
+    Serial.print(" | S3 rx=");
+    Serial.print(s3PacketsReceived);
+    Serial.print(" crc=");
+    Serial.print(s3ChecksumErrors);
+    Serial.print(" lost=");
+    Serial.print(s3Sequence.lost);
+    Serial.print(" old=");
+    Serial.print(s3Sequence.discarded);
+    Serial.print(" resync=");
+    Serial.println(s3Sequence.resyncs);
 }
 
-// ✨✨✨ WiFi连接函数（独立封装）✨✨✨
-void connectWiFi() {
-    Serial.println("Initializing WiFi...");
-    
-    // 完全重置WiFi
-    WiFi.mode(WIFI_OFF);
-    delay(1000);
-    
+// ✨✨✨ WiFi连接状态机 ✨✨✨
+void startWiFi() {
     WiFi.mode(WIFI_STA);
-    WiFi.disconnect(true);
-    delay(500);
+    WiFi.setSleep(false);          // 禁用省电模式
+    WiFi.setAutoReconnect(false);  // 重连由状态机负责
+    WiFi.persistent(false);        // 不保存WiFi配置到flash
+    beginConnect();
+}
+
+void setLinkState(LinkState state) {
+    linkState = state;
+    linkStateTime = millis();
+}
+
+void beginConnect() {
+    if (cachedApMagic == apCacheMagic) {
+        Serial.print("Fast connect to ");
+        Serial.print(ssid);
+        Serial.print(" (channel ");
+        Serial.print(cachedChannel);
+        Serial.println(")");
+        WiFi.begin(ssid, password, cachedChannel, cachedBssid);
+        setLinkState(LINK_FAST_CONNECT);
+    } else {
+        Serial.print("Connecting to ");
+        Serial.println(ssid);
+        WiFi.begin(ssid, password);
+        setLinkState(LINK_FULL_CONNECT);
+    }
+}
+
+void updateWiFi() {
+    wl_status_t status = WiFi.status();
     
-    // 禁用省电模式
-    WiFi.setSleep(false);
+    switch (linkState) {
+        case LINK_CONNECTED:
+            if (status != WL_CONNECTED) {
+                Serial.println("WiFi disconnected! Buffering samples, reconnecting...");
+                linkLostTime = millis();
+                WiFi.disconnect();
+                beginConnect();
+            }
+            break;
+        
+        case LINK_FAST_CONNECT:
+            if (status == WL_CONNECTED) {
+                onWiFiConnected();
+            } else if (millis() - linkStateTime > fastConnectTimeout) {
+                // AP可能换了信道，退回完整扫描
+                Serial.println("Fast connect failed, scanning...");
+                WiFi.disconnect();
+                WiFi.begin(ssid, password);
+                setLinkState(LINK_FULL_CONNECT);
+            }
+            break;
+        
+        case LINK_FULL_CONNECT:
+            if (status == WL_CONNECTED) {
+                onWiFiConnected();
+            } else if (millis() - linkStateTime > fullConnectTimeout) {
+                Serial.print("✗ WiFi connect timeout, status ");
+                Serial.println(status);
+                WiFi.disconnect();
+                setLinkState(LINK_WAIT_RETRY);
+            }
+            break;
+        
+        case LINK_WAIT_RETRY:
+            if (millis() - linkStateTime > retryDelay) {
+                beginConnect();
+            }
+            break;
+    }
+}
+
+void onWiFiConnected() {
+    unsigned long connectMs = millis() - linkStateTime;
+    bool wasFast = linkState == LINK_FAST_CONNECT;
+    setLinkState(LINK_CONNECTED);
     
-    // 设置自动重连
-    WiFi.setAutoReconnect(true);
-    WiFi.persistent(false); // ✨ 改为false，不保存WiFi配置到flash
+    // 缓存本次的AP，下次直连
+    memcpy(cachedBssid, WiFi.BSSID(), sizeof(cachedBssid));
+    cachedChannel = WiFi.channel();
+    cachedApMagic = apCacheMagic;
     
-    Serial.print("Connecting to: ");
-    Serial.println(ssid);
+    // 网络接口重建后重新绑定端口
+    udpReceive.stop();
+    udpCommand.stop();
+    udpReceive.begin(listenPort);
+    udpCommand.begin(commandPort);
     
-    WiFi.begin(ssid, password);
+    // 断线期间UE的状态已过期，先发关键帧
+    transmit.keyframeRequested = true;
     
-    // 等待连接，最多30秒
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 60) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-        
-        if (attempts % 10 == 0) {
-            Serial.println();
-            Serial.print("Status: ");
-            Serial.print(WiFi.status());
-            Serial.print(" | Attempts: ");
-            Serial.println(attempts);
-        }
+    Serial.print("✓ WiFi Connected (");
+    Serial.print(wasFast ? "fast, " : "scan, ");
+    Serial.print(connectMs);
+    Serial.print(" ms");
+    if (linkLostTime != 0) {
+        Serial.print(", offline ");
+        Serial.print(millis() - linkLostTime);
+        Serial.print(" ms, buffered ");
+        Serial.print(offlineSamples.size());
     }
-    
-    Serial.println();
-    
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("✓ WiFi Connected!");
-        Serial.print("IP: ");
-        Serial.println(WiFi.localIP());
-        Serial.print("RSSI: ");
-        Serial.print(WiFi.RSSI());
-        Serial.println(" dBm");
-    } else {
-        Serial.println("✗ WiFi Failed!");
-        Serial.print("Final Status: ");
-        Serial.println(WiFi.status());
-        Serial.println("Restarting in 5s...");
-        delay(5000);
-        ESP.restart();
+    Serial.println(")");
+    Serial.print("IP: ");
+    Serial.print(WiFi.localIP());
+    Serial.print(" | RSSI: ");
+    Serial.print(WiFi.RSSI());
+    Serial.print(" dBm | Listening on port ");
+    Serial.print(listenPort);
+    Serial.print(", commands on port ");
+    Serial.println(commandPort);
+}
+
+// 补发离线缓冲的样本（带原始时间戳），每轮最多发送几个数据报，避免长时间占用loop
+void flushOfflineSamples() {
+    LocalSample sample;
+    for (int message = 0; message < maxFlushMessagesPerPass && offlineSamples.size() > 0; message++) {
+        OSCMessage batch("/avatar/input/samples");
+        batch.add((int32_t)2);
+        for (int i = 0; i < maxBatchSamples && offlineSamples.pop(sample); i++) {
+            batch.add((int32_t)sample.timestampUs);
+            batch.add(normalizeJoystick(sample.joyX));
+            batch.add(normalizeJoystick(sample.joyY));
+            batch.add(normalizePressure(sample.pressure2));
+        }
+        udpSend.beginPacket(ueHost, uePort);
+        batch.send(udpSend);
+        udpSend.endPacket();
     }
 }
 
+// 取出所有排队的S3数据包，只保留最新的一个，避免IMU数据滞后若干包
 void receiveS3Data() {
+    uint8_t buffer[sizeof(S3PacketV2) > sizeof(S3PacketV1) ? sizeof(S3PacketV2) : sizeof(S3PacketV1)];
     int packetSize = udpReceive.parsePacket();
-    if (packetSize == sizeof(SensorDataPacket)) {
-        SensorDataPacket tempData;
-        udpReceive.read((uint8_t*)&tempData, sizeof(SensorDataPacket));
+    while (packetSize > 0) {
+        int length = udpReceive.read(buffer, sizeof(buffer));
+        // 超长的包读不完，剩余字节在下一次 parsePacket 时丢弃
         
-        if (tempData.header[0] == 'S' && tempData.header[1] == '3' && 
-            tempData.header[2] == 'D' && tempData.header[3] == 'T') {
-            
-            uint8_t calculatedChecksum = calculateChecksum((uint8_t*)&tempData, sizeof(SensorDataPacket) - 1);
-            if (calculatedChecksum == tempData.checksum) {
-                s3Data = tempData;
-                s3DataValid = true;
-                lastS3DataTime = millis();
-            } else {
-                Serial.println("Checksum error!");
-            }
+        S3Reading reading;
+        S3PacketStatus status = length == packetSize
+            ? parseS3Packet(buffer, length, reading)
+            : S3_PACKET_BAD_SIZE;
+        
+        if (status == S3_PACKET_OK) {
+            acceptS3Reading(reading);
+        } else if (status == S3_PACKET_BAD_CHECKSUM) {
+            s3ChecksumErrors++;
         }
+        
+        packetSize = udpReceive.parsePacket();
     }
 }
 
-void sendOSCFloat(const char* address, float value) {
+void acceptS3Reading(const S3Reading &reading) {
+    // 重复或乱序的旧包直接丢弃；S3重启（超时或序号连续回到旧范围）后重新同步
+    if (reading.hasSequence && !s3Sequence.accept(reading.sequence, millis(), s3Timeout)) {
+        return;
+    }
+    
+    s3Data = reading;
+    s3DataValid = true;
+    s3PacketsReceived++;
+    lastS3DataTime = millis();
+    s3Address = udpReceive.remoteIP();
+    s3AddressKnown = true;
+}
+
+void sendOSCInt(const char* address, int32_t value) {
     OSCMessage msg(address);
     msg.add(value);
     udpSend.beginPacket(ueHost, uePort);
@@ -262,15 +617,117 @@ void sendOSCFloat(const char* address, float value) {
     udpSend.endPacket();
 }
 
-void sendOSCBool(const char* address, bool value) {
-    OSCMessage msg(address);
-    msg.add((int32_t)(value ? 1 : 0));
+// ✨✨✨ UE反向指令处理（非阻塞）✨✨✨
+// UE每帧把所有指令打成一个OSC bundle发来：/handle/<n>/vibrate|led|rate|mode|keyframe，末尾是 /handle/seq
+void receiveCommands() {
+    int packetSize = udpCommand.parsePacket();
+    while (packetSize > 0) {
+        // 超过上限的数据报读入后会被截断而无法解析，整个丢弃并提示；不回传确认，UE 端会看到丢失
+        if (packetSize > maxCommandBytes) {
+            Serial.print("指令数据报过大，已丢弃: ");
+            Serial.println(packetSize);
+            packetSize = udpCommand.parsePacket();
+            continue;
+        }
+        
+        uint8_t buffer[maxCommandBytes];
+        int length = udpCommand.read(buffer, packetSize);
+        
+        OSCBundle bundle;
+        bundle.fill(buffer, length);
+        
+        if (!bundle.hasError()) {
+            bundle.dispatch("/handle/2/vibrate", onVibrateCommand);
+            bundle.dispatch("/handle/2/led", onLedCommand);
+            bundle.dispatch("/handle/2/rate", onRateCommand);
+            bundle.dispatch("/handle/2/mode", onModeCommand);
+            bundle.dispatch("/handle/2/keyframe", onKeyframeCommand);
+            
+            // 左手柄的指令原样转发给ESP32S3
+            if (s3AddressKnown && bundleHasPrefix(bundle, "/handle/1/")) {
+                udpCommand.beginPacket(s3Address, s3CommandPort);
+                udpCommand.write(buffer, length);
+                udpCommand.endPacket();
+            }
+            
+            // 处理完整个数据报后回传确认，UE据此测量往返延迟
+            bundle.dispatch("/handle/seq", onSequenceCommand);
+        }
+        
+        packetSize = udpCommand.parsePacket();
+    }
+}
+
+bool bundleHasPrefix(OSCBundle &bundle, const char* prefix) {
+    char address[32];
+    size_t prefixLength = strlen(prefix);
+    for (int i = 0; i < bundle.size(); i++) {
+        OSCMessage* msg = bundle.getOSCMessage(i);
+        if (msg && msg->getAddress(address, 0, sizeof(address)) > 0 &&
+            strncmp(address, prefix, prefixLength) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void onVibrateCommand(OSCMessage &msg) {
+    int durationMs = msg.getInt(0);
+    float strength = constrain(msg.getFloat(1), 0.0, 1.0);
+    ledcWrite(vibrationChannel, (uint32_t)(strength * 255));
+    vibrationEndTime = millis() + durationMs;
+    vibrationActive = true;
+}
+
+void onLedCommand(OSCMessage &msg) {
+    ledcWrite(ledRChannel, constrain(msg.getInt(0), 0, 255));
+    ledcWrite(ledGChannel, constrain(msg.getInt(1), 0, 255));
+    ledcWrite(ledBChannel, constrain(msg.getInt(2), 0, 255));
+}
+
+// 修改当前模式的频率
+void onRateCommand(OSCMessage &msg) {
+    transmit.setRate(msg.getInt(0));
+    sendRateStatus();
+}
+
+// 切换模式：参数0为模式(0=空闲, 1=试次)，可选参数1为该模式的频率
+void onModeCommand(OSCMessage &msg) {
+    bool hasRate = msg.size() > 1 && msg.isInt(1);
+    transmit.setMode(msg.getInt(0), hasRate, hasRate ? msg.getInt(1) : 0);
+    sendRateStatus();
+}
+
+// 请求下一帧发送关键帧（UE检测到丢帧时发送）；可选参数0为新的关键帧间隔(毫秒)
+void onKeyframeCommand(OSCMessage &msg) {
+    transmit.requestKeyframe(msg.size() > 0 && msg.isInt(0) ? msg.getInt(0) : 0);
+}
+
+// 报告：手柄编号, 当前频率(Hz), 模式
+void sendRateStatus() {
+    lastRateReportTime = millis();
+    OSCMessage msg("/avatar/status/rate");
+    msg.add((int32_t)2);
+    msg.add((int32_t)transmit.rateHz());
+    msg.add((int32_t)transmit.mode);
     udpSend.beginPacket(ueHost, uePort);
     msg.send(udpSend);
     udpSend.endPacket();
 }
 
-void readAndSendButton(int pin, const char* address, bool &currentState, bool &lastState) {
+void onSequenceCommand(OSCMessage &msg) {
+    sendOSCInt("/avatar/feedback/ack", msg.getInt(0));
+}
+
+void updateVibration() {
+    if (vibrationActive && (long)(millis() - vibrationEndTime) >= 0) {
+        ledcWrite(vibrationChannel, 0);
+        vibrationActive = false;
+    }
+}
+
+// 消抖读取按钮，状态变化随下一帧发送
+void readButton(int pin, bool &currentState, bool &lastState) {
     bool reading = !digitalRead(pin);
     
     if (reading != lastState) {
@@ -280,17 +737,8 @@ void readAndSendButton(int pin, const char* address, bool &currentState, bool &l
     if ((millis() - lastDebounceTime) > debounceDelay) {
         if (reading != currentState) {
             currentState = reading;
-            sendOSCBool(address, currentState);
         }
     }
     
     lastState = reading;
 }
-
-uint8_t calculateChecksum(uint8_t* data, size_t length) {
-    uint8_t sum = 0;
-    for (size_t i = 0; i < length; i++) {
-        sum ^= data[i];
-    }
-    return sum;
-}
\ No newline at end of file
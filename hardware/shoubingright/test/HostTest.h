@@ -0,0 +1,31 @@
+#pragma once
+
+// 主机测试用的最小断言：失败时打印位置并计数，不中断后续检查
+
+#include <stdio.h>
+
+static int hostTestFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK(%s) 失败\n", __FILE__, __LINE__, #condition); \
+            hostTestFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        long long actualValue = (long long)(actual); \
+        long long expectedValue = (long long)(expected); \
+        if (actualValue != expectedValue) { \
+            printf("%s:%d: %s = %lld，期望 %lld\n", __FILE__, __LINE__, #actual, actualValue, expectedValue); \
+            hostTestFailures++; \
+        } \
+    } while (0)
+
+// main 的返回值：全部通过为 0
+inline int finishTests(const char* name) {
+    printf("%s: %s\n", name, hostTestFailures == 0 ? "通过" : "失败");
+    return hostTestFailures == 0 ? 0 : 1;
+}
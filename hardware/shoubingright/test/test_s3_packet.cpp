@@ -0,0 +1,157 @@
+// ESP32S3 数据包校验和序号跟踪的主机测试
+
+#include "S3Packet.h"
+#include "HostTest.h"
+
+static S3PacketV2 makeV2(uint16_t sequence, uint32_t timestampUs, float accelX) {
+    S3PacketV2 packet;
+    memset(&packet, 0, sizeof(packet));
+    memcpy(packet.header, "S3D2", 4);
+    packet.sequence = sequence;
+    packet.timestampUs = timestampUs;
+    packet.accelX = accelX;
+    packet.accelZ = 1.0f;
+    packet.pressure1 = 0.25f;
+    packet.buttons = 0x05;
+    packet.crc = crc16Ccitt((const uint8_t*)&packet, sizeof(packet) - sizeof(packet.crc));
+    return packet;
+}
+
+static S3PacketV1 makeV1(float gyroZ) {
+    S3PacketV1 packet;
+    memset(&packet, 0, sizeof(packet));
+    memcpy(packet.header, "S3DT", 4);
+    packet.gyroZ = gyroZ;
+    packet.buttons = 0x02;
+    packet.checksum = xorChecksum((const uint8_t*)&packet, sizeof(packet) - 1);
+    return packet;
+}
+
+static void testCrc() {
+    // CRC16-CCITT（0x1021，初值 0xFFFF）的标准校验值
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK_EQ(crc16Ccitt(check, sizeof(check)), 0x29B1);
+    CHECK_EQ(crc16Ccitt(check, 0), 0xFFFF);
+}
+
+static void testParseV2() {
+    S3PacketV2 packet = makeV2(1234, 987654321u, 0.5f);
+    S3Reading reading;
+    CHECK_EQ(parseS3Packet((const uint8_t*)&packet, sizeof(packet), reading), S3_PACKET_OK);
+    CHECK(reading.hasSequence);
+    CHECK_EQ(reading.sequence, 1234);
+    CHECK_EQ(reading.timestampUs, 987654321u);
+    CHECK(reading.accelX == 0.5f && reading.accelZ == 1.0f && reading.pressure1 == 0.25f);
+    CHECK_EQ(reading.buttons, 0x05);
+
+    // 任意一个字节的任意一位翻转都能被 CRC 发现
+    int undetected = 0;
+    for (size_t byte = 4; byte < sizeof(packet); byte++) {
+        for (int bit = 0; bit < 8; bit++) {
+            S3PacketV2 corrupted = packet;
+            ((uint8_t*)&corrupted)[byte] ^= (uint8_t)(1 << bit);
+            undetected += parseS3Packet((const uint8_t*)&corrupted, sizeof(corrupted), reading) == S3_PACKET_OK ? 1 : 0;
+        }
+    }
+    CHECK_EQ(undetected, 0);
+
+    S3PacketV2 badHeader = packet;
+    badHeader.header[3] = 'X';
+    CHECK_EQ(parseS3Packet((const uint8_t*)&badHeader, sizeof(badHeader), reading), S3_PACKET_BAD_HEADER);
+
+    // 截断或多出字节的包按长度拒绝
+    CHECK_EQ(parseS3Packet((const uint8_t*)&packet, sizeof(packet) - 1, reading), S3_PACKET_BAD_SIZE);
+    uint8_t longer[sizeof(packet) + 1] = {0};
+    memcpy(longer, &packet, sizeof(packet));
+    CHECK_EQ(parseS3Packet(longer, sizeof(longer), reading), S3_PACKET_BAD_SIZE);
+}
+
+static void testParseV1() {
+    S3PacketV1 packet = makeV1(-12.5f);
+    S3Reading reading;
+    CHECK_EQ(parseS3Packet((const uint8_t*)&packet, sizeof(packet), reading), S3_PACKET_OK);
+    CHECK(!reading.hasSequence);
+    CHECK(reading.gyroZ == -12.5f);
+    CHECK_EQ(reading.buttons, 0x02);
+
+    packet.pressure1 = 1.0f;
+    CHECK_EQ(parseS3Packet((const uint8_t*)&packet, sizeof(packet), reading), S3_PACKET_BAD_CHECKSUM);
+}
+
+static void testSequenceAdvance() {
+    CHECK_EQ(sequenceAdvance(10, 11), 1);
+    CHECK_EQ(sequenceAdvance(10, 10), 0);
+    CHECK_EQ(sequenceAdvance(10, 8), -2);
+    CHECK_EQ(sequenceAdvance(65535, 0), 1);
+    CHECK_EQ(sequenceAdvance(65530, 4), 10);
+    CHECK_EQ(sequenceAdvance(4, 65530), -10);
+}
+
+static void testSequenceTracker() {
+    const uint32_t timeoutMs = 200;
+    S3SequenceTracker tracker;
+    uint32_t nowMs = 1000;
+
+    // 连续、跨回绕、缺口计为丢包
+    CHECK(tracker.accept(65533, nowMs, timeoutMs));
+    CHECK(tracker.accept(65534, nowMs += 2, timeoutMs));
+    CHECK(tracker.accept(1, nowMs += 2, timeoutMs));
+    CHECK_EQ(tracker.lost, 2);
+
+    // 重复和乱序的旧包丢弃
+    CHECK(!tracker.accept(1, nowMs += 2, timeoutMs));
+    CHECK(!tracker.accept(65535, nowMs += 2, timeoutMs));
+    CHECK(tracker.accept(2, nowMs += 2, timeoutMs));
+    CHECK_EQ(tracker.discarded, 2);
+    CHECK_EQ(tracker.resyncs, 0);
+
+    // 重复的旧包不会凑成“连续递增”而触发重新同步
+    for (int i = 0; i < 5; i++) {
+        CHECK(!tracker.accept(1, nowMs += 2, timeoutMs));
+    }
+    CHECK_EQ(tracker.resyncs, 0);
+
+    // S3重启且中间超过超时：最后的序号很小（< 1000）时也立即接受新的序号
+    S3SequenceTracker rebooted;
+    nowMs = 5000;
+    for (uint16_t sequence = 0; sequence < 500; sequence++) {
+        CHECK(rebooted.accept(sequence, nowMs += 2, timeoutMs));
+    }
+    nowMs += 1500;
+    CHECK(rebooted.accept(0, nowMs, timeoutMs));
+    CHECK(rebooted.accept(1, nowMs += 2, timeoutMs));
+    CHECK_EQ(rebooted.resyncs, 1);
+    CHECK_EQ(rebooted.discarded, 0);
+    CHECK_EQ(rebooted.lost, 0);
+
+    // 没有超时（例如 S3 很快重启）：连续几个依次递增的旧序号后重新同步，之后正常接受
+    S3SequenceTracker quick;
+    nowMs = 9000;
+    for (uint16_t sequence = 0; sequence < 800; sequence++) {
+        quick.accept(sequence, nowMs += 2, timeoutMs);
+    }
+    int accepted = 0;
+    for (uint16_t sequence = 0; sequence < 10; sequence++) {
+        accepted += quick.accept(sequence, nowMs += 2, timeoutMs) ? 1 : 0;
+    }
+    CHECK_EQ(quick.discarded, S3SequenceTracker::restartPackets - 1);
+    CHECK_EQ(accepted, 10 - (S3SequenceTracker::restartPackets - 1));
+    CHECK_EQ(quick.resyncs, 1);
+
+    // millis() 回绕时超时判断仍然正确
+    S3SequenceTracker wrapping;
+    nowMs = 0xFFFFFFFFu - 50;
+    CHECK(wrapping.accept(100, nowMs, timeoutMs));
+    nowMs += 100;
+    CHECK(!wrapping.accept(99, nowMs, timeoutMs));
+    CHECK_EQ(wrapping.resyncs, 0);
+}
+
+int main() {
+    testCrc();
+    testParseV2();
+    testParseV1();
+    testSequenceAdvance();
+    testSequenceTracker();
+    return finishTests("test_s3_packet");
+}
@@ -0,0 +1,166 @@
+// 定时采样缓冲与过采样抽取的主机测试
+
+#include "SampleBuffer.h"
+#include "HostTest.h"
+
+#include <thread>
+
+static void testOversampler() {
+    // 每 4 组读数输出一次平均值
+    Oversampler<3> oversampler(4);
+    const uint16_t readings[4][3] = {
+        {100, 4095, 0},
+        {104, 4095, 1},
+        {108, 4095, 2},
+        {112, 4095, 5},
+    };
+    float averaged[3] = {-1.0f, -1.0f, -1.0f};
+    for (int i = 0; i < 3; i++) {
+        CHECK(!oversampler.add(readings[i], averaged));
+    }
+    CHECK(oversampler.add(readings[3], averaged));
+    CHECK(averaged[0] == 106.0f);
+    CHECK(averaged[1] == 4095.0f);
+    CHECK(averaged[2] == 2.0f);
+
+    // 输出后重新累加，不带上一组的余数
+    const uint16_t constant[3] = {7, 7, 7};
+    for (int i = 0; i < 3; i++) {
+        CHECK(!oversampler.add(constant, averaged));
+    }
+    CHECK(oversampler.add(constant, averaged));
+    CHECK(averaged[0] == 7.0f && averaged[1] == 7.0f && averaged[2] == 7.0f);
+
+    // 因子为 0 时按 1 处理：每组读数直接输出
+    Oversampler<1> passthrough(0);
+    CHECK_EQ(passthrough.factor(), 1);
+    uint16_t single = 1234;
+    float value = 0.0f;
+    CHECK(passthrough.add(&single, &value));
+    CHECK(value == 1234.0f);
+
+    // 最大因子下 12 位满量程读数的累加不溢出
+    Oversampler<1> wide(255);
+    uint16_t fullScale = 4095;
+    bool emitted = false;
+    for (int i = 0; i < 255; i++) {
+        emitted = wide.add(&fullScale, &value);
+    }
+    CHECK(emitted);
+    CHECK(value == 4095.0f);
+}
+
+static void testRingOverflow() {
+    SampleRing<LocalSample, 8> ring;
+    LocalSample sample = {};
+    for (uint32_t i = 0; i < 8; i++) {
+        sample.timestampUs = i;
+        CHECK(ring.push(sample));
+    }
+    CHECK_EQ(ring.size(), 8);
+
+    // 满时丢弃新样本并计数，不覆盖未读数据
+    sample.timestampUs = 100;
+    CHECK(!ring.push(sample));
+    CHECK(!ring.push(sample));
+    CHECK_EQ(ring.dropped(), 2);
+    CHECK_EQ(ring.size(), 8);
+
+    LocalSample out = {};
+    CHECK(ring.pop(out));
+    CHECK_EQ(out.timestampUs, 0);
+    sample.timestampUs = 8;
+    CHECK(ring.push(sample));
+
+    for (uint32_t i = 1; i <= 8; i++) {
+        CHECK(ring.pop(out));
+        CHECK_EQ(out.timestampUs, i);
+    }
+    CHECK(!ring.pop(out));
+    CHECK_EQ(ring.size(), 0);
+}
+
+static void testRingIndexWrap() {
+    // 下标在 uint32 回绕前后保持先进先出，满和空的判断不受影响
+    SampleRing<LocalSample, 16> ring(0xFFFFFFF0u);
+    LocalSample sample = {};
+    LocalSample out = {};
+    uint32_t nextPush = 0;
+    uint32_t nextPop = 0;
+    for (int round = 0; round < 8; round++) {
+        for (;;) {
+            sample.timestampUs = nextPush;
+            if (!ring.push(sample)) {
+                break;
+            }
+            nextPush++;
+        }
+        CHECK_EQ(ring.size(), 16);
+        for (int i = 0; i < 10; i++) {
+            CHECK(ring.pop(out));
+            CHECK_EQ(out.timestampUs, nextPop);
+            nextPop++;
+        }
+        CHECK_EQ(ring.size(), 6);
+    }
+    while (ring.pop(out)) {
+        CHECK_EQ(out.timestampUs, nextPop);
+        nextPop++;
+    }
+    CHECK_EQ(nextPop, nextPush);
+    CHECK_EQ(ring.dropped(), 8);
+}
+
+static void testTimerWrap() {
+    // 500Hz 的窗口跨过 micros() 回绕：相邻时间戳的无符号差仍是一个窗口
+    const uint32_t windowUs = 2000;
+    uint32_t nowUs = 0xFFFFFFFFu - 5 * windowUs;
+    uint32_t previous = windowMidpointUs(nowUs, windowUs);
+    for (int i = 0; i < 10; i++) {
+        nowUs += windowUs;
+        uint32_t timestamp = windowMidpointUs(nowUs, windowUs);
+        CHECK_EQ(timestamp - previous, windowUs);
+        previous = timestamp;
+    }
+    CHECK(nowUs < windowUs * 5);
+
+    // 窗口刚在回绕后结束时，中点落在回绕之前
+    CHECK_EQ(windowMidpointUs(400, windowUs), 0xFFFFFFFFu - 599);
+}
+
+static void testRingThreads() {
+    // 单生产者/单消费者：采样任务和网络循环在不同线程时顺序不乱、不丢失
+    SampleRing<LocalSample, 256> ring;
+    const uint32_t count = 2000000;
+    std::thread producer([&ring]() {
+        LocalSample sample = {};
+        for (uint32_t i = 0; i < count; i++) {
+            sample.timestampUs = i;
+            while (!ring.push(sample)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t outOfOrder = 0;
+    LocalSample out = {};
+    while (expected < count) {
+        if (ring.pop(out)) {
+            outOfOrder += out.timestampUs != expected ? 1 : 0;
+            expected++;
+        }
+    }
+    producer.join();
+    CHECK_EQ(outOfOrder, 0);
+    CHECK_EQ(ring.size(), 0);
+}
+
+int main() {
+    testOversampler();
+    testRingOverflow();
+    testRingIndexWrap();
+    testTimerWrap();
+    testRingThreads();
+    return finishTests("test_sample_buffer");
+}
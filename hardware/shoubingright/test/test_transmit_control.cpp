@@ -0,0 +1,111 @@
+// 传输模式与发送节拍的主机测试
+// 按 loop() 的流程模拟发送循环：到节拍 → 决定是否关键帧 → 有变化或关键帧时发送，并在中途切换模式
+
+#include "TransmitControl.h"
+#include "HostTest.h"
+
+// 模拟发送循环的统计
+struct LoopStats {
+    int ticks = 0;
+    int frames = 0;
+    int keyframes = 0;
+    uint32_t maxFrameGapUs = 0;
+};
+
+// 以 stepUs 为步长运行 durationUs；changeEveryTicks > 0 时每隔这么多个周期数据变化一次
+static LoopStats runLoop(TransmitControl& control, uint32_t& nowUs, uint32_t durationUs, uint32_t stepUs,
+                         int changeEveryTicks) {
+    LoopStats stats;
+    uint32_t lastFrameUs = nowUs;
+    for (uint32_t elapsed = 0; elapsed < durationUs; elapsed += stepUs, nowUs += stepUs) {
+        if (!control.tick(nowUs)) {
+            continue;
+        }
+        stats.ticks++;
+        bool changed = changeEveryTicks > 0 && stats.ticks % changeEveryTicks == 0;
+        bool keyframe = control.keyframeDue(nowUs / 1000);
+        if (!keyframe && !changed) {
+            continue;
+        }
+        control.frameSent(keyframe, nowUs / 1000);
+        stats.frames++;
+        stats.keyframes += keyframe ? 1 : 0;
+        if (nowUs - lastFrameUs > stats.maxFrameGapUs) {
+            stats.maxFrameGapUs = nowUs - lastFrameUs;
+        }
+        lastFrameUs = nowUs;
+    }
+    return stats;
+}
+
+int main() {
+    // 上电默认：空闲模式 10Hz，第一帧为关键帧；UE在试次开始时切换到试次模式
+    TransmitControl control;
+    CHECK_EQ(control.mode, MODE_IDLE);
+    CHECK_EQ(control.rateHz(), 10);
+    CHECK(control.keyframeRequested);
+
+    // 试次模式：500Hz 完整帧
+    control.setMode(MODE_TRIAL, false, 0);
+    CHECK_EQ(control.rateHz(), 500);
+    CHECK_EQ(control.intervalUs(), 2000);
+
+    uint32_t nowUs = 10000;
+    LoopStats trial = runLoop(control, nowUs, 1000000, 100, 0);
+    CHECK(trial.ticks >= 499 && trial.ticks <= 501);
+    CHECK_EQ(trial.frames, trial.ticks);
+    CHECK_EQ(trial.keyframes, trial.ticks);
+
+    // 切到空闲模式：10Hz，数据不变时只发关键帧，间隔不超过关键帧间隔（须小于UE的2秒超时）
+    control.setMode(MODE_IDLE, false, 0);
+    CHECK_EQ(control.rateHz(), 10);
+    CHECK(control.keyframeRequested);
+    LoopStats idle = runLoop(control, nowUs, 5000000, 100, 0);
+    CHECK(idle.ticks >= 49 && idle.ticks <= 51);
+    CHECK(idle.frames >= 5 && idle.frames <= 6);
+    CHECK_EQ(idle.keyframes, idle.frames);
+    CHECK(idle.maxFrameGapUs <= 1100000);
+
+    // 空闲模式下数据变化时发送增量帧
+    LoopStats changing = runLoop(control, nowUs, 1000000, 100, 2);
+    CHECK(changing.frames >= 5);
+    CHECK(changing.frames > changing.keyframes);
+
+    // 模式切换带频率参数只修改该模式的频率，回到试次时使用原来的频率
+    control.setMode(MODE_IDLE, true, 20);
+    CHECK_EQ(control.idleRateHz, 20);
+    CHECK_EQ(control.trialRateHz, 500);
+    control.setMode(MODE_TRIAL, false, 0);
+    CHECK_EQ(control.rateHz(), 500);
+    control.setRate(250);
+    CHECK_EQ(control.trialRateHz, 250);
+    CHECK_EQ(control.idleRateHz, 20);
+
+    // 频率和关键帧间隔的范围
+    control.setRate(0);
+    CHECK_EQ(control.rateHz(), 1);
+    control.setRate(5000);
+    CHECK_EQ(control.rateHz(), 1000);
+    control.requestKeyframe(50);
+    CHECK_EQ(control.keyframeIntervalMs, 100);
+    control.requestKeyframe(5000);
+    CHECK_EQ(control.keyframeIntervalMs, 1500);
+    control.requestKeyframe(0);
+    CHECK_EQ(control.keyframeIntervalMs, 1500);
+
+    // 循环卡住 50ms 后重新对齐节拍，不连续补发
+    control.setRate(500);
+    runLoop(control, nowUs, 10000, 100, 0);
+    nowUs += 50000;
+    LoopStats resumed = runLoop(control, nowUs, 10000, 100, 0);
+    CHECK(resumed.ticks >= 5 && resumed.ticks <= 6);
+
+    // micros() 回绕时节拍不受影响
+    TransmitControl wrapping;
+    wrapping.setMode(MODE_TRIAL, false, 0);
+    uint32_t wrapUs = 0xFFFFFFFFu - 500000;
+    LoopStats acrossWrap = runLoop(wrapping, wrapUs, 1000000, 100, 0);
+    CHECK(acrossWrap.ticks >= 499 && acrossWrap.ticks <= 501);
+
+    return finishTests("test_transmit_control");
+}